@@ -12,6 +12,10 @@ if(NOT DEFINED VSTGUI_ENABLE_OPENGL_SUPPORT)
     option(VSTGUI_ENABLE_OPENGL_SUPPORT "Enable OpenGL support" ON)
 endif()
 
+if(NOT DEFINED VSTGUI_ENABLE_TRACING)
+    option(VSTGUI_ENABLE_TRACING "Enable recording of trace events in the hot paths" OFF)
+endif()
+
 ##########################################################################################
 if(UNIX AND NOT CMAKE_HOST_APPLE)
     set(LINUX TRUE CACHE INTERNAL "VSTGUI linux platform")
@@ -80,6 +84,14 @@ else()
 	set(VSTGUI_COMPILE_DEFINITIONS_RELEASE "${VSTGUI_COMPILE_DEFINITIONS_RELEASE};VSTGUI_OPENGL_SUPPORT=0")
 endif()
 
+if(VSTGUI_ENABLE_TRACING)
+	set(VSTGUI_COMPILE_DEFINITIONS_DEBUG "${VSTGUI_COMPILE_DEFINITIONS_DEBUG};VSTGUI_ENABLE_TRACING=1")
+	set(VSTGUI_COMPILE_DEFINITIONS_RELEASE "${VSTGUI_COMPILE_DEFINITIONS_RELEASE};VSTGUI_ENABLE_TRACING=1")
+else()
+	set(VSTGUI_COMPILE_DEFINITIONS_DEBUG "${VSTGUI_COMPILE_DEFINITIONS_DEBUG};VSTGUI_ENABLE_TRACING=0")
+	set(VSTGUI_COMPILE_DEFINITIONS_RELEASE "${VSTGUI_COMPILE_DEFINITIONS_RELEASE};VSTGUI_ENABLE_TRACING=0")
+endif()
+
 set(VSTGUI_COMPILE_DEFINITIONS PRIVATE
     $<$<CONFIG:Debug>:${VSTGUI_COMPILE_DEFINITIONS_DEBUG}>
     $<$<CONFIG:Release>:${VSTGUI_COMPILE_DEFINITIONS_RELEASE}>
@@ -5,12 +5,130 @@
 #include "animations.h"
 #include "../cview.h"
 #include "../cframe.h"
+#include "../cbitmap.h"
+#include "../cdrawcontext.h"
+#include "../coffscreencontext.h"
+#include "../cviewcontainer.h"
 #include "../controls/ccontrol.h"
 #include <cassert>
 #include <cmath>
 
 namespace VSTGUI {
 namespace Animation {
+namespace Detail {
+
+//-----------------------------------------------------------------------------
+class OffscreenLayerView : public CView
+{
+public:
+	OffscreenLayerView (const CRect& size, CBitmap* bitmap) : CView (size)
+	{
+		setBackground (bitmap);
+		setMouseEnabled (false);
+	}
+
+	void draw (CDrawContext* context) override
+	{
+		auto bitmap = getDrawBackground ();
+		auto bitmapSize = bitmap->getSize ();
+		const auto& viewSize = getViewSize ();
+		if (viewSize.getSize () == bitmapSize)
+		{
+			bitmap->draw (context, viewSize);
+		}
+		else
+		{
+			CGraphicsTransform transform;
+			transform.scale (viewSize.getWidth () / bitmapSize.x, viewSize.getHeight () / bitmapSize.y);
+			transform.translate (viewSize.left, viewSize.top);
+			CDrawContext::Transform t (*context, transform);
+			bitmap->draw (context, CRect (CPoint (), bitmapSize));
+		}
+		setDirty (false);
+	}
+};
+
+//-----------------------------------------------------------------------------
+/** Moves a bitmap of a view instead of the view
+ *
+ *	The view is hidden and a view drawing the bitmap is inserted at its place. When the layer is
+ *	destroyed the view gets the size of the layer and its visibility is restored.
+ */
+class OffscreenLayer
+{
+public:
+	/** returns nullptr if the view has no parent or cannot be rendered offscreen */
+	static std::unique_ptr<OffscreenLayer> create (CView* view);
+
+	OffscreenLayer (CView* view, CViewContainer* parent, CBitmap* bitmap);
+	~OffscreenLayer () noexcept;
+
+	const CRect& getViewSize () const { return layerView->getViewSize (); }
+	void setViewSize (const CRect& rect);
+
+private:
+	SharedPointer<CView> view;
+	SharedPointer<CView> layerView;
+	bool viewWasVisible;
+};
+
+//-----------------------------------------------------------------------------
+std::unique_ptr<OffscreenLayer> OffscreenLayer::create (CView* view)
+{
+	auto parent = view->getParentView () ? view->getParentView ()->asViewContainer () : nullptr;
+	if (!parent)
+		return nullptr;
+	auto viewSize = view->getViewSize ();
+	auto frame = view->getFrame ();
+	auto bitmap = renderBitmapOffscreen (
+		viewSize.getSize (), frame ? frame->getScaleFactor () : 1., [&] (CDrawContext& context) {
+			CDrawContext::Transform transform (
+				context, CGraphicsTransform ().translate (-viewSize.left, -viewSize.top));
+			view->drawRect (&context, viewSize);
+		});
+	if (!bitmap)
+		return nullptr;
+	return std::unique_ptr<OffscreenLayer> (new OffscreenLayer (view, parent, bitmap));
+}
+
+//-----------------------------------------------------------------------------
+OffscreenLayer::OffscreenLayer (CView* view, CViewContainer* parent, CBitmap* bitmap)
+: view (view), viewWasVisible (view->isVisible ())
+{
+	layerView = makeOwned<OffscreenLayerView> (view->getViewSize (), bitmap);
+	layerView->setAlphaValue (view->getAlphaValue ());
+	// the container owns the view it adds
+	layerView->remember ();
+	parent->addView (layerView, view);
+	view->setVisible (false);
+}
+
+//-----------------------------------------------------------------------------
+OffscreenLayer::~OffscreenLayer () noexcept
+{
+	auto rect = layerView->getViewSize ();
+	if (auto parent = layerView->getParentView ())
+		parent->asViewContainer ()->removeView (layerView);
+	if (view->getViewSize () != rect)
+	{
+		view->setViewSize (rect);
+		view->setMouseableArea (rect);
+	}
+	view->setVisible (viewWasVisible);
+}
+
+//-----------------------------------------------------------------------------
+void OffscreenLayer::setViewSize (const CRect& rect)
+{
+	if (layerView->getViewSize () == rect)
+		return;
+	layerView->invalid ();
+	layerView->setViewSize (rect);
+	layerView->invalid ();
+}
+
+} // Detail
+
 //------------------------------------------------------------------------
 /*! @defgroup AnimationTargets Animation Targets
  *	@ingroup animation
@@ -51,21 +169,30 @@ void AlphaValueAnimation::animationFinished (CView* view, IdStringPtr name, bool
 /** @class ViewSizeAnimation
 	see @ref page_animation Support */
 //-----------------------------------------------------------------------------
-ViewSizeAnimation::ViewSizeAnimation (const CRect& inNewRect, bool forceEndValueOnFinish)
+ViewSizeAnimation::ViewSizeAnimation (const CRect& inNewRect, bool forceEndValueOnFinish,
+									  bool useOffscreenLayer)
 : newRect (inNewRect)
 , forceEndValueOnFinish (forceEndValueOnFinish)
+, useOffscreenLayer (useOffscreenLayer)
 {
 }
 
+//-----------------------------------------------------------------------------
+ViewSizeAnimation::~ViewSizeAnimation () noexcept = default;
+
 //-----------------------------------------------------------------------------
 void ViewSizeAnimation::animationStart (CView* view, IdStringPtr name)
 {
 	startRect = view->getViewSize ();
+	if (useOffscreenLayer)
+		layer = Detail::OffscreenLayer::create (view);
 }
 
 //-----------------------------------------------------------------------------
 void ViewSizeAnimation::animationFinished (CView* view, IdStringPtr name, bool wasCanceled)
 {
+	// the view gets the size of the last tick
+	layer = nullptr;
 	if (!wasCanceled || forceEndValueOnFinish)
 	{
 		if (view->getViewSize () != newRect)
@@ -86,7 +213,9 @@ void ViewSizeAnimation::animationTick (CView* view, IdStringPtr name, float pos)
 	r.right = (int32_t)(startRect.right + ((newRect.right - startRect.right) * pos));
 	r.top = (int32_t)(startRect.top + ((newRect.top - startRect.top) * pos));
 	r.bottom = (int32_t)(startRect.bottom + ((newRect.bottom - startRect.bottom) * pos));
-	if (view->getViewSize () != r)
+	if (layer)
+		layer->setViewSize (r);
+	else if (view->getViewSize () != r)
 	{
 		view->invalid ();
 		view->setViewSize (r);
@@ -99,10 +228,12 @@ void ViewSizeAnimation::animationTick (CView* view, IdStringPtr name, float pos)
 /** @class ExchangeViewAnimation
 	see @ref page_animation Support */
 //-----------------------------------------------------------------------------
-ExchangeViewAnimation::ExchangeViewAnimation (CView* oldView, CView* newView, AnimationStyle style)
+ExchangeViewAnimation::ExchangeViewAnimation (CView* oldView, CView* newView, AnimationStyle style,
+											  bool useOffscreenLayer)
 : newView (newView)
 , viewToRemove (oldView)
 , style (style)
+, useOffscreenLayer (useOffscreenLayer)
 {
 	vstgui_assert (newView->isAttached () == false);
 	vstgui_assert (viewToRemove->isAttached ());
@@ -121,10 +252,21 @@ ExchangeViewAnimation::~ExchangeViewAnimation () noexcept
 //-----------------------------------------------------------------------------
 void ExchangeViewAnimation::updateViewSize (CView* view, const CRect& rect)
 {
-	view->invalid ();
-	view->setViewSize (rect);
-	view->setMouseableArea (rect);
-	view->invalid ();
+	if (view == newView && newViewLayer)
+	{
+		newViewLayer->setViewSize (rect);
+	}
+	else if (view == viewToRemove && oldViewLayer)
+	{
+		oldViewLayer->setViewSize (rect);
+	}
+	else
+	{
+		view->invalid ();
+		view->setViewSize (rect);
+		view->setMouseableArea (rect);
+		view->invalid ();
+	}
 }
 
 //-----------------------------------------------------------------------------
@@ -266,6 +408,12 @@ void ExchangeViewAnimation::animationStart (CView* view, IdStringPtr name)
 	CViewContainer* parent = viewToRemove->getParentView ()->asViewContainer ();
 	vstgui_assert (view == parent);
 	#endif
+	if (!useOffscreenLayer || style == kAlphaValueFade)
+		return;
+	newViewLayer = Detail::OffscreenLayer::create (newView);
+	// only the push in and out styles move the old view
+	if (style == kPushInOutFromLeft || style == kPushInOutFromRight)
+		oldViewLayer = Detail::OffscreenLayer::create (viewToRemove);
 }
 
 //-----------------------------------------------------------------------------
@@ -315,6 +463,8 @@ void ExchangeViewAnimation::animationTick (CView* view, IdStringPtr name, float
 void ExchangeViewAnimation::animationFinished (CView* view, IdStringPtr name, bool wasCanceled)
 {
 	animationTick (nullptr, nullptr, 1.f);
+	newViewLayer = nullptr;
+	oldViewLayer = nullptr;
 	if (auto viewContainer = viewToRemove->getParentView ()->asViewContainer ())
 	{
 		viewContainer->removeView (viewToRemove);
@@ -7,9 +7,13 @@
 #include "../vstguifwd.h"
 #include "ianimationtarget.h"
 #include "../crect.h"
+#include <memory>
 
 namespace VSTGUI {
 namespace Animation {
+namespace Detail {
+class OffscreenLayer;
+} // Detail
 
 //-----------------------------------------------------------------------------
 /// @brief animates the alpha value of the view
@@ -24,6 +28,9 @@ public:
 	void animationStart (CView* view, IdStringPtr name) override;
 	void animationTick (CView* view, IdStringPtr name, float pos) override;
 	void animationFinished (CView* view, IdStringPtr name, bool wasCanceled) override;
+
+	float getEndValue () const { return endValue; }
+	bool getForceEndValueOnFinish () const { return forceEndValueOnFinish; }
 protected:
 	float startValue;
 	float endValue;
@@ -38,15 +45,28 @@ protected:
 class ViewSizeAnimation : public IAnimationTarget, public NonAtomicReferenceCounted
 {
 public:
-	ViewSizeAnimation (const CRect& newRect, bool forceEndValueOnFinish = false);
+	/** If useOffscreenLayer is true, the view is rendered once into an offscreen bitmap when the
+		animation starts and only this bitmap is moved and scaled while the animation runs. The
+		view itself gets its new size when the animation has finished, so a container is only
+		laid out and drawn once instead of on every tick.
+	*/
+	ViewSizeAnimation (const CRect& newRect, bool forceEndValueOnFinish = false,
+					   bool useOffscreenLayer = false);
+	~ViewSizeAnimation () noexcept override;
 
 	void animationStart (CView* view, IdStringPtr name) override;
 	void animationTick (CView* view, IdStringPtr name, float pos) override;
 	void animationFinished (CView* view, IdStringPtr name, bool wasCanceled) override;
+
+	const CRect& getNewRect () const { return newRect; }
+	bool getForceEndValueOnFinish () const { return forceEndValueOnFinish; }
+	bool getUseOffscreenLayer () const { return useOffscreenLayer; }
 protected:
 	CRect startRect;
 	CRect newRect;
 	bool forceEndValueOnFinish;
+	bool useOffscreenLayer;
+	std::unique_ptr<Detail::OffscreenLayer> layer;
 };
 
 //-----------------------------------------------------------------------------
@@ -67,8 +87,12 @@ public:
 		kPushInOutFromRight
 	};
 
-	/** oldView must be a subview of the animation view */
-	ExchangeViewAnimation (CView* oldView, CView* newView, AnimationStyle style = kAlphaValueFade);
+	/** oldView must be a subview of the animation view
+		If useOffscreenLayer is true, the moving views of the push styles are rendered once into
+		offscreen bitmaps which are moved instead of the views.
+	*/
+	ExchangeViewAnimation (CView* oldView, CView* newView, AnimationStyle style = kAlphaValueFade,
+						   bool useOffscreenLayer = false);
 	~ExchangeViewAnimation () noexcept override;
 
 	void animationStart (CView* view, IdStringPtr name) override;
@@ -93,6 +117,9 @@ protected:
 	float newViewAlphaValueEnd;
 	float oldViewAlphaValueStart;
 	CRect destinationRect;
+	bool useOffscreenLayer;
+	std::unique_ptr<Detail::OffscreenLayer> newViewLayer;
+	std::unique_ptr<Detail::OffscreenLayer> oldViewLayer;
 };
 
 //-----------------------------------------------------------------------------
@@ -108,6 +135,9 @@ public:
 	void animationStart (CView* view, IdStringPtr name) override;
 	void animationTick (CView* view, IdStringPtr name, float pos) override;
 	void animationFinished (CView* view, IdStringPtr name, bool wasCanceled) override;
+
+	float getEndValue () const { return endValue; }
+	bool getForceEndValueOnFinish () const { return forceEndValueOnFinish; }
 protected:
 	float startValue;
 	float endValue;
@@ -12,6 +12,8 @@ The source can be found under /lib/animation/
 @section the_animator The Animator
 Every @link VSTGUI::CFrame::getAnimator CFrame @endlink object can have one @link VSTGUI::Animation::Animator Animator @endlink object which runs animations at 60 Hz.
 
+The time of the animations is the predicted presentation time of the frame from the shared @link VSTGUI::Animation::FrameClock FrameClock @endlink, so the animations advance in even steps even if the timer driving them is late or fires twice in one frame.
+
 The animator is responsible for running animations.
 You can add and remove animations.
 Animations are identified by a view and a name.
@@ -24,6 +26,10 @@ You can also stop all animations for a view with @link VSTGUI::CView::removeAllA
 The animator is the owner of the target and timing function objects and will destroy these objects when the animation has finished.
 This means that the animator will call delete on these objects or if they are inherited from CBaseObject it will call forget() on them.
 
+Animations of the included AlphaValueAnimation, ViewSizeAnimation and ControlValueAnimation targets with a LinearTimingFunction, PowerTimingFunction or CubicBezierTimingFunction are run in a batch without calling the virtual methods of these objects.
+All other animations, including the ones with subclasses of these classes, are run via the IAnimationTarget and ITimingFunction interfaces.
+On every frame the batched animations are run before all other animations, so the order of two animations of different kinds is not the order in which they were added.
+
 @section the_animation The Animation
 
 An animation is made up by an @link VSTGUI::Animation::IAnimationTarget IAnimationTarget @endlink and an @link VSTGUI::Animation::ITimingFunction ITimingFunction @endlink object.
@@ -90,12 +96,14 @@ public:
 //-----------------------------------------------------------------------------
 
 #include "animator.h"
+#include "batchedanimations.h"
+#include "frameclock.h"
 #include "ianimationtarget.h"
 #include "itimingfunction.h"
 #include "../cvstguitimer.h"
 #include "../cview.h"
 #include "../dispatchlist.h"
-#include "../platform/platformfactory.h"
+#include "../vstguitrace.h"
 #include <list>
 
 #define DEBUG_LOG	0 // DEBUG
@@ -154,9 +162,14 @@ protected:
 #if DEBUG_LOG
 		DebugPrint ("Animation timer started\n");
 #endif
+		// the frames of the clock must have the period of the timer, otherwise ticks are skipped,
+		// and the time the timer was stopped is not dropped frames
+		auto& clock = FrameClock::getShared ();
+		clock.setFrameInterval (FrameClock::kTimerInterval);
+		clock.reset ();
 		timer = new CVSTGUITimer ([this] (CVSTGUITimer*) {
 			onTimer ();
-		}, 1000/60); // 60 Hz
+		}, FrameClock::kTimerInterval); // 60 Hz
 	}
 	
 	~Timer () noexcept override
@@ -170,13 +183,19 @@ protected:
 	
 	void onTimer ()
 	{
+		auto& clock = FrameClock::getShared ();
+		if (!clock.tick ())
+			return;
 		inTimer = true;
 		auto guard = shared (this);
 #if DEBUG_LOG
 		DebugPrint ("Current Animators : %d\n", animators.size ());
+		if (clock.getNumDroppedFrames ())
+			DebugPrint ("Dropped animation frames : %d\n", clock.getNumDroppedFrames ());
 #endif
+		auto frameTicks = clock.getFrameTicks ();
 		for (auto& animator : animators)
-			animator->onTimer ();
+			animator->onFrame (frameTicks);
 		inTimer = false;
 		for (auto& animator : toRemove)
 			removeAnimator (animator);
@@ -197,11 +216,12 @@ Timer* Timer::gInstance = nullptr;
 class Animation : public NonAtomicReferenceCounted
 {
 public:
-	Animation (CView* view, const std::string& name, IAnimationTarget* at, ITimingFunction* t,
-			   DoneFunction&& notification, bool notifyOnCancel);
+	Animation (CView* view, const std::string& name, NameID nameID, IAnimationTarget* at,
+			   ITimingFunction* t, DoneFunction&& notification, bool notifyOnCancel);
 	~Animation () noexcept override;
 	
 	std::string name;
+	NameID nameID;
 	SharedPointer<CView> view;
 	IAnimationTarget* animationTarget;
 	ITimingFunction* timingFunction;
@@ -213,9 +233,10 @@ public:
 };
 
 //-----------------------------------------------------------------------------
-Animation::Animation (CView* view, const std::string& name, IAnimationTarget* at,
+Animation::Animation (CView* view, const std::string& name, NameID nameID, IAnimationTarget* at,
 					  ITimingFunction* t, DoneFunction&& notification, bool notifyOnCancel)
 : name (name)
+, nameID (nameID)
 , view (view)
 , animationTarget (at)
 , timingFunction (t)
@@ -244,7 +265,12 @@ Animation::~Animation () noexcept
 //-----------------------------------------------------------------------------
 struct Animator::Impl
 {
+	bool empty () const { return animations.empty () && batched.empty (); }
+	void removeAnimation (CView* view, Detail::NameID nameID);
+
+	/** animations with custom targets or timing functions */
 	DispatchList<SharedPointer<Detail::Animation>> animations;
+	Detail::BatchedAnimations batched;
 };
 ///@endcond
 
@@ -265,11 +291,17 @@ void Animator::addAnimation (CView* view, IdStringPtr name, IAnimationTarget* ta
 							 ITimingFunction* timingFunction, DoneFunction notification,
 							 bool notifyOnCancel)
 {
-	if (pImpl->animations.empty ())
+	if (pImpl->empty ())
 		Detail::Timer::addAnimator (this);
-	removeAnimation (view, name);
-	pImpl->animations.add (makeOwned<Detail::Animation> (view, name, target, timingFunction,
-														 std::move (notification), notifyOnCancel));
+	IdStringPtr internedName = nullptr;
+	auto nameID = Detail::internAnimationName (name, &internedName);
+	pImpl->removeAnimation (view, nameID);
+	if (!pImpl->batched.add (view, nameID, internedName, target, timingFunction, notification,
+							 notifyOnCancel))
+	{
+		pImpl->animations.add (makeOwned<Detail::Animation> (
+			view, name, nameID, target, timingFunction, std::move (notification), notifyOnCancel));
+	}
 #if DEBUG_LOG
 	DebugPrint ("new animation added: %p - %s\n", view, name);
 #endif
@@ -295,9 +327,20 @@ void Animator::addAnimation (CView* view, IdStringPtr name, IAnimationTarget* ta
 //-----------------------------------------------------------------------------
 void Animator::removeAnimation (CView* view, IdStringPtr name)
 {
-	pImpl->animations.forEach ([&] (const SharedPointer<Detail::Animation>& animation) {
-		if (animation->view == view && animation->name == name)
+	auto nameID = Detail::findAnimationName (name);
+	if (nameID != Detail::kInvalidNameID)
+		pImpl->removeAnimation (view, nameID);
+}
+
+//-----------------------------------------------------------------------------
+void Animator::Impl::removeAnimation (CView* view, Detail::NameID nameID)
+{
+	if (batched.remove (view, nameID))
+		return;
+	animations.forEach ([&] (const SharedPointer<Detail::Animation>& animation) {
+		if (animation->view == view && animation->nameID == nameID)
 		{
+			auto name = animation->name.data ();
 #if DEBUG_LOG
 			DebugPrint ("animation removed: %p - %s\n", view, name);
 #endif
@@ -308,7 +351,7 @@ void Animator::removeAnimation (CView* view, IdStringPtr name)
 			}
 			if (!animation->notifyOnCancel)
 				animation->notification = nullptr;
-			pImpl->animations.remove (animation);
+			animations.remove (animation);
 		}
 	});
 }
@@ -316,6 +359,7 @@ void Animator::removeAnimation (CView* view, IdStringPtr name)
 //-----------------------------------------------------------------------------
 void Animator::removeAnimations (CView* view)
 {
+	pImpl->batched.removeAll (view);
 	pImpl->animations.forEach ([&] (const SharedPointer<Detail::Animation>& animation) {
 		if (animation->view == view)
 		{
@@ -335,8 +379,21 @@ void Animator::removeAnimations (CView* view)
 //-----------------------------------------------------------------------------
 void Animator::onTimer ()
 {
+	// the animations must use the time base of the animation timer, only start the clock when the
+	// timer does not run, as a tick outside of the timer would take the frame of the next tick
+	auto& clock = FrameClock::getShared ();
+	if (!clock.isRunning ())
+		clock.tick ();
+	onFrame (clock.getFrameTicks ());
+}
+
+//-----------------------------------------------------------------------------
+void Animator::onFrame (uint64_t currentTicks)
+{
+	VSTGUI_TRACE_OBJECT_SCOPE ("Animator::onFrame", this);
 	auto selfGuard = shared (this);
-	auto currentTicks = getPlatformFactory ().getTicks ();
+	// the batched animations always run first (see the documentation of the animator)
+	pImpl->batched.tick (currentTicks);
 	pImpl->animations.forEach ([&] (SharedPointer<Detail::Animation>& animation) {
 		if (animation->startTime == 0)
 		{
@@ -363,7 +420,7 @@ void Animator::onTimer ()
 			pImpl->animations.remove (animation);
 		}
 	});
-	if (pImpl->animations.empty ())
+	if (pImpl->empty ())
 		Detail::Timer::removeAnimator (this);
 }
 
@@ -55,6 +55,8 @@ public:
 
 	Animator ();	// do not use this, instead use CFrame::getAnimator()
 	void onTimer ();
+	/** run the animations at the frame time in milliseconds */
+	void onFrame (uint64_t frameTime);
 
 protected:
 	~Animator () noexcept override;
@@ -0,0 +1,479 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "batchedanimations.h"
+#include "animations.h"
+#include "timingfunctions.h"
+#include "../controls/ccontrol.h"
+#include "../cview.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+
+namespace VSTGUI {
+namespace Animation {
+namespace Detail {
+
+//-----------------------------------------------------------------------------
+namespace {
+
+using NameMap = std::unordered_map<std::string, NameID>;
+
+//-----------------------------------------------------------------------------
+NameMap& getNameMap ()
+{
+	static NameMap gNameMap;
+	return gNameMap;
+}
+
+//-----------------------------------------------------------------------------
+} // anonymous
+
+//-----------------------------------------------------------------------------
+NameID internAnimationName (IdStringPtr name, IdStringPtr* internedName)
+{
+	auto& map = getNameMap ();
+	auto it = map.emplace (name ? name : "", static_cast<NameID> (map.size () + 1)).first;
+	if (internedName)
+		*internedName = it->first.data ();
+	return it->second;
+}
+
+//-----------------------------------------------------------------------------
+NameID findAnimationName (IdStringPtr name)
+{
+	auto& map = getNameMap ();
+	auto it = map.find (name ? name : "");
+	return it == map.end () ? kInvalidNameID : it->second;
+}
+
+//-----------------------------------------------------------------------------
+BatchedAnimations::~BatchedAnimations () noexcept
+{
+	// same as destroying Detail::Animation objects, the notifications are called without finishing
+	for (auto& info : infos)
+		release (info);
+}
+
+//-----------------------------------------------------------------------------
+bool BatchedAnimations::canBatch (IAnimationTarget* target, ITimingFunction* timingFunction)
+{
+	if (!target || !timingFunction)
+		return false;
+	const auto& targetType = typeid (*target);
+	if (targetType != typeid (AlphaValueAnimation) && targetType != typeid (ViewSizeAnimation) &&
+		targetType != typeid (ControlValueAnimation))
+		return false;
+	// the offscreen layer needs the virtual methods of the target
+	if (targetType == typeid (ViewSizeAnimation) &&
+		static_cast<ViewSizeAnimation*> (target)->getUseOffscreenLayer ())
+		return false;
+	const auto& timingType = typeid (*timingFunction);
+	if (timingType == typeid (PowerTimingFunction))
+		return static_cast<PowerTimingFunction*> (timingFunction)->getFactor () != 0.f;
+	return timingType == typeid (LinearTimingFunction) ||
+		   timingType == typeid (CubicBezierTimingFunction);
+}
+
+//-----------------------------------------------------------------------------
+bool BatchedAnimations::add (CView* view, NameID nameID, IdStringPtr name,
+							 IAnimationTarget* target, ITimingFunction* timingFunction,
+							 DoneFunction& notification, bool notifyOnCancel)
+{
+	if (!view || !canBatch (target, timingFunction))
+		return false;
+
+	Info info;
+	info.view = view;
+	info.name = name;
+	info.target = target;
+	info.timingFunction = timingFunction;
+	info.notification = std::move (notification);
+	info.notifyOnCancel = notifyOnCancel;
+	float endValue = 0.f;
+	const auto& targetType = typeid (*target);
+	if (targetType == typeid (AlphaValueAnimation))
+	{
+		auto alpha = static_cast<AlphaValueAnimation*> (target);
+		info.kind = Kind::AlphaValue;
+		info.forceEndValueOnFinish = alpha->getForceEndValueOnFinish ();
+		endValue = alpha->getEndValue ();
+	}
+	else if (targetType == typeid (ControlValueAnimation))
+	{
+		auto controlValue = static_cast<ControlValueAnimation*> (target);
+		info.kind = Kind::ControlValue;
+		info.control = dynamic_cast<CControl*> (view);
+		info.forceEndValueOnFinish = controlValue->getForceEndValueOnFinish ();
+		endValue = controlValue->getEndValue ();
+	}
+	else
+	{
+		auto viewSize = static_cast<ViewSizeAnimation*> (target);
+		info.kind = Kind::ViewSize;
+		info.forceEndValueOnFinish = viewSize->getForceEndValueOnFinish ();
+		info.endRect = viewSize->getNewRect ();
+	}
+
+	// the timing functions as cubic polynomial ((a * t + b) * t + c) * t
+	auto timing = static_cast<TimingFunctionBase*> (timingFunction);
+	double a = 0., b = 0., c = 1.;
+	float exponent = 0.f;
+	float minPos = 0.f;
+	float maxPos = 1.f;
+	const auto& timingType = typeid (*timingFunction);
+	if (timingType == typeid (CubicBezierTimingFunction))
+	{
+		auto bezier = static_cast<CubicBezierTimingFunction*> (timingFunction);
+		auto y1 = bezier->getP1 ().y;
+		auto y2 = bezier->getP2 ().y;
+		a = 1. + 3. * y1 - 3. * y2;
+		b = 3. * y2 - 6. * y1;
+		c = 3. * y1;
+		// CubicBezierTimingFunction does not clamp the position
+		minPos = -std::numeric_limits<float>::max ();
+		maxPos = std::numeric_limits<float>::max ();
+	}
+	else if (timingType == typeid (PowerTimingFunction))
+	{
+		exponent = static_cast<PowerTimingFunction*> (timingFunction)->getFactor ();
+		++numPower;
+	}
+
+	views.emplace_back (view);
+	nameIDs.emplace_back (nameID);
+	kinds.emplace_back (info.kind);
+	states.emplace_back (State::Pending);
+	startTicks.emplace_back (0);
+	durations.emplace_back (timing->getLength ());
+	lengths.emplace_back (static_cast<float> (std::max<uint32_t> (timing->getLength (), 1)));
+	coefA.emplace_back (a);
+	coefB.emplace_back (b);
+	coefC.emplace_back (c);
+	exponents.emplace_back (exponent);
+	clampMin.emplace_back (minPos);
+	clampMax.emplace_back (maxPos);
+	lastPositions.emplace_back (-1.f);
+	startValues.emplace_back (0.f);
+	endValues.emplace_back (endValue);
+	infos.emplace_back (std::move (info));
+	// a finished animation with the same key may still be stored until the end of the tick
+	indices[{view, nameID}] = views.size () - 1;
+	++numPending;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool BatchedAnimations::remove (CView* view, NameID nameID)
+{
+	auto it = indices.find ({view, nameID});
+	if (it == indices.end ())
+		return false;
+	auto index = it->second;
+	vstgui_assert (views[index] == view && nameIDs[index] == nameID);
+	cancel (index, false);
+	if (!inTick)
+		removeAt (index);
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void BatchedAnimations::removeAll (CView* view)
+{
+	for (auto index = views.size (); index > 0; --index)
+	{
+		if (views[index - 1] == view && states[index - 1] != State::Finished)
+		{
+			cancel (index - 1, true);
+			if (!inTick)
+				removeAt (index - 1);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+void BatchedAnimations::tick (uint64_t currentTicks)
+{
+	if (views.empty ())
+		return;
+	inTick = true;
+	// animations added while ticking start with the next tick
+	auto count = views.size ();
+	if (numPending)
+	{
+		for (auto index = 0u; index < count; ++index)
+		{
+			if (states[index] == State::Pending)
+				start (index, currentTicks);
+		}
+	}
+
+	times.resize (count);
+	positions.resize (count);
+	for (auto index = 0u; index < count; ++index)
+	{
+		auto time = static_cast<float> (static_cast<uint32_t> (currentTicks - startTicks[index]));
+		double t = time / lengths[index];
+		auto pos = static_cast<float> (((coefA[index] * t + coefB[index]) * t + coefC[index]) * t);
+		times[index] = time;
+		positions[index] = std::min (std::max (pos, clampMin[index]), clampMax[index]);
+	}
+	if (numPower)
+	{
+		for (auto index = 0u; index < count; ++index)
+		{
+			if (exponents[index] != 0.f)
+				positions[index] = std::min (
+					std::max (std::pow (times[index] / lengths[index], exponents[index]), 0.f),
+					1.f);
+		}
+	}
+
+	for (auto index = 0u; index < count; ++index)
+	{
+		// canceled by a target of an earlier animation
+		if (states[index] != State::Running)
+			continue;
+		auto pos = positions[index];
+		if (pos != lastPositions[index])
+		{
+			lastPositions[index] = pos;
+			apply (index, pos);
+		}
+		if (states[index] == State::Running &&
+			static_cast<uint32_t> (times[index]) >= durations[index])
+			finish (index, false);
+	}
+	inTick = false;
+	removeFinished ();
+}
+
+//-----------------------------------------------------------------------------
+void BatchedAnimations::start (size_t index, uint64_t currentTicks)
+{
+	const auto& info = infos[index];
+	switch (kinds[index])
+	{
+		case Kind::AlphaValue:
+			startValues[index] = info.view->getAlphaValue ();
+			break;
+		case Kind::ControlValue:
+			if (info.control)
+				startValues[index] = info.control->getValue ();
+			break;
+		case Kind::ViewSize:
+			infos[index].startRect = info.view->getViewSize ();
+			break;
+	}
+	startTicks[index] = currentTicks;
+	states[index] = State::Running;
+	--numPending;
+}
+
+//-----------------------------------------------------------------------------
+void BatchedAnimations::apply (size_t index, float pos)
+{
+	auto view = views[index];
+	switch (kinds[index])
+	{
+		case Kind::AlphaValue:
+		{
+			view->setAlphaValue (startValues[index] + (endValues[index] - startValues[index]) * pos);
+			break;
+		}
+		case Kind::ControlValue:
+		{
+			if (auto control = infos[index].control)
+			{
+				control->setValue (startValues[index] +
+								   (endValues[index] - startValues[index]) * pos);
+				if (control->isDirty ())
+					control->invalid ();
+			}
+			break;
+		}
+		case Kind::ViewSize:
+		{
+			const auto& startRect = infos[index].startRect;
+			const auto& newRect = infos[index].endRect;
+			CRect r;
+			r.left = (int32_t)(startRect.left + ((newRect.left - startRect.left) * pos));
+			r.right = (int32_t)(startRect.right + ((newRect.right - startRect.right) * pos));
+			r.top = (int32_t)(startRect.top + ((newRect.top - startRect.top) * pos));
+			r.bottom = (int32_t)(startRect.bottom + ((newRect.bottom - startRect.bottom) * pos));
+			if (view->getViewSize () != r)
+			{
+				view->invalid ();
+				view->setViewSize (r);
+				view->setMouseableArea (r);
+				view->invalid ();
+			}
+			break;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+void BatchedAnimations::finish (size_t index, bool wasCanceled)
+{
+	if (states[index] == State::Pending)
+		--numPending;
+	states[index] = State::Finished;
+	++numFinished;
+	auto it = indices.find ({views[index], nameIDs[index]});
+	if (it != indices.end () && it->second == index)
+		indices.erase (it);
+	if (wasCanceled && !infos[index].forceEndValueOnFinish)
+		return;
+	auto view = views[index];
+	switch (kinds[index])
+	{
+		case Kind::AlphaValue:
+		{
+			view->setAlphaValue (endValues[index]);
+			break;
+		}
+		case Kind::ControlValue:
+		{
+			if (auto control = infos[index].control)
+				control->setValue (endValues[index]);
+			break;
+		}
+		case Kind::ViewSize:
+		{
+			auto newRect = infos[index].endRect;
+			if (view->getViewSize () != newRect)
+			{
+				view->invalid ();
+				view->setViewSize (newRect);
+				view->setMouseableArea (newRect);
+				view->invalid ();
+			}
+			break;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+void BatchedAnimations::cancel (size_t index, bool keepNotification)
+{
+	finish (index, true);
+	if (!keepNotification && !infos[index].notifyOnCancel)
+		infos[index].notification = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+void BatchedAnimations::moveEntry (size_t from, size_t to)
+{
+	views[to] = views[from];
+	nameIDs[to] = nameIDs[from];
+	kinds[to] = kinds[from];
+	states[to] = states[from];
+	startTicks[to] = startTicks[from];
+	durations[to] = durations[from];
+	lengths[to] = lengths[from];
+	coefA[to] = coefA[from];
+	coefB[to] = coefB[from];
+	coefC[to] = coefC[from];
+	exponents[to] = exponents[from];
+	clampMin[to] = clampMin[from];
+	clampMax[to] = clampMax[from];
+	lastPositions[to] = lastPositions[from];
+	startValues[to] = startValues[from];
+	endValues[to] = endValues[from];
+	infos[to] = std::move (infos[from]);
+	if (states[to] != State::Finished)
+		indices[{views[to], nameIDs[to]}] = to;
+}
+
+//-----------------------------------------------------------------------------
+void BatchedAnimations::resizeEntries (size_t count)
+{
+	views.resize (count);
+	nameIDs.resize (count);
+	kinds.resize (count);
+	states.resize (count);
+	startTicks.resize (count);
+	durations.resize (count);
+	lengths.resize (count);
+	coefA.resize (count);
+	coefB.resize (count);
+	coefC.resize (count);
+	exponents.resize (count);
+	clampMin.resize (count);
+	clampMax.resize (count);
+	lastPositions.resize (count);
+	startValues.resize (count);
+	endValues.resize (count);
+	infos.resize (count);
+}
+
+//-----------------------------------------------------------------------------
+void BatchedAnimations::removeAt (size_t index)
+{
+	vstgui_assert (states[index] == State::Finished);
+	auto info = std::move (infos[index]);
+	if (exponents[index] != 0.f)
+		--numPower;
+	--numFinished;
+	auto last = views.size () - 1;
+	if (index != last)
+		moveEntry (last, index);
+	resizeEntries (last);
+	release (info);
+}
+
+//-----------------------------------------------------------------------------
+void BatchedAnimations::removeFinished ()
+{
+	if (numFinished == 0)
+		return;
+	size_t count = 0;
+	for (auto index = 0u; index < views.size (); ++index)
+	{
+		if (states[index] == State::Finished)
+		{
+			if (exponents[index] != 0.f)
+				--numPower;
+			released.emplace_back (std::move (infos[index]));
+			continue;
+		}
+		if (count != index)
+			moveEntry (index, count);
+		++count;
+	}
+	resizeEntries (count);
+	numFinished = 0;
+
+	// the notifications may add new animations
+	auto toRelease = std::move (released);
+	released.clear ();
+	for (auto& info : toRelease)
+		release (info);
+}
+
+//-----------------------------------------------------------------------------
+void BatchedAnimations::release (Info& info)
+{
+	if (info.notification)
+		info.notification (info.view, info.name, info.target);
+	info.notification = nullptr;
+	if (auto obj = dynamic_cast<IReference*> (info.target))
+		obj->forget ();
+	else
+		delete info.target;
+	if (auto obj = dynamic_cast<IReference*> (info.timingFunction))
+		obj->forget ();
+	else
+		delete info.timingFunction;
+	info.target = nullptr;
+	info.timingFunction = nullptr;
+}
+
+} // Detail
+} // Animation
+} // VSTGUI
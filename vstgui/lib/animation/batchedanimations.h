@@ -0,0 +1,166 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#pragma once
+
+#include "../vstguifwd.h"
+#include "../crect.h"
+#include <unordered_map>
+#include <vector>
+
+namespace VSTGUI {
+namespace Animation {
+
+/// @cond ignore
+namespace Detail {
+
+//-----------------------------------------------------------------------------
+using NameID = uint32_t;
+static constexpr NameID kInvalidNameID = 0;
+
+/** returns the id of the name and adds it if it is not known yet
+ *
+ *	@param internedName returns the interned copy of the name, which is valid until the end of the
+ *	process
+ */
+NameID internAnimationName (IdStringPtr name, IdStringPtr* internedName = nullptr);
+/** returns kInvalidNameID if the name was never interned */
+NameID findAnimationName (IdStringPtr name);
+
+//-----------------------------------------------------------------------------
+/** Runs the animations of the built-in targets and timing functions without virtual calls
+ *
+ *	Animations of an AlphaValueAnimation, ViewSizeAnimation or ControlValueAnimation target with a
+ *	LinearTimingFunction, PowerTimingFunction or CubicBezierTimingFunction are stored in contiguous
+ *	arrays. The positions of all animations are computed in one loop per tick, which the compiler
+ *	can vectorize, and the targets are applied directly. Subclasses of these types are not batched,
+ *	as they may override the virtual methods.
+ *
+ *	Animations are identified by the view and the interned name, so no string is compared, and
+ *	an index of the running animations finds them without a search. Animations added while ticking
+ *	start with the next tick. Finished and canceled animations are
+ *	removed after the tick and their notifications are called after that.
+ */
+class BatchedAnimations
+{
+public:
+	BatchedAnimations () = default;
+	~BatchedAnimations () noexcept;
+
+	BatchedAnimations (const BatchedAnimations&) = delete;
+	BatchedAnimations& operator= (const BatchedAnimations&) = delete;
+
+	static bool canBatch (IAnimationTarget* target, ITimingFunction* timingFunction);
+
+	/** the ownership of target and timingFunction is transferred on success
+	 *
+	 *	@return false if the target or the timing function cannot be batched
+	 */
+	bool add (CView* view, NameID nameID, IdStringPtr name, IAnimationTarget* target,
+			  ITimingFunction* timingFunction, DoneFunction& notification, bool notifyOnCancel);
+	/** cancel the animation, returns false if there is no such animation */
+	bool remove (CView* view, NameID nameID);
+	/** cancel all animations of the view */
+	void removeAll (CView* view);
+	void tick (uint64_t currentTicks);
+
+	bool empty () const { return views.empty (); }
+	size_t size () const { return views.size (); }
+
+private:
+	enum class Kind : uint8_t
+	{
+		AlphaValue,
+		ViewSize,
+		ControlValue
+	};
+	enum class State : uint8_t
+	{
+		Pending,
+		Running,
+		Finished
+	};
+
+	/** data only used when an animation starts or ends */
+	struct Key
+	{
+		CView* view;
+		NameID nameID;
+
+		bool operator== (const Key& other) const
+		{
+			return view == other.view && nameID == other.nameID;
+		}
+	};
+	struct KeyHash
+	{
+		size_t operator() (const Key& key) const
+		{
+			return std::hash<CView*> () (key.view) ^ (static_cast<size_t> (key.nameID) << 1);
+		}
+	};
+
+	struct Info
+	{
+		SharedPointer<CView> view;
+		CControl* control {nullptr};
+		IdStringPtr name {nullptr};
+		IAnimationTarget* target {nullptr};
+		ITimingFunction* timingFunction {nullptr};
+		DoneFunction notification;
+		CRect startRect;
+		CRect endRect;
+		Kind kind {Kind::AlphaValue};
+		bool forceEndValueOnFinish {false};
+		bool notifyOnCancel {false};
+	};
+
+	void start (size_t index, uint64_t currentTicks);
+	void apply (size_t index, float pos);
+	void finish (size_t index, bool wasCanceled);
+	void cancel (size_t index, bool keepNotification);
+	void removeAt (size_t index);
+	void removeFinished ();
+	void moveEntry (size_t from, size_t to);
+	void resizeEntries (size_t count);
+	static void release (Info& info);
+
+	// the key of each animation
+	std::vector<CView*> views;
+	std::vector<NameID> nameIDs;
+	// the hot data of the position computation
+	std::vector<Kind> kinds;
+	std::vector<State> states;
+	std::vector<uint64_t> startTicks;
+	std::vector<uint32_t> durations;
+	std::vector<float> lengths;
+	std::vector<double> coefA;
+	std::vector<double> coefB;
+	std::vector<double> coefC;
+	/** the factor of a PowerTimingFunction, zero for the other timing functions */
+	std::vector<float> exponents;
+	std::vector<float> clampMin;
+	std::vector<float> clampMax;
+	std::vector<float> lastPositions;
+	std::vector<float> startValues;
+	std::vector<float> endValues;
+	std::vector<Info> infos;
+	/** the position of the animations which are not finished */
+	std::unordered_map<Key, size_t, KeyHash> indices;
+	// scratch arrays of a tick
+	std::vector<float> times;
+	std::vector<float> positions;
+	std::vector<Info> released;
+
+	size_t numPending {0};
+	size_t numPower {0};
+	size_t numFinished {0};
+	bool inTick {false};
+};
+
+} // Detail
+/// @endcond
+
+} // Animation
+} // VSTGUI
@@ -0,0 +1,113 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "frameclock.h"
+#include "../platform/platformfactory.h"
+#include <algorithm>
+#include <cmath>
+
+namespace VSTGUI {
+namespace Animation {
+
+//-----------------------------------------------------------------------------
+FrameClock::FrameClock (TimeSource&& timeSource, double frameInterval)
+: timeSource (std::move (timeSource)), frameInterval (frameInterval)
+{
+	vstgui_assert (frameInterval > 0.);
+}
+
+//-----------------------------------------------------------------------------
+FrameClock& FrameClock::getShared ()
+{
+	static FrameClock gInstance;
+	return gInstance;
+}
+
+//-----------------------------------------------------------------------------
+double FrameClock::now () const
+{
+	if (timeSource)
+		return timeSource ();
+	return static_cast<double> (getPlatformFactory ().getTicks ());
+}
+
+//-----------------------------------------------------------------------------
+bool FrameClock::tick ()
+{
+	auto time = now ();
+	++statistics.numTicks;
+	if (!running)
+	{
+		running = true;
+		gridStart = lastTickTime = time;
+		frameIndex = 0;
+		frameTime = gridStart + frameInterval;
+		numDroppedFrames = 0;
+		++statistics.numFrames;
+		return true;
+	}
+	// the frame is the one with the nearest start, so that timer jitter of less than half a frame
+	// does not move the tick into another frame
+	auto position = std::round ((time - gridStart) / frameInterval);
+	auto index = static_cast<uint64_t> (std::max (position, 0.));
+	if (index <= frameIndex)
+	{
+		++statistics.numSkippedTicks;
+		return false;
+	}
+	auto jitter = std::abs ((time - lastTickTime) - (index - frameIndex) * frameInterval);
+	numDroppedFrames = static_cast<uint32_t> (index - frameIndex - 1);
+	frameIndex = index;
+	frameTime = gridStart + (index + 1) * frameInterval;
+	lastTickTime = time;
+
+	++statistics.numFrames;
+	statistics.numDroppedFrames += numDroppedFrames;
+	jitterSum += jitter;
+	++numJitterSamples;
+	statistics.maxJitter = std::max (statistics.maxJitter, jitter);
+	statistics.meanJitter = jitterSum / static_cast<double> (numJitterSamples);
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void FrameClock::reset ()
+{
+	running = false;
+}
+
+//-----------------------------------------------------------------------------
+uint64_t FrameClock::getFrameTicks () const
+{
+	return static_cast<uint64_t> (std::llround (frameTime));
+}
+
+//-----------------------------------------------------------------------------
+void FrameClock::setFrameInterval (double milliseconds)
+{
+	vstgui_assert (milliseconds > 0.);
+	if (milliseconds <= 0. || milliseconds == frameInterval)
+		return;
+	// continue with the new interval at the current frame
+	gridStart = frameTime - frameInterval - frameIndex * milliseconds;
+	frameInterval = milliseconds;
+}
+
+//-----------------------------------------------------------------------------
+void FrameClock::setTimeSource (TimeSource&& source)
+{
+	timeSource = std::move (source);
+	reset ();
+}
+
+//-----------------------------------------------------------------------------
+void FrameClock::resetStatistics ()
+{
+	statistics = {};
+	jitterSum = 0.;
+	numJitterSamples = 0;
+}
+
+} // Animation
+} // VSTGUI
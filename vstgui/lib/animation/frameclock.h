@@ -0,0 +1,110 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#pragma once
+
+#include "../vstguibase.h"
+#include <functional>
+
+namespace VSTGUI {
+namespace Animation {
+
+//-----------------------------------------------------------------------------
+/** The time source of the animations
+ *
+ *	The timer which drives the animations does not fire exactly once per displayed frame: it
+ *	fires late when the main thread is busy and its interval does not match the refresh rate of the
+ *	display. Animating with the time the timer fired produces uneven steps.
+ *
+ *	The frame clock snaps every tick to a grid of frames with a fixed interval and provides the
+ *	predicted presentation time of the current frame, which is the end of the frame the tick
+ *	belongs to. So the time of consecutive frames always advances by a multiple of the frame
+ *	interval. A tick in a frame which already started is skipped, and when the tick is late the
+ *	clock advances directly to the current frame and counts the frames in between as dropped.
+ *
+ *	The frame interval must be the period of the timer which calls tick (). If the timer is faster
+ *	than the frames, ticks regularly fall into the frame of the tick before and are skipped.
+ *
+ *	The animators of all frames are driven by the shared clock (see getShared ()). The animation
+ *	timer fires every kTimerInterval milliseconds and sets the interval of the shared clock to it.
+ */
+class FrameClock
+{
+public:
+	/** returns the current time in milliseconds */
+	using TimeSource = std::function<double ()>;
+
+	static constexpr double kDefaultFrameInterval = 1000. / 60.;
+	/** the period of the animation timer, the timers have a resolution of milliseconds */
+	static constexpr uint32_t kTimerInterval = 1000 / 60;
+
+	struct Statistics
+	{
+		uint64_t numTicks {0};
+		uint64_t numFrames {0};
+		/** frames without a tick */
+		uint64_t numDroppedFrames {0};
+		/** ticks in a frame which already had a tick */
+		uint64_t numSkippedTicks {0};
+		/** the difference between the time from one frame to the next and the frames between
+		 *	them in milliseconds */
+		double maxJitter {0.};
+		double meanJitter {0.};
+	};
+
+	/** @param timeSource the platform ticks are used if empty */
+	explicit FrameClock (TimeSource&& timeSource = {},
+						 double frameInterval = kDefaultFrameInterval);
+
+	static FrameClock& getShared ();
+
+	/** advance the clock to the current time
+	 *
+	 *	@return true if a new frame started, false if the current time is in the same frame as the
+	 *	last tick
+	 */
+	bool tick ();
+	/** restart the grid of frames at the next tick, without counting the time in between as
+	 *	dropped frames */
+	void reset ();
+	/** true after the first tick since the clock was created or reset */
+	bool isRunning () const { return running; }
+
+	/** the predicted presentation time of the current frame in milliseconds */
+	double getFrameTime () const { return frameTime; }
+	/** the frame time rounded to the milliseconds of the timing functions */
+	uint64_t getFrameTicks () const;
+	/** the number of frames since the start of the grid */
+	uint64_t getFrameIndex () const { return frameIndex; }
+	/** the frames dropped by the last tick */
+	uint32_t getNumDroppedFrames () const { return numDroppedFrames; }
+
+	void setFrameInterval (double milliseconds);
+	double getFrameInterval () const { return frameInterval; }
+
+	void setTimeSource (TimeSource&& timeSource);
+
+	const Statistics& getStatistics () const { return statistics; }
+	void resetStatistics ();
+
+private:
+	double now () const;
+
+	TimeSource timeSource;
+	Statistics statistics;
+	double frameInterval;
+	double gridStart {0.};
+	double frameTime {0.};
+	double lastTickTime {0.};
+	double jitterSum {0.};
+	/** the frames with a frame before them, if the statistics were reset while the clock was
+	 *	running this is not numFrames - 1 */
+	uint64_t numJitterSamples {0};
+	uint64_t frameIndex {0};
+	uint32_t numDroppedFrames {0};
+	bool running {false};
+};
+
+} // Animation
+} // VSTGUI
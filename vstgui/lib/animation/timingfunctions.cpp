@@ -4,7 +4,11 @@
 
 #include "timingfunctions.h"
 #include "../vstguibase.h"
+#include <algorithm>
 #include <cmath>
+#include <cstdio>
+#include <mutex>
+#include <unordered_map>
 
 namespace VSTGUI {
 namespace Animation {
@@ -150,6 +154,234 @@ CubicBezierTimingFunction CubicBezierTimingFunction::easyInOut (uint32_t time)
 	return CubicBezierTimingFunction (time, CPoint (0.42, 0.), CPoint (0.58, 1.));
 }
 
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+namespace {
+
+//-----------------------------------------------------------------------------
+class LookupTableCache
+{
+public:
+	using Ptr = TimingFunctionLookupTable::Ptr;
+
+	static LookupTableCache& instance ()
+	{
+		static LookupTableCache gInstance;
+		return gInstance;
+	}
+
+	template<typename Proc>
+	Ptr get (const std::string& key, Proc createSamples)
+	{
+		std::lock_guard<std::mutex> guard (mutex);
+		auto& entry = tables[key];
+		if (auto table = entry.lock ())
+			return table;
+		auto table = std::make_shared<const TimingFunctionLookupTable> (createSamples ());
+		entry = table;
+		// drop the entries of tables which are not in use anymore
+		if (tables.size () > 2 * numEntriesAfterPurge + 16)
+		{
+			for (auto it = tables.begin (); it != tables.end ();)
+			{
+				if (it->second.expired ())
+					it = tables.erase (it);
+				else
+					++it;
+			}
+			numEntriesAfterPurge = tables.size ();
+		}
+		return table;
+	}
+
+private:
+	std::mutex mutex;
+	std::unordered_map<std::string, std::weak_ptr<const TimingFunctionLookupTable>> tables;
+	size_t numEntriesAfterPurge {0};
+};
+
+//-----------------------------------------------------------------------------
+/** a one dimensional cubic bezier from 0 to 1 with the control points c1 and c2 */
+struct CubicBezier
+{
+	CubicBezier (double c1, double c2)
+	{
+		c = 3. * c1;
+		b = 3. * (c2 - c1) - c;
+		a = 1. - c - b;
+	}
+	double operator() (double t) const { return ((a * t + b) * t + c) * t; }
+	double derivative (double t) const { return (3. * a * t + 2. * b) * t + c; }
+
+	double a, b, c;
+};
+
+//-----------------------------------------------------------------------------
+/** returns the curve parameter t where bezier (t) is x */
+double solveCubicBezier (const CubicBezier& bezier, double x)
+{
+	static constexpr double kEpsilon = 1e-7;
+	// Newton-Raphson converges fast for most curves
+	auto t = x;
+	for (auto i = 0; i < 8; ++i)
+	{
+		auto error = bezier (t) - x;
+		if (std::abs (error) < kEpsilon)
+			return t;
+		auto derivative = bezier.derivative (t);
+		if (std::abs (derivative) < 1e-6)
+			break;
+		t -= error / derivative;
+	}
+	// bisection for flat parts of the curve, x is monotonic in [0..1] for control points in [0..1]
+	double low = 0.;
+	double high = 1.;
+	t = x;
+	while (low < high)
+	{
+		auto value = bezier (t);
+		if (std::abs (value - x) < kEpsilon)
+			break;
+		if (x > value)
+			low = t;
+		else
+			high = t;
+		auto next = (high - low) * 0.5 + low;
+		if (next == t)
+			break;
+		t = next;
+	}
+	return t;
+}
+
+//-----------------------------------------------------------------------------
+std::string makeKey (const char* type, std::initializer_list<double> parameters,
+					 uint32_t resolution)
+{
+	std::string key (type);
+	char buffer[32];
+	for (auto p : parameters)
+	{
+		snprintf (buffer, sizeof (buffer), ":%a", p);
+		key += buffer;
+	}
+	snprintf (buffer, sizeof (buffer), "/%u", resolution);
+	key += buffer;
+	return key;
+}
+
+//-----------------------------------------------------------------------------
+} // anonymous
+
+//-----------------------------------------------------------------------------
+TimingFunctionLookupTable::TimingFunctionLookupTable (std::vector<float>&& samples)
+: samples (std::move (samples))
+{
+	vstgui_assert (this->samples.size () > 1);
+	if (this->samples.size () < 2)
+		this->samples.resize (2, this->samples.empty () ? 0.f : this->samples.front ());
+	resolution = static_cast<uint32_t> (this->samples.size () - 1);
+}
+
+//-----------------------------------------------------------------------------
+auto TimingFunctionLookupTable::cubicBezier (CPoint p1, CPoint p2, uint32_t resolution) -> Ptr
+{
+	resolution = std::max<uint32_t> (resolution, 1);
+	// the x values of the control points must be in [0..1] so that x is monotonic
+	auto x1 = std::min (std::max (p1.x, 0.), 1.);
+	auto x2 = std::min (std::max (p2.x, 0.), 1.);
+	auto key = makeKey ("cubicBezier", {x1, p1.y, x2, p2.y}, resolution);
+	return LookupTableCache::instance ().get (key, [&] () {
+		CubicBezier curveX (x1, x2);
+		CubicBezier curveY (p1.y, p2.y);
+		std::vector<float> samples (resolution + 1);
+		for (auto i = 0u; i <= resolution; ++i)
+		{
+			auto x = static_cast<double> (i) / resolution;
+			samples[i] = static_cast<float> (curveY (solveCubicBezier (curveX, x)));
+		}
+		samples.front () = 0.f;
+		samples.back () = 1.f;
+		return samples;
+	});
+}
+
+//-----------------------------------------------------------------------------
+auto TimingFunctionLookupTable::power (float factor, uint32_t resolution) -> Ptr
+{
+	resolution = std::max<uint32_t> (resolution, 1);
+	auto key = makeKey ("power", {factor}, resolution);
+	return LookupTableCache::instance ().get (key, [&] () {
+		std::vector<float> samples (resolution + 1);
+		for (auto i = 0u; i <= resolution; ++i)
+		{
+			auto pos = std::pow (static_cast<float> (i) / resolution, factor);
+			samples[i] = std::min (std::max (pos, 0.f), 1.f);
+		}
+		return samples;
+	});
+}
+
+//-----------------------------------------------------------------------------
+auto TimingFunctionLookupTable::bake (TimingFunctionBase& timingFunction, uint32_t resolution,
+									  const std::string& sharedKey) -> Ptr
+{
+	resolution = std::max<uint32_t> (resolution, 1);
+	auto createSamples = [&] () {
+		auto length = static_cast<double> (timingFunction.getLength ());
+		std::vector<float> samples (resolution + 1);
+		for (auto i = 0u; i <= resolution; ++i)
+		{
+			auto milliseconds = static_cast<uint32_t> (std::round (length * i / resolution));
+			samples[i] = timingFunction.getPosition (milliseconds);
+		}
+		return samples;
+	};
+	if (sharedKey.empty ())
+		return std::make_shared<const TimingFunctionLookupTable> (createSamples ());
+	auto key = makeKey ("bake", {}, resolution) + ":" + sharedKey;
+	return LookupTableCache::instance ().get (key, createSamples);
+}
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+LookupTableTimingFunction::LookupTableTimingFunction (uint32_t length,
+													  const TimingFunctionLookupTable::Ptr& table)
+: TimingFunctionBase (length)
+, table (table)
+, invLength (length ? 1.f / static_cast<float> (length) : 1.f)
+{
+	vstgui_assert (table);
+}
+
+//-----------------------------------------------------------------------------
+LookupTableTimingFunction* LookupTableTimingFunction::cubicBezier (uint32_t length, CPoint p1,
+																   CPoint p2, uint32_t resolution)
+{
+	return new LookupTableTimingFunction (
+		length, TimingFunctionLookupTable::cubicBezier (p1, p2, resolution));
+}
+
+//-----------------------------------------------------------------------------
+LookupTableTimingFunction* LookupTableTimingFunction::power (uint32_t length, float factor,
+															 uint32_t resolution)
+{
+	return new LookupTableTimingFunction (length,
+										  TimingFunctionLookupTable::power (factor, resolution));
+}
+
+//-----------------------------------------------------------------------------
+LookupTableTimingFunction* LookupTableTimingFunction::bake (TimingFunctionBase& timingFunction,
+															uint32_t resolution,
+															const std::string& sharedKey)
+{
+	return new LookupTableTimingFunction (
+		timingFunction.getLength (),
+		TimingFunctionLookupTable::bake (timingFunction, resolution, sharedKey));
+}
+
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
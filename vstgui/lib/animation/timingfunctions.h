@@ -8,6 +8,9 @@
 #include "itimingfunction.h"
 #include "../cpoint.h"
 #include <map>
+#include <memory>
+#include <string>
+#include <vector>
 
 namespace VSTGUI {
 namespace Animation {
@@ -57,6 +60,8 @@ public:
 
 	float getPosition (uint32_t milliseconds) override;
 
+	float getFactor () const { return factor; }
+
 protected:
 	float factor;
 };
@@ -96,6 +101,9 @@ public:
 
 	float getPosition (uint32_t milliseconds) override;
 
+	CPoint getP1 () const { return p1; }
+	CPoint getP2 () const { return p2; }
+
 	// some common timings
 	static CubicBezierTimingFunction easy (uint32_t time);
 	static CubicBezierTimingFunction easyIn (uint32_t time);
@@ -109,6 +117,97 @@ private:
 	CPoint p2;
 };
 
+//-----------------------------------------------------------------------------
+/** Positions of a timing function sampled over the normalized time
+ *
+ *	The tables are immutable and shared: requesting a table with the same parameters returns the
+ *	same instance as long as it is in use. Positions between two samples are interpolated linearly.
+ *
+ *	The cubic bezier table solves the curve for x, so the position matches the CSS
+ *	cubic-bezier () timing function, unlike CubicBezierTimingFunction, which uses the normalized
+ *	time as curve parameter.
+ */
+class TimingFunctionLookupTable
+{
+public:
+	using Ptr = std::shared_ptr<const TimingFunctionLookupTable>;
+
+	static constexpr uint32_t kDefaultResolution = 256;
+
+	/** the table of the CSS cubic-bezier (p1.x, p1.y, p2.x, p2.y) timing function */
+	static Ptr cubicBezier (CPoint p1, CPoint p2, uint32_t resolution = kDefaultResolution);
+	/** the table of the position t^factor */
+	static Ptr power (float factor, uint32_t resolution = kDefaultResolution);
+	/** sample the timing function over its length
+	 *
+	 *	@param sharedKey tables baked with the same non-empty key and resolution are shared,
+	 *	otherwise a new table is created on every call
+	 */
+	static Ptr bake (TimingFunctionBase& timingFunction, uint32_t resolution = kDefaultResolution,
+					 const std::string& sharedKey = {});
+
+	/** the interpolated position at the normalized time, which is clamped to [0..1] */
+	float getPosition (float normalizedTime) const
+	{
+		if (!(normalizedTime > 0.f))
+			return samples.front ();
+		if (normalizedTime >= 1.f)
+			return samples.back ();
+		auto pos = normalizedTime * static_cast<float> (resolution);
+		auto index = static_cast<uint32_t> (pos);
+		auto fraction = pos - static_cast<float> (index);
+		return samples[index] + (samples[index + 1] - samples[index]) * fraction;
+	}
+
+	uint32_t getResolution () const { return resolution; }
+
+	explicit TimingFunctionLookupTable (std::vector<float>&& samples);
+
+private:
+	std::vector<float> samples;
+	uint32_t resolution;
+};
+
+//-----------------------------------------------------------------------------
+/** A timing function which looks up the position in a shared TimingFunctionLookupTable
+ *
+ *	Use it instead of CubicBezierTimingFunction, PowerTimingFunction or
+ *	InterpolationTimingFunction when many animations run at the same time, as getting the position
+ *	is only a table lookup.
+ *
+ *	@ingroup AnimationTimingFunctions
+ */
+class LookupTableTimingFunction : public TimingFunctionBase
+{
+public:
+	LookupTableTimingFunction (uint32_t length, const TimingFunctionLookupTable::Ptr& table);
+	LookupTableTimingFunction (const LookupTableTimingFunction&) = default;
+	LookupTableTimingFunction& operator= (const LookupTableTimingFunction&) = default;
+
+	float getPosition (uint32_t milliseconds) override
+	{
+		return table->getPosition (static_cast<float> (milliseconds) * invLength);
+	}
+
+	const TimingFunctionLookupTable::Ptr& getTable () const { return table; }
+
+	static LookupTableTimingFunction* cubicBezier (
+		uint32_t length, CPoint p1, CPoint p2,
+		uint32_t resolution = TimingFunctionLookupTable::kDefaultResolution);
+	static LookupTableTimingFunction* power (
+		uint32_t length, float factor,
+		uint32_t resolution = TimingFunctionLookupTable::kDefaultResolution);
+	/** bake the timing function, see TimingFunctionLookupTable::bake () */
+	static LookupTableTimingFunction* bake (
+		TimingFunctionBase& timingFunction,
+		uint32_t resolution = TimingFunctionLookupTable::kDefaultResolution,
+		const std::string& sharedKey = {});
+
+private:
+	TimingFunctionLookupTable::Ptr table;
+	float invLength;
+};
+
 //-----------------------------------------------------------------------------
 /// @ingroup AnimationTimingFunctions
 ///	@ingroup new_in_4_0
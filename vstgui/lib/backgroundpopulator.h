@@ -0,0 +1,240 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#pragma once
+
+#include "cvstguitimer.h"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <mutex>
+#include <vector>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+
+//------------------------------------------------------------------------
+/** Populates a model from a background thread in chunks
+ *
+ *	The produce function runs on a background thread and pushes items into the Sink. The items are
+ *	handed over in chunks and merged on the UI thread via the merge function, which is called by a
+ *	timer every merge interval with at most maxItemsPerMerge items. So partial results are shown
+ *	right away and a single merge step does not block the UI for long.
+ *
+ *	The merge function typically appends the items to the model and calls
+ *	CDataBrowser::rowsAppended (), CListControl::rowsAppended () or COptionMenu::addEntry ().
+ *
+ *	@code
+ *	auto populator = makeOwned<BackgroundPopulator<UTF8String>> (
+ *	    [&] (BackgroundPopulator<UTF8String>::Items& items) {
+ *		    std::move (items.begin (), items.end (), std::back_inserter (names));
+ *		    dataBrowser->rowsAppended ();
+ *	    });
+ *	populator->start ([] (BackgroundPopulator<UTF8String>::Sink& sink) {
+ *		while (!sink.isCancelled () && moreFiles ())
+ *			sink.push (nextFileName ());
+ *	});
+ *	@endcode
+ */
+template<typename T>
+class BackgroundPopulator : public NonAtomicReferenceCounted
+{
+public:
+	using Items = std::vector<T>;
+
+	class Sink
+	{
+	public:
+		/** add an item, items are handed over to the UI thread in chunks */
+		void push (T&& item);
+		/** hand over the pushed items now */
+		void flush ();
+		/** the population was cancelled, the produce function should return */
+		bool isCancelled () const { return populator.cancelled; }
+
+	private:
+		explicit Sink (BackgroundPopulator& populator) : populator (populator) {}
+
+		BackgroundPopulator& populator;
+		Items items;
+
+		friend class BackgroundPopulator;
+	};
+
+	/** called on the background thread */
+	using ProduceFunc = std::function<void (Sink& sink)>;
+	/** called on the UI thread with the items to merge into the model */
+	using MergeFunc = std::function<void (Items& items)>;
+	/** called on the UI thread after all items were merged */
+	using DoneFunc = std::function<void ()>;
+
+	explicit BackgroundPopulator (MergeFunc&& mergeFunc, DoneFunc&& doneFunc = nullptr);
+	~BackgroundPopulator () noexcept;
+
+	void setChunkSize (size_t size) { chunkSize = std::max<size_t> (1, size); }
+	void setMaxItemsPerMerge (size_t numItems) { maxItemsPerMerge = std::max<size_t> (1, numItems); }
+
+	/** start the produce function on a background thread. With a merge interval of zero no timer
+	 *	is started and merge () must be called by the owner.
+	 */
+	void start (ProduceFunc&& produceFunc, uint32_t mergeIntervalInMilliseconds = 16);
+	/** stop the background thread, items not merged yet are dropped */
+	void cancel ();
+	/** merge the items produced so far, returns false when the population is finished */
+	bool merge ();
+
+	bool isRunning () const { return running; }
+	size_t getNumMergedItems () const { return numMerged; }
+
+private:
+	void reset ();
+
+	MergeFunc mergeFunc;
+	DoneFunc doneFunc;
+	size_t chunkSize {1000};
+	size_t maxItemsPerMerge {10000};
+	size_t numMerged {0};
+	bool running {false};
+
+	SharedPointer<CVSTGUITimer> timer;
+	std::future<void> worker;
+	std::atomic<bool> cancelled {false};
+
+	std::mutex mutex;
+	Items pending;
+	size_t pendingPosition {0};
+	bool produced {false};
+};
+
+//------------------------------------------------------------------------
+template<typename T>
+inline void BackgroundPopulator<T>::Sink::push (T&& item)
+{
+	items.emplace_back (std::move (item));
+	if (items.size () >= populator.chunkSize)
+		flush ();
+}
+
+//------------------------------------------------------------------------
+template<typename T>
+inline void BackgroundPopulator<T>::Sink::flush ()
+{
+	if (items.empty ())
+		return;
+	std::lock_guard<std::mutex> guard (populator.mutex);
+	if (populator.pending.empty ())
+		populator.pending.swap (items);
+	else
+	{
+		populator.pending.insert (populator.pending.end (), std::make_move_iterator (items.begin ()),
+		                          std::make_move_iterator (items.end ()));
+		items.clear ();
+	}
+}
+
+//------------------------------------------------------------------------
+template<typename T>
+inline BackgroundPopulator<T>::BackgroundPopulator (MergeFunc&& mergeFunc, DoneFunc&& doneFunc)
+: mergeFunc (std::move (mergeFunc)), doneFunc (std::move (doneFunc))
+{
+}
+
+//------------------------------------------------------------------------
+template<typename T>
+inline BackgroundPopulator<T>::~BackgroundPopulator () noexcept
+{
+	cancel ();
+}
+
+//------------------------------------------------------------------------
+template<typename T>
+inline void BackgroundPopulator<T>::start (ProduceFunc&& produceFunc, uint32_t mergeInterval)
+{
+	cancel ();
+	cancelled = false;
+	running = true;
+	numMerged = 0;
+	worker = std::async (std::launch::async, [this, produceFunc = std::move (produceFunc)] () {
+		Sink sink (*this);
+		produceFunc (sink);
+		sink.flush ();
+		std::lock_guard<std::mutex> guard (mutex);
+		produced = true;
+	});
+	if (mergeInterval > 0)
+		timer = makeOwned<CVSTGUITimer> ([this] (CVSTGUITimer*) { merge (); }, mergeInterval);
+}
+
+//------------------------------------------------------------------------
+template<typename T>
+inline void BackgroundPopulator<T>::cancel ()
+{
+	cancelled = true;
+	reset ();
+}
+
+//------------------------------------------------------------------------
+template<typename T>
+inline void BackgroundPopulator<T>::reset ()
+{
+	if (timer)
+	{
+		timer->stop ();
+		timer = nullptr;
+	}
+	if (worker.valid ())
+		worker.wait ();
+	worker = {};
+	pending.clear ();
+	pendingPosition = 0;
+	produced = false;
+	running = false;
+}
+
+//------------------------------------------------------------------------
+template<typename T>
+inline bool BackgroundPopulator<T>::merge ()
+{
+	if (!running)
+		return false;
+
+	Items items;
+	bool finished = false;
+	{
+		std::lock_guard<std::mutex> guard (mutex);
+		auto available = pending.size () - pendingPosition;
+		if (pendingPosition == 0 && available <= maxItemsPerMerge)
+			items.swap (pending);
+		else
+		{
+			auto first = pending.begin () + static_cast<std::ptrdiff_t> (pendingPosition);
+			auto count = std::min (available, maxItemsPerMerge);
+			items.assign (std::make_move_iterator (first),
+			              std::make_move_iterator (first + static_cast<std::ptrdiff_t> (count)));
+			pendingPosition += count;
+			if (pendingPosition == pending.size ())
+			{
+				pending.clear ();
+				pendingPosition = 0;
+			}
+		}
+		finished = produced && pending.empty ();
+	}
+	if (!items.empty ())
+	{
+		numMerged += items.size ();
+		mergeFunc (items);
+	}
+	if (!finished)
+		return true;
+	reset ();
+	if (doneFunc)
+		doneFunc ();
+	return false;
+}
+
+//------------------------------------------------------------------------
+} // VSTGUI
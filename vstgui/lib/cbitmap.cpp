@@ -5,9 +5,12 @@
 #include "cbitmap.h"
 #include "cdrawcontext.h"
 #include "ccolor.h"
+#include "coffscreencontext.h"
 #include "platform/iplatformbitmap.h"
 #include "platform/platformfactory.h"
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 
 namespace VSTGUI {
 
@@ -86,17 +89,13 @@ void CBitmap::draw (CDrawContext* context, const CRect& rect, const CPoint& offs
 //-----------------------------------------------------------------------------
 CCoord CBitmap::getWidth () const
 {
-	if (auto pb = getPlatformBitmap ())
-		return pb->getSize ().x / pb->getScaleFactor ();
-	return 0;
+	return getSize ().x;
 }
 
 //-----------------------------------------------------------------------------
 CCoord CBitmap::getHeight () const
 {
-	if (auto pb = getPlatformBitmap ())
-		return pb->getSize ().y / pb->getScaleFactor ();
-	return 0;
+	return getSize ().y;
 }
 
 //------------------------------------------------------------------------
@@ -174,6 +173,124 @@ auto CBitmap::getBestPlatformBitmapForScaleFactor (double scaleFactor) const ->
 	return bestBitmap;
 }
 
+//-----------------------------------------------------------------------------
+PlatformBitmapPtr CBitmap::resolvePlatformBitmap (double scaleFactor, CRect& dest, CPoint& offset)
+{
+	return getBestPlatformBitmapForScaleFactor (scaleFactor);
+}
+
+//-----------------------------------------------------------------------------
+auto CBitmap::findBitmap (double scaleFactor) const -> PlatformBitmapPtr
+{
+	for (const auto& bitmap : bitmaps)
+	{
+		if (bitmap->getScaleFactor () == scaleFactor)
+			return bitmap;
+	}
+	return nullptr;
+}
+
+//-----------------------------------------------------------------------------
+void CBitmap::addLazyBitmap (double scaleFactor, PlatformBitmapLoader&& loader)
+{
+	for (auto& lazyBitmap : lazyBitmaps)
+	{
+		if (lazyBitmap.scaleFactor == scaleFactor)
+		{
+			lazyBitmap.loader = std::move (loader);
+			lazyBitmap.failed = false;
+			return;
+		}
+	}
+	lazyBitmaps.push_back ({scaleFactor, std::move (loader)});
+}
+
+//-----------------------------------------------------------------------------
+auto CBitmap::loadBitmap (LazyBitmap& lazyBitmap) -> PlatformBitmapPtr
+{
+	if (auto platformBitmap = findBitmap (lazyBitmap.scaleFactor))
+		return platformBitmap;
+	if (lazyBitmap.failed || !lazyBitmap.loader)
+		return nullptr;
+	if (auto platformBitmap = lazyBitmap.loader ())
+	{
+		platformBitmap->setScaleFactor (lazyBitmap.scaleFactor);
+		CPoint size = platformBitmap->getSize ();
+		size.x /= lazyBitmap.scaleFactor;
+		size.y /= lazyBitmap.scaleFactor;
+		if (bitmaps.empty () || size == getSize ())
+		{
+			bitmaps.emplace_back (platformBitmap);
+			return platformBitmap;
+		}
+	}
+	// don't try it again with every selection
+	lazyBitmap.failed = true;
+	return nullptr;
+}
+
+//-----------------------------------------------------------------------------
+void CBitmap::selectScaleFactor (double scaleFactor)
+{
+	PlatformBitmapPtr selected;
+	while (!selected)
+	{
+		// the smallest difference wins, on a tie the larger scale factor
+		double bestScaleFactor = 0.;
+		bool found = false;
+		auto check = [&] (double candidate) {
+			auto diff = std::abs (candidate - scaleFactor);
+			auto bestDiff = std::abs (bestScaleFactor - scaleFactor);
+			if (!found || diff < bestDiff || (diff == bestDiff && candidate > bestScaleFactor))
+			{
+				bestScaleFactor = candidate;
+				found = true;
+			}
+		};
+		for (const auto& bitmap : bitmaps)
+			check (bitmap->getScaleFactor ());
+		for (const auto& lazyBitmap : lazyBitmaps)
+		{
+			if (!lazyBitmap.failed)
+				check (lazyBitmap.scaleFactor);
+		}
+		if (!found)
+			return;
+		if (!(selected = findBitmap (bestScaleFactor)))
+		{
+			auto it = std::find_if (lazyBitmaps.begin (), lazyBitmaps.end (),
+			                        [&] (const LazyBitmap& lb) { return lb.scaleFactor == bestScaleFactor; });
+			selected = loadBitmap (*it);
+		}
+	}
+	auto isLazy = [&] (const PlatformBitmapPtr& bitmap) {
+		return std::any_of (lazyBitmaps.begin (), lazyBitmaps.end (), [&] (const LazyBitmap& lb) {
+			return lb.scaleFactor == bitmap->getScaleFactor ();
+		});
+	};
+	bitmaps.erase (std::remove_if (bitmaps.begin (), bitmaps.end (),
+	                               [&] (const PlatformBitmapPtr& bitmap) {
+		                               return bitmap != selected && isLazy (bitmap);
+	                               }),
+	               bitmaps.end ());
+}
+
+//-----------------------------------------------------------------------------
+size_t CBitmap::getUnloadedMemorySize () const
+{
+	auto size = getSize ();
+	size_t result = 0;
+	for (const auto& lazyBitmap : lazyBitmaps)
+	{
+		if (lazyBitmap.failed || findBitmap (lazyBitmap.scaleFactor))
+			continue;
+		auto width = static_cast<size_t> (std::ceil (size.x * lazyBitmap.scaleFactor));
+		auto height = static_cast<size_t> (std::ceil (size.y * lazyBitmap.scaleFactor));
+		result += width * height * 4;
+	}
+	return result;
+}
+
 //-----------------------------------------------------------------------------
 // CNinePartTiledBitmap Implementation
 //-----------------------------------------------------------------------------
@@ -204,6 +321,123 @@ A nine-part tiled bitmap is tiled in nine parts which are drawing according to i
 @endverbatim
 
 */
+namespace {
+
+//-----------------------------------------------------------------------------
+/** the composed bitmaps of all nine-part bitmaps, only used on the UI thread */
+class NinePartCache
+{
+public:
+	struct Entry
+	{
+		const CNinePartTiledBitmap* owner;
+		CPoint size;
+		double scaleFactor;
+		uint64_t lastUse;
+		/** nullptr until drawn a second time */
+		SharedPointer<CBitmap> bitmap;
+		size_t memorySize;
+	};
+	using EntryList = std::vector<Entry>;
+
+	static NinePartCache& instance ()
+	{
+		static NinePartCache gInstance;
+		return gInstance;
+	}
+
+	/** false before the first use and after the static destruction */
+	static bool exists () { return gExists; }
+
+	size_t getBudget () const { return budget; }
+	void setBudget (size_t bytes)
+	{
+		budget = bytes;
+		shrink ();
+	}
+
+	size_t getMemorySize () const
+	{
+		size_t result = 0;
+		for (const auto& entry : entries)
+		{
+			if (entry.bitmap)
+				result += entry.memorySize;
+		}
+		return result;
+	}
+
+	uint32_t getNumBitmaps (const CNinePartTiledBitmap* owner) const
+	{
+		return static_cast<uint32_t> (
+			std::count_if (entries.begin (), entries.end (), [&] (const Entry& entry) {
+				return entry.owner == owner && entry.bitmap != nullptr;
+			}));
+	}
+
+	EntryList::iterator find (const CNinePartTiledBitmap* owner, const CPoint& size,
+							  double scaleFactor)
+	{
+		auto it = std::find_if (entries.begin (), entries.end (), [&] (const Entry& entry) {
+			return entry.owner == owner && entry.size == size && entry.scaleFactor == scaleFactor;
+		});
+		if (it != entries.end ())
+			it->lastUse = ++useCounter;
+		return it;
+	}
+
+	EntryList::iterator end () { return entries.end (); }
+
+	void addUncomposed (const CNinePartTiledBitmap* owner, const CPoint& size, double scaleFactor,
+						size_t memorySize)
+	{
+		entries.push_back ({owner, size, scaleFactor, ++useCounter, nullptr, memorySize});
+		shrink ();
+	}
+
+	void remove (const CNinePartTiledBitmap* owner)
+	{
+		entries.erase (std::remove_if (entries.begin (), entries.end (),
+									   [&] (const Entry& entry) { return entry.owner == owner; }),
+					   entries.end ());
+	}
+
+	/** remove the least recently used entries until the composed bitmaps fit into the budget */
+	void shrink ()
+	{
+		// the sizes which were only drawn once
+		static constexpr size_t kMaxUncomposedSizes = 64;
+
+		std::sort (entries.begin (), entries.end (),
+				   [] (const Entry& a, const Entry& b) { return a.lastUse > b.lastUse; });
+		size_t memorySize = 0;
+		size_t numUncomposed = 0;
+		auto it = std::remove_if (entries.begin (), entries.end (), [&] (const Entry& entry) {
+			if (!entry.bitmap)
+				return ++numUncomposed > kMaxUncomposedSizes;
+			if (memorySize + entry.memorySize > budget)
+				return true;
+			memorySize += entry.memorySize;
+			return false;
+		});
+		entries.erase (it, entries.end ());
+	}
+
+private:
+	NinePartCache () { gExists = true; }
+	~NinePartCache () noexcept { gExists = false; }
+
+	static bool gExists;
+
+	EntryList entries;
+	size_t budget {CNinePartTiledBitmap::kDefaultCacheBudget};
+	uint64_t useCounter {0};
+};
+
+bool NinePartCache::gExists = false;
+
+} // anonymous
+
 //-----------------------------------------------------------------------------
 CNinePartTiledBitmap::CNinePartTiledBitmap (const CResourceDescription& desc, const CNinePartTiledDescription& offsets)
 : CBitmap (desc)
@@ -218,10 +452,118 @@ CNinePartTiledBitmap::CNinePartTiledBitmap (const PlatformBitmapPtr& platformBit
 {
 }
 
+//-----------------------------------------------------------------------------
+CNinePartTiledBitmap::~CNinePartTiledBitmap () noexcept
+{
+	// a static bitmap may be released after the cache
+	if (NinePartCache::exists ())
+		purgeCache ();
+}
+
+//-----------------------------------------------------------------------------
+void CNinePartTiledBitmap::setPartOffsets (const CNinePartTiledDescription& partOffsets)
+{
+	offsets = partOffsets;
+	purgeCache ();
+}
+
+//-----------------------------------------------------------------------------
+void CNinePartTiledBitmap::selectScaleFactor (double scaleFactor)
+{
+	auto previousBitmaps = bitmaps;
+	CBitmap::selectScaleFactor (scaleFactor);
+	// the composed bitmaps were drawn from the previous variants
+	if (previousBitmaps != bitmaps)
+		purgeCache ();
+}
+
+//-----------------------------------------------------------------------------
+void CNinePartTiledBitmap::setCacheBudget (size_t bytes)
+{
+	NinePartCache::instance ().setBudget (bytes);
+}
+
+//-----------------------------------------------------------------------------
+size_t CNinePartTiledBitmap::getCacheBudget ()
+{
+	return NinePartCache::instance ().getBudget ();
+}
+
+//-----------------------------------------------------------------------------
+size_t CNinePartTiledBitmap::getCacheMemorySize ()
+{
+	return NinePartCache::instance ().getMemorySize ();
+}
+
+//-----------------------------------------------------------------------------
+uint32_t CNinePartTiledBitmap::getNumCachedBitmaps () const
+{
+	return NinePartCache::instance ().getNumBitmaps (this);
+}
+
+//-----------------------------------------------------------------------------
+void CNinePartTiledBitmap::purgeCache ()
+{
+	NinePartCache::instance ().remove (this);
+}
+
+//-----------------------------------------------------------------------------
+CBitmap* CNinePartTiledBitmap::getComposedBitmap (CDrawContext* context, const CRect& destRect)
+{
+	auto& cache = NinePartCache::instance ();
+	auto size = destRect.getSize ();
+	if (cache.getBudget () == 0 || size.x <= 0. || size.y <= 0.)
+		return nullptr;
+	// the composed bitmap has the pixels of the tiled drawing only if it is drawn without rotation,
+	// with a uniform scale and with its edges on device pixels
+	const auto& matrix = context->getCurrentTransform ();
+	if (matrix.m12 != 0. || matrix.m21 != 0. || matrix.m11 != matrix.m22 || matrix.m11 <= 0.)
+		return nullptr;
+	auto scaleFactor = context->getScaleFactor () * matrix.m11;
+	CRect deviceRect (destRect);
+	matrix.transform (deviceRect);
+	auto isOnPixel = [&] (CCoord value) {
+		value *= context->getScaleFactor ();
+		return std::abs (value - std::round (value)) < 0.001;
+	};
+	if (!isOnPixel (deviceRect.left) || !isOnPixel (deviceRect.top) ||
+		!isOnPixel (deviceRect.right) || !isOnPixel (deviceRect.bottom))
+		return nullptr;
+	auto memorySize = static_cast<size_t> (std::ceil (size.x * scaleFactor)) *
+					  static_cast<size_t> (std::ceil (size.y * scaleFactor)) * 4;
+	if (memorySize > cache.getBudget ())
+		return nullptr;
+
+	auto it = cache.find (this, size, scaleFactor);
+	if (it == cache.end ())
+	{
+		// a size which is only drawn once, like while the view is resized, is not worth composing
+		cache.addUncomposed (this, size, scaleFactor, memorySize);
+		return nullptr;
+	}
+	if (it->bitmap)
+		return it->bitmap;
+
+	auto offscreen = COffscreenContext::create (size, scaleFactor);
+	if (!offscreen)
+		return nullptr;
+	offscreen->beginDraw ();
+	offscreen->drawBitmapNinePartTiled (this, CRect (CPoint (), size), offsets);
+	offscreen->endDraw ();
+	it->bitmap = offscreen->getBitmap ();
+	auto bitmap = it->bitmap.get ();
+	// the entry is the most recently used one and fits into the budget, so it is kept
+	cache.shrink ();
+	return bitmap;
+}
+
 //-----------------------------------------------------------------------------
 void CNinePartTiledBitmap::draw (CDrawContext* inContext, const CRect& inDestRect, const CPoint& offset, float inAlpha)
 {
-	inContext->drawBitmapNinePartTiled (this, inDestRect, offsets, inAlpha);
+	if (auto composed = getComposedBitmap (inContext, inDestRect))
+		inContext->drawBitmap (composed, inDestRect, CPoint (), inAlpha);
+	else
+		inContext->drawBitmapNinePartTiled (this, inDestRect, offsets, inAlpha);
 }
 
 //------------------------------------------------------------------------
@@ -10,6 +10,7 @@
 #include "cresourcedescription.h"
 #include "pixelbuffer.h"
 #include "platform/iplatformbitmap.h"
+#include <functional>
 #include <vector>
 
 namespace VSTGUI {
@@ -17,12 +18,18 @@ namespace VSTGUI {
 //-----------------------------------------------------------------------------
 // CBitmap Declaration
 //! @brief Encapsulates various platform depended kinds of bitmaps
+//!
+//! A bitmap can hold platform bitmaps for different scale factors. Instead of decoding all of them
+//! up front, variants can be added lazily with a loader (see addLazyBitmap ()). Only the variant
+//! which matches the scale factor best is decoded when selectScaleFactor () is called, and the
+//! other lazily added variants are released again. The draw contexts only use the loaded variants.
 //-----------------------------------------------------------------------------
 class CBitmap : public AtomicReferenceCounted
 {
 public:
 	using BitmapVector = std::vector<PlatformBitmapPtr>;
 	using const_iterator = BitmapVector::const_iterator;
+	using PlatformBitmapLoader = std::function<PlatformBitmapPtr ()>;
 
 	/** Create an image from a resource identifier */
 	explicit CBitmap (const CResourceDescription& desc);
@@ -44,7 +51,7 @@ public:
 	/** get the height of the image */
 	CCoord getHeight () const;
 	/** get size of image */
-	CPoint getSize () const;
+	virtual CPoint getSize () const;
 
 	/** check if image is loaded */
 	bool isLoaded () const { return getPlatformBitmap () ? true : false; }
@@ -56,6 +63,30 @@ public:
 
 	bool addBitmap (const PlatformBitmapPtr& platformBitmap);
 	PlatformBitmapPtr getBestPlatformBitmapForScaleFactor (double scaleFactor) const;
+	/** get the platform bitmap the draw contexts draw for this bitmap
+	 *
+	 *	A bitmap which does not keep a platform bitmap of its own (like CAtlasBitmap or a compressed
+	 *	CFilmstripBitmap) returns the platform bitmap which holds its pixels and adjusts dest and
+	 *	offset to the part of it which is drawn.
+	 */
+	virtual PlatformBitmapPtr resolvePlatformBitmap (double scaleFactor, CRect& dest,
+													 CPoint& offset);
+
+	/** add a variant for scaleFactor which is decoded by the loader when it is selected
+	 *
+	 *	A variant which is already loaded can be added too, it is released when another variant
+	 *	is selected and decoded again by the loader when it is selected later. The decoded variant
+	 *	must have the size of the bitmap multiplied by scaleFactor.
+	 */
+	void addLazyBitmap (double scaleFactor, PlatformBitmapLoader&& loader);
+	bool hasLazyBitmaps () const { return !lazyBitmaps.empty (); }
+	/** decode the variant which matches scaleFactor best and release the other lazy variants
+	 *
+	 *	Nothing is released if no variant could be decoded.
+	 */
+	virtual void selectScaleFactor (double scaleFactor);
+	/** the estimated memory size in bytes of the lazy variants which are not decoded */
+	size_t getUnloadedMemorySize () const;
 
 	const_iterator begin () const { return bitmaps.begin (); }
 	const_iterator end () const { return bitmaps.end (); }
@@ -65,8 +96,20 @@ public:
 protected:
 	CBitmap ();
 
+	struct LazyBitmap
+	{
+		double scaleFactor;
+		PlatformBitmapLoader loader;
+		bool failed {false};
+	};
+	using LazyBitmapVector = std::vector<LazyBitmap>;
+
+	PlatformBitmapPtr findBitmap (double scaleFactor) const;
+	PlatformBitmapPtr loadBitmap (LazyBitmap& lazyBitmap);
+
 	CResourceDescription resourceDesc;
 	BitmapVector bitmaps;
+	LazyBitmapVector lazyBitmaps;
 };
 
 //-----------------------------------------------------------------------------
@@ -122,27 +165,53 @@ struct CNinePartTiledDescription
 //-----------------------------------------------------------------------------
 // CNinePartTiledBitmap Declaration
 /// @brief a nine-part tiled bitmap
+///
+/// Drawing the nine parts tiles every part into the destination, which needs many bitmap draws
+/// for large destinations. When the bitmap is drawn a second time with the same size and scale
+/// factor, the composed result is rendered into an offscreen bitmap and drawn with a single bitmap
+/// draw from then on. The composed bitmaps of all nine-part bitmaps share one least recently used
+/// cache which is limited to the cache budget in bytes.
 /// @ingroup new_in_4_0
 //-----------------------------------------------------------------------------
 class CNinePartTiledBitmap : public CBitmap
 {
 public:
+	static constexpr size_t kDefaultCacheBudget = 16 * 1024 * 1024;
+
 	CNinePartTiledBitmap (const CResourceDescription& desc, const CNinePartTiledDescription& offsets);
 	CNinePartTiledBitmap (const PlatformBitmapPtr& platformBitmap, const CNinePartTiledDescription& offsets);
-	~CNinePartTiledBitmap () noexcept override = default;
+	~CNinePartTiledBitmap () noexcept override;
 	
 	//-----------------------------------------------------------------------------
 	/// @name Part Offsets
 	//-----------------------------------------------------------------------------
 	//@{
-	void setPartOffsets (const CNinePartTiledDescription& partOffsets) { offsets = partOffsets; }
+	void setPartOffsets (const CNinePartTiledDescription& partOffsets);
 	const CNinePartTiledDescription& getPartOffsets () const { return offsets; }
 	//@}
 
+	//-----------------------------------------------------------------------------
+	/// @name Composed Bitmap Cache
+	//-----------------------------------------------------------------------------
+	//@{
+	/** the maximum bytes of the composed bitmaps of all nine-part bitmaps, zero disables the cache */
+	static void setCacheBudget (size_t bytes);
+	static size_t getCacheBudget ();
+	/** the bytes of the composed bitmaps of all nine-part bitmaps */
+	static size_t getCacheMemorySize ();
+	/** the number of composed bitmaps of this bitmap */
+	uint32_t getNumCachedBitmaps () const;
+	/** release the composed bitmaps of this bitmap */
+	void purgeCache ();
+	//@}
+
 	void draw (CDrawContext* context, const CRect& rect, const CPoint& offset = CPoint (0, 0), float alpha = 1.f) override;
+	void selectScaleFactor (double scaleFactor) override;
 
 //-----------------------------------------------------------------------------
 protected:
+	CBitmap* getComposedBitmap (CDrawContext* context, const CRect& destRect);
+
 	CNinePartTiledDescription offsets;
 };
 
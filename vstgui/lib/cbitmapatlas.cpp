@@ -0,0 +1,306 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "cbitmapatlas.h"
+#include "platform/iplatformbitmap.h"
+#include "platform/platformfactory.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+namespace VSTGUI {
+
+//-----------------------------------------------------------------------------
+namespace {
+
+//-----------------------------------------------------------------------------
+size_t getMemorySize (CPoint size, double scaleFactor)
+{
+	return static_cast<size_t> (std::ceil (size.x * scaleFactor)) *
+		   static_cast<size_t> (std::ceil (size.y * scaleFactor)) * 4;
+}
+
+//-----------------------------------------------------------------------------
+bool hasScaleFactor (const CBitmap& bitmap, double scaleFactor)
+{
+	return std::any_of (bitmap.begin (), bitmap.end (), [&] (const PlatformBitmapPtr& pb) {
+		return pb->getScaleFactor () == scaleFactor;
+	});
+}
+
+//-----------------------------------------------------------------------------
+bool copyPixels (IPlatformBitmap& source, IPlatformBitmapPixelAccess& destination, CPoint destPos,
+				 CPoint destSize)
+{
+	auto sourceAccess = source.lockPixels (true);
+	if (!sourceAccess)
+		return false;
+	auto sourceSize = source.getSize ();
+	auto x = static_cast<uint32_t> (destPos.x);
+	auto y = static_cast<uint32_t> (destPos.y);
+	auto width = static_cast<uint32_t> (std::min (sourceSize.x, destSize.x - destPos.x));
+	auto height = static_cast<uint32_t> (std::min (sourceSize.y, destSize.y - destPos.y));
+	for (auto row = 0u; row < height; ++row)
+	{
+		std::memcpy (destination.getAddress () + (y + row) * destination.getBytesPerRow () + x * 4,
+					 sourceAccess->getAddress () + row * sourceAccess->getBytesPerRow (),
+					 width * 4);
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+} // anonymous
+
+//-----------------------------------------------------------------------------
+// CAtlasBitmap Implementation
+//-----------------------------------------------------------------------------
+CAtlasBitmap::CAtlasBitmap (CBitmap* page, const CRect& rect) : page (page), rect (rect)
+{
+}
+
+//-----------------------------------------------------------------------------
+PlatformBitmapPtr CAtlasBitmap::resolvePlatformBitmap (double scaleFactor, CRect& dest,
+													   CPoint& offset)
+{
+	// only the part of the page which belongs to this bitmap must be visible
+	CRect bitmapRect (dest.getTopLeft () - offset, rect.getSize ());
+	CRect pageDest (dest);
+	pageDest.bound (bitmapRect);
+	if (pageDest.isEmpty ())
+		return nullptr;
+	offset = pageDest.getTopLeft () - bitmapRect.getTopLeft () + rect.getTopLeft ();
+	dest = pageDest;
+	return page->resolvePlatformBitmap (scaleFactor, dest, offset);
+}
+
+//-----------------------------------------------------------------------------
+// CBitmapAtlas Implementation
+//-----------------------------------------------------------------------------
+/*! @class CBitmapAtlas
+@code
+CBitmapAtlas::NamedBitmapList icons;
+for (auto& name : iconNames)
+	icons.emplace_back (name, makeOwned<CBitmap> (CResourceDescription (name.data ())));
+auto atlas = CBitmapAtlas::pack (icons);
+auto button = new COnOffButton (r, listener, tag, atlas->getBitmap ("power.png"));
+@endcode
+*/
+//-----------------------------------------------------------------------------
+CBitmapAtlas::CBitmapAtlas (const PageList& pages, EntryList&& entries)
+: pages (pages), entries (std::move (entries))
+{
+}
+
+//-----------------------------------------------------------------------------
+SharedPointer<CBitmapAtlas> CBitmapAtlas::pack (const NamedBitmapList& bitmaps,
+												const Config& config)
+{
+	EntryList entries;
+	entries.reserve (bitmaps.size ());
+	std::vector<double> scaleFactors;
+	std::vector<size_t> candidates;
+	for (const auto& it : bitmaps)
+	{
+		Entry entry;
+		entry.name = it.first;
+		entry.bitmap = it.second;
+		entries.emplace_back (std::move (entry));
+		const auto& bitmap = it.second;
+		if (!bitmap || !bitmap->getPlatformBitmap () || dynamic_cast<CAtlasBitmap*> (bitmap.get ()))
+			continue;
+		auto size = bitmap->getSize ();
+		if (size.x <= 0. || size.y <= 0. || size.x > config.maxBitmapSize ||
+			size.y > config.maxBitmapSize || size.x > config.maxPageSize ||
+			size.y > config.maxPageSize)
+			continue;
+		if (scaleFactors.empty ())
+		{
+			for (const auto& platformBitmap : *bitmap)
+				scaleFactors.emplace_back (platformBitmap->getScaleFactor ());
+			std::sort (scaleFactors.begin (), scaleFactors.end ());
+		}
+		if (std::all_of (scaleFactors.begin (), scaleFactors.end (),
+						 [&] (double scaleFactor) { return hasScaleFactor (*bitmap, scaleFactor); }))
+			candidates.emplace_back (entries.size () - 1);
+	}
+
+	// shelf packing, the highest bitmaps first
+	std::stable_sort (candidates.begin (), candidates.end (), [&] (size_t a, size_t b) {
+		auto sizeA = entries[a].bitmap->getSize ();
+		auto sizeB = entries[b].bitmap->getSize ();
+		return sizeA.y > sizeB.y || (sizeA.y == sizeB.y && sizeA.x > sizeB.x);
+	});
+	std::vector<CPoint> pageSizes;
+	CPoint shelf;
+	CCoord shelfHeight = 0.;
+	for (auto index : candidates)
+	{
+		auto& entry = entries[index];
+		auto size = entry.bitmap->getSize ();
+		size (std::ceil (size.x), std::ceil (size.y));
+		if (!pageSizes.empty () && shelf.x + size.x > config.maxPageSize)
+		{
+			shelf (0., shelf.y + shelfHeight + config.padding);
+			shelfHeight = 0.;
+		}
+		if (pageSizes.empty () || shelf.y + size.y > config.maxPageSize)
+		{
+			pageSizes.emplace_back (0., 0.);
+			shelf (0., 0.);
+			shelfHeight = 0.;
+		}
+		entry.page = static_cast<uint32_t> (pageSizes.size () - 1);
+		entry.rect = CRect (shelf, entry.bitmap->getSize ());
+		shelf.x += size.x + config.padding;
+		shelfHeight = std::max (shelfHeight, size.y);
+		auto& pageSize = pageSizes.back ();
+		pageSize.x = std::max (pageSize.x, shelf.x - config.padding);
+		pageSize.y = std::max (pageSize.y, shelf.y + size.y);
+	}
+
+	PageList pages;
+	for (auto pageIndex = 0u; pageIndex < pageSizes.size (); ++pageIndex)
+	{
+		SharedPointer<CBitmap> page;
+		for (auto scaleFactor : scaleFactors)
+		{
+			auto size = pageSizes[pageIndex];
+			size.x = std::ceil (size.x * scaleFactor);
+			size.y = std::ceil (size.y * scaleFactor);
+			auto platformBitmap = getPlatformFactory ().createBitmap (size);
+			auto pixelAccess = platformBitmap ? platformBitmap->lockPixels (true) : nullptr;
+			if (!pixelAccess)
+			{
+				// the platform does not support pixel access, keep all bitmaps as they are
+				for (auto& entry : entries)
+				{
+					entry.page = kNotPacked;
+					entry.rect = {};
+				}
+				return makeOwned<CBitmapAtlas> (PageList (), std::move (entries));
+			}
+			for (auto row = 0u; row < static_cast<uint32_t> (size.y); ++row)
+				std::memset (pixelAccess->getAddress () + row * pixelAccess->getBytesPerRow (), 0,
+							 static_cast<size_t> (size.x) * 4);
+			for (auto& entry : entries)
+			{
+				if (entry.page != pageIndex)
+					continue;
+				auto source = entry.bitmap->getBestPlatformBitmapForScaleFactor (scaleFactor);
+				auto pos = entry.rect.getTopLeft ();
+				pos.x *= scaleFactor;
+				pos.y *= scaleFactor;
+				pos.makeIntegral ();
+				if (!copyPixels (*source, *pixelAccess, pos, size))
+					entry.page = kNotPacked;
+			}
+			pixelAccess = nullptr;
+			platformBitmap->setScaleFactor (scaleFactor);
+			if (page)
+				page->addBitmap (platformBitmap);
+			else
+				page = makeOwned<CBitmap> (platformBitmap);
+		}
+		pages.emplace_back (page);
+	}
+
+	for (auto& entry : entries)
+	{
+		if (entry.page == kNotPacked)
+			entry.rect = {};
+		else
+			entry.bitmap = makeOwned<CAtlasBitmap> (pages[entry.page], entry.rect);
+	}
+	return makeOwned<CBitmapAtlas> (pages, std::move (entries));
+}
+
+//-----------------------------------------------------------------------------
+SharedPointer<CBitmapAtlas> CBitmapAtlas::create (const PageList& pages,
+												  const std::string& description)
+{
+	EntryList entries;
+	std::istringstream stream (description);
+	std::string line;
+	while (std::getline (stream, line))
+	{
+		if (line.empty ())
+			continue;
+		std::istringstream lineStream (line);
+		Entry entry;
+		CCoord x, y, width, height;
+		if (!(lineStream >> entry.page >> x >> y >> width >> height))
+			return nullptr;
+		lineStream >> std::ws;
+		std::getline (lineStream, entry.name);
+		if (entry.name.empty () || entry.page >= pages.size () || !pages[entry.page])
+			return nullptr;
+		entry.rect = CRect (CPoint (x, y), CPoint (width, height));
+		CRect pageRect (CPoint (), pages[entry.page]->getSize ());
+		if (width <= 0. || height <= 0. || !pageRect.rectInside (entry.rect))
+			return nullptr;
+		entry.bitmap = makeOwned<CAtlasBitmap> (pages[entry.page], entry.rect);
+		entries.emplace_back (std::move (entry));
+	}
+	return makeOwned<CBitmapAtlas> (pages, std::move (entries));
+}
+
+//-----------------------------------------------------------------------------
+CBitmap* CBitmapAtlas::getBitmap (const std::string& name) const
+{
+	auto it = std::find_if (entries.begin (), entries.end (),
+							[&] (const Entry& entry) { return entry.name == name; });
+	return it != entries.end () ? it->bitmap.get () : nullptr;
+}
+
+//-----------------------------------------------------------------------------
+uint32_t CBitmapAtlas::getNumPackedBitmaps () const
+{
+	return static_cast<uint32_t> (std::count_if (
+		entries.begin (), entries.end (), [] (const Entry& entry) { return entry.page != kNotPacked; }));
+}
+
+//-----------------------------------------------------------------------------
+size_t CBitmapAtlas::getPageMemorySize () const
+{
+	size_t result = 0;
+	for (const auto& page : pages)
+	{
+		for (const auto& platformBitmap : *page)
+			result += getMemorySize (platformBitmap->getSize (), 1.);
+	}
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+size_t CBitmapAtlas::getUnpackedMemorySize () const
+{
+	size_t result = 0;
+	for (const auto& entry : entries)
+	{
+		if (entry.page == kNotPacked)
+			continue;
+		for (const auto& platformBitmap : *pages[entry.page])
+			result += getMemorySize (entry.rect.getSize (), platformBitmap->getScaleFactor ());
+	}
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+std::string CBitmapAtlas::toDescription () const
+{
+	std::ostringstream stream;
+	for (const auto& entry : entries)
+	{
+		if (entry.page == kNotPacked)
+			continue;
+		stream << entry.page << ' ' << entry.rect.left << ' ' << entry.rect.top << ' '
+			   << entry.rect.getWidth () << ' ' << entry.rect.getHeight () << ' ' << entry.name
+			   << '\n';
+	}
+	return stream.str ();
+}
+
+} // VSTGUI
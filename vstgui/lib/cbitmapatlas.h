@@ -0,0 +1,122 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#pragma once
+
+#include "cbitmap.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace VSTGUI {
+
+//-----------------------------------------------------------------------------
+// CAtlasBitmap Declaration
+/// @brief a bitmap which is a part of a bitmap atlas page
+//-----------------------------------------------------------------------------
+/** The part has no platform bitmaps of its own. The draw contexts draw the part of the page via
+ *	resolvePlatformBitmap (), but getPlatformBitmap () returns nullptr, so CBitmapPixelAccess and
+ *	the bitmap filters cannot be used with it.
+ */
+class CAtlasBitmap : public CBitmap
+{
+public:
+	CAtlasBitmap (CBitmap* page, const CRect& rect);
+	~CAtlasBitmap () noexcept override = default;
+
+	CBitmap* getPage () const { return page; }
+	/** the rect of the bitmap in the page */
+	const CRect& getRect () const { return rect; }
+
+	PlatformBitmapPtr resolvePlatformBitmap (double scaleFactor, CRect& dest,
+											 CPoint& offset) override;
+	CPoint getSize () const override { return rect.getSize (); }
+
+//-----------------------------------------------------------------------------
+protected:
+	SharedPointer<CBitmap> page;
+	CRect rect;
+};
+
+//-----------------------------------------------------------------------------
+// CBitmapAtlas Declaration
+/// @brief packs many small bitmaps into a few large bitmaps
+//-----------------------------------------------------------------------------
+/** Every bitmap has its own platform bitmap with its own allocation and surface. With many small
+ *	icons and button states this costs memory and the draw calls switch the source surface all the
+ *	time. The atlas copies the pixels of small bitmaps into pages and replaces them with
+ *	CAtlasBitmap instances which draw their part of the page.
+ *
+ *	The pages get a platform bitmap for every scale factor of the first packed bitmap. A bitmap is
+ *	only packed if it has a platform bitmap for each of these scale factors, is not larger than
+ *	Config::maxBitmapSize and its pixels are accessible. All other bitmaps are kept as they are.
+ *
+ *	The layout can be written as text via toDescription () and restored together with the pages,
+ *	so that an atlas can be created offline (see tools/imagestitcher).
+ */
+class CBitmapAtlas : public AtomicReferenceCounted
+{
+public:
+	struct Config
+	{
+		/** maximum width and height of a page */
+		CCoord maxPageSize {1024.};
+		/** bitmaps wider or higher are not packed */
+		CCoord maxBitmapSize {256.};
+		/** space between the bitmaps, so that they do not bleed into each other when scaled */
+		CCoord padding {1.};
+	};
+
+	static constexpr uint32_t kNotPacked = 0xffffffff;
+
+	struct Entry
+	{
+		std::string name;
+		/** the part of the page or the original bitmap if it was not packed */
+		SharedPointer<CBitmap> bitmap;
+		/** the index of the page or kNotPacked */
+		uint32_t page {kNotPacked};
+		/** the rect in the page */
+		CRect rect;
+	};
+	using EntryList = std::vector<Entry>;
+	using PageList = std::vector<SharedPointer<CBitmap>>;
+	using NamedBitmapList = std::vector<std::pair<std::string, SharedPointer<CBitmap>>>;
+
+	/** pack the bitmaps, the entries of the atlas are in the same order as the bitmaps */
+	static SharedPointer<CBitmapAtlas> pack (const NamedBitmapList& bitmaps, const Config& config);
+	static SharedPointer<CBitmapAtlas> pack (const NamedBitmapList& bitmaps)
+	{
+		return pack (bitmaps, Config ());
+	}
+	/** restore an atlas from its pages and the description of the layout
+	 *
+	 *	@return nullptr if the description is invalid or does not match the pages
+	 */
+	static SharedPointer<CBitmapAtlas> create (const PageList& pages,
+											   const std::string& description);
+
+	const EntryList& getEntries () const { return entries; }
+	const PageList& getPages () const { return pages; }
+	/** returns nullptr if there is no entry with this name */
+	CBitmap* getBitmap (const std::string& name) const;
+	uint32_t getNumPackedBitmaps () const;
+
+	/** the bytes of the platform bitmaps of all pages */
+	size_t getPageMemorySize () const;
+	/** the bytes the platform bitmaps of the packed bitmaps need on their own */
+	size_t getUnpackedMemorySize () const;
+
+	/** the layout of the packed bitmaps as text, one line per bitmap: page x y width height name */
+	std::string toDescription () const;
+
+	CBitmapAtlas (const PageList& pages, EntryList&& entries);
+	~CBitmapAtlas () noexcept override = default;
+
+private:
+	PageList pages;
+	EntryList entries;
+};
+
+} // VSTGUI
@@ -231,6 +231,25 @@ void CDataBrowser::recalculateSubViews ()
  * @param rememberSelection if true selection will be remembered
  */
 void CDataBrowser::recalculateLayout (bool rememberSelection)
+{
+	if (db->dbHasVariableRowHeights (this))
+	{
+		CCoord rowLineWidth = getRowLineWidth ();
+		rowHeights.build (static_cast<size_t> (std::max (0, db->dbGetNumRows (this))),
+		                  [&] (size_t row) {
+			                  return db->dbGetVariableRowHeight (static_cast<int32_t> (row), this) +
+			                         rowLineWidth;
+		                  });
+	}
+	else
+	{
+		rowHeights.clear ();
+	}
+	updateLayout (rememberSelection);
+}
+
+//-----------------------------------------------------------------------------------------------
+void CDataBrowser::updateLayout (bool rememberSelection)
 {
 	CCoord lineWidth = 0;
 	CColor lineColor;
@@ -242,6 +261,8 @@ void CDataBrowser::recalculateLayout (bool rememberSelection)
 	CCoord allRowsHeight = rowHeight * numRows;
 	if (style & kDrawRowLines)
 		allRowsHeight += numRows * lineWidth;
+	if (!rowHeights.empty ())
+		allRowsHeight = rowHeights.getTotalHeight ();
 	CCoord allColumnsWidth = 0;
 	for (int32_t i = 0; i < numColumns; i++)
 		allColumnsWidth += db->dbGetCurrentColumnWidth (i, this);
@@ -362,6 +383,81 @@ void CDataBrowser::makeRowVisible (int32_t row)
 	makeRectVisible (r);
 }
 
+//-----------------------------------------------------------------------------------------------
+/**
+ * @param row row which height has changed
+ */
+void CDataBrowser::rowHeightChanged (int32_t row)
+{
+	if (row < 0 || static_cast<size_t> (row) >= rowHeights.size ())
+		return;
+	rowHeights.setHeight (static_cast<size_t> (row), db->dbGetVariableRowHeight (row, this) + getRowLineWidth ());
+	updateLayout (true);
+}
+
+//-----------------------------------------------------------------------------------------------
+void CDataBrowser::rowsAppended ()
+{
+	auto numRows = static_cast<size_t> (std::max (0, db->dbGetNumRows (this)));
+	if (numRows < rowHeights.size ())
+	{
+		recalculateLayout (true);
+		return;
+	}
+	if (db->dbHasVariableRowHeights (this))
+	{
+		CCoord rowLineWidth = getRowLineWidth ();
+		for (auto row = rowHeights.size (); row < numRows; ++row)
+			rowHeights.append (
+			    db->dbGetVariableRowHeight (static_cast<int32_t> (row), this) + rowLineWidth);
+	}
+	else
+	{
+		rowHeights.clear ();
+	}
+	updateLayout (true);
+}
+
+//-----------------------------------------------------------------------------------------------
+CCoord CDataBrowser::getRowLineWidth ()
+{
+	CCoord lineWidth = 0;
+	if (style & kDrawRowLines)
+	{
+		CColor lineColor;
+		db->dbGetLineWidthAndColor (lineWidth, lineColor, this);
+	}
+	return lineWidth;
+}
+
+//-----------------------------------------------------------------------------------------------
+CCoord CDataBrowser::getRowOffset (int32_t row)
+{
+	if (!rowHeights.empty ())
+		return rowHeights.getOffset (static_cast<size_t> (std::max (0, row)));
+	return getRowSpan (row) * row;
+}
+
+//-----------------------------------------------------------------------------------------------
+CCoord CDataBrowser::getRowSpan (int32_t row)
+{
+	if (row >= 0 && static_cast<size_t> (row) < rowHeights.size ())
+		return rowHeights.getHeight (static_cast<size_t> (row));
+	return db->dbGetRowHeight (this) + getRowLineWidth ();
+}
+
+//-----------------------------------------------------------------------------------------------
+int32_t CDataBrowser::getRowAtOffset (CCoord offset)
+{
+	if (!rowHeights.empty ())
+		return static_cast<int32_t> (rowHeights.getRowAt (offset));
+	int32_t numRows = db->dbGetNumRows (this);
+	CCoord rowSpan = getRowSpan (0);
+	if (rowSpan <= 0.)
+		return 0;
+	return static_cast<int32_t> (std::min<CCoord> (std::floor (offset / rowSpan), numRows));
+}
+
 //-----------------------------------------------------------------------------------------------
 /**
  * @param index row to select
@@ -379,24 +475,23 @@ void CDataBrowser::setSelectedRow (int32_t index, bool makeVisible)
 		index = numRows-1;
 
 	bool hasChanged = true;
-	Selection::iterator alreadySelected = std::find (selection.begin (), selection.end (), index);
-	if (alreadySelected != selection.end ())
+	if (isRowSelected (index))
 	{
-		selection.erase (alreadySelected);
-		hasChanged = !selection.empty ();
+		removeFromSelection (index);
+		hasChanged = !selectedRows.empty ();
 	}
 	else
 	{
 		invalidateRow (index);
 	}
 	
-	for (auto row : selection)
+	for (const auto& row : selectedRows)
 	{
-		dbView->invalidateRow (row);
+		dbView->invalidateRow (row.first);
 	}
-	selection.clear ();
+	clearSelection ();
 	
-	selection.emplace_back (index);
+	addToSelection (index);
 	if (hasChanged)
 		db->dbSelectionChanged (this);
 	
@@ -407,22 +502,82 @@ void CDataBrowser::setSelectedRow (int32_t index, bool makeVisible)
 //-----------------------------------------------------------------------------------------------
 int32_t CDataBrowser::getSelectedRow () const
 {
-	if (!selection.empty ())
-		return selection[0];
+	const auto& rows = getSelection ();
+	if (!rows.empty ())
+		return rows[0];
 	return kNoSelection;
 }
 
+//-----------------------------------------------------------------------------------------------
+const CDataBrowser::Selection& CDataBrowser::getSelection () const
+{
+	compactSelection ();
+	return selection;
+}
+
+//-----------------------------------------------------------------------------------------------
+bool CDataBrowser::isRowSelected (int32_t row) const
+{
+	return selectedRows.find (row) != selectedRows.end ();
+}
+
+//-----------------------------------------------------------------------------------------------
+void CDataBrowser::addToSelection (int32_t row)
+{
+	if (selectedRows.emplace (row, selection.size ()).second)
+		selection.emplace_back (row);
+}
+
+//-----------------------------------------------------------------------------------------------
+void CDataBrowser::removeFromSelection (int32_t row)
+{
+	auto it = selectedRows.find (row);
+	if (it == selectedRows.end ())
+		return;
+	if (it->second == selection.size () - 1)
+		selection.pop_back ();
+	else
+		selectionNeedsCompaction = true;
+	selectedRows.erase (it);
+}
+
+//-----------------------------------------------------------------------------------------------
+void CDataBrowser::compactSelection () const
+{
+	if (!selectionNeedsCompaction)
+		return;
+	// keep the entries of selected rows, a row unselected and selected again has a newer entry
+	size_t numRows = 0;
+	for (size_t index = 0; index < selection.size (); ++index)
+	{
+		auto it = selectedRows.find (selection[index]);
+		if (it == selectedRows.end () || it->second != index)
+			continue;
+		it->second = numRows;
+		selection[numRows++] = selection[index];
+	}
+	selection.resize (numRows);
+	selectionNeedsCompaction = false;
+}
+
+//-----------------------------------------------------------------------------------------------
+void CDataBrowser::clearSelection ()
+{
+	selection.clear ();
+	selectedRows.clear ();
+	selectionNeedsCompaction = false;
+}
+
 //-----------------------------------------------------------------------------------------------
 void CDataBrowser::selectRow (int32_t row)
 {
 	if (row > db->dbGetNumRows (this))
 		return;
-	Selection::iterator alreadySelected = std::find (selection.begin (), selection.end (), row);
-	if (alreadySelected == selection.end ())
+	if (!isRowSelected (row))
 	{
 		if (getStyle () & kMultiSelectionStyle)
 		{
-			selection.emplace_back (row);
+			addToSelection (row);
 			dbView->invalidateRow (row);
 			db->dbSelectionChanged (this);
 		}
@@ -438,12 +593,11 @@ void CDataBrowser::unselectRow (int32_t row)
 {
 	if (row > db->dbGetNumRows (this))
 		return;
-	Selection::iterator alreadySelected = std::find (selection.begin (), selection.end (), row);
-	if (alreadySelected != selection.end ())
+	if (isRowSelected (row))
 	{
 		if (getStyle () & kMultiSelectionStyle)
 		{
-			selection.erase (alreadySelected);
+			removeFromSelection (row);
 			dbView->invalidateRow (row);
 			db->dbSelectionChanged (this);
 		}
@@ -457,13 +611,13 @@ void CDataBrowser::unselectRow (int32_t row)
 //-----------------------------------------------------------------------------------------------
 void CDataBrowser::unselectAll ()
 {
-	if (!selection.empty ())
+	if (!selectedRows.empty ())
 	{
-		for (auto row : selection)
+		for (const auto& row : selectedRows)
 		{
-			dbView->invalidateRow (row);
+			dbView->invalidateRow (row.first);
 		}
-		selection.clear ();
+		clearSelection ();
 		db->dbSelectionChanged (this);
 	}
 }
@@ -471,22 +625,22 @@ void CDataBrowser::unselectAll ()
 //-----------------------------------------------------------------------------------------------
 void CDataBrowser::validateSelection ()
 {
-	bool selectionChanged = false;
 	int32_t numRows = db->dbGetNumRows (this);
-	for (Selection::iterator it = selection.begin (); it != selection.end ();)
+	bool hasChanged = false;
+	for (auto it = selectedRows.begin (); it != selectedRows.end ();)
 	{
-		if (*it >= numRows)
-		{
-			it = selection.erase (it);
-			selectionChanged = true;
-		}
-		else
+		if (it->first < numRows)
 		{
 			++it;
+			continue;
 		}
+		it = selectedRows.erase (it);
+		hasChanged = true;
 	}
-	if (selectionChanged)
-		db->dbSelectionChanged (this);
+	if (!hasChanged)
+		return;
+	selectionNeedsCompaction = true;
+	db->dbSelectionChanged (this);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -502,10 +656,8 @@ CRect CDataBrowser::getCellBounds (const Cell& cell)
 		CColor lineColor;
 		db->dbGetLineWidthAndColor (lineWidth, lineColor, this);
 	}
-	CCoord rowHeight = db->dbGetRowHeight (this);
-	if (style & kDrawRowLines)
-		rowHeight += lineWidth;
-	CRect result (0, rowHeight * cell.row, 0, rowHeight * (cell.row+1));
+	CCoord rowTop = getRowOffset (cell.row);
+	CRect result (0, rowTop, 0, rowTop + getRowSpan (cell.row));
 	for (int32_t i = 0; i <= cell.column; i++)
 	{
 		CCoord colWidth = db->dbGetCurrentColumnWidth (i, this);
@@ -744,20 +896,8 @@ CDataBrowserView::CDataBrowserView (const CRect& size, IDataBrowserDelegate* db,
 //-----------------------------------------------------------------------------------------------
 CRect CDataBrowserView::getRowBounds (int32_t row)
 {
-	CCoord lineWidth = 0;
-	if (browser->getStyle () & CDataBrowser::kDrawRowLines || browser->getStyle () & CDataBrowser::kDrawColumnLines)
-	{
-		CColor lineColor;
-		db->dbGetLineWidthAndColor (lineWidth, lineColor, browser);
-	}
-	CCoord rowHeight = db->dbGetRowHeight (browser);
-
-	CRect where (getViewSize ());
-	where.originize ();
-	if (browser->getStyle () & CDataBrowser::kDrawRowLines)
-		rowHeight+=lineWidth;
-
-	CRect r (getViewSize ().left, getViewSize ().top + rowHeight * row, getViewSize ().right, getViewSize ().top + rowHeight * (row+1));
+	CCoord rowTop = getViewSize ().top + browser->getRowOffset (row);
+	CRect r (getViewSize ().left, rowTop, getViewSize ().right, rowTop + browser->getRowSpan (row));
 	return r;
 }
 
@@ -788,25 +928,29 @@ void CDataBrowserView::drawRect (CDrawContext* context, const CRect& updateRect)
 		db->dbGetLineWidthAndColor (lineWidth, lineColor, browser);
 	}
 
-	CCoord rowHeight = db->dbGetRowHeight (browser);
-	if (drawRowLines)
-		rowHeight += lineWidth;
 	int32_t numRows = db->dbGetNumRows (browser);
 	int32_t numColumns = db->dbGetNumColumns (browser);
 
-	const CDataBrowser::Selection& selection = browser->getSelection ();
+	// only visit the rows intersecting the update rect and their neighbours, as the row lines
+	// are centered on the row borders
+	auto firstRow = browser->getRowAtOffset (updateRect.top - getViewSize ().top) - 1;
+	auto lastRow = browser->getRowAtOffset (updateRect.bottom - getViewSize ().top) + 2;
+	firstRow = std::max (0, std::min (firstRow, numRows));
+	lastRow = std::max (firstRow, std::min (lastRow, numRows));
 
 	CDrawContext::LineList lines;
 
 	CRect r (getViewSize ());
-	r.setHeight (rowHeight - lineWidth);
-	for (int32_t row = 0; row < numRows; row++)
+	r.offset (0, browser->getRowOffset (firstRow));
+	for (int32_t row = firstRow; row < lastRow; row++)
 	{
+		CCoord rowSpan = browser->getRowSpan (row);
+		r.setHeight (rowSpan - lineWidth);
 		CRect testRect (r);
 		testRect.bound (updateRect);
 		if (testRect.isEmpty () == false)
 		{
-			bool isSelected = std::find (selection.begin (), selection.end (), row) != selection.end ();
+			bool isSelected = browser->isRowSelected (row);
 			for (int32_t col = 0; col < numColumns; col++)
 			{
 				CCoord columnWidth = db->dbGetCurrentColumnWidth (col, browser);
@@ -830,7 +974,7 @@ void CDataBrowserView::drawRect (CDrawContext* context, const CRect& updateRect)
 		r.setWidth (getWidth ());
 		if (drawRowLines)
 			lines.emplace_back (r.getBottomLeft (), r.getBottomRight ());
-		r.offset (0, rowHeight);
+		r.offset (0, rowSpan);
 	}
 	if (browser->getStyle () & CDataBrowser::kDrawColumnLines)
 	{
@@ -874,12 +1018,11 @@ bool CDataBrowserView::getCell (const CPoint& where, CDataBrowser::Cell& cell)
 		CColor lineColor;
 		db->dbGetLineWidthAndColor (lineWidth, lineColor, browser);
 	}
-	CCoord rowHeight = db->dbGetRowHeight (browser);
 	int32_t numColumns = db->dbGetNumColumns (browser);
 
-	if (browser->getStyle () & CDataBrowser::kDrawRowLines)
-		rowHeight += lineWidth;
-	int32_t rowNum = (int32_t)(_where.y / rowHeight);
+	int32_t rowNum = browser->getRowAtOffset (_where.y);
+	if (rowNum < 0)
+		return false;
 	int32_t colNum = 0;
 	CCoord cw = 0;
 	for (int32_t i = 0; i < numColumns; i++)
@@ -906,7 +1049,7 @@ CMouseEventResult CDataBrowserView::onMouseDown (CPoint &where, const CButtonSta
 	if (getCell (where, cell))
 	{
 		const CDataBrowser::Selection& selection = browser->getSelection ();
-		bool alreadySelected = std::find (selection.begin (), selection.end (), cell.row) != selection.end ();
+		bool alreadySelected = browser->isRowSelected (cell.row);
 		if (browser->getStyle () & CDataBrowser::kMultiSelectionStyle)
 		{
 			if (buttons.getModifierState () == kControl)
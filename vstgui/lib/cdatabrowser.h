@@ -9,6 +9,8 @@
 #include "cfont.h"
 #include "ccolor.h"
 #include "cstring.h"
+#include "crowheightindex.h"
+#include <unordered_map>
 #include <vector>
 
 namespace VSTGUI {
@@ -74,6 +76,19 @@ public:
 	virtual void invalidateRow (int32_t row);
 	/** scrolls the scrollview so that row is visible */
 	virtual void makeRowVisible (int32_t row);
+	/** call if the height of a row changed, only needed if the delegate has variable row heights */
+	virtual void rowHeightChanged (int32_t row);
+	/** call if the delegate added rows at the end, cheaper than recalculateLayout as only the new
+	 *	rows are queried */
+	virtual void rowsAppended ();
+
+	/** get the vertical offset of row relative to the first row including the row lines */
+	CCoord getRowOffset (int32_t row);
+	/** get the height of row including its row line */
+	CCoord getRowSpan (int32_t row);
+	/** get the row at the vertical offset relative to the first row, returns the number of rows
+	 *	if offset is below the last row */
+	int32_t getRowAtOffset (CCoord offset);
 
 	/** get bounds of a cell */
 	virtual CRect getCellBounds (const Cell& cell);
@@ -85,8 +100,10 @@ public:
 	/** set the exclusive selected row */
 	virtual void setSelectedRow (int32_t row, bool makeVisible = false);
 
-	/** get all selected rows */
-	const Selection& getSelection () const { return selection; }
+	/** get all selected rows in the order they were selected */
+	const Selection& getSelection () const;
+	/** check if row is selected in constant time */
+	bool isRowSelected (int32_t row) const;
 	/** add row to selection */
 	virtual void selectRow (int32_t row);
 	/** remove row from selection */
@@ -117,12 +134,26 @@ protected:
 
 	void recalculateSubViews () override;
 	void validateSelection ();
+	void updateLayout (bool rememberSelection);
+	CCoord getRowLineWidth ();
+	void addToSelection (int32_t row);
+	void removeFromSelection (int32_t row);
+	void clearSelection ();
+	void compactSelection () const;
 
 	IDataBrowserDelegate* db;
 	CDataBrowserView* dbView;
 	CDataBrowserHeader* dbHeader;
 	CViewContainer* dbHeaderContainer;
-	Selection selection;
+	CRowHeightIndex rowHeights;
+
+private:
+	/** the rows in selection order. Unselected rows are removed lazily by compactSelection, so
+	 *	subclasses use getSelection () */
+	mutable Selection selection;
+	/** the selected rows and their index in selection */
+	mutable std::unordered_map<int32_t, size_t> selectedRows;
+	mutable bool selectionNeedsCompaction {false};
 };
 
 //-----------------------------------------------------------------------------
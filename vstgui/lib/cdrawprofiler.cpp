@@ -0,0 +1,208 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "cdrawprofiler.h"
+#include "cdrawcontext.h"
+#include "cviewcontainer.h"
+#include "vstguitrace.h"
+#include <algorithm>
+#include <cstdio>
+#include <typeinfo>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+
+//------------------------------------------------------------------------
+namespace {
+
+//------------------------------------------------------------------------
+double toSeconds (CDrawProfiler::Clock::duration duration)
+{
+	return std::chrono::duration<double> (duration).count ();
+}
+
+//------------------------------------------------------------------------
+CRect getFrameRect (const CView* view)
+{
+	CRect r (view->getViewSize ());
+	auto transform = view->getGlobalTransform ();
+	// the global transform of a container includes its own transform, which only applies to its
+	// children
+	if (auto container = view->asViewContainer ())
+		transform = transform * container->getTransform ().inverse ();
+	return transform.transform (r);
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+CDrawProfiler::CDrawProfiler (uint32_t numFramesToAggregate)
+: numFramesToAggregate (std::max<uint32_t> (numFramesToAggregate, 1))
+{
+	stack.reserve (32);
+}
+
+//------------------------------------------------------------------------
+void CDrawProfiler::setNumFramesToAggregate (uint32_t numFrames)
+{
+	numFramesToAggregate = std::max<uint32_t> (numFrames, 1);
+	if (this->numFrames >= numFramesToAggregate)
+		publishResults ();
+}
+
+//------------------------------------------------------------------------
+void CDrawProfiler::beginFrame ()
+{
+	stack.clear ();
+	frameStart = Clock::now ();
+	inFrame = true;
+}
+
+//------------------------------------------------------------------------
+bool CDrawProfiler::endFrame ()
+{
+	if (!inFrame)
+		return false;
+	inFrame = false;
+	frameTime += Clock::now () - frameStart;
+	if (++numFrames < numFramesToAggregate)
+		return false;
+	publishResults ();
+	return true;
+}
+
+//------------------------------------------------------------------------
+void CDrawProfiler::beginView (CView* view)
+{
+	if (inFrame)
+		stack.push_back ({view, Clock::now (), {}});
+}
+
+//------------------------------------------------------------------------
+void CDrawProfiler::endView (CView* view)
+{
+	if (!inFrame)
+		return;
+	vstgui_assert (!stack.empty ());
+	if (stack.empty ())
+		return;
+	auto entry = stack.back ();
+	stack.pop_back ();
+	auto totalTime = Clock::now () - entry.start;
+	if (entry.view == view)
+	{
+		auto& viewStats = stats[view];
+		++viewStats.numDraws;
+		viewStats.totalTime += totalTime;
+		viewStats.selfTime += totalTime - entry.childrenTime;
+	}
+	if (!stack.empty ())
+		stack.back ().childrenTime += totalTime;
+}
+
+//------------------------------------------------------------------------
+void CDrawProfiler::forgetView (CView* view)
+{
+	stats.erase (view);
+	results.erase (std::remove_if (results.begin (), results.end (),
+								   [view] (const Entry& entry) { return entry.view == view; }),
+				   results.end ());
+	// a view may be removed while it draws
+	for (auto& entry : stack)
+	{
+		if (entry.view == view)
+			entry.view = nullptr;
+	}
+}
+
+//------------------------------------------------------------------------
+void CDrawProfiler::reset ()
+{
+	stats.clear ();
+	stack.clear ();
+	results.clear ();
+	inFrame = false;
+	frameTime = {};
+	numFrames = numResultFrames = 0;
+	resultFrameTime = 0.;
+}
+
+//------------------------------------------------------------------------
+void CDrawProfiler::publishResults ()
+{
+	results.clear ();
+	results.reserve (stats.size ());
+	for (const auto& it : stats)
+	{
+		Entry entry;
+		entry.view = it.first;
+		entry.className = Trace::demangleTypeName (typeid (*it.first).name ());
+		entry.numDraws = it.second.numDraws;
+		entry.selfTime = toSeconds (it.second.selfTime);
+		entry.totalTime = toSeconds (it.second.totalTime);
+		results.emplace_back (std::move (entry));
+	}
+	std::sort (results.begin (), results.end (),
+			   [] (const Entry& a, const Entry& b) { return a.selfTime > b.selfTime; });
+	numResultFrames = numFrames;
+	resultFrameTime = toSeconds (frameTime);
+	stats.clear ();
+	frameTime = {};
+	numFrames = 0;
+}
+
+//------------------------------------------------------------------------
+std::string CDrawProfiler::createReport (size_t maxEntries) const
+{
+	std::string report;
+	if (numResultFrames == 0)
+		return report;
+	auto perFrame = 1000. / numResultFrames;
+	char line[512];
+	snprintf (line, sizeof (line), "Draw profile of %u frames, %.3f ms per frame\n",
+			  numResultFrames, resultFrameTime * perFrame);
+	report += line;
+	snprintf (line, sizeof (line), "%10s %10s %8s  %s\n", "self ms", "total ms", "draws", "view");
+	report += line;
+	auto numEntries = maxEntries ? std::min (maxEntries, results.size ()) : results.size ();
+	for (auto index = 0u; index < numEntries; ++index)
+	{
+		const auto& entry = results[index];
+		auto r = entry.view->getViewSize ();
+		snprintf (line, sizeof (line), "%10.3f %10.3f %8.2f  %s %p (%g, %g, %g, %g)\n",
+				  entry.selfTime * perFrame, entry.totalTime * perFrame,
+				  static_cast<double> (entry.numDraws) / numResultFrames, entry.className.data (),
+				  static_cast<const void*> (entry.view), r.left, r.top, r.getWidth (),
+				  r.getHeight ());
+		report += line;
+	}
+	return report;
+}
+
+//------------------------------------------------------------------------
+void CDrawProfiler::drawHeatMap (CDrawContext* context) const
+{
+	if (results.empty () || results.front ().selfTime <= 0.)
+		return;
+	auto maxTime = results.front ().selfTime;
+	context->saveGlobalState ();
+	context->setDrawMode (kAliasing);
+	context->setLineWidth (1.);
+	// draw the cheapest first, so that the expensive views are on top
+	for (auto it = results.rbegin (); it != results.rend (); ++it)
+	{
+		auto heat = it->selfTime / maxTime;
+		if (heat < 0.01)
+			continue;
+		auto r = getFrameRect (it->view);
+		context->setFillColor (CColor (255, 0, 0, static_cast<uint8_t> (16. + heat * 144.)));
+		context->setFrameColor (CColor (255, 0, 0, static_cast<uint8_t> (64. + heat * 191.)));
+		context->drawRect (r, kDrawFilledAndStroked);
+	}
+	context->restoreGlobalState ();
+}
+
+//------------------------------------------------------------------------
+} // VSTGUI
@@ -0,0 +1,103 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#pragma once
+
+#include "vstguifwd.h"
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+
+//------------------------------------------------------------------------
+/** Measures the time each view of a frame needs to draw
+ *
+ *	Enabled via CFrame::setDrawProfilingEnabled (). CViewContainer::drawRect () measures every
+ *	child it draws and the profiler separates the time a view needs for itself from the time its
+ *	children need. The times are summed up over a number of frames, where each call to
+ *	CFrame::drawRect () is one frame, and then published as results which can be shown as heat map
+ *	on top of the frame or as text report.
+ */
+class CDrawProfiler : public NonAtomicReferenceCounted
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	struct Entry
+	{
+		CView* view {nullptr};
+		/** the demangled class name of the view */
+		std::string className;
+		uint32_t numDraws {0};
+		/** seconds without the time needed for drawing the children */
+		double selfTime {0.};
+		/** seconds including the time needed for drawing the children */
+		double totalTime {0.};
+	};
+	using EntryList = std::vector<Entry>;
+
+	explicit CDrawProfiler (uint32_t numFramesToAggregate = 60);
+
+	void setNumFramesToAggregate (uint32_t numFrames);
+	uint32_t getNumFramesToAggregate () const { return numFramesToAggregate; }
+
+	void beginFrame ();
+	/** returns true if new results are available */
+	bool endFrame ();
+	/** views are only measured between beginFrame and endFrame */
+	void beginView (CView* view);
+	void endView (CView* view);
+	/** must be called when the view is removed from the frame */
+	void forgetView (CView* view);
+	/** drop the results and all measurements of the current frames */
+	void reset ();
+
+	/** the results of the last aggregated frames sorted by self time, the most expensive first */
+	const EntryList& getResults () const { return results; }
+	/** the number of frames the results were aggregated over */
+	uint32_t getNumResultFrames () const { return numResultFrames; }
+	/** the draw time of all frames the results were aggregated over in seconds */
+	double getResultFrameTime () const { return resultFrameTime; }
+
+	/** a text report of the results with the times averaged per frame
+	 *
+	 *	@param maxEntries maximum number of views in the report, zero for all
+	 */
+	std::string createReport (size_t maxEntries = 0) const;
+	/** fill the area of each view of the results, the more opaque the more expensive the view */
+	void drawHeatMap (CDrawContext* context) const;
+
+private:
+	void publishResults ();
+
+	struct Stats
+	{
+		uint32_t numDraws {0};
+		Clock::duration selfTime {};
+		Clock::duration totalTime {};
+	};
+	struct StackEntry
+	{
+		CView* view;
+		Clock::time_point start;
+		Clock::duration childrenTime;
+	};
+
+	std::unordered_map<CView*, Stats> stats;
+	std::vector<StackEntry> stack;
+	EntryList results;
+	Clock::time_point frameStart;
+	Clock::duration frameTime {};
+	double resultFrameTime {0.};
+	uint32_t numFramesToAggregate;
+	uint32_t numFrames {0};
+	uint32_t numResultFrames {0};
+	bool inFrame {false};
+};
+
+//------------------------------------------------------------------------
+} // VSTGUI
@@ -0,0 +1,351 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "cfilmstripbitmap.h"
+#include "platform/iplatformbitmap.h"
+#include "platform/platformfactory.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace VSTGUI {
+
+//-----------------------------------------------------------------------------
+namespace {
+
+//-----------------------------------------------------------------------------
+uint64_t hashTile (const uint32_t* pixels, size_t numPixels)
+{
+	// FNV-1a
+	uint64_t hash = 14695981039346656037ull;
+	for (auto i = 0u; i < numPixels; ++i)
+	{
+		hash ^= pixels[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+//-----------------------------------------------------------------------------
+size_t getMemorySize (const IPlatformBitmap& platformBitmap)
+{
+	auto size = platformBitmap.getSize ();
+	return static_cast<size_t> (size.x) * static_cast<size_t> (size.y) * 4;
+}
+
+//-----------------------------------------------------------------------------
+} // anonymous
+
+//-----------------------------------------------------------------------------
+// CFilmstripBitmap Implementation
+//-----------------------------------------------------------------------------
+/*! @class CFilmstripBitmap
+A filmstrip of 128 frames of 128 x 128 pixels needs 8 MB as platform bitmap and twice that with a
+second strip for the 2x scale factor. As most pixels of a knob strip do not change from frame to
+frame, the compressed strip usually needs only a fraction of that.
+@code
+auto knobStrip = makeOwned<CFilmstripBitmap> (CResourceDescription ("knob.png"), 128);
+knobStrip->addStrip (getPlatformFactory ().createBitmap (CResourceDescription ("knob#2x.png")));
+knobStrip->compress ();
+auto knob = new CAnimKnob (CRect (0, 0, 128, 128), listener, tag, knobStrip);
+@endcode
+*/
+//-----------------------------------------------------------------------------
+CFilmstripBitmap::CFilmstripBitmap (const CResourceDescription& desc, uint32_t numFrames)
+: CBitmap (desc), numFrames (std::max<uint32_t> (numFrames, 1))
+{
+}
+
+//-----------------------------------------------------------------------------
+CFilmstripBitmap::CFilmstripBitmap (const PlatformBitmapPtr& platformBitmap, uint32_t numFrames)
+: CBitmap (platformBitmap), numFrames (std::max<uint32_t> (numFrames, 1))
+{
+}
+
+//-----------------------------------------------------------------------------
+bool CFilmstripBitmap::addStrip (const PlatformBitmapPtr& platformBitmap)
+{
+	if (!platformBitmap)
+		return false;
+	if (strips.empty ())
+		return addBitmap (platformBitmap);
+	return compressStrip (platformBitmap);
+}
+
+//-----------------------------------------------------------------------------
+bool CFilmstripBitmap::compress ()
+{
+	if (isCompressed ())
+		return true;
+	if (bitmaps.empty ())
+		return false;
+	for (const auto& platformBitmap : bitmaps)
+	{
+		if (!compressStrip (platformBitmap))
+		{
+			strips.clear ();
+			return false;
+		}
+	}
+	bitmaps.clear ();
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool CFilmstripBitmap::compressStrip (const PlatformBitmapPtr& platformBitmap)
+{
+	auto scaleFactor = platformBitmap->getScaleFactor ();
+	auto pixelSize = platformBitmap->getSize ();
+	CPoint stripSize (pixelSize.x / scaleFactor, pixelSize.y / scaleFactor);
+	auto width = static_cast<uint32_t> (pixelSize.x);
+	auto height = static_cast<uint32_t> (pixelSize.y);
+	if (width == 0 || height == 0 || height % numFrames)
+		return false;
+	if (!strips.empty ())
+	{
+		if (stripSize != size)
+		{
+			vstgui_assert (stripSize == size, "wrong bitmap size");
+			return false;
+		}
+		for (const auto& strip : strips)
+		{
+			if (strip.scaleFactor == scaleFactor)
+			{
+				vstgui_assert (strip.scaleFactor != scaleFactor, "scale factor already added");
+				return false;
+			}
+		}
+	}
+	auto pixelAccess = platformBitmap->lockPixels (true);
+	if (!pixelAccess)
+		return false;
+
+	Strip strip;
+	strip.scaleFactor = scaleFactor;
+	strip.frameWidth = width;
+	strip.frameHeight = height / numFrames;
+	strip.tilesPerRow = (width + kTileSize - 1) / kTileSize;
+	strip.tilesPerColumn = (strip.frameHeight + kTileSize - 1) / kTileSize;
+	strip.tileIndices.reserve (strip.tilesPerRow * strip.tilesPerColumn * numFrames);
+
+	constexpr auto kTilePixels = kTileSize * kTileSize;
+	uint32_t tile[kTilePixels];
+	std::unordered_multimap<uint64_t, uint32_t> tileMap;
+	auto address = pixelAccess->getAddress ();
+	auto bytesPerRow = pixelAccess->getBytesPerRow ();
+	// tiles never cross the border between two frames
+	for (auto frameTop = 0u; frameTop < height; frameTop += strip.frameHeight)
+	{
+		for (auto tileY = 0u; tileY < strip.frameHeight; tileY += kTileSize)
+		{
+			auto rows = std::min (kTileSize, strip.frameHeight - tileY);
+			auto source = address + (frameTop + tileY) * bytesPerRow;
+			for (auto x = 0u; x < width; x += kTileSize)
+			{
+				auto columns = std::min (kTileSize, width - x);
+				std::fill (std::begin (tile), std::end (tile), 0u);
+				for (auto row = 0u; row < rows; ++row)
+					std::memcpy (&tile[row * kTileSize], source + row * bytesPerRow + x * 4,
+								 columns * 4);
+				auto hash = hashTile (tile, kTilePixels);
+				auto numTiles = static_cast<uint32_t> (strip.tilePixels.size () / kTilePixels);
+				auto tileIndex = numTiles;
+				auto range = tileMap.equal_range (hash);
+				for (auto it = range.first; it != range.second; ++it)
+				{
+					if (std::memcmp (tile, &strip.tilePixels[it->second * kTilePixels],
+									 sizeof (tile)) == 0)
+					{
+						tileIndex = it->second;
+						break;
+					}
+				}
+				if (tileIndex == numTiles)
+				{
+					strip.tilePixels.insert (strip.tilePixels.end (), std::begin (tile),
+											 std::end (tile));
+					tileMap.emplace (hash, tileIndex);
+				}
+				strip.tileIndices.emplace_back (tileIndex);
+			}
+		}
+	}
+	strip.tilePixels.shrink_to_fit ();
+
+	if (strips.empty ())
+		size = stripSize;
+	strips.emplace_back (std::move (strip));
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool CFilmstripBitmap::decode (const Strip& strip, uint32_t frameIndex,
+							   IPlatformBitmap& platformBitmap) const
+{
+	auto pixelAccess = platformBitmap.lockPixels (true);
+	if (!pixelAccess)
+		return false;
+	constexpr auto kTilePixels = kTileSize * kTileSize;
+	auto address = pixelAccess->getAddress ();
+	auto bytesPerRow = pixelAccess->getBytesPerRow ();
+	auto tileIndex =
+		strip.tileIndices.data () + frameIndex * strip.tilesPerRow * strip.tilesPerColumn;
+	for (auto y = 0u; y < strip.frameHeight; y += kTileSize)
+	{
+		auto rows = std::min (kTileSize, strip.frameHeight - y);
+		for (auto x = 0u; x < strip.frameWidth; x += kTileSize, ++tileIndex)
+		{
+			auto columns = std::min (kTileSize, strip.frameWidth - x);
+			auto tile = &strip.tilePixels[*tileIndex * kTilePixels];
+			for (auto row = 0u; row < rows; ++row)
+				std::memcpy (address + (y + row) * bytesPerRow + x * 4, &tile[row * kTileSize],
+							 columns * 4);
+		}
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+size_t CFilmstripBitmap::findStrip (double scaleFactor) const
+{
+	// the exact one, otherwise the smallest one above or the biggest one below
+	size_t best = 0;
+	for (auto index = 1u; index < strips.size (); ++index)
+	{
+		auto current = strips[best].scaleFactor;
+		auto candidate = strips[index].scaleFactor;
+		if (current == scaleFactor)
+			break;
+		if (candidate == scaleFactor)
+			best = index;
+		else if (current < scaleFactor ? candidate > current
+									   : (candidate > scaleFactor && candidate < current))
+			best = index;
+	}
+	return best;
+}
+
+//-----------------------------------------------------------------------------
+CBitmap* CFilmstripBitmap::getCachedFrame (size_t stripIndex, uint32_t frameIndex)
+{
+	for (auto& entry : cache)
+	{
+		if (entry.stripIndex == stripIndex && entry.frameIndex == frameIndex)
+		{
+			entry.lastUse = ++useCounter;
+			return entry.bitmap;
+		}
+	}
+	const auto& strip = strips[stripIndex];
+	auto platformBitmap =
+		getPlatformFactory ().createBitmap (CPoint (strip.frameWidth, strip.frameHeight));
+	if (!platformBitmap)
+		return nullptr;
+	platformBitmap->setScaleFactor (strip.scaleFactor);
+	if (!decode (strip, frameIndex, *platformBitmap))
+		return nullptr;
+
+	auto bitmap = makeOwned<CBitmap> (platformBitmap);
+	if (cache.size () < maxCachedFrames)
+	{
+		cache.push_back ({stripIndex, frameIndex, ++useCounter, bitmap});
+	}
+	else
+	{
+		auto leastRecentlyUsed = std::min_element (
+			cache.begin (), cache.end (),
+			[] (const CachedFrame& a, const CachedFrame& b) { return a.lastUse < b.lastUse; });
+		*leastRecentlyUsed = {stripIndex, frameIndex, ++useCounter, bitmap};
+	}
+	return bitmap;
+}
+
+//-----------------------------------------------------------------------------
+PlatformBitmapPtr CFilmstripBitmap::getFrame (uint32_t frameIndex, double scaleFactor)
+{
+	if (strips.empty () || frameIndex >= numFrames)
+		return nullptr;
+	if (auto bitmap = getCachedFrame (findStrip (scaleFactor), frameIndex))
+		return bitmap->getPlatformBitmap ();
+	return nullptr;
+}
+
+//-----------------------------------------------------------------------------
+PlatformBitmapPtr CFilmstripBitmap::resolvePlatformBitmap (double scaleFactor, CRect& dest,
+														   CPoint& offset)
+{
+	if (strips.empty ())
+		return CBitmap::resolvePlatformBitmap (scaleFactor, dest, offset);
+	auto frameHeight = size.y / numFrames;
+	auto frame = std::floor (offset.y / frameHeight + 0.0001);
+	auto frameIndex = static_cast<uint32_t> (
+		std::min (std::max (frame, 0.), static_cast<double> (numFrames - 1)));
+	offset.y -= frameIndex * frameHeight;
+	// the parts of the following frames are not drawn
+	if (dest.getHeight () > frameHeight - offset.y)
+		dest.setHeight (std::max (frameHeight - offset.y, 0.));
+	if (auto bitmap = getCachedFrame (findStrip (scaleFactor), frameIndex))
+		return bitmap->getPlatformBitmap ();
+	return nullptr;
+}
+
+//-----------------------------------------------------------------------------
+CPoint CFilmstripBitmap::getSize () const
+{
+	return strips.empty () ? CBitmap::getSize () : size;
+}
+
+//-----------------------------------------------------------------------------
+CPoint CFilmstripBitmap::getFrameSize () const
+{
+	auto frameSize = getSize ();
+	frameSize.y /= numFrames;
+	return frameSize;
+}
+
+//-----------------------------------------------------------------------------
+void CFilmstripBitmap::setMaxCachedFrames (uint32_t numCachedFrames)
+{
+	maxCachedFrames = std::max<uint32_t> (numCachedFrames, 1);
+	while (cache.size () > maxCachedFrames)
+	{
+		cache.erase (std::min_element (
+			cache.begin (), cache.end (),
+			[] (const CachedFrame& a, const CachedFrame& b) { return a.lastUse < b.lastUse; }));
+	}
+}
+
+//-----------------------------------------------------------------------------
+void CFilmstripBitmap::purgeCache ()
+{
+	cache.clear ();
+}
+
+//-----------------------------------------------------------------------------
+size_t CFilmstripBitmap::getResidentMemorySize () const
+{
+	size_t result = 0;
+	for (const auto& strip : strips)
+		result += (strip.tileIndices.size () + strip.tilePixels.size ()) * sizeof (uint32_t);
+	for (const auto& entry : cache)
+		result += getMemorySize (*entry.bitmap->getPlatformBitmap ());
+	for (const auto& platformBitmap : bitmaps)
+		result += getMemorySize (*platformBitmap);
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+size_t CFilmstripBitmap::getUncompressedMemorySize () const
+{
+	size_t result = 0;
+	for (const auto& strip : strips)
+		result += static_cast<size_t> (strip.frameWidth) * strip.frameHeight * numFrames * 4;
+	for (const auto& platformBitmap : bitmaps)
+		result += getMemorySize (*platformBitmap);
+	return result;
+}
+
+} // VSTGUI
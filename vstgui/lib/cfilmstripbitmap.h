@@ -0,0 +1,122 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#pragma once
+
+#include "cbitmap.h"
+#include <vector>
+
+namespace VSTGUI {
+
+//-----------------------------------------------------------------------------
+// CFilmstripBitmap Declaration
+/// @brief a filmstrip which only keeps the displayed frames decoded
+//-----------------------------------------------------------------------------
+/** The frames of the strip are stacked vertically, as used by CAnimKnob, CMovieBitmap,
+ *	CMovieButton and the other multi frame controls.
+ *
+ *	The strip is kept uncompressed until compress () is called. Compressing splits the strip into
+ *	tiles of kTileSize x kTileSize pixels and stores equal tiles only once, so the parts which do
+ *	not change from frame to frame (the background of a knob, the transparent corners) do not need
+ *	memory per frame. The platform bitmaps of the strip are released after they were compressed.
+ *
+ *	The draw contexts draw a compressed strip by decoding the frame selected by the offset into a
+ *	platform bitmap of one frame (see resolvePlatformBitmap ()). A draw only shows the frame which
+ *	contains the top left point of the offset. The decoded frames are kept in a small least
+ *	recently used cache, so that a control which switches between a few frames does not decode on
+ *	every draw.
+ *
+ *	As a compressed strip has no platform bitmap, getPlatformBitmap () returns nullptr and
+ *	isLoaded () returns false. CBitmapPixelAccess, the bitmap filters and other code which works on
+ *	the platform bitmap directly cannot be used with it, only decoded frames (see getFrame ()).
+ */
+class CFilmstripBitmap : public CBitmap
+{
+public:
+	static constexpr uint32_t kTileSize = 16;
+	static constexpr uint32_t kDefaultMaxCachedFrames = 4;
+
+	CFilmstripBitmap (const CResourceDescription& desc, uint32_t numFrames);
+	CFilmstripBitmap (const PlatformBitmapPtr& platformBitmap, uint32_t numFrames);
+	~CFilmstripBitmap () noexcept override = default;
+
+	//-----------------------------------------------------------------------------
+	/// @name CFilmstripBitmap Methods
+	//-----------------------------------------------------------------------------
+	//@{
+	/** add the strip for another scale factor, it must have the same size as the first one
+	 *
+	 *	The strip is compressed if this filmstrip is compressed.
+	 */
+	bool addStrip (const PlatformBitmapPtr& platformBitmap);
+	/** compress the strips and release their platform bitmaps
+	 *
+	 *	Returns false and keeps the strips uncompressed if the pixels of a platform bitmap are not
+	 *	accessible or its height is not a multiple of the number of frames.
+	 */
+	bool compress ();
+
+	uint32_t getNumFrames () const { return numFrames; }
+	/** the size of one frame */
+	CPoint getFrameSize () const;
+	/** false if the strip is kept uncompressed */
+	bool isCompressed () const { return !strips.empty (); }
+
+	/** the number of decoded frames kept for drawing */
+	void setMaxCachedFrames (uint32_t numFrames);
+	uint32_t getMaxCachedFrames () const { return maxCachedFrames; }
+	uint32_t getNumCachedFrames () const { return static_cast<uint32_t> (cache.size ()); }
+	/** release all decoded frames */
+	void purgeCache ();
+
+	/** the bytes needed for the compressed strips and the decoded frames */
+	size_t getResidentMemorySize () const;
+	/** the bytes the uncompressed platform bitmaps of the strips would need */
+	size_t getUncompressedMemorySize () const;
+
+	/** decode the frame of the compressed strip closest to the scale factor */
+	PlatformBitmapPtr getFrame (uint32_t frameIndex, double scaleFactor = 1.);
+	//@}
+
+	PlatformBitmapPtr resolvePlatformBitmap (double scaleFactor, CRect& dest,
+											 CPoint& offset) override;
+	CPoint getSize () const override;
+
+//-----------------------------------------------------------------------------
+protected:
+	struct Strip
+	{
+		double scaleFactor {1.};
+		/** in pixels */
+		uint32_t frameWidth {0};
+		uint32_t frameHeight {0};
+		uint32_t tilesPerRow {0};
+		uint32_t tilesPerColumn {0};
+		/** the index of the tile in tilePixels for every tile of every frame */
+		std::vector<uint32_t> tileIndices;
+		std::vector<uint32_t> tilePixels;
+	};
+
+	struct CachedFrame
+	{
+		size_t stripIndex;
+		uint32_t frameIndex;
+		uint64_t lastUse;
+		SharedPointer<CBitmap> bitmap;
+	};
+
+	bool compressStrip (const PlatformBitmapPtr& platformBitmap);
+	size_t findStrip (double scaleFactor) const;
+	CBitmap* getCachedFrame (size_t stripIndex, uint32_t frameIndex);
+	bool decode (const Strip& strip, uint32_t frameIndex, IPlatformBitmap& platformBitmap) const;
+
+	std::vector<Strip> strips;
+	std::vector<CachedFrame> cache;
+	CPoint size;
+	uint32_t numFrames {0};
+	uint32_t maxCachedFrames {kDefaultMaxCachedFrames};
+	uint64_t useCounter {0};
+};
+
+} // VSTGUI
@@ -5,9 +5,11 @@
 #include "cframe.h"
 #include "events.h"
 #include "finally.h"
+#include "vstguitrace.h"
 #include "coffscreencontext.h"
 #include "ctooltipsupport.h"
 #include "cinvalidrectlist.h"
+#include "cdrawprofiler.h"
 #include "itouchevent.h"
 #include "iscalefactorchangedlistener.h"
 #include "idatapackage.h"
@@ -66,6 +68,7 @@ struct CFrame::Impl
 	IViewAddedRemovedObserver* viewAddedRemovedObserver {nullptr};
 	SharedPointer<CTooltipSupport> tooltips;
 	SharedPointer<Animation::Animator> animator;
+	SharedPointer<CDrawProfiler> drawProfiler;
 #if VSTGUI_ENABLE_DEPRECATED_METHODS
 	Optional<ModalViewSessionID> legacyModalViewSessionID;
 #endif
@@ -88,6 +91,8 @@ struct CFrame::Impl
 	bool active {false};
 	bool windowActive {false};
 	bool inEventHandling {false};
+	bool drawProfilerHeatMap {false};
+	bool inPlatformRedraw {false};
 	BitmapInterpolationQuality bitmapQuality {BitmapInterpolationQuality::kDefault};
 
 	struct PostEventHandler
@@ -327,15 +332,35 @@ void CFrame::drawRect (CDrawContext* pContext, const CRect& updateRect)
 	if (updateRect.getWidth () <= 0 || updateRect.getHeight () <= 0 || pContext == nullptr)
 		return;
 
+	VSTGUI_TRACE_OBJECT_SCOPE ("CFrame::drawRect", this);
 	auto lifeGuard = shared (pContext);
 
 	if (pImpl)
 		pContext->setBitmapInterpolationQuality (pImpl->bitmapQuality);
 
+	auto profiler = getDrawProfiler ();
+	// all rects of one platform redraw are profiled as one frame
+	bool profileFrame = profiler && !pImpl->inPlatformRedraw;
+	if (profileFrame)
+		profiler->beginFrame ();
+
 	drawClipped (pContext, updateRect, [&] () {
 		// draw the background and the children
 		CViewContainer::drawRect (pContext, updateRect);
+		if (profiler && pImpl->drawProfilerHeatMap)
+			profiler->drawHeatMap (pContext);
 	});
+
+	if (profileFrame)
+		endDrawProfilerFrame (profiler);
+}
+
+//-----------------------------------------------------------------------------
+void CFrame::endDrawProfilerFrame (CDrawProfiler* profiler)
+{
+	// the heat map is updated with the next frame, which adds this frame to the profile
+	if (profiler->endFrame () && pImpl->drawProfilerHeatMap)
+		invalid ();
 }
 
 //-----------------------------------------------------------------------------
@@ -1138,6 +1163,8 @@ void CFrame::onViewRemoved (CView* pView)
 		pImpl->windowActiveStateChangeViews.remove (pView);
 	if (pImpl->animator)
 		pImpl->animator->removeAnimations (pView);
+	if (pImpl->drawProfiler)
+		pImpl->drawProfiler->forgetView (pView);
 }
 
 //-----------------------------------------------------------------------------
@@ -1479,6 +1506,46 @@ void CFrame::setFocusWidth (CCoord width)
 	setAttribute ('vfwi', width);
 }
 
+//-----------------------------------------------------------------------------
+void CFrame::setDrawProfilingEnabled (bool state, uint32_t numFramesToAggregate)
+{
+	if (state)
+	{
+		if (pImpl->drawProfiler)
+			pImpl->drawProfiler->setNumFramesToAggregate (numFramesToAggregate);
+		else
+			pImpl->drawProfiler = makeOwned<CDrawProfiler> (numFramesToAggregate);
+	}
+	else if (pImpl->drawProfiler)
+	{
+		pImpl->drawProfiler = nullptr;
+		if (pImpl->drawProfilerHeatMap)
+			invalid ();
+	}
+}
+
+//-----------------------------------------------------------------------------
+CDrawProfiler* CFrame::getDrawProfiler () const
+{
+	return pImpl ? pImpl->drawProfiler.get () : nullptr;
+}
+
+//-----------------------------------------------------------------------------
+void CFrame::setDrawProfilerHeatMapVisible (bool state)
+{
+	if (pImpl->drawProfilerHeatMap == state)
+		return;
+	pImpl->drawProfilerHeatMap = state;
+	if (pImpl->drawProfiler)
+		invalid ();
+}
+
+//-----------------------------------------------------------------------------
+bool CFrame::isDrawProfilerHeatMapVisible () const
+{
+	return pImpl->drawProfilerHeatMap;
+}
+
 //-----------------------------------------------------------------------------
 /**
  * @param src rect which to scroll
@@ -1486,15 +1553,17 @@ void CFrame::setFocusWidth (CCoord width)
  */
 void CFrame::scrollRect (const CRect& src, const CPoint& distance)
 {
-	CRect rect (src);
-	rect.offset (getViewSize ().left, getViewSize ().top);
-
-	if (pImpl->platformFrame)
+	if (isVisible () && pImpl->platformFrame && getTransform ().isInvariant ())
 	{
+		// the platform frame moves the pending invalid rects together with the content
+		if (pImpl->collectInvalidRects)
+			pImpl->collectInvalidRects->flush ();
 		if (pImpl->platformFrame->scrollRect (src, distance))
 			return;
 	}
-	invalidRect (src);
+	CRect rect (src);
+	rect.unite (CRect (src).offset (distance));
+	invalidRect (rect);
 }
 
 //-----------------------------------------------------------------------------
@@ -1666,9 +1735,26 @@ bool CFrame::platformDrawRect (CDrawContext* context, const CRect& rect)
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+void CFrame::platformOnBeginRedraw ()
+{
+	pImpl->inPlatformRedraw = true;
+	if (auto profiler = getDrawProfiler ())
+		profiler->beginFrame ();
+}
+
+//-----------------------------------------------------------------------------
+void CFrame::platformOnEndRedraw ()
+{
+	pImpl->inPlatformRedraw = false;
+	if (auto profiler = getDrawProfiler ())
+		endDrawProfilerFrame (profiler);
+}
+
 //-----------------------------------------------------------------------------
 void CFrame::platformOnEvent (Event& event)
 {
+	VSTGUI_TRACE_OBJECT_SCOPE ("CFrame::platformOnEvent", this);
 	dispatchEvent (event);
 }
 
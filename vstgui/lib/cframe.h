@@ -184,6 +184,21 @@ public:
 	CCoord getFocusWidth () const;
 	//@}
 
+	//-----------------------------------------------------------------------------
+	/// @name Draw Profiling Methods
+	//! When enabled, the time each view needs to draw is measured and aggregated over a number of
+	//! frames. See CDrawProfiler.
+	//-----------------------------------------------------------------------------
+	//@{
+	/** enable or disable the draw profiler */
+	void setDrawProfilingEnabled (bool state, uint32_t numFramesToAggregate = 60);
+	/** the draw profiler, nullptr if profiling is disabled */
+	CDrawProfiler* getDrawProfiler () const;
+	/** show the results of the draw profiler as heat map on top of all views */
+	void setDrawProfilerHeatMapVisible (bool state);
+	bool isDrawProfilerHeatMapVisible () const;
+	//@}
+
 	using EventProcessingFunction = std::function<void ()>;
 	/** Queue a function which will be executed after the current event was handled.
 	 *	Only allowed when inEventProcessing () is true
@@ -257,6 +272,8 @@ protected:
 
 	// platform frame
 	bool platformDrawRect (CDrawContext* context, const CRect& rect) override;
+	void platformOnBeginRedraw () override;
+	void platformOnEndRedraw () override;
 	void platformOnEvent (Event& event) override;
 	DragOperation platformOnDragEnter (DragEventData data) override;
 	DragOperation platformOnDragMove (DragEventData data) override;
@@ -275,6 +292,7 @@ private:
 #endif
 	void initModalViewSession (const ModalViewSession& session);
 	void clearModalViewSessions ();
+	void endDrawProfilerFrame (CDrawProfiler* profiler);
 	void dispatchKeyboardEvent (KeyboardEvent& event);
 	void dispatchMouseEvent (MouseEvent& event);
 	void dispatchMouseDownEvent (MouseDownEvent& event);
@@ -107,5 +107,84 @@ inline void joinNearbyInvalidRects (CInvalidRectList& list, CCoord maxDistance)
 	}
 }
 
+//-----------------------------------------------------------------------------
+/** update the list after the content of src was moved by distance
+ *
+ *	Pending rectangles inside src are moved with the content and the area which was uncovered by
+ *	the move is added to the list.
+ */
+inline void scrollInvalidRects (CInvalidRectList& list, const CRect& src, const CPoint& distance)
+{
+	CRect dest (src);
+	dest.offset (distance);
+
+	std::vector<CRect> moved;
+	for (const auto& rect : list)
+	{
+		CRect r (rect);
+		r.bound (src);
+		if (r.isEmpty ())
+			continue;
+		r.offset (distance);
+		moved.emplace_back (r);
+	}
+	for (const auto& rect : moved)
+		list.add (rect);
+
+	CRect area (src);
+	area.unite (dest);
+	if (distance.x > 0)
+		list.add ({area.left, area.top, dest.left, area.bottom});
+	else if (distance.x < 0)
+		list.add ({dest.right, area.top, area.right, area.bottom});
+	if (distance.y > 0)
+		list.add ({area.left, area.top, area.right, dest.top});
+	else if (distance.y < 0)
+		list.add ({area.left, dest.bottom, area.right, area.bottom});
+}
+
+//-----------------------------------------------------------------------------
+/** the part of src which can be copied inside of bounds when its content is moved by distance
+ *
+ *	Content outside of bounds, or moved outside of them, is not copied. The result is empty if the
+ *	distance is larger than the visible part of src, then the destination must be redrawn instead.
+ */
+inline CRect getScrollCopySource (const CRect& bounds, const CRect& src, const CPoint& distance)
+{
+	CRect copySrc (src);
+	copySrc.bound (bounds);
+	CRect movedBounds (bounds);
+	movedBounds.offset (-distance.x, -distance.y);
+	copySrc.bound (movedBounds);
+	return copySrc;
+}
+
+//-----------------------------------------------------------------------------
+/** the bounding rectangle of the area of a back buffer which must be copied to the window
+ *
+ *	A platform frame adds the rectangles it has drawn and the destination rectangles of the
+ *	content it has moved by scrolling.
+ */
+struct CBlitRect
+{
+	void add (const CRect& r)
+	{
+		if (r.isEmpty ())
+			return;
+		if (rect.isEmpty ())
+			rect = r;
+		else
+			rect.unite (r);
+	}
+	void add (const CBlitRect& r) { add (r.rect); }
+
+	bool empty () const { return rect.isEmpty (); }
+	const CRect& get () const { return rect; }
+	void clear () { rect = {}; }
+
+private:
+	CRect rect;
+};
+
 //-----------------------------------------------------------------------------
 } // VSTGUI
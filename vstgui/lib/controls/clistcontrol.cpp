@@ -6,6 +6,7 @@
 #include "../cdrawcontext.h"
 #include "../cframe.h"
 #include "../cgraphicspath.h"
+#include "../crowheightindex.h"
 #include "../cscrollview.h"
 #include "../events.h"
 #include "clistcontrol.h"
@@ -21,6 +22,7 @@ struct CListControl::Impl
 	SharedPointer<IListControlConfigurator> configurator;
 
 	std::vector<CListControlRowDesc> rowDescriptions;
+	CRowHeightIndex rowHeights;
 	Optional<int32_t> hoveredRow {};
 	bool doHoverCheck {false};
 	CCoord minHeight {0.};
@@ -88,7 +90,6 @@ void CListControl::recalculateLayout ()
 	if (!impl->configurator)
 		return;
 
-	CCoord height = 0.;
 	auto numRows = getNumRows ();
 	impl->rowDescriptions.resize (static_cast<size_t> (numRows));
 	impl->doHoverCheck = false;
@@ -96,10 +97,63 @@ void CListControl::recalculateLayout ()
 	for (auto row = 0; row < numRows; ++row)
 	{
 		impl->rowDescriptions[row] = impl->configurator->getRowDesc (row);
-		height += impl->rowDescriptions[row].height;
 		impl->doHoverCheck |= (impl->rowDescriptions[row].flags & CListControlRowDesc::Hoverable) != 0;
 	}
+	impl->rowHeights.build (impl->rowDescriptions.size (),
+	                        [this] (size_t row) { return impl->rowDescriptions[row].height; });
+	updateHeight ();
+}
+
+//------------------------------------------------------------------------
+void CListControl::updateRowDesc (int32_t row)
+{
+	if (!impl->configurator || row < getMinRowIndex () || row > getMaxRowIndex ())
+		return;
+	auto index = getNormalizedRowIndex (row);
+	if (index >= impl->rowDescriptions.size ())
+		return;
+	auto& desc = impl->rowDescriptions[index];
+	desc = impl->configurator->getRowDesc (static_cast<int32_t> (index));
+	impl->doHoverCheck |= (desc.flags & CListControlRowDesc::Hoverable) != 0;
+	if (impl->rowHeights.getHeight (index) != desc.height)
+	{
+		impl->rowHeights.setHeight (index, desc.height);
+		updateHeight ();
+		invalid ();
+	}
+	else
+	{
+		invalidRow (row);
+	}
+}
+
+//------------------------------------------------------------------------
+void CListControl::rowsAppended ()
+{
+	if (!impl->configurator)
+		return;
+	auto numRows = static_cast<size_t> (getNumRows ());
+	if (numRows < impl->rowDescriptions.size ())
+	{
+		recalculateLayout ();
+		return;
+	}
+	impl->rowDescriptions.reserve (numRows);
+	for (auto row = impl->rowDescriptions.size (); row < numRows; ++row)
+	{
+		impl->rowDescriptions.emplace_back (impl->configurator->getRowDesc (static_cast<int32_t> (row)));
+		const auto& desc = impl->rowDescriptions.back ();
+		impl->doHoverCheck |= (desc.flags & CListControlRowDesc::Hoverable) != 0;
+		impl->rowHeights.append (desc.height);
+	}
+	updateHeight ();
+	invalid ();
+}
 
+//------------------------------------------------------------------------
+void CListControl::updateHeight ()
+{
+	CCoord height = impl->rowHeights.getTotalHeight ();
 	if (impl->minHeight > 0 && height < impl->minHeight)
 		height = impl->minHeight;
 
@@ -117,16 +171,13 @@ Optional<CRect> CListControl::getRowRect (int32_t row) const
 {
 	if (row < getMinRowIndex () || row > getMaxRowIndex ())
 		return {};
-	row -= getMinRowIndex ();
+	auto index = getNormalizedRowIndex (row);
+	if (index >= impl->rowHeights.size ())
+		return {};
 	CRect rowSize;
 	rowSize.setWidth (getWidth ());
-	for (auto i = 0u; i < impl->rowDescriptions.size (); ++i)
-	{
-		rowSize.setHeight (impl->rowDescriptions[i].height);
-		if (i == row)
-			break;
-		rowSize.offset (0, impl->rowDescriptions[i].height);
-	}
+	rowSize.setHeight (impl->rowHeights.getHeight (index));
+	rowSize.offset (0, impl->rowHeights.getOffset (index));
 	rowSize.offset (getViewSize ().getTopLeft ());
 	return makeOptional (rowSize);
 }
@@ -143,13 +194,9 @@ Optional<int32_t> CListControl::getRowAtPoint (CPoint where) const
 {
 	where.offsetInverse (getViewSize ().getTopLeft ());
 
-	auto numRows = getNumRows ();
-	for (auto row = 0; row < numRows; ++row)
-	{
-		if (where.y < impl->rowDescriptions[row].height)
-			return {row + getMinRowIndex ()};
-		where.y -= impl->rowDescriptions[row].height;
-	}
+	auto row = impl->rowHeights.getRowAt (where.y);
+	if (row < impl->rowHeights.size ())
+		return {static_cast<int32_t> (row) + getMinRowIndex ()};
 	return {};
 }
 
@@ -176,13 +223,16 @@ void CListControl::drawRect (CDrawContext* context, const CRect& updateRect)
 	if (!getTransparency ())
 		impl->drawer->drawBackground (context, getViewSize ());
 
+	auto numRows = static_cast<int32_t> (impl->rowHeights.size ());
+	auto firstRow = static_cast<int32_t> (
+	    impl->rowHeights.getRowAt (updateRect.top - getViewSize ().top));
 	CRect rowSize;
 	rowSize.setTopLeft (getViewSize ().getTopLeft ());
+	rowSize.offset (0, impl->rowHeights.getOffset (static_cast<size_t> (firstRow)));
 	rowSize.setWidth (getWidth ());
 	rowSize.setHeight (0);
-	auto numRows = getNumRows ();
 	auto selectedRow = static_cast<int32_t> (getNormalizedRowIndex (getIntValue ()));
-	for (auto row = 0; row < numRows; ++row)
+	for (auto row = firstRow; row < numRows && rowSize.top < updateRect.bottom; ++row)
 	{
 		rowSize.setHeight (impl->rowDescriptions[row].height);
 		if (updateRect.rectOverlap (rowSize))
@@ -264,9 +314,15 @@ void CListControl::setMax (float val)
 	if (getMax () != val && val >= getMin ())
 	{
 		auto ov = getValue ();
+		auto appended = val > getMax ();
 		CControl::setMax (val);
 		if (isAttached ())
-			recalculateLayout ();
+		{
+			if (appended)
+				rowsAppended ();
+			else
+				recalculateLayout ();
+		}
 		if (ov != getValue ())
 			valueChanged ();
 	}
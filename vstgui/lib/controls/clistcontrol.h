@@ -36,6 +36,12 @@ public:
 	IListControlConfigurator* getConfigurator () const;
 
 	void recalculateLayout ();
+	/** fetch the description of one row again, use this instead of recalculateLayout if only the
+	 *	height or flags of a single row changed */
+	void updateRowDesc (int32_t row);
+	/** fetch the descriptions of the rows added at the end after the max value was increased,
+	 *	use this instead of recalculateLayout if rows were only appended */
+	void rowsAppended ();
 
 	void invalidRow (int32_t row);
 	Optional<int32_t> getRowAtPoint (CPoint where) const;
@@ -69,6 +75,7 @@ private:
 	size_t getNormalizedRowIndex (int32_t row) const;
 	bool rowSelectable (int32_t row) const;
 	void clearHoveredRow ();
+	void updateHeight ();
 
 	struct Impl;
 	std::unique_ptr<Impl> impl;
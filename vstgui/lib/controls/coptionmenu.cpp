@@ -394,6 +394,9 @@ COptionMenu::COptionMenu ()
 COptionMenu::COptionMenu (const COptionMenu& v)
 : CParamDisplay (v)
 , menuItems (new CMenuItemList (*v.menuItems))
+, model (v.model)
+, modelMenu (v.modelMenu)
+, modelEntriesPending (v.modelEntriesPending)
 , nbItemsPerColumn (v.nbItemsPerColumn)
 , bgWhenClick (v.bgWhenClick)
 {
@@ -491,22 +494,25 @@ void COptionMenu::beforePopup ()
 {
 	if (listeners)
 		listeners->forEach ([this] (IOptionMenuListener* l) { l->onOptionMenuPrePopup (this); });
-	for (auto& menuItem : *menuItems)
+	for (auto& menuItem : *getItems ())
 	{
 		if (auto* commandItem = menuItem.cast<CCommandMenuItem> ())
 			commandItem->validate ();
-		if (menuItem->getSubmenu ())
-			menuItem->getSubmenu ()->beforePopup ();
+		// submenus not filled from the model yet have no command items nor listeners
+		auto submenu = menuItem->getSubmenu ();
+		if (submenu && !submenu->modelEntriesPending)
+			submenu->beforePopup ();
 	}
 }
 
 //------------------------------------------------------------------------
 void COptionMenu::afterPopup ()
 {
-	for (auto& menuItem : *menuItems)
+	for (auto& menuItem : *getItems ())
 	{
-		if (menuItem->getSubmenu ())
-			menuItem->getSubmenu ()->afterPopup ();
+		auto submenu = menuItem->getSubmenu ();
+		if (submenu && !submenu->modelEntriesPending)
+			submenu->afterPopup ();
 	}
 	if (listeners)
 		listeners->forEach ([this] (IOptionMenuListener* l) { l->onOptionMenuPostPopup (this); });
@@ -534,7 +540,7 @@ bool COptionMenu::popup (const PopupCallback& callback)
 	lastResult = -1;
 	lastMenu = nullptr;
 
-	if (!menuItems->empty ())
+	if (getNbEntries () > 0)
 	{
 		getFrame ()->onStartLocalEventLoop ();
 		if (auto platformMenu = getFrame ()->getPlatformFrame ()->createPlatformOptionMenu ())
@@ -585,7 +591,7 @@ bool COptionMenu::popup (const PopupCallback& callback)
 //------------------------------------------------------------------------
 bool COptionMenu::popup (CFrame* frame, const CPoint& frameLocation, const PopupCallback& callback)
 {
-	if (frame == nullptr || menuItems->empty ())
+	if (frame == nullptr || getNbEntries () == 0)
 		return false;
 	if (isAttached ())
 		return false;
@@ -673,6 +679,7 @@ void COptionMenu::setPrefixNumbers (int32_t preCount)
 //-----------------------------------------------------------------------------
 CMenuItem* COptionMenu::addEntry (CMenuItem* item, int32_t index)
 {
+	createModelEntries ();
 	if (index < 0 || index > getNbEntries ())
 		menuItems->emplace_back (owned (item));
 	else
@@ -714,18 +721,65 @@ CMenuItem* COptionMenu::getCurrent () const
 //-----------------------------------------------------------------------------
 CMenuItem* COptionMenu::getEntry (int32_t index) const
 {
-	if (index < 0 || menuItems->empty () || index >= getNbEntries ())
+	if (index < 0 || index >= getNbEntries ())
 		return nullptr;
 	
-	return (*menuItems)[static_cast<size_t> (index)];
+	return (*getItems ())[static_cast<size_t> (index)];
 }
 
 //-----------------------------------------------------------------------------
 int32_t COptionMenu::getNbEntries () const
 {
+	if (modelEntriesPending)
+		return static_cast<int32_t> (model->getNumItems (modelMenu));
 	return static_cast<int32_t> (menuItems->size ());
 }
 
+//-----------------------------------------------------------------------------
+CMenuItemList* COptionMenu::getItems () const
+{
+	createModelEntries ();
+	return menuItems;
+}
+
+//-----------------------------------------------------------------------------
+void COptionMenu::setModel (COptionMenuModel* inModel, COptionMenuModel::Index menu)
+{
+	removeAllEntry ();
+	model = inModel;
+	modelMenu = menu;
+	modelEntriesPending = model && model->isSubmenu (menu);
+}
+
+//-----------------------------------------------------------------------------
+void COptionMenu::createModelEntries () const
+{
+	if (!modelEntriesPending)
+		return;
+	modelEntriesPending = false;
+	menuItems->reserve (menuItems->size () + model->getNumItems (modelMenu));
+	for (auto index = model->getFirstItem (modelMenu); index != COptionMenuModel::kInvalidIndex;
+	     index = model->getNextItem (index))
+	{
+		UTF8String title (model->getTitle (index));
+		if (model->isSubmenu (index))
+		{
+			auto submenu = makeOwned<COptionMenu> ();
+			submenu->setStyle (getStyle ());
+			submenu->model = model;
+			submenu->modelMenu = index;
+			submenu->modelEntriesPending = true;
+			menuItems->emplace_back (makeOwned<CMenuItem> (title, submenu));
+		}
+		else
+		{
+			auto item = makeOwned<CMenuItem> (title, "", 0, nullptr, model->getFlags (index));
+			item->setTag (model->getTag (index));
+			menuItems->emplace_back (std::move (item));
+		}
+	}
+}
+
 //------------------------------------------------------------------------
 COptionMenu* COptionMenu::getSubMenu (int32_t idx) const
 {
@@ -742,7 +796,7 @@ int32_t COptionMenu::getCurrentIndex (bool countSeparator) const
 		return currentIndex;
 	int32_t i = 0;
 	int32_t numSeparators = 0;
-	for (auto& item : *menuItems)
+	for (auto& item : *getItems ())
 	{
 		if (item->isSeparator ())
 			numSeparators++;
@@ -767,7 +821,7 @@ bool COptionMenu::setCurrent (int32_t index, bool countSeparator)
 	else
 	{
 		int32_t i = 0;
-		for (auto& menuItem : *menuItems)
+		for (auto& menuItem : *getItems ())
 		{
 			if (i > index)
 				break;
@@ -790,8 +844,9 @@ bool COptionMenu::setCurrent (int32_t index, bool countSeparator)
 //------------------------------------------------------------------------
 bool COptionMenu::removeEntry (int32_t index)
 {
-	if (index < 0 || menuItems->empty () || index >= getNbEntries ())
+	if (index < 0 || index >= getNbEntries ())
 		return false;
+	createModelEntries ();
 	menuItems->erase (menuItems->begin () + index);
 	return true;
 }
@@ -800,6 +855,8 @@ bool COptionMenu::removeEntry (int32_t index)
 bool COptionMenu::removeAllEntry ()
 {
 	menuItems->clear ();
+	model = nullptr;
+	modelEntriesPending = false;
 	return true;
 }
 
@@ -819,7 +876,7 @@ bool COptionMenu::checkEntry (int32_t index, bool state)
 bool COptionMenu::checkEntryAlone (int32_t index)
 {
 	int32_t pos = 0;
-	for (auto& item : *menuItems)
+	for (auto& item : *getItems ())
 	{
 		item->setChecked (pos == index);
 		pos++;
@@ -7,6 +7,7 @@
 #include "cparamdisplay.h"
 #include "icommandmenuitemtarget.h"
 #include "ioptionmenulistener.h"
+#include "coptionmenumodel.h"
 #include "../cstring.h"
 #include "../dispatchlist.h"
 #include "../cbitmap.h"
@@ -293,7 +294,15 @@ public:
 	/** pops up the menu at frameLocation */
 	bool popup (CFrame* frame, const CPoint& frameLocation, const PopupCallback& callback = {});
 
-	CMenuItemList* getItems () const { return menuItems; }
+	CMenuItemList* getItems () const;
+
+	/** show a menu of model, removes all entries. The entries are created from the model when
+	 *	they are first needed and submenus are filled when they are opened.
+	 */
+	void setModel (COptionMenuModel* model,
+	               COptionMenuModel::Index menu = COptionMenuModel::kRootIndex);
+	COptionMenuModel* getModel () const { return model; }
+	COptionMenuModel::Index getModelMenu () const { return modelMenu; }
 
 	/** remove separators as first and last item and double separators */
 	void cleanupSeparators (bool deep);
@@ -307,7 +316,7 @@ public:
 	void setMin (float val) override {}
 	float getMin () const override { return 0; }
 	void setMax (float val) override {}
-	float getMax () const override { return (float)(menuItems->size () - 1); }
+	float getMax () const override { return (float)(getNbEntries () - 1); }
 
 	void draw (CDrawContext* pContext) override;
 	CMouseEventResult onMouseDown (CPoint& where, const CButtonState& buttons) override;
@@ -321,8 +330,12 @@ protected:
 	bool doPopup ();
 	void beforePopup ();
 	void afterPopup ();
+	void createModelEntries () const;
 
 	CMenuItemList* menuItems;
+	SharedPointer<COptionMenuModel> model;
+	COptionMenuModel::Index modelMenu {COptionMenuModel::kRootIndex};
+	mutable bool modelEntriesPending {false};
 
 	bool inPopup {false};
 	int32_t currentIndex {-1};
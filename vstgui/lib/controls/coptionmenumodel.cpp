@@ -0,0 +1,133 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "coptionmenumodel.h"
+#include "coptionmenu.h"
+#include <cstring>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+
+//------------------------------------------------------------------------
+COptionMenuModel::COptionMenuModel ()
+{
+	clear ();
+}
+
+//------------------------------------------------------------------------
+void COptionMenuModel::reserve (size_t numItems, size_t numTitleBytes)
+{
+	nodes.reserve (numItems + 1);
+	titles.reserve (numTitleBytes + numItems + 1);
+}
+
+//------------------------------------------------------------------------
+void COptionMenuModel::clear ()
+{
+	nodes.clear ();
+	titles.assign (1, '\0');
+	nodes.emplace_back (Node {0, kSubmenuNode, -1});
+}
+
+//------------------------------------------------------------------------
+auto COptionMenuModel::addNode (Index menu, UTF8StringPtr title, int32_t tag, uint32_t flags)
+    -> Index
+{
+	vstgui_assert (menu < nodes.size () && (nodes[menu].flags & kSubmenuNode));
+	if (menu >= nodes.size () || !(nodes[menu].flags & kSubmenuNode))
+		return kInvalidIndex;
+
+	// all empty titles share the terminator at the start of the arena
+	uint32_t titleOffset = 0;
+	if (title && *title)
+	{
+		titleOffset = static_cast<uint32_t> (titles.size ());
+		titles.append (title, strlen (title) + 1);
+	}
+	auto index = static_cast<Index> (nodes.size ());
+	nodes.emplace_back (Node {titleOffset, flags, tag});
+
+	auto& parent = nodes[menu];
+	if (parent.lastChild == kInvalidIndex)
+		parent.firstChild = index;
+	else
+		nodes[parent.lastChild].nextSibling = index;
+	parent.lastChild = index;
+	++parent.numChildren;
+	return index;
+}
+
+//------------------------------------------------------------------------
+auto COptionMenuModel::addItem (Index menu, UTF8StringPtr title, int32_t tag, int32_t flags)
+    -> Index
+{
+	if (title && strcmp (title, "-") == 0)
+		return addSeparator (menu);
+	return addNode (menu, title, tag, static_cast<uint32_t> (flags) & ~kSubmenuNode);
+}
+
+//------------------------------------------------------------------------
+auto COptionMenuModel::addSubmenu (Index menu, UTF8StringPtr title) -> Index
+{
+	return addNode (menu, title, -1, kSubmenuNode);
+}
+
+//------------------------------------------------------------------------
+auto COptionMenuModel::addSeparator (Index menu) -> Index
+{
+	return addNode (menu, nullptr, -1, CMenuItem::kSeparator);
+}
+
+//------------------------------------------------------------------------
+uint32_t COptionMenuModel::getNumItems (Index menu) const
+{
+	return menu < nodes.size () ? nodes[menu].numChildren : 0;
+}
+
+//------------------------------------------------------------------------
+auto COptionMenuModel::getFirstItem (Index menu) const -> Index
+{
+	return menu < nodes.size () ? nodes[menu].firstChild : kInvalidIndex;
+}
+
+//------------------------------------------------------------------------
+auto COptionMenuModel::getNextItem (Index item) const -> Index
+{
+	return item < nodes.size () ? nodes[item].nextSibling : kInvalidIndex;
+}
+
+//------------------------------------------------------------------------
+UTF8StringView COptionMenuModel::getTitle (Index item) const
+{
+	if (item >= nodes.size ())
+		return UTF8StringView ("");
+	return UTF8StringView (titles.data () + nodes[item].titleOffset);
+}
+
+//------------------------------------------------------------------------
+int32_t COptionMenuModel::getTag (Index item) const
+{
+	return item < nodes.size () ? nodes[item].tag : -1;
+}
+
+//------------------------------------------------------------------------
+int32_t COptionMenuModel::getFlags (Index item) const
+{
+	return item < nodes.size () ? static_cast<int32_t> (nodes[item].flags & ~kSubmenuNode) : 0;
+}
+
+//------------------------------------------------------------------------
+bool COptionMenuModel::isSubmenu (Index item) const
+{
+	return item < nodes.size () && (nodes[item].flags & kSubmenuNode);
+}
+
+//------------------------------------------------------------------------
+size_t COptionMenuModel::getMemoryUsage () const
+{
+	return sizeof (*this) + nodes.capacity () * sizeof (Node) + titles.capacity ();
+}
+
+//------------------------------------------------------------------------
+} // VSTGUI
@@ -0,0 +1,92 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#pragma once
+
+#include "../cstring.h"
+#include "../vstguibase.h"
+#include <limits>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+
+//------------------------------------------------------------------------
+/** Compact storage for large menu trees
+ *
+ *	All titles are stored in one string arena and every item is a small fixed size record which
+ *	references its first child and next sibling by index. So building a menu tree with tens of
+ *	thousands of items costs only a few allocations and no CMenuItem or COptionMenu is created.
+ *
+ *	A COptionMenu shows a menu of the model via COptionMenu::setModel (). It creates the CMenuItems
+ *	of a menu when they are first needed and the COptionMenus of submenus are only filled when
+ *	they are opened.
+ *
+ *	The model should not be changed while a COptionMenu shows it.
+ */
+class COptionMenuModel : public NonAtomicReferenceCounted
+{
+public:
+	using Index = uint32_t;
+
+	static constexpr Index kRootIndex = 0;
+	static constexpr Index kInvalidIndex = std::numeric_limits<Index>::max ();
+
+	COptionMenuModel ();
+
+	/** reserve memory for numItems items with numTitleBytes bytes of titles in total */
+	void reserve (size_t numItems, size_t numTitleBytes = 0);
+	/** remove all items */
+	void clear ();
+
+	/** add an item to menu, flags are the CMenuItem::Flags, a title of "-" adds a separator */
+	Index addItem (Index menu, UTF8StringPtr title, int32_t tag = -1, int32_t flags = 0);
+	/** add a submenu to menu, returns the index of the submenu to add items to */
+	Index addSubmenu (Index menu, UTF8StringPtr title);
+	/** add a separator to menu */
+	Index addSeparator (Index menu);
+
+	/** the number of items of menu */
+	uint32_t getNumItems (Index menu) const;
+	/** the index of the first item of menu or kInvalidIndex if menu is empty */
+	Index getFirstItem (Index menu) const;
+	/** the index of the item following item or kInvalidIndex if item is the last one */
+	Index getNextItem (Index item) const;
+
+	UTF8StringView getTitle (Index item) const;
+	int32_t getTag (Index item) const;
+	int32_t getFlags (Index item) const;
+	bool isSubmenu (Index item) const;
+
+	/** the number of items in the whole tree */
+	size_t getTotalNumItems () const { return nodes.size () - 1; }
+	/** the number of bytes allocated by the model */
+	size_t getMemoryUsage () const;
+
+private:
+	enum NodeFlags : uint32_t
+	{
+		kSubmenuNode = 1u << 31
+	};
+
+	struct Node
+	{
+		uint32_t titleOffset;
+		uint32_t flags;
+		int32_t tag;
+		Index firstChild {kInvalidIndex};
+		Index lastChild {kInvalidIndex};
+		Index nextSibling {kInvalidIndex};
+		uint32_t numChildren {0};
+	};
+
+	Index addNode (Index menu, UTF8StringPtr title, int32_t tag, uint32_t flags);
+
+	std::vector<Node> nodes;
+	std::string titles;
+};
+
+//------------------------------------------------------------------------
+} // VSTGUI
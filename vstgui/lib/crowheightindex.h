@@ -0,0 +1,130 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#pragma once
+
+#include "vstguibase.h"
+#include <algorithm>
+#include <vector>
+
+namespace VSTGUI {
+
+//-----------------------------------------------------------------------------
+/** Prefix sum index over the heights of rows (a Fenwick tree)
+ *
+ *	Converts between rows and vertical positions in O(log n) and supports changing the height of
+ *	individual rows in O(log n).
+ */
+struct CRowHeightIndex
+{
+	/** build the index with the height returned by proc (row) for every row in O(n) */
+	template<typename Proc>
+	void build (size_t numRows, Proc proc);
+
+	size_t size () const { return heights.size (); }
+	bool empty () const { return heights.empty (); }
+	void clear ();
+
+	/** the height of the row */
+	CCoord getHeight (size_t row) const { return heights[row]; }
+	/** change the height of the row */
+	void setHeight (size_t row, CCoord height);
+	/** add a row at the end in O(log n) */
+	void append (CCoord height);
+	/** the position of the top of the row, this is the sum of all heights of the rows before */
+	CCoord getOffset (size_t row) const;
+	/** the sum of all heights */
+	CCoord getTotalHeight () const { return getOffset (heights.size ()); }
+	/** the row at position, returns size () if position is below the last row */
+	size_t getRowAt (CCoord position) const;
+
+private:
+	std::vector<CCoord> heights;
+	std::vector<CCoord> tree; // one based
+	size_t topBit {0};
+};
+
+//-----------------------------------------------------------------------------
+template<typename Proc>
+inline void CRowHeightIndex::build (size_t numRows, Proc proc)
+{
+	heights.resize (numRows);
+	tree.assign (numRows + 1, 0.);
+	for (size_t row = 0; row < numRows; ++row)
+	{
+		heights[row] = proc (row);
+		auto index = row + 1;
+		tree[index] += heights[row];
+		auto parent = index + (index & (~index + 1));
+		if (parent <= numRows)
+			tree[parent] += tree[index];
+	}
+	topBit = 1;
+	while ((topBit << 1) <= numRows)
+		topBit <<= 1;
+}
+
+//-----------------------------------------------------------------------------
+inline void CRowHeightIndex::clear ()
+{
+	heights.clear ();
+	tree.clear ();
+	topBit = 0;
+}
+
+//-----------------------------------------------------------------------------
+inline void CRowHeightIndex::setHeight (size_t row, CCoord height)
+{
+	auto diff = height - heights[row];
+	if (diff == 0.)
+		return;
+	heights[row] = height;
+	for (auto index = row + 1; index < tree.size (); index += index & (~index + 1))
+		tree[index] += diff;
+}
+
+//-----------------------------------------------------------------------------
+inline void CRowHeightIndex::append (CCoord height)
+{
+	if (tree.empty ())
+		tree.emplace_back (0.);
+	heights.emplace_back (height);
+	// the new node covers the rows (index - lowest bit, index]
+	auto index = heights.size ();
+	auto first = index - (index & (~index + 1));
+	tree.emplace_back (height + getOffset (index - 1) - getOffset (first));
+	if ((topBit << 1) <= index)
+		topBit = topBit ? topBit << 1 : 1;
+}
+
+//-----------------------------------------------------------------------------
+inline CCoord CRowHeightIndex::getOffset (size_t row) const
+{
+	CCoord result = 0.;
+	for (auto index = std::min (row, heights.size ()); index > 0; index &= index - 1)
+		result += tree[index];
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+inline size_t CRowHeightIndex::getRowAt (CCoord position) const
+{
+	if (position < 0.)
+		return 0;
+	// find the number of rows which end at or above position
+	size_t index = 0;
+	for (auto bit = topBit; bit > 0; bit >>= 1)
+	{
+		auto next = index + bit;
+		if (next < tree.size () && tree[next] <= position)
+		{
+			index = next;
+			position -= tree[next];
+		}
+	}
+	return index;
+}
+
+//-----------------------------------------------------------------------------
+} // VSTGUI
@@ -7,11 +7,236 @@
 #include "cbitmapfilter.h"
 #include "cframe.h"
 #include "cbitmap.h"
+#include "cvstguitimer.h"
+#include "vstguitrace.h"
+#include "platform/iplatformbitmap.h"
 #include <cassert>
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <vector>
 
 namespace VSTGUI {
 
+//-----------------------------------------------------------------------------
+struct CShadowViewContainer::Shadow
+{
+	struct Key
+	{
+		CPoint pixelSize;
+		double scaleFactor {1.};
+		double blurSize {0.};
+		uint64_t hash {0};
+
+		bool operator== (const Key& other) const
+		{
+			return pixelSize == other.pixelSize && scaleFactor == other.scaleFactor &&
+				   blurSize == other.blurSize && hash == other.hash;
+		}
+	};
+
+	Key key;
+	/** the alpha channel of the silhouette */
+	std::vector<uint8_t> mask;
+	/** the silhouette, it must not be used by the UI thread until the shadow is ready */
+	SharedPointer<CBitmap> bitmap;
+	/** the bitmap is blurred */
+	std::atomic<bool> ready {false};
+	double blurTime {0.};
+
+	bool equals (const Shadow& other) const { return key == other.key && mask == other.mask; }
+};
+
+//-----------------------------------------------------------------------------
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+//-----------------------------------------------------------------------------
+double millisecondsSince (Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli> (Clock::now () - start).count ();
+}
+
+//-----------------------------------------------------------------------------
+CShadowViewContainer::ShadowStatistics& statistics ()
+{
+	static CShadowViewContainer::ShadowStatistics gStatistics;
+	return gStatistics;
+}
+
+//-----------------------------------------------------------------------------
+/** copy the alpha channel of the bitmap into the mask of the shadow and hash it */
+bool readMask (CShadowViewContainer::Shadow& shadow)
+{
+	auto platformBitmap = shadow.bitmap->getPlatformBitmap ();
+	auto access = platformBitmap ? platformBitmap->lockPixels (true) : nullptr;
+	if (!access)
+		return false;
+	auto width = static_cast<uint32_t> (platformBitmap->getSize ().x);
+	auto height = static_cast<uint32_t> (platformBitmap->getSize ().y);
+	uint32_t alphaOffset = 0;
+	switch (access->getPixelFormat ())
+	{
+		case IPlatformBitmapPixelAccess::kARGB:
+		case IPlatformBitmapPixelAccess::kABGR: alphaOffset = 0; break;
+		case IPlatformBitmapPixelAccess::kRGBA:
+		case IPlatformBitmapPixelAccess::kBGRA: alphaOffset = 3; break;
+	}
+	shadow.mask.resize (static_cast<size_t> (width) * height);
+	// FNV-1a
+	uint64_t hash = 14695981039346656037ull;
+	auto maskPtr = shadow.mask.data ();
+	for (auto y = 0u; y < height; ++y)
+	{
+		auto pixel = access->getAddress () + y * access->getBytesPerRow () + alphaOffset;
+		for (auto x = 0u; x < width; ++x, pixel += 4, ++maskPtr)
+		{
+			*maskPtr = *pixel;
+			hash = (hash ^ *pixel) * 1099511628211ull;
+		}
+	}
+	shadow.key.pixelSize = platformBitmap->getSize ();
+	shadow.key.hash = hash;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+template <size_t numBoxes>
+std::array<int32_t, numBoxes> boxesForGauss (double sigma)
+{
+	std::array<int32_t, numBoxes> boxes;
+	double ideal = std::sqrt ((12 * sigma * sigma / numBoxes) + 1);
+	uint16_t l = static_cast<uint16_t> (std::floor (ideal));
+	if (l % 2 == 0)
+		l--;
+	int32_t u = l + 2;
+	ideal = ((12. * sigma * sigma) - (numBoxes * l * l) - (4. * numBoxes * l) - (3. * numBoxes)) / ((-4. * l) - 4.);
+	int32_t m = static_cast<int32_t> (std::floor (ideal));
+	for (int32_t i = 0; i < numBoxes; ++i)
+		boxes[i] = (i < m ? l : u);
+	return boxes;
+}
+
+//-----------------------------------------------------------------------------
+/** turn the silhouette into the shadow, this may run on a background thread */
+void blurShadow (CShadowViewContainer::Shadow& shadow)
+{
+	VSTGUI_TRACE_SCOPE ("CShadowViewContainer::blurShadow");
+	auto start = Clock::now ();
+	{
+		auto bitmap = shadow.bitmap.get ();
+		SharedPointer<BitmapFilter::IFilter> setColorFilter = owned (BitmapFilter::Factory::getInstance ().createFilter (BitmapFilter::Standard::kSetColor));
+		if (setColorFilter)
+		{
+			setColorFilter->setProperty (BitmapFilter::Standard::Property::kInputBitmap, bitmap);
+			setColorFilter->setProperty (BitmapFilter::Standard::Property::kInputColor, kBlackCColor);
+			setColorFilter->setProperty (BitmapFilter::Standard::Property::kIgnoreAlphaColorValue, (int32_t)1);
+			if (setColorFilter->run (true))
+			{
+				SharedPointer<BitmapFilter::IFilter> boxBlurFilter = owned (BitmapFilter::Factory::getInstance ().createFilter (BitmapFilter::Standard::kBoxBlur));
+				if (boxBlurFilter)
+				{
+					auto boxSizes = boxesForGauss<3> (shadow.key.blurSize);
+					boxBlurFilter->setProperty (BitmapFilter::Standard::Property::kInputBitmap, bitmap);
+					boxBlurFilter->setProperty (BitmapFilter::Standard::Property::kRadius, boxSizes[0]);
+					boxBlurFilter->setProperty (BitmapFilter::Standard::Property::kAlphaChannelOnly, 1);
+					if (boxBlurFilter->run (true))
+					{
+						boxBlurFilter->setProperty (BitmapFilter::Standard::Property::kRadius, boxSizes[1]);
+						boxBlurFilter->run (true);
+						boxBlurFilter->setProperty (BitmapFilter::Standard::Property::kRadius, boxSizes[2]);
+						boxBlurFilter->run (true);
+					}
+				}
+			}
+		}
+		// the filters release their references to the bitmap here, before the UI thread may
+		// use it
+	}
+	shadow.blurTime = millisecondsSince (start);
+	shadow.ready.store (true, std::memory_order_release);
+}
+
+//-----------------------------------------------------------------------------
+void recordBlur (const CShadowViewContainer::Shadow& shadow)
+{
+	auto& stats = statistics ();
+	++stats.numBlurredShadows;
+	stats.blurTime += shadow.blurTime;
+	stats.maxBlurTime = std::max (stats.maxBlurTime, shadow.blurTime);
+}
+
+//-----------------------------------------------------------------------------
+/** the shadows of all containers, only used on the UI thread */
+class ShadowCache
+{
+public:
+	using ShadowPtr = CShadowViewContainer::ShadowPtr;
+
+	static ShadowCache& instance ()
+	{
+		static ShadowCache gInstance;
+		return gInstance;
+	}
+
+	ShadowPtr find (const CShadowViewContainer::Shadow& shadow)
+	{
+		collect ();
+		for (const auto& entry : entries)
+		{
+			auto cached = entry.lock ();
+			if (cached && cached->equals (shadow))
+				return cached;
+		}
+		return nullptr;
+	}
+
+	void add (const ShadowPtr& shadow) { entries.emplace_back (shadow); }
+
+	void blurAsync (const ShadowPtr& shadow)
+	{
+		// the job keeps the shadow alive until the blur is finished
+		auto raw = shadow.get ();
+		running.emplace_back (
+			Job {shadow, std::async (std::launch::async, [raw] () { blurShadow (*raw); })});
+	}
+
+	/** remove finished jobs and unused shadows */
+	void collect ()
+	{
+		running.erase (std::remove_if (running.begin (), running.end (),
+									   [] (Job& job) {
+										   if (!job.shadow->ready.load (std::memory_order_acquire))
+											   return false;
+										   job.worker.wait ();
+										   recordBlur (*job.shadow);
+										   return true;
+									   }),
+					   running.end ());
+		entries.erase (std::remove_if (entries.begin (), entries.end (),
+									   [] (const std::weak_ptr<CShadowViewContainer::Shadow>& entry) {
+										   return entry.expired ();
+									   }),
+					   entries.end ());
+	}
+
+private:
+	struct Job
+	{
+		ShadowPtr shadow;
+		std::future<void> worker;
+	};
+
+	std::vector<std::weak_ptr<CShadowViewContainer::Shadow>> entries;
+	std::vector<Job> running;
+};
+
+} // anonymous
+
 //-----------------------------------------------------------------------------
 CShadowViewContainer::CShadowViewContainer (const CRect& size)
 : CViewContainer (size)
@@ -41,6 +266,8 @@ CShadowViewContainer::~CShadowViewContainer () noexcept = default;
 void CShadowViewContainer::beforeDelete ()
 {
 	unregisterViewContainerListener (this);
+	queuedShadow = nullptr;
+	setPendingShadow (nullptr);
 	CViewContainer::beforeDelete ();
 }
 
@@ -48,7 +275,8 @@ void CShadowViewContainer::beforeDelete ()
 bool CShadowViewContainer::removed (CView* parent)
 {
 	getFrame ()->unregisterScaleFactorChangedListener (this);
-	setBackground (nullptr);
+	queuedShadow = nullptr;
+	setShadow (nullptr);
 	return CViewContainer::removed (parent);
 }
 
@@ -108,28 +336,23 @@ void CShadowViewContainer::invalidateShadow ()
 }
 
 //-----------------------------------------------------------------------------
-CMessageResult CShadowViewContainer::notify (CBaseObject* sender, IdStringPtr message)
+auto CShadowViewContainer::getShadowStatistics () -> const ShadowStatistics&
 {
-	if (message == kMsgViewSizeChanged)
-		invalidateShadow ();
-	return CViewContainer::notify(sender, message);
+	return statistics ();
 }
 
 //-----------------------------------------------------------------------------
-template <size_t numBoxes>
-static std::array<int32_t, numBoxes> boxesForGauss (double sigma)
+void CShadowViewContainer::resetShadowStatistics ()
 {
-	std::array<int32_t, numBoxes> boxes;
-	double ideal = std::sqrt ((12 * sigma * sigma / numBoxes) + 1);
-	uint16_t l = static_cast<uint16_t> (std::floor (ideal));
-	if (l % 2 == 0)
-		l--;
-	int32_t u = l + 2;
-	ideal = ((12. * sigma * sigma) - (numBoxes * l * l) - (4. * numBoxes * l) - (3. * numBoxes)) / ((-4. * l) - 4.);
-	int32_t m = static_cast<int32_t> (std::floor (ideal));
-	for (int32_t i = 0; i < numBoxes; ++i)
-		boxes[i] = (i < m ? l : u);
-	return boxes;
+	statistics () = {};
+}
+
+//-----------------------------------------------------------------------------
+CMessageResult CShadowViewContainer::notify (CBaseObject* sender, IdStringPtr message)
+{
+	if (message == kMsgViewSizeChanged)
+		invalidateShadow ();
+	return CViewContainer::notify(sender, message);
 }
 
 //-----------------------------------------------------------------------------
@@ -149,60 +372,144 @@ void CShadowViewContainer::drawRect (CDrawContext* pContext, const CRect& update
 		if (matrixScale != 0.)
 			scaleFactor *= matrixScale;
 	}
+	checkPendingShadow ();
 	if (scaleFactor != scaleFactorUsed && getWidth () > 0. && getHeight () > 0.)
 	{
 		scaleFactorUsed = scaleFactor;
-		CCoord width = getWidth ();
-		CCoord height = getHeight ();
-		
-		if (auto offscreenContext = COffscreenContext::create ({width, height}, scaleFactor))
-		{
-			offscreenContext->beginDraw ();
-			CDrawContext::Transform transform (*offscreenContext, CGraphicsTransform ().translate (-getViewSize ().left - shadowOffset.x, -getViewSize ().top - shadowOffset.y));
-			dontDrawBackground = true;
-			CViewContainer::draw (offscreenContext);
-			dontDrawBackground = false;
-			offscreenContext->endDraw ();
-			CBitmap* bitmap = offscreenContext->getBitmap ();
-			if (bitmap)
-			{
-				setBackground (bitmap);
-				SharedPointer<BitmapFilter::IFilter> setColorFilter = owned (BitmapFilter::Factory::getInstance ().createFilter (BitmapFilter::Standard::kSetColor));
-				if (setColorFilter)
-				{
-					setColorFilter->setProperty (BitmapFilter::Standard::Property::kInputBitmap, bitmap);
-					setColorFilter->setProperty (BitmapFilter::Standard::Property::kInputColor, kBlackCColor);
-					setColorFilter->setProperty (BitmapFilter::Standard::Property::kIgnoreAlphaColorValue, (int32_t)1);
-					if (setColorFilter->run (true))
-					{
-						SharedPointer<BitmapFilter::IFilter> boxBlurFilter = owned (BitmapFilter::Factory::getInstance ().createFilter (BitmapFilter::Standard::kBoxBlur));
-						if (boxBlurFilter)
-						{
-							auto boxSizes = boxesForGauss<3> (shadowBlurSize);
-							boxBlurFilter->setProperty (BitmapFilter::Standard::Property::kInputBitmap, bitmap);
-							boxBlurFilter->setProperty (BitmapFilter::Standard::Property::kRadius, boxSizes[0]);
-							boxBlurFilter->setProperty (BitmapFilter::Standard::Property::kAlphaChannelOnly, 1);
-							if (boxBlurFilter->run (true))
-							{
-								boxBlurFilter->setProperty (BitmapFilter::Standard::Property::kRadius, boxSizes[1]);
-								boxBlurFilter->run (true);
-								boxBlurFilter->setProperty (BitmapFilter::Standard::Property::kRadius, boxSizes[2]);
-								boxBlurFilter->run (true);
-							}
-						}
-					}
-				}
+		updateShadow (scaleFactor);
+	}
+	CViewContainer::drawRect (pContext, updateRect);
+}
 
-				CViewContainer::drawRect (pContext, updateRect);
-			}
-		}
+//-----------------------------------------------------------------------------
+void CShadowViewContainer::updateShadow (double scaleFactor)
+{
+	VSTGUI_TRACE_OBJECT_SCOPE ("CShadowViewContainer::renderShadow", this);
+	auto newShadow = std::make_shared<Shadow> ();
+	newShadow->key.scaleFactor = scaleFactor;
+	newShadow->key.blurSize = shadowBlurSize;
+	{
+		auto start = Clock::now ();
+		auto offscreenContext = COffscreenContext::create ({getWidth (), getHeight ()}, scaleFactor);
+		if (!offscreenContext)
+			return;
+		offscreenContext->beginDraw ();
+		CDrawContext::Transform transform (*offscreenContext, CGraphicsTransform ().translate (-getViewSize ().left - shadowOffset.x, -getViewSize ().top - shadowOffset.y));
+		dontDrawBackground = true;
+		CViewContainer::draw (offscreenContext);
+		dontDrawBackground = false;
+		offscreenContext->endDraw ();
+		newShadow->bitmap = offscreenContext->getBitmap ();
+		++statistics ().numRenderedShadows;
+		statistics ().renderTime += millisecondsSince (start);
+		// the offscreen context must release the bitmap before it is blurred on another thread
+	}
+	if (!newShadow->bitmap)
+		return;
+
+	if (!readMask (*newShadow))
+	{
+		// without access to the pixels the shadow cannot be shared
+		blurShadow (*newShadow);
+		recordBlur (*newShadow);
+		setShadow (newShadow);
+		return;
+	}
+	if (pendingShadow && !pendingShadow->ready.load (std::memory_order_acquire))
+	{
+		// only one blur per container, the latest silhouette waits until the pending shadow is
+		// ready and the silhouettes in between are dropped
+		if (pendingShadow->equals (*newShadow))
+			queuedShadow = nullptr;
+		else if (shadow && shadow->equals (*newShadow))
+			queuedShadow = shadow;
+		else
+			queuedShadow = newShadow;
+		return;
+	}
+	applyShadow (newShadow);
+}
+
+//-----------------------------------------------------------------------------
+void CShadowViewContainer::applyShadow (const ShadowPtr& newShadow)
+{
+	if (shadow && shadow->equals (*newShadow))
+	{
+		// the silhouette did not change
+		setPendingShadow (nullptr);
+		return;
+	}
+	auto& cache = ShadowCache::instance ();
+	if (auto cached = cache.find (*newShadow))
+	{
+		++statistics ().numSharedShadows;
+		if (cached->ready.load (std::memory_order_acquire))
+			setShadow (cached);
+		else
+			setPendingShadow (cached);
+		return;
+	}
+	cache.add (newShadow);
+	if (shadow)
+	{
+		++statistics ().numAsyncBlurs;
+		cache.blurAsync (newShadow);
+		setPendingShadow (newShadow);
 	}
 	else
 	{
-		CViewContainer::drawRect (pContext, updateRect);
+		// there is no previous shadow to draw meanwhile
+		blurShadow (*newShadow);
+		recordBlur (*newShadow);
+		setShadow (newShadow);
 	}
 }
 
+//-----------------------------------------------------------------------------
+void CShadowViewContainer::setShadow (const ShadowPtr& newShadow)
+{
+	shadow = newShadow;
+	setPendingShadow (nullptr);
+	setBackground (shadow ? shadow->bitmap : nullptr);
+}
+
+//-----------------------------------------------------------------------------
+void CShadowViewContainer::setPendingShadow (const ShadowPtr& newShadow)
+{
+	pendingShadow = newShadow;
+	if (!pendingShadow)
+	{
+		if (pendingShadowTimer)
+		{
+			pendingShadowTimer->stop ();
+			pendingShadowTimer = nullptr;
+		}
+	}
+	else if (!pendingShadowTimer)
+	{
+		pendingShadowTimer = makeOwned<CVSTGUITimer> (
+			[this] (CVSTGUITimer*) {
+				ShadowCache::instance ().collect ();
+				if (checkPendingShadow ())
+					invalid ();
+			},
+			16);
+	}
+}
+
+//-----------------------------------------------------------------------------
+bool CShadowViewContainer::checkPendingShadow ()
+{
+	if (!pendingShadow || !pendingShadow->ready.load (std::memory_order_acquire))
+		return false;
+	ShadowCache::instance ().collect ();
+	auto queued = std::move (queuedShadow);
+	setShadow (pendingShadow);
+	if (queued)
+		applyShadow (queued);
+	return true;
+}
+
 //-----------------------------------------------------------------------------
 void CShadowViewContainer::drawBackgroundRect (CDrawContext* pContext, const CRect& _updateRect)
 {
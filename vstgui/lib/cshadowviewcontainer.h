@@ -7,6 +7,7 @@
 #include "cviewcontainer.h"
 #include "iviewlistener.h"
 #include "iscalefactorchangedlistener.h"
+#include <memory>
 
 namespace VSTGUI {
 
@@ -15,6 +16,13 @@ namespace VSTGUI {
 //! @brief a view container which draws a shadow for it's subviews
 /// @ingroup containerviews
 /// @ingroup new_in_4_1
+///
+/// The shadow is the blurred silhouette of the subviews. Blurred shadows are shared by all
+/// shadow view containers, so containers with the same silhouette, blur size and scale factor
+/// blur it only once. When the silhouette changes, the new shadow is blurred on a background
+/// thread and the previous shadow is drawn until it is ready. A container blurs only one shadow
+/// at a time, a silhouette change during the blur is blurred when it is finished and only the
+/// latest of several changes is kept.
 //-----------------------------------------------------------------------------
 class CShadowViewContainer : public CViewContainer,
                              public IScaleFactorChangedListener,
@@ -39,8 +47,29 @@ public:
 	double getShadowBlurSize () const { return shadowBlurSize; }
 
 	void invalidateShadow ();
+	/** a new shadow is blurred on a background thread */
+	bool isShadowPending () const { return pendingShadow != nullptr; }
 	//@}
 
+	/** statistics of all shadow view containers */
+	struct ShadowStatistics
+	{
+		/** silhouettes drawn on the UI thread */
+		uint64_t numRenderedShadows {0};
+		uint64_t numBlurredShadows {0};
+		/** blurs on a background thread */
+		uint64_t numAsyncBlurs {0};
+		/** silhouettes which were already blurred or are being blurred */
+		uint64_t numSharedShadows {0};
+		/** milliseconds spent drawing the silhouettes */
+		double renderTime {0.};
+		/** milliseconds spent blurring, on the UI thread or in the background */
+		double blurTime {0.};
+		double maxBlurTime {0.};
+	};
+	static const ShadowStatistics& getShadowStatistics ();
+	static void resetShadowStatistics ();
+
 	// override
 	bool removed (CView* parent) override;
 	bool attached (CView* parent) override;
@@ -52,6 +81,12 @@ public:
 	void onScaleFactorChanged (CFrame* frame, double newScaleFactor) override;
 
 	CLASS_METHODS(CShadowViewContainer, CViewContainer)
+
+	/// @cond ignore
+	struct Shadow;
+	using ShadowPtr = std::shared_ptr<Shadow>;
+	/// @endcond
+
 protected:
 	void viewContainerViewAdded (CViewContainer* container, CView* view) override;
 	void viewContainerViewRemoved (CViewContainer* container, CView* view) override;
@@ -59,11 +94,22 @@ protected:
 
 	void beforeDelete () override;
 
+	void updateShadow (double scaleFactor);
+	void setShadow (const ShadowPtr& newShadow);
+	void applyShadow (const ShadowPtr& newShadow);
+	void setPendingShadow (const ShadowPtr& newShadow);
+	bool checkPendingShadow ();
+
 	bool dontDrawBackground;
 	CPoint shadowOffset;
 	float shadowIntensity;
 	double shadowBlurSize;
 	double scaleFactorUsed;
+	ShadowPtr shadow;
+	ShadowPtr pendingShadow;
+	/** the latest silhouette, which is blurred when the pending shadow is ready */
+	ShadowPtr queuedShadow;
+	SharedPointer<CVSTGUITimer> pendingShadowTimer;
 };
 
 } // VSTGUI
@@ -17,6 +17,8 @@
 #include "dispatchlist.h"
 #include "events.h"
 #include "finally.h"
+#include "cdrawprofiler.h"
+#include "vstguitrace.h"
 
 #include <algorithm>
 #include <cassert>
@@ -845,6 +847,7 @@ void CViewContainer::drawRect (CDrawContext* pContext, const CRect& updateRect)
 		_focusView = frame->getFocusView ();
 		_focusDrawing = dynamic_cast<IFocusDrawing*> (_focusView);
 	}
+	auto profiler = frame ? frame->getDrawProfiler () : nullptr;
 
 	{
 		CDrawContext::Transform tr (*pContext, getTransform ());
@@ -889,7 +892,14 @@ void CViewContainer::drawRect (CDrawContext* pContext, const CRect& updateRect)
 					pContext->setClipRect (viewSize);
 					float globalContextAlpha = pContext->getGlobalAlpha ();
 					pContext->setGlobalAlpha (globalContextAlpha * pV->getAlphaValue ());
-					pV->drawRect (pContext, viewSize);
+					if (profiler)
+						profiler->beginView (pV);
+					{
+						VSTGUI_TRACE_VIEW_DRAW (pV.get ());
+						pV->drawRect (pContext, viewSize);
+					}
+					if (profiler)
+						profiler->endView (pV);
 					pContext->setGlobalAlpha (globalContextAlpha);
 				}
 			}
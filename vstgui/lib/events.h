@@ -342,6 +342,13 @@ struct MouseMoveEvent : MouseDownUpMoveEvent
 	{
 		type = EventType::MouseMove;
 	}
+
+	/** positions of earlier move events which were merged into this event by the platform, oldest
+	 *	first and in frame coordinates. Only set if the platform coalesces mouse move events and
+	 *	keeps their history (see InputEventCoalescer).
+	 */
+	const CPoint* coalescedPositions {nullptr};
+	uint32_t numCoalescedPositions {0};
 };
 
 //------------------------------------------------------------------------
@@ -8,6 +8,7 @@
 #include "cvstguitimer.h"
 #include "genericstringlistdatabrowsersource.h"
 #include "platform/iplatformfont.h"
+#include <algorithm>
 
 //------------------------------------------------------------------------
 namespace VSTGUI {
@@ -27,6 +28,7 @@ GenericStringListDataBrowserSource::GenericStringListDataBrowserSource (
 , drawFont (kSystemFont)
 , dataBrowser (nullptr)
 , delegate (delegate)
+, searchIndex (stringList)
 {
 }
 
@@ -49,10 +51,71 @@ void GenericStringListDataBrowserSource::dbRemoved (CDataBrowser* browser)
 void GenericStringListDataBrowserSource::setStringList (const StringVector* inStringList)
 {
 	stringList = inStringList;
+	searchIndex.setStringList (stringList);
+	updateFilteredRows ();
 	if (dataBrowser)
 		dataBrowser->recalculateLayout (true);
 }
 
+//-----------------------------------------------------------------------------
+void GenericStringListDataBrowserSource::setFilter (const UTF8String& inFilter, FilterMode mode)
+{
+	if (filter == inFilter && filterMode == mode)
+		return;
+	int32_t selectedString = -1;
+	if (dataBrowser)
+		selectedString = getStringIndex (dataBrowser->getSelectedRow ());
+	filter = inFilter;
+	filterMode = mode;
+	updateFilteredRows ();
+	if (dataBrowser)
+	{
+		dataBrowser->recalculateLayout (true);
+		auto row = getRow (selectedString);
+		if (row >= 0)
+			dataBrowser->setSelectedRow (row, true);
+		else
+			dataBrowser->unselectAll ();
+	}
+}
+
+//-----------------------------------------------------------------------------
+void GenericStringListDataBrowserSource::updateFilteredRows ()
+{
+	if (filter.empty ())
+		filteredRows.clear ();
+	else if (filterMode == FilterMode::Prefix)
+		searchIndex.findAllWithPrefix (filter.getString (), filteredRows);
+	else
+		searchIndex.findAllContaining (filter.getString (), filteredRows);
+}
+
+//-----------------------------------------------------------------------------
+int32_t GenericStringListDataBrowserSource::getStringIndex (int32_t row) const
+{
+	if (row < 0)
+		return -1;
+	if (filter.empty ())
+		return (stringList && static_cast<size_t> (row) < stringList->size ()) ? row : -1;
+	if (static_cast<size_t> (row) >= filteredRows.size ())
+		return -1;
+	return static_cast<int32_t> (filteredRows[static_cast<size_t> (row)]);
+}
+
+//-----------------------------------------------------------------------------
+int32_t GenericStringListDataBrowserSource::getRow (int32_t stringIndex) const
+{
+	if (stringIndex < 0 || !stringList || static_cast<size_t> (stringIndex) >= stringList->size ())
+		return -1;
+	if (filter.empty ())
+		return stringIndex;
+	auto it = std::lower_bound (filteredRows.begin (), filteredRows.end (),
+	                            static_cast<uint32_t> (stringIndex));
+	if (it == filteredRows.end () || *it != static_cast<uint32_t> (stringIndex))
+		return -1;
+	return static_cast<int32_t> (std::distance (filteredRows.begin (), it));
+}
+
 //-----------------------------------------------------------------------------
 void GenericStringListDataBrowserSource::setupUI (
     const CColor& _selectionColor, const CColor& _fontColor, const CColor& _rowlineColor,
@@ -82,6 +145,8 @@ void GenericStringListDataBrowserSource::dbSelectionChanged (CDataBrowser* brows
 //-----------------------------------------------------------------------------
 int32_t GenericStringListDataBrowserSource::dbGetNumRows (CDataBrowser* browser)
 {
+	if (!filter.empty ())
+		return static_cast<int32_t> (filteredRows.size ());
 	return stringList ? (int32_t)stringList->size () : 0;
 }
 
@@ -135,7 +200,7 @@ void GenericStringListDataBrowserSource::drawRowBackground (CDrawContext* contex
                                                             int32_t flags,
                                                             CDataBrowser* browser) const
 {
-	vstgui_assert (row >= 0 && static_cast<size_t> (row) < stringList->size ());
+	vstgui_assert (getStringIndex (row) >= 0);
 
 	context->setDrawMode (kAliasing);
 	context->setLineWidth (1.);
@@ -167,7 +232,8 @@ void GenericStringListDataBrowserSource::drawRowString (CDrawContext* context, c
                                                         int32_t row, int32_t flags,
                                                         CDataBrowser* browser) const
 {
-	vstgui_assert (row >= 0 && static_cast<size_t> (row) < stringList->size ());
+	auto index = getStringIndex (row);
+	vstgui_assert (index >= 0);
 
 	context->saveGlobalState ();
 	CRect stringSize (size);
@@ -175,7 +241,7 @@ void GenericStringListDataBrowserSource::drawRowString (CDrawContext* context, c
 	context->setFont (drawFont);
 	context->setFontColor (fontColor);
 	ConcatClip cc (*context, stringSize);
-	context->drawString ((*stringList)[static_cast<size_t> (row)].getPlatformString (), stringSize,
+	context->drawString ((*stringList)[static_cast<size_t> (index)].getPlatformString (), stringSize,
 	                     textAlignment);
 	context->restoreGlobalState ();
 }
@@ -185,7 +251,7 @@ void GenericStringListDataBrowserSource::dbDrawCell (CDrawContext* context, cons
                                                      int32_t row, int32_t column, int32_t flags,
                                                      CDataBrowser* browser)
 {
-	vstgui_assert (row >= 0 && static_cast<size_t> (row) < stringList->size ());
+	vstgui_assert (getStringIndex (row) >= 0);
 	vstgui_assert (column == 0);
 
 	drawRowBackground (context, size, row, flags, browser);
@@ -216,20 +282,23 @@ void GenericStringListDataBrowserSource::dbOnKeyboardEvent (KeyboardEvent& event
 			timer->start ();
 		}
 		keyDownFindString += static_cast<char> (toupper (event.character));
-		StringVector::const_iterator it = stringList->begin ();
-		int32_t row = 0;
-		while (it != stringList->end ())
+		int32_t row = -1;
+		if (filter.empty ())
+			row = searchIndex.findFirstWithPrefix (keyDownFindString);
+		else
 		{
-			std::string str ((*it).getString (), 0, keyDownFindString.length ());
-			std::transform (str.begin (), str.end (), str.begin (), ::toupper);
-			if (str == keyDownFindString)
+			StringListSearchIndex::IndexList matches;
+			searchIndex.findAllWithPrefix (keyDownFindString, matches);
+			for (auto index : matches)
 			{
-				dataBrowser->setSelectedRow (row, true);
-				event.consumed = true;
-				return;
+				if ((row = getRow (static_cast<int32_t> (index))) >= 0)
+					break;
 			}
-			row++;
-			++it;
+		}
+		if (row >= 0)
+		{
+			dataBrowser->setSelectedRow (row, true);
+			event.consumed = true;
 		}
 	}
 }
@@ -8,6 +8,7 @@
 #include "cfont.h"
 #include "ccolor.h"
 #include "cdrawdefs.h"
+#include "stringlistsearchindex.h"
 
 //-----------------------------------------------------------------------------
 namespace VSTGUI {
@@ -38,6 +39,25 @@ public:
 	void setStringList (const StringVector* stringList);
 	const StringVector* getStringList () const { return stringList; }
 
+	enum class FilterMode
+	{
+		Prefix,
+		Substring,
+	};
+	/** only show the strings matching the filter (case insensitive), an empty filter shows all.
+	 *
+	 *	While a filter is set, the rows of the data browser are not the indices of the string
+	 *	list, use getStringIndex () and getRow () to convert between them.
+	 */
+	void setFilter (const UTF8String& filter, FilterMode mode = FilterMode::Substring);
+	const UTF8String& getFilter () const { return filter; }
+	FilterMode getFilterMode () const { return filterMode; }
+
+	/** the index into the string list of the row or -1 */
+	int32_t getStringIndex (int32_t row) const;
+	/** the row showing the string at index of the string list or -1 if it is filtered */
+	int32_t getRow (int32_t stringIndex) const;
+
 	void setupUI (const CColor& selectionColor, const CColor& fontColor, const CColor& rowlineColor,
 	              const CColor& rowBackColor, const CColor& rowAlteranteBackColor,
 	              CFontRef font = nullptr, int32_t rowHeight = -1, CCoord textInset = 2.);
@@ -99,6 +119,8 @@ protected:
 
 	CMessageResult notify (CBaseObject* sender, IdStringPtr message) override;
 
+	void updateFilteredRows ();
+
 	const StringVector* stringList;
 	int32_t rowHeight;
 	CColor fontColor;
@@ -114,6 +136,11 @@ protected:
 
 	SharedPointer<CVSTGUITimer> timer;
 	std::string keyDownFindString;
+
+	StringListSearchIndex searchIndex;
+	UTF8String filter;
+	FilterMode filterMode {FilterMode::Substring};
+	StringListSearchIndex::IndexList filteredRows;
 };
 
 //------------------------------------------------------------------------
@@ -41,6 +41,14 @@ public:
 	                                      CDataBrowser* browser) = 0;
 	/** return height of one row */
 	virtual CCoord dbGetRowHeight (CDataBrowser* browser) = 0;
+	/** return true if the rows have different heights, see dbGetVariableRowHeight */
+	virtual bool dbHasVariableRowHeights (CDataBrowser* browser) { return false; }
+	/** return height of row, only called if dbHasVariableRowHeights returns true. Call
+	 *	CDataBrowser::rowHeightChanged when the height of a row changes */
+	virtual CCoord dbGetVariableRowHeight (int32_t row, CDataBrowser* browser)
+	{
+		return dbGetRowHeight (browser);
+	}
 	/** return height of header */
 	virtual CCoord dbGetHeaderHeight (CDataBrowser* browser) = 0;
 	/** return the line width and color */
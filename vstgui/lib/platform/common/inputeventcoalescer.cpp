@@ -0,0 +1,115 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "inputeventcoalescer.h"
+
+//-----------------------------------------------------------------------------
+namespace VSTGUI {
+
+//-----------------------------------------------------------------------------
+InputEventCoalescer::InputEventCoalescer (DispatchFunc&& dispatchFunc)
+: dispatchFunc (std::move (dispatchFunc))
+{
+}
+
+//-----------------------------------------------------------------------------
+void InputEventCoalescer::setEnabled (bool state)
+{
+	if (!state)
+		flush ();
+	enabled = state;
+}
+
+//-----------------------------------------------------------------------------
+void InputEventCoalescer::onMouseMove (const MouseMoveEvent& event)
+{
+	++numReceived;
+	if (wheelPending)
+		dispatchWheel ();
+	if (movePending)
+	{
+		if (pendingMove.buttonState == event.buttonState &&
+		    pendingMove.modifiers == event.modifiers && pendingMove.clickCount == event.clickCount)
+		{
+			if (keepHistory)
+				history.emplace_back (pendingMove.position);
+			pendingMove.position = event.mousePosition;
+			return;
+		}
+		dispatchMove ();
+	}
+	pendingMove = {event.mousePosition, event.buttonState, event.modifiers, event.clickCount};
+	movePending = true;
+	if (!enabled)
+		dispatchMove ();
+}
+
+//-----------------------------------------------------------------------------
+void InputEventCoalescer::onMouseWheel (const MouseWheelEvent& event)
+{
+	++numReceived;
+	if (movePending)
+		dispatchMove ();
+	if (wheelPending)
+	{
+		if (pendingWheel.modifiers == event.modifiers && pendingWheel.flags == event.flags)
+		{
+			pendingWheel.position = event.mousePosition;
+			pendingWheel.deltaX += event.deltaX;
+			pendingWheel.deltaY += event.deltaY;
+			return;
+		}
+		dispatchWheel ();
+	}
+	pendingWheel = {event.mousePosition, event.modifiers, event.deltaX, event.deltaY, event.flags};
+	wheelPending = true;
+	if (!enabled)
+		dispatchWheel ();
+}
+
+//-----------------------------------------------------------------------------
+void InputEventCoalescer::flush ()
+{
+	// only one of both can be pending, as each flushes the other
+	if (movePending)
+		dispatchMove ();
+	if (wheelPending)
+		dispatchWheel ();
+}
+
+//-----------------------------------------------------------------------------
+void InputEventCoalescer::dispatchMove ()
+{
+	movePending = false;
+	++numDispatched;
+	MouseMoveEvent event (pendingMove.position, pendingMove.buttonState);
+	event.modifiers = pendingMove.modifiers;
+	event.clickCount = pendingMove.clickCount;
+	// the event may be dispatched into a nested event loop which merges further events
+	auto positions = std::move (history);
+	history.clear ();
+	if (!positions.empty ())
+	{
+		event.coalescedPositions = positions.data ();
+		event.numCoalescedPositions = static_cast<uint32_t> (positions.size ());
+	}
+	dispatchFunc (event);
+}
+
+//-----------------------------------------------------------------------------
+void InputEventCoalescer::dispatchWheel ()
+{
+	wheelPending = false;
+	++numDispatched;
+	MouseWheelEvent event;
+	event.mousePosition = pendingWheel.position;
+	event.modifiers = pendingWheel.modifiers;
+	event.deltaX = pendingWheel.deltaX;
+	event.deltaY = pendingWheel.deltaY;
+	event.flags = pendingWheel.flags;
+	dispatchFunc (event);
+}
+
+//-----------------------------------------------------------------------------
+} // VSTGUI
@@ -0,0 +1,84 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#pragma once
+
+#include "../../events.h"
+#include <functional>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+namespace VSTGUI {
+
+//-----------------------------------------------------------------------------
+/** Merges consecutive mouse move and wheel events of a platform frame
+ *
+ *	Move events with the same buttons and modifiers are merged into the last one and wheel events
+ *	with the same modifiers and flags accumulate their deltas. Any other kind of event must call
+ *	flush () before it is dispatched, so that the order of events and all button transitions are
+ *	kept. The platform calls flush () once per frame before it draws, so at most one move or wheel
+ *	event is dispatched per frame instead of one per native event.
+ *
+ *	With the history enabled a dispatched move event references the positions of the merged
+ *	events via MouseMoveEvent::coalescedPositions.
+ */
+class InputEventCoalescer
+{
+public:
+	using DispatchFunc = std::function<void (Event& event)>;
+
+	explicit InputEventCoalescer (DispatchFunc&& dispatchFunc);
+
+	/** when disabled, every event is dispatched directly */
+	void setEnabled (bool state);
+	bool isEnabled () const { return enabled; }
+	void setKeepHistory (bool state) { keepHistory = state; }
+	bool getKeepHistory () const { return keepHistory; }
+
+	void onMouseMove (const MouseMoveEvent& event);
+	void onMouseWheel (const MouseWheelEvent& event);
+	/** dispatch the pending events */
+	void flush ();
+	bool hasPendingEvents () const { return movePending || wheelPending; }
+
+	/** number of move and wheel events passed to the coalescer */
+	uint64_t getNumReceivedEvents () const { return numReceived; }
+	/** number of move and wheel events dispatched by the coalescer */
+	uint64_t getNumDispatchedEvents () const { return numDispatched; }
+	void resetCounters () { numReceived = numDispatched = 0; }
+
+private:
+	void dispatchMove ();
+	void dispatchWheel ();
+
+	struct PendingMove
+	{
+		CPoint position;
+		MouseEventButtonState buttonState;
+		Modifiers modifiers;
+		uint32_t clickCount {0};
+	};
+	struct PendingWheel
+	{
+		CPoint position;
+		Modifiers modifiers;
+		CCoord deltaX {0.};
+		CCoord deltaY {0.};
+		uint32_t flags {0};
+	};
+
+	DispatchFunc dispatchFunc;
+	PendingMove pendingMove;
+	PendingWheel pendingWheel;
+	std::vector<CPoint> history;
+	uint64_t numReceived {0};
+	uint64_t numDispatched {0};
+	bool movePending {false};
+	bool wheelPending {false};
+	bool enabled {true};
+	bool keepHistory {false};
+};
+
+//-----------------------------------------------------------------------------
+} // VSTGUI
@@ -0,0 +1,324 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "viewlayercompositor.h"
+#include "../../cdrawcontext.h"
+#include "../../cinvalidrectlist.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+namespace VSTGUI {
+namespace {
+
+class CompositedViewLayer;
+using CompositedViewLayerList = std::vector<CompositedViewLayer*>;
+
+} // anonymous
+
+//-----------------------------------------------------------------------------
+struct ViewLayerCompositor::Impl
+{
+	SurfaceFactory surfaceFactory;
+	InvalidCallback invalidCallback;
+	/** the layers without a parent layer in composite order */
+	CompositedViewLayerList layers;
+	Statistics statistics;
+	double scaleFactor {1.};
+	uint64_t nextOrder {0};
+
+	void invalid (const CRect& rect)
+	{
+		if (invalidCallback && !rect.isEmpty ())
+			invalidCallback (rect);
+	}
+};
+
+//-----------------------------------------------------------------------------
+namespace {
+
+//-----------------------------------------------------------------------------
+class CompositedViewLayer : public IPlatformViewLayer
+{
+public:
+	using CompositorPtr = std::shared_ptr<ViewLayerCompositor::Impl>;
+
+	CompositedViewLayer (const CompositorPtr& compositor,
+						 IPlatformViewLayerDelegate* drawDelegate, CompositedViewLayer* parent)
+	: compositor (compositor)
+	, drawDelegate (drawDelegate)
+	, parent (parent)
+	, scaleFactor (compositor->scaleFactor)
+	, order (compositor->nextOrder++)
+	{
+		getSiblings ().emplace_back (this);
+		sort (getSiblings ());
+	}
+
+	~CompositedViewLayer () noexcept override
+	{
+		invalid ();
+		auto& siblings = getSiblings ();
+		siblings.erase (std::remove (siblings.begin (), siblings.end (), this), siblings.end ());
+		// the children are not composited anymore
+		for (auto child : children)
+			child->parent = nullptr;
+	}
+
+	bool belongsTo (const CompositorPtr& other) const { return compositor == other; }
+
+	//-----------------------------------------------------------------------------
+	void invalidRect (const CRect& rect) override
+	{
+		CRect r (rect);
+		r.bound (getBounds ());
+		if (r.isEmpty ())
+			return;
+		dirtyRects.add (r);
+		r.offset (getFrameOrigin ());
+		r.bound (getVisibleRect ());
+		compositor->invalid (r);
+	}
+
+	//-----------------------------------------------------------------------------
+	void setSize (const CRect& newSize) override
+	{
+		if (newSize == size)
+			return;
+		invalid ();
+		auto resized = newSize.getSize () != size.getSize ();
+		size = newSize;
+		// a moved layer is only composited at the new position
+		if (resized)
+			invalidAll ();
+		invalid ();
+	}
+
+	//-----------------------------------------------------------------------------
+	void setZIndex (uint32_t newZIndex) override
+	{
+		if (newZIndex == zIndex)
+			return;
+		zIndex = newZIndex;
+		sort (getSiblings ());
+		invalid ();
+	}
+
+	//-----------------------------------------------------------------------------
+	void setAlpha (float newAlpha) override
+	{
+		if (newAlpha == alpha)
+			return;
+		alpha = newAlpha;
+		invalid ();
+	}
+
+	//-----------------------------------------------------------------------------
+	void draw (CDrawContext* context, const CRect& updateRect) override
+	{
+		// the layer is drawn by the compositor
+	}
+
+	//-----------------------------------------------------------------------------
+	void onScaleFactorChanged (double newScaleFactor) override
+	{
+		if (newScaleFactor == scaleFactor)
+			return;
+		scaleFactor = newScaleFactor;
+		invalidAll ();
+		invalid ();
+	}
+
+	//-----------------------------------------------------------------------------
+	void render (ViewLayerCompositor::Statistics& statistics)
+	{
+		// the invalid rects of hidden layers are kept until they are visible
+		if (alpha <= 0.f || size.isEmpty ())
+			return;
+		if (!dirtyRects.empty ())
+			renderDirtyRects (statistics);
+		for (auto child : children)
+			child->render (statistics);
+	}
+
+	//-----------------------------------------------------------------------------
+	void composite (CDrawContext& context, CRect clip, const CPoint& origin, float parentAlpha,
+					ViewLayerCompositor::Statistics& statistics)
+	{
+		CRect frameRect (size);
+		frameRect.offset (origin);
+		clip.bound (frameRect);
+		auto compositeAlpha = parentAlpha * alpha;
+		if (clip.isEmpty () || compositeAlpha <= 0.f)
+			return;
+		if (surface)
+		{
+			context.setClipRect (clip);
+			surface->drawInto (context, frameRect.getTopLeft (), compositeAlpha);
+			++statistics.numCompositedLayers;
+		}
+		for (auto child : children)
+			child->composite (context, clip, frameRect.getTopLeft (), compositeAlpha, statistics);
+	}
+
+	//-----------------------------------------------------------------------------
+	static void sort (CompositedViewLayerList& list)
+	{
+		std::sort (list.begin (), list.end (),
+				   [] (const CompositedViewLayer* a, const CompositedViewLayer* b) {
+					   return a->zIndex < b->zIndex || (a->zIndex == b->zIndex && a->order < b->order);
+				   });
+	}
+
+private:
+	CompositedViewLayerList& getSiblings ()
+	{
+		return parent ? parent->children : compositor->layers;
+	}
+
+	CRect getBounds () const { return CRect (CPoint (), size.getSize ()); }
+
+	CPoint getFrameOrigin () const
+	{
+		auto origin = size.getTopLeft ();
+		for (auto p = parent; p; p = p->parent)
+			origin += p->size.getTopLeft ();
+		return origin;
+	}
+
+	/** the rect in the frame which shows the layer */
+	CRect getVisibleRect () const
+	{
+		CRect r (size);
+		if (parent)
+		{
+			r.offset (parent->getFrameOrigin ());
+			r.bound (parent->getVisibleRect ());
+		}
+		return r;
+	}
+
+	void invalid () { compositor->invalid (getVisibleRect ()); }
+
+	void invalidAll ()
+	{
+		dirtyRects.clear ();
+		dirtyRects.add (getBounds ());
+	}
+
+	void renderDirtyRects (ViewLayerCompositor::Statistics& statistics)
+	{
+		CPoint pixelSize (std::ceil (size.getWidth () * scaleFactor),
+						  std::ceil (size.getHeight () * scaleFactor));
+		if (!surface || surfaceSize != pixelSize)
+		{
+			surface = compositor->surfaceFactory (pixelSize, scaleFactor);
+			surfaceSize = pixelSize;
+			if (!surface)
+				return;
+			invalidAll ();
+		}
+		auto& context = surface->getDrawContext ();
+		context.beginDraw ();
+		for (const auto& rect : dirtyRects)
+		{
+			context.setClipRect (rect);
+			context.clearRect (rect);
+			context.saveGlobalState ();
+			drawDelegate->drawViewLayer (&context, rect);
+			context.restoreGlobalState ();
+			++statistics.numRenderedRects;
+		}
+		context.endDraw ();
+		dirtyRects.clear ();
+	}
+
+	CompositorPtr compositor;
+	IPlatformViewLayerDelegate* drawDelegate;
+	CompositedViewLayer* parent;
+	CompositedViewLayerList children;
+	std::unique_ptr<IViewLayerSurface> surface;
+	CPoint surfaceSize;
+	CInvalidRectList dirtyRects;
+	CRect size;
+	double scaleFactor;
+	float alpha {1.f};
+	uint32_t zIndex {0};
+	uint64_t order;
+};
+
+} // anonymous
+
+//-----------------------------------------------------------------------------
+ViewLayerCompositor::ViewLayerCompositor (SurfaceFactory&& surfaceFactory,
+										  InvalidCallback&& invalidCallback)
+{
+	impl = std::make_shared<Impl> ();
+	impl->surfaceFactory = std::move (surfaceFactory);
+	impl->invalidCallback = std::move (invalidCallback);
+}
+
+//-----------------------------------------------------------------------------
+ViewLayerCompositor::~ViewLayerCompositor () noexcept
+{
+	// the layers may live longer than the platform frame
+	impl->invalidCallback = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+SharedPointer<IPlatformViewLayer> ViewLayerCompositor::createLayer (
+	IPlatformViewLayerDelegate* drawDelegate, IPlatformViewLayer* parentLayer)
+{
+	auto parent = dynamic_cast<CompositedViewLayer*> (parentLayer);
+	if (!drawDelegate || (parentLayer && (!parent || !parent->belongsTo (impl))))
+		return nullptr;
+	return makeOwned<CompositedViewLayer> (impl, drawDelegate, parent);
+}
+
+//-----------------------------------------------------------------------------
+bool ViewLayerCompositor::hasLayers () const
+{
+	return !impl->layers.empty ();
+}
+
+//-----------------------------------------------------------------------------
+void ViewLayerCompositor::render ()
+{
+	for (auto layer : impl->layers)
+		layer->render (impl->statistics);
+}
+
+//-----------------------------------------------------------------------------
+void ViewLayerCompositor::composite (CDrawContext& context, const CRect& rect)
+{
+	for (auto layer : impl->layers)
+		layer->composite (context, rect, CPoint (), 1.f, impl->statistics);
+}
+
+//-----------------------------------------------------------------------------
+void ViewLayerCompositor::setScaleFactor (double scaleFactor)
+{
+	impl->scaleFactor = scaleFactor;
+}
+
+//-----------------------------------------------------------------------------
+double ViewLayerCompositor::getScaleFactor () const
+{
+	return impl->scaleFactor;
+}
+
+//-----------------------------------------------------------------------------
+auto ViewLayerCompositor::getStatistics () const -> const Statistics&
+{
+	return impl->statistics;
+}
+
+//-----------------------------------------------------------------------------
+void ViewLayerCompositor::resetStatistics ()
+{
+	impl->statistics = {};
+}
+
+} // VSTGUI
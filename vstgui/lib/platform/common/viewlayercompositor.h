@@ -0,0 +1,89 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#pragma once
+
+#include "../../crect.h"
+#include "../iplatformviewlayer.h"
+#include <functional>
+#include <memory>
+
+//-----------------------------------------------------------------------------
+namespace VSTGUI {
+
+//-----------------------------------------------------------------------------
+/** The surface of a view layer, implemented by the platform */
+class IViewLayerSurface
+{
+public:
+	virtual ~IViewLayerSurface () noexcept = default;
+
+	/** the context to render the layer into the surface
+	 *
+	 *	It draws in the coordinates of the layer, the scale factor is applied by the surface.
+	 *	Nested layered view containers must not be drawn into it, so it must not be the context of
+	 *	a bitmap (see CLayeredViewContainer::drawRect).
+	 */
+	virtual CDrawContext& getDrawContext () = 0;
+	/** draw the surface into context with its top left corner at pos */
+	virtual void drawInto (CDrawContext& context, const CPoint& pos, float alpha) = 0;
+};
+
+//-----------------------------------------------------------------------------
+/** Composites view layers into the back buffer of a platform frame without a GPU
+ *
+ *	For platforms without native layers. Every layer renders its views into its own surface, and
+ *	only the invalid rects of a layer are rendered again. The frame draws the views outside of the
+ *	layers into a base buffer. When a layer changed, the base buffer is copied into the back
+ *	buffer and the layers are composited over it via composite (), so the views below a layer are
+ *	not drawn again when the layer is animated.
+ *
+ *	The layers are composited in the order of their z-index, layers with the same z-index in the
+ *	order they were created. A layer with a parent layer is composited directly after its parent,
+ *	clipped to it and with the alpha value of the parent applied.
+ */
+class ViewLayerCompositor
+{
+public:
+	/** create a surface with a size in pixels */
+	using SurfaceFactory =
+		std::function<std::unique_ptr<IViewLayerSurface> (const CPoint& size, double scaleFactor)>;
+	/** the frame must composite the rect with its next redraw */
+	using InvalidCallback = std::function<void (const CRect& rect)>;
+
+	struct Statistics
+	{
+		/** calls of IPlatformViewLayerDelegate::drawViewLayer */
+		uint64_t numRenderedRects {0};
+		/** layers drawn by composite () */
+		uint64_t numCompositedLayers {0};
+	};
+
+	ViewLayerCompositor (SurfaceFactory&& surfaceFactory, InvalidCallback&& invalidCallback);
+	~ViewLayerCompositor () noexcept;
+
+	SharedPointer<IPlatformViewLayer> createLayer (IPlatformViewLayerDelegate* drawDelegate,
+												   IPlatformViewLayer* parentLayer = nullptr);
+	bool hasLayers () const;
+
+	/** render the invalid rects of all visible layers into their surfaces */
+	void render ();
+	/** draw the layers clipped to rect into context, this changes the clip rect of context */
+	void composite (CDrawContext& context, const CRect& rect);
+
+	void setScaleFactor (double scaleFactor);
+	double getScaleFactor () const;
+
+	const Statistics& getStatistics () const;
+	void resetStatistics ();
+
+	/// @cond ignore
+	struct Impl;
+	/// @endcond
+
+private:
+	std::shared_ptr<Impl> impl;
+};
+
+} // VSTGUI
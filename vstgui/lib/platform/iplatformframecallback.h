@@ -31,6 +31,9 @@ class IPlatformFrameCallback
 {
 public:
 	virtual bool platformDrawRect (CDrawContext* context, const CRect& rect) = 0;
+	/** enclose all platformDrawRect calls of one redraw of the platform frame */
+	virtual void platformOnBeginRedraw () = 0;
+	virtual void platformOnEndRedraw () = 0;
 	
 	virtual void platformOnEvent (Event& event) = 0;
 
@@ -40,6 +40,31 @@ private:
 	size_t size;
 };
 
+//-----------------------------------------------------------------------------
+struct PNGStreamReader
+{
+	PNGStreamReader (const BitmapStreamReadFunc& readFunc) : readFunc (readFunc) {}
+
+	cairo_surface_t* create () { return cairo_image_surface_create_from_png_stream (read, this); }
+
+private:
+	static cairo_status_t read (void* closure, unsigned char* data, unsigned int length)
+	{
+		auto self = reinterpret_cast<PNGStreamReader*> (closure);
+		while (length > 0)
+		{
+			auto numBytes = self->readFunc (data, length);
+			if (numBytes == 0 || numBytes > length)
+				return CAIRO_STATUS_READ_ERROR;
+			data += numBytes;
+			length -= numBytes;
+		}
+		return CAIRO_STATUS_SUCCESS;
+	}
+
+	const BitmapStreamReadFunc& readFunc;
+};
+
 //-----------------------------------------------------------------------------
 struct PNGMemoryWriter
 {
@@ -154,6 +179,22 @@ SharedPointer<Bitmap> Bitmap::create (const void* ptr, uint32_t memSize)
 	return nullptr;
 }
 
+//-----------------------------------------------------------------------------
+SharedPointer<Bitmap> Bitmap::create (const BitmapStreamReadFunc& readFunc)
+{
+	Cairo::CairoBitmapPrivate::PNGStreamReader reader (readFunc);
+	if (auto surface = reader.create ())
+	{
+		if (cairo_surface_status (surface) != CAIRO_STATUS_SUCCESS)
+		{
+			cairo_surface_destroy (surface);
+			return nullptr;
+		}
+		return makeOwned<Bitmap> (Cairo::SurfaceHandle {surface});
+	}
+	return nullptr;
+}
+
 //-----------------------------------------------------------------------------
 Bitmap::Bitmap (const CPoint& _size)
 {
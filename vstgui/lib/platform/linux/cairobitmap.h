@@ -23,6 +23,7 @@ class Bitmap : public IPlatformBitmap
 public:
 	static SharedPointer<Bitmap> create (UTF8StringPtr absolutePath);
 	static SharedPointer<Bitmap> create (const void* ptr, uint32_t memSize);
+	static SharedPointer<Bitmap> create (const BitmapStreamReadFunc& readFunc);
 
 	Bitmap ();
 	explicit Bitmap (const CPoint& size);
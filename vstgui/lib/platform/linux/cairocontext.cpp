@@ -385,7 +385,8 @@ void Context::drawPoint (const CPoint& point, const CColor& color)
 }
 
 //-----------------------------------------------------------------------------
-void Context::drawBitmap (CBitmap* bitmap, const CRect& dest, const CPoint& offset, float alpha)
+void Context::drawBitmap (CBitmap* bitmap, const CRect& inDest, const CPoint& inOffset,
+						  float alpha)
 {
 	if (auto cd = DrawBlock::begin (*this))
 	{
@@ -393,8 +394,10 @@ void Context::drawBitmap (CBitmap* bitmap, const CRect& dest, const CPoint& offs
 		CGraphicsTransform t = getCurrentTransform ();
 		if (t.m11 == t.m22 && t.m12 == 0 && t.m21 == 0)
 			transformedScaleFactor *= t.m11;
+		CRect dest (inDest);
+		CPoint offset (inOffset);
 		auto cairoBitmap =
-			bitmap->getBestPlatformBitmapForScaleFactor (transformedScaleFactor).cast<Bitmap> ();
+			bitmap->resolvePlatformBitmap (transformedScaleFactor, dest, offset).cast<Bitmap> ();
 		if (cairoBitmap)
 		{
 			cairo_translate (cr, dest.left, dest.top);
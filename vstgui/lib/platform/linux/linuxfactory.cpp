@@ -139,6 +139,13 @@ PlatformBitmapPtr LinuxFactory::createBitmapFromMemory (const void* ptr,
 	return Cairo::Bitmap::create (ptr, memSize);
 }
 
+//-----------------------------------------------------------------------------
+PlatformBitmapPtr
+	LinuxFactory::createBitmapFromStream (const BitmapStreamReadFunc& readFunc) const noexcept
+{
+	return Cairo::Bitmap::create (readFunc);
+}
+
 //-----------------------------------------------------------------------------
 PNGBitmapBuffer LinuxFactory::createBitmapMemoryPNGRepresentation (
 	const PlatformBitmapPtr& bitmap) const noexcept
@@ -5,12 +5,14 @@
 #include "x11frame.h"
 #include "x11dragging.h"
 #include "x11utils.h"
+#include "../../cbitmap.h"
 #include "../../cbuttonstate.h"
 #include "../../cframe.h"
 #include "../../crect.h"
 #include "../../dragging.h"
 #include "../../vstkeycode.h"
 #include "../../cinvalidrectlist.h"
+#include "../../vstguitrace.h"
 #include "../iplatformopenglview.h"
 #include "../iplatformviewlayer.h"
 #include "../iplatformtextedit.h"
@@ -18,6 +20,8 @@
 #include "../common/fileresourceinputstream.h"
 #include "../common/generictextedit.h"
 #include "../common/genericoptionmenu.h"
+#include "../common/inputeventcoalescer.h"
+#include "../common/viewlayercompositor.h"
 #include "cairobitmap.h"
 #include "cairocontext.h"
 #include "x11platform.h"
@@ -178,17 +182,19 @@ struct DrawHandler
 	void onSizeChanged (const CPoint& size)
 	{
 		cairo_xcb_surface_set_size (windowSurface, size.x, size.y);
+		scrolledRect.clear ();
 		backBuffer = Cairo::SurfaceHandle (cairo_surface_create_similar (
 			windowSurface, CAIRO_CONTENT_COLOR_ALPHA, size.x, size.y));
-		CRect r;
-		r.setSize (size);
-		drawContext = makeOwned<Cairo::Context> (r, backBuffer);
+		surfaceRect = {};
+		surfaceRect.setSize (size);
+		drawContext = makeOwned<Cairo::Context> (surfaceRect, backBuffer);
+		releaseBaseBuffer ();
 	}
 
 	template<typename RectList, typename Proc>
 	void draw (const RectList& dirtyRects, Proc proc)
 	{
-		CRect copyRect;
+		CBlitRect copyRect;
 		drawContext->beginDraw ();
 		for (auto rect : dirtyRects)
 		{
@@ -196,20 +202,126 @@ struct DrawHandler
 			drawContext->saveGlobalState ();
 			proc (drawContext, rect);
 			drawContext->restoreGlobalState ();
-			if (copyRect.isEmpty ())
-				copyRect = rect;
-			else
-				copyRect.unite (rect);
+			copyRect.add (rect);
 		}
 		drawContext->endDraw ();
-		blitBackbufferToWindow (copyRect);
+		VSTGUI_TRACE_SCOPE ("X11::Frame::blit");
+		copyRect.add (scrolledRect);
+		scrolledRect.clear ();
+		blitBackbufferToWindow (copyRect.get ());
 		xcb_flush (RunLoop::instance ().getXcbConnection ());
 	}
 
+	/** draw with view layers: the views are drawn into the base buffer, which is copied into the
+	 *	back buffer with the layers composited over it. compositeRects are the rects which only
+	 *	need to be composited again.
+	 */
+	template<typename RectList, typename Proc>
+	void draw (const RectList& dirtyRects, const RectList& compositeRects,
+			   ViewLayerCompositor& compositor, Proc proc)
+	{
+		RectList baseRects;
+		if (!baseBuffer)
+		{
+			baseBuffer = Cairo::SurfaceHandle (
+				cairo_surface_create_similar (windowSurface, CAIRO_CONTENT_COLOR_ALPHA,
+											  surfaceRect.getWidth (), surfaceRect.getHeight ()));
+			baseContext = makeOwned<Cairo::Context> (surfaceRect, baseBuffer);
+			baseRects.add (surfaceRect);
+		}
+		else
+		{
+			baseRects = dirtyRects;
+		}
+		baseContext->beginDraw ();
+		for (auto rect : baseRects)
+		{
+			baseContext->setClipRect (rect);
+			baseContext->saveGlobalState ();
+			proc (baseContext, rect);
+			baseContext->restoreGlobalState ();
+		}
+		baseContext->endDraw ();
+
+		compositor.render ();
+
+		RectList rects (compositeRects);
+		for (const auto& rect : baseRects)
+			rects.add (rect);
+		{
+			Cairo::ContextHandle context (cairo_create (backBuffer));
+			cairo_set_operator (context, CAIRO_OPERATOR_SOURCE);
+			cairo_set_source_surface (context, baseBuffer, 0, 0);
+			for (const auto& rect : rects)
+				cairo_rectangle (context, rect.left, rect.top, rect.getWidth (), rect.getHeight ());
+			cairo_fill (context);
+		}
+		CBlitRect copyRect;
+		drawContext->beginDraw ();
+		for (auto rect : rects)
+		{
+			drawContext->setClipRect (rect);
+			drawContext->saveGlobalState ();
+			compositor.composite (*drawContext, rect);
+			drawContext->restoreGlobalState ();
+			copyRect.add (rect);
+		}
+		drawContext->endDraw ();
+		VSTGUI_TRACE_SCOPE ("X11::Frame::blit");
+		copyRect.add (scrolledRect);
+		scrolledRect.clear ();
+		blitBackbufferToWindow (copyRect.get ());
+		xcb_flush (RunLoop::instance ().getXcbConnection ());
+	}
+
+	/** the base buffer is only needed while there are view layers */
+	void releaseBaseBuffer ()
+	{
+		baseContext = nullptr;
+		baseBuffer = {};
+	}
+
+	bool hasBaseBuffer () const { return baseBuffer; }
+
+	/** move the content of src by distance in the back buffer or in the base buffer if there are
+	 *	view layers. The result is copied to the window with the next draw call.
+	 *	@return the moved rect, which is smaller than src moved by distance if content is moved
+	 *	from or to outside of the surface, and empty if nothing was moved
+	 */
+	CRect scroll (const CRect& src, const CPoint& distance)
+	{
+		auto copySrc = getScrollCopySource (surfaceRect, src, distance);
+		if (copySrc.isEmpty ())
+			return {};
+		CRect dest (copySrc);
+		dest.offset (distance);
+		const auto& surface = baseBuffer ? baseBuffer : backBuffer;
+		Cairo::ContextHandle context (cairo_create (surface));
+		cairo_rectangle (context, dest.left, dest.top, dest.getWidth (), dest.getHeight ());
+		cairo_clip (context);
+		// a surface cannot be its own source, so the content is copied via an intermediate group
+		cairo_push_group (context);
+		cairo_set_operator (context, CAIRO_OPERATOR_SOURCE);
+		cairo_set_source_surface (context, surface, distance.x, distance.y);
+		cairo_paint (context);
+		cairo_pop_group_to_source (context);
+		cairo_set_operator (context, CAIRO_OPERATOR_SOURCE);
+		cairo_paint (context);
+		// with view layers the moved rect is composited by the next draw call
+		if (!baseBuffer)
+			scrolledRect.add (dest);
+		return dest;
+	}
+
 private:
 	Cairo::SurfaceHandle windowSurface;
 	Cairo::SurfaceHandle backBuffer;
 	SharedPointer<Cairo::Context> drawContext;
+	/** the views without the view layers */
+	Cairo::SurfaceHandle baseBuffer;
+	SharedPointer<Cairo::Context> baseContext;
+	CRect surfaceRect;
+	CBlitRect scrolledRect;
 
 	void blitBackbufferToWindow (const CRect& rect)
 	{
@@ -223,6 +335,35 @@ private:
 	}
 };
 
+//------------------------------------------------------------------------
+/** a view layer in a Cairo image surface */
+struct CairoViewLayerSurface : IViewLayerSurface
+{
+	CairoViewLayerSurface (const CPoint& size, double scaleFactor)
+	{
+		auto platformBitmap = makeOwned<Cairo::Bitmap> (size);
+		platformBitmap->setScaleFactor (scaleFactor);
+		bitmap = makeOwned<CBitmap> (platformBitmap);
+		CRect r;
+		r.setSize (size);
+		drawContext = makeOwned<Cairo::Context> (r, platformBitmap->getSurface ());
+		if (scaleFactor != 1.)
+			scaleTransform = std::unique_ptr<CDrawContext::Transform> (new CDrawContext::Transform (
+				*drawContext, CGraphicsTransform ().scale (scaleFactor, scaleFactor)));
+	}
+
+	CDrawContext& getDrawContext () override { return *drawContext; }
+
+	void drawInto (CDrawContext& context, const CPoint& pos, float alpha) override
+	{
+		context.drawBitmap (bitmap, CRect (pos, bitmap->getSize ()), CPoint (), alpha);
+	}
+
+	SharedPointer<CBitmap> bitmap;
+	SharedPointer<Cairo::Context> drawContext;
+	std::unique_ptr<CDrawContext::Transform> scaleTransform;
+};
+
 //------------------------------------------------------------------------
 struct DoubleClickDetector
 {
@@ -317,16 +458,33 @@ struct Frame::Impl : IFrameEventHandler
 	DrawHandler drawHandler;
 	DoubleClickDetector doubleClickDetector;
 	IPlatformFrameCallback* frame;
+	InputEventCoalescer inputEventCoalescer;
 	std::unique_ptr<GenericOptionMenuTheme> genericOptionMenuTheme;
 	SharedPointer<RedrawTimerHandler> redrawTimer;
 	RectList dirtyRects;
+	/** rects which only need to be composited again because a view layer changed */
+	RectList compositeRects;
+	ViewLayerCompositor compositor;
 	CCursorType currentCursor {kCursorDefault};
 	uint32_t pointerGrabed {0};
 	XdndHandler dndHandler;
 
 	//------------------------------------------------------------------------
 	Impl (::Window parent, CPoint size, IPlatformFrameCallback* frame)
-	: window (parent, size), drawHandler (window), frame (frame), dndHandler (&window, frame)
+	: window (parent, size)
+	, drawHandler (window)
+	, frame (frame)
+	, inputEventCoalescer ([frame] (Event& event) { frame->platformOnEvent (event); })
+	, compositor (
+		  [] (const CPoint& surfaceSize, double scaleFactor) {
+			  return std::unique_ptr<IViewLayerSurface> (
+				  new CairoViewLayerSurface (surfaceSize, scaleFactor));
+		  },
+		  [this] (const CRect& rect) {
+			  compositeRects.add (rect);
+			  scheduleRedraw ();
+		  })
+	, dndHandler (&window, frame)
 	{
 		RunLoop::instance ().registerWindowEventHandler (window.getID (), this);
 	}
@@ -366,20 +524,60 @@ struct Frame::Impl : IFrameEventHandler
 	//------------------------------------------------------------------------
 	void redraw ()
 	{
-		drawHandler.draw (dirtyRects, [&] (CDrawContext* context, const CRect& rect) {
+		VSTGUI_TRACE_OBJECT_SCOPE ("X11::Frame::redraw", frame);
+		frame->platformOnBeginRedraw ();
+		auto drawViews = [&] (CDrawContext* context, const CRect& rect) {
 			frame->platformDrawRect (context, rect);
-		});
+		};
+		if (compositor.hasLayers ())
+		{
+			drawHandler.draw (dirtyRects, compositeRects, compositor, drawViews);
+		}
+		else
+		{
+			// the rects of removed layers must be drawn again
+			for (const auto& rect : compositeRects)
+				dirtyRects.add (rect);
+			drawHandler.releaseBaseBuffer ();
+			drawHandler.draw (dirtyRects, drawViews);
+		}
 		dirtyRects.clear ();
+		compositeRects.clear ();
+		frame->platformOnEndRedraw ();
 	}
 
 	//------------------------------------------------------------------------
 	void invalidRect (CRect r)
 	{
 		dirtyRects.add (r);
+		scheduleRedraw ();
+	}
+
+	//------------------------------------------------------------------------
+	void scrollRect (const CRect& src, const CPoint& distance)
+	{
+		auto dest = drawHandler.scroll (src, distance);
+		if (drawHandler.hasBaseBuffer () && !dest.isEmpty ())
+			compositeRects.add (dest);
+		scrollInvalidRects (dirtyRects, src, distance);
+		// the part of the destination which was not copied is drawn again
+		CRect fullDest (src);
+		fullDest.offset (distance);
+		if (dest != fullDest)
+			dirtyRects.add (fullDest);
+		scheduleRedraw ();
+	}
+
+	//------------------------------------------------------------------------
+	void scheduleRedraw ()
+	{
 		if (redrawTimer)
 			return;
 		redrawTimer = makeOwned<RedrawTimerHandler> (16, [this] () {
-			if (dirtyRects.data ().empty ())
+			// the merged mouse move and wheel events are dispatched once per frame, before the
+			// frame is drawn
+			inputEventCoalescer.flush ();
+			if (dirtyRects.empty () && compositeRects.empty ())
 				return;
 			redraw ();
 		});
@@ -425,6 +623,7 @@ struct Frame::Impl : IFrameEventHandler
 	//------------------------------------------------------------------------
 	void onEvent (xcb_key_press_event_t& event) override
 	{
+		inputEventCoalescer.flush ();
 		auto type = (event.response_type & ~0x80);
 		auto keyEvent = RunLoop::instance ().getCurrentKeyEvent ();
 		frame->platformOnEvent (keyEvent);
@@ -464,10 +663,12 @@ struct Frame::Impl : IFrameEventHandler
 						break;
 					}
 				}
-				frame->platformOnEvent (wheelEvent);
+				inputEventCoalescer.onMouseWheel (wheelEvent);
+				scheduleRedraw ();
 			}
 			else // mouse down
 			{
+				inputEventCoalescer.flush ();
 				MouseDownEvent downEvent;
 				downEvent.mousePosition = where;
 				setupMouseEventButtons (downEvent, event.detail);
@@ -490,6 +691,7 @@ struct Frame::Impl : IFrameEventHandler
 			}
 			else
 			{
+				inputEventCoalescer.flush ();
 				MouseUpEvent upEvent;
 				upEvent.mousePosition = where;
 				setupMouseEventButtons (upEvent, event.detail);
@@ -509,15 +711,14 @@ struct Frame::Impl : IFrameEventHandler
 		setupMouseEventButtons (moveEvent, event.state);
 		setupEventModifiers (moveEvent.modifiers, event.state);
 		doubleClickDetector.onEvent (moveEvent, event.time);
-		frame->platformOnEvent (moveEvent);
-		// make sure we get more motion events
-		auto xcb = RunLoop::instance ().getXcbConnection ();
-		xcb_get_motion_events (xcb, window.getID (), event.time, event.time + 10000000);
+		inputEventCoalescer.onMouseMove (moveEvent);
+		scheduleRedraw ();
 	}
 
 	//------------------------------------------------------------------------
 	void onEvent (xcb_enter_notify_event_t& event) override
 	{
+		inputEventCoalescer.flush ();
 		if ((event.response_type & ~0x80) == XCB_LEAVE_NOTIFY)
 		{
 			MouseExitEvent exitEvent;
@@ -565,6 +766,7 @@ struct Frame::Impl : IFrameEventHandler
 	//------------------------------------------------------------------------
 	void onEvent (xcb_client_message_event_t& event, xcb_window_t proxyId = 0) override
 	{
+		inputEventCoalescer.flush ();
 		if (Atoms::xEmbed.valid () && event.type == Atoms::xEmbed ())
 		{
 			switch (static_cast<XEMBED> (event.data.data32[1]))
@@ -645,6 +847,8 @@ Frame::Frame (IPlatformFrameCallback* frame, const CRect& size, uint32_t parent,
 	}
 
 	impl = std::unique_ptr<Impl> (new Impl (parent, {size.getWidth (), size.getHeight ()}, frame));
+	if (cfg)
+		impl->inputEventCoalescer.setEnabled (cfg->coalesceInputEvents);
 
 	frame->platformOnActivate (true);
 }
@@ -733,9 +937,8 @@ bool Frame::invalidRect (const CRect& rect)
 //------------------------------------------------------------------------
 bool Frame::scrollRect (const CRect& src, const CPoint& distance)
 {
-	(void)src;
-	(void)distance;
-	return false;
+	impl->scrollRect (src, distance);
+	return true;
 }
 
 //------------------------------------------------------------------------
@@ -764,6 +967,19 @@ uint32_t Frame::getX11WindowID () const
 	return impl->window.getID ();
 }
 
+//------------------------------------------------------------------------
+void Frame::setKeepMouseMoveHistory (bool state)
+{
+	impl->inputEventCoalescer.setKeepHistory (state);
+}
+
+//------------------------------------------------------------------------
+void Frame::getInputEventCounters (uint64_t& received, uint64_t& dispatched) const
+{
+	received = impl->inputEventCoalescer.getNumReceivedEvents ();
+	dispatched = impl->inputEventCoalescer.getNumDispatchedEvents ();
+}
+
 //------------------------------------------------------------------------
 SharedPointer<IPlatformTextEdit> Frame::createPlatformTextEdit (IPlatformTextEditCallback* textEdit)
 {
@@ -796,8 +1012,7 @@ SharedPointer<IPlatformOpenGLView> Frame::createPlatformOpenGLView ()
 SharedPointer<IPlatformViewLayer> Frame::createPlatformViewLayer (
 	IPlatformViewLayerDelegate* drawDelegate, IPlatformViewLayer* parentLayer)
 {
-	// optional
-	return nullptr;
+	return impl->compositor.createLayer (drawDelegate, parentLayer);
 }
 
 #if VSTGUI_ENABLE_DEPRECATED_METHODS
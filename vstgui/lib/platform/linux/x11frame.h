@@ -60,6 +60,8 @@ private:
 	bool setupGenericOptionMenu (bool use, GenericOptionMenuTheme* theme = nullptr) override;
 
 	uint32_t getX11WindowID () const override;
+	void setKeepMouseMoveHistory (bool state) override;
+	void getInputEventCounters (uint64_t& received, uint64_t& dispatched) const override;
 
 	void optionMenuPopupStarted () override;
 	void optionMenuPopupStopped () override;
@@ -638,7 +638,11 @@ void CGDrawContext::fillRectWithBitmap (CBitmap* bitmap, const CRect& srcRect, c
 
 	auto platformBitmap = bitmap->getBestPlatformBitmapForScaleFactor (scaleFactor);
 	if (!platformBitmap)
+	{
+		// the bitmap draws a part of another platform bitmap
+		CDrawContext::fillRectWithBitmap (bitmap, srcRect, dstRect, alpha);
 		return;
+	}
 	CPoint bitmapSize = platformBitmap->getSize ();
 	if (srcRect.right > bitmapSize.x || srcRect.bottom > bitmapSize.y)
 		return;
@@ -677,7 +681,9 @@ void CGDrawContext::drawBitmap (CBitmap* bitmap, const CRect& inRect, const CPoi
 	CGraphicsTransform t = getCurrentTransform ();
 	if (t.m11 == t.m22 && t.m12 == 0 && t.m21 == 0)
 		transformedScaleFactor *= t.m11;
-	auto platformBitmap = bitmap->getBestPlatformBitmapForScaleFactor (transformedScaleFactor);
+	CRect rect (inRect);
+	CPoint offset (inOffset);
+	auto platformBitmap = bitmap->resolvePlatformBitmap (transformedScaleFactor, rect, offset);
 	if (!platformBitmap)
 		return;
 	auto cgBitmap = platformBitmap.cast<CGBitmap> ();
@@ -704,8 +710,11 @@ void CGDrawContext::drawBitmap (CBitmap* bitmap, const CRect& inRect, const CPoi
 				}
 			}
 
-			drawCGImageRef (context, image, layer, cgBitmap->getScaleFactor (), inRect, inOffset,
-			                alpha, bitmap);
+			auto bitmapScaleFactor = cgBitmap->getScaleFactor ();
+			CPoint imageSize (cgBitmap->getSize ().x / bitmapScaleFactor,
+			                  cgBitmap->getSize ().y / bitmapScaleFactor);
+			drawCGImageRef (context, image, layer, bitmapScaleFactor, rect, offset, alpha,
+			                imageSize);
 
 			releaseCGContext (context);
 		}
@@ -715,7 +724,7 @@ void CGDrawContext::drawBitmap (CBitmap* bitmap, const CRect& inRect, const CPoi
 //-----------------------------------------------------------------------------
 void CGDrawContext::drawCGImageRef (CGContextRef context, CGImageRef image, CGLayerRef layer,
                                     double bitmapScaleFactor, const CRect& inRect,
-                                    const CPoint& inOffset, float alpha, CBitmap* bitmap)
+                                    const CPoint& inOffset, float alpha, const CPoint& imageSize)
 {
 	setCGDrawContextQuality (context);
 
@@ -726,9 +735,9 @@ void CGDrawContext::drawCGImageRef (CGContextRef context, CGImageRef image, CGLa
 
 	CGRect dest;
 	dest.origin.x = static_cast<CGFloat> (rect.left - offset.x);
-	dest.origin.y = static_cast<CGFloat> (-(rect.top) - (bitmap->getHeight () - offset.y));
-	dest.size.width = static_cast<CGFloat> (bitmap->getWidth ());
-	dest.size.height = static_cast<CGFloat> (bitmap->getHeight ());
+	dest.origin.y = static_cast<CGFloat> (-(rect.top) - (imageSize.y - offset.y));
+	dest.size.width = static_cast<CGFloat> (imageSize.x);
+	dest.size.height = static_cast<CGFloat> (imageSize.y);
 
 	CGRect clipRect;
 	clipRect.origin.x = static_cast<CGFloat> (rect.left);
@@ -1076,6 +1076,7 @@ void NSViewFrame::addDebugRedrawRect (CRect r, bool isClipBoundingBox)
 void NSViewFrame::drawRect (NSRect* rect)
 {
 	inDraw = true;
+	frame->platformOnBeginRedraw ();
 	NSGraphicsContext* nsContext = [NSGraphicsContext currentContext];
 
 #if MAC_OS_X_VERSION_MIN_REQUIRED < MAX_OS_X_VERSION_10_10
@@ -1113,6 +1114,7 @@ void NSViewFrame::drawRect (NSRect* rect)
 	}
 	drawContext.endDraw ();
 	inDraw = false;
+	frame->platformOnEndRedraw ();
 }
 
 //------------------------------------------------------------------------
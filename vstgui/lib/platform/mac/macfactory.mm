@@ -141,6 +141,20 @@ PlatformBitmapPtr MacFactory::createBitmapFromMemory (const void* ptr,
 	return CGBitmap::createFromMemory (ptr, memSize);
 }
 
+//-----------------------------------------------------------------------------
+PlatformBitmapPtr
+	MacFactory::createBitmapFromStream (const BitmapStreamReadFunc& readFunc) const noexcept
+{
+	// ImageIO needs the complete data
+	PNGBitmapBuffer buffer;
+	uint8_t chunk[8192];
+	while (auto numBytes = readFunc (chunk, sizeof (chunk)))
+		buffer.insert (buffer.end (), chunk, chunk + numBytes);
+	if (buffer.empty ())
+		return nullptr;
+	return CGBitmap::createFromMemory (buffer.data (), static_cast<uint32_t> (buffer.size ()));
+}
+
 //-----------------------------------------------------------------------------
 PNGBitmapBuffer
 	MacFactory::createBitmapMemoryPNGRepresentation (const PlatformBitmapPtr& bitmap) const noexcept
@@ -40,6 +40,8 @@ class FrameConfig : public IPlatformFrameConfig
 {
 public:
 	SharedPointer<IRunLoop> runLoop;
+	/** merge consecutive mouse move and wheel events received within one frame */
+	bool coalesceInputEvents {true};
 };
 
 //------------------------------------------------------------------------
@@ -47,6 +49,11 @@ class IX11Frame
 {
 public:
 	virtual uint32_t getX11WindowID () const = 0;
+
+	/** keep the positions of merged mouse move events, see MouseMoveEvent::coalescedPositions */
+	virtual void setKeepMouseMoveHistory (bool state) = 0;
+	/** number of mouse move and wheel events received from X11 and dispatched to the frame */
+	virtual void getInputEventCounters (uint64_t& received, uint64_t& dispatched) const = 0;
 };
 
 //------------------------------------------------------------------------
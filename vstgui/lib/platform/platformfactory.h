@@ -93,6 +93,14 @@ public:
 	 */
 	virtual PlatformBitmapPtr createBitmapFromMemory (const void* ptr,
 													  uint32_t memSize) const noexcept = 0;
+	/** Create a platform bitmap object from a stream
+	 *
+	 *	Platforms which can decode incrementally do not hold the complete encoded data in memory.
+	 *	@param readFunc called repeatedly to get the encoded data
+	 *	@return platform bitmap or nullptr on failure
+	 */
+	virtual PlatformBitmapPtr
+		createBitmapFromStream (const BitmapStreamReadFunc& readFunc) const noexcept = 0;
 	/** Create a memory representation of the platform bitmap in PNG format.
 	 *	@param bitmap the platform bitmap object
 	 *	@return memory buffer containing the PNG representation of the bitmap
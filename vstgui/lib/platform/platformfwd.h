@@ -21,6 +21,8 @@ namespace VSTGUI {
 
 using PNGBitmapBuffer = std::vector<uint8_t>;
 using FontFamilyCallback = std::function<bool (const std::string&)>;
+/** fill the buffer with up to size bytes, return the number of bytes written or zero at the end */
+using BitmapStreamReadFunc = std::function<uint32_t (void* buffer, uint32_t size)>;
 
 class LinuxFactory;
 class MacFactory;
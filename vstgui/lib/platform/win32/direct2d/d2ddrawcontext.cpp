@@ -427,21 +427,25 @@ void D2DDrawContext::clearRect (const CRect& rect)
 }
 
 //-----------------------------------------------------------------------------
-void D2DDrawContext::drawBitmap (CBitmap* bitmap, const CRect& dest, const CPoint& offset, float alpha)
+void D2DDrawContext::drawBitmap (CBitmap* bitmap, const CRect& inDest, const CPoint& inOffset, float alpha)
 {
 	if (renderTarget == nullptr)
 		return;
-	ConcatClip concatClip (*this, dest);
-	D2DApplyClip ac (this);
-	if (ac.isEmpty ())
-		return;
-	
+
 	double transformedScaleFactor = getScaleFactor ();
 	CGraphicsTransform t = getCurrentTransform ();
 	if (t.m11 == t.m22 && t.m12 == 0 && t.m21 == 0)
 		transformedScaleFactor *= t.m11;
-	IPlatformBitmap* platformBitmap = bitmap->getBestPlatformBitmapForScaleFactor (transformedScaleFactor);
-	D2DBitmap* d2dBitmap = platformBitmap ? dynamic_cast<D2DBitmap*> (platformBitmap) : nullptr;
+	CRect dest (inDest);
+	CPoint offset (inOffset);
+	auto platformBitmap = bitmap->resolvePlatformBitmap (transformedScaleFactor, dest, offset);
+
+	ConcatClip concatClip (*this, dest);
+	D2DApplyClip ac (this);
+	if (ac.isEmpty ())
+		return;
+
+	auto d2dBitmap = platformBitmap.cast<D2DBitmap> ();
 	if (d2dBitmap && d2dBitmap->getSource ())
 	{
 		if (auto d2d1Bitmap = D2DBitmapCache::getBitmap (d2dBitmap, renderTarget, device))
@@ -452,8 +456,8 @@ void D2DDrawContext::drawBitmap (CBitmap* bitmap, const CRect& dest, const CPoin
 			Transform transform (*this, bitmapTransform);
 
 			CRect d (dest);
-			d.setWidth (bitmap->getWidth ());
-			d.setHeight (bitmap->getHeight ());
+			d.setWidth (platformBitmap->getSize ().x / bitmapScaleFactor);
+			d.setHeight (platformBitmap->getSize ().y / bitmapScaleFactor);
 			d.offset (-offset.x, -offset.y);
 			d.makeIntegral ();
 			CRect source;
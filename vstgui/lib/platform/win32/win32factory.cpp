@@ -279,6 +279,20 @@ PlatformBitmapPtr Win32Factory::createBitmapFromMemory (const void* ptr,
 	return nullptr;
 }
 
+//-----------------------------------------------------------------------------
+PlatformBitmapPtr
+	Win32Factory::createBitmapFromStream (const BitmapStreamReadFunc& readFunc) const noexcept
+{
+	// WIC needs a seekable stream, so collect the complete data
+	PNGBitmapBuffer buffer;
+	uint8_t chunk[8192];
+	while (auto numBytes = readFunc (chunk, sizeof (chunk)))
+		buffer.insert (buffer.end (), chunk, chunk + numBytes);
+	if (buffer.empty ())
+		return nullptr;
+	return createBitmapFromMemory (buffer.data (), static_cast<uint32_t> (buffer.size ()));
+}
+
 //-----------------------------------------------------------------------------
 PNGBitmapBuffer Win32Factory::createBitmapMemoryPNGRepresentation (
 	const PlatformBitmapPtr& bitmap) const noexcept
@@ -646,6 +646,8 @@ void Win32Frame::paint (HWND hwnd)
 	bool needsInvalidation = false;
 	CRect frameSize;
 
+	getFrame ()->platformOnBeginRedraw ();
+
 	PAINTSTRUCT ps;
 	if (HDC hdc = BeginPaint (hwnd, &ps))
 	{
@@ -715,6 +717,7 @@ void Win32Frame::paint (HWND hwnd)
 	DeleteObject (rgn);
 	
 	inPaint = false;
+	getFrame ()->platformOnEndRedraw ();
 	if (needsInvalidation && !frameSize.isEmpty ())
 	{
 		invalidRect (frameSize);
@@ -0,0 +1,254 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "stringlistsearchindex.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+
+//-----------------------------------------------------------------------------
+StringListSearchIndex::StringListSearchIndex (const StringVector* stringList)
+: stringList (stringList)
+{
+}
+
+//-----------------------------------------------------------------------------
+void StringListSearchIndex::setStringList (const StringVector* inStringList)
+{
+	stringList = inStringList;
+	invalidate ();
+}
+
+//-----------------------------------------------------------------------------
+void StringListSearchIndex::invalidate ()
+{
+	text.clear ();
+	stringStart.clear ();
+	sortedStrings.clear ();
+	minimumTree.clear ();
+	suffixArray.clear ();
+}
+
+//-----------------------------------------------------------------------------
+std::string StringListSearchIndex::fold (const std::string& str)
+{
+	std::string result (str);
+	for (auto& c : result)
+	{
+		if (c >= 'a' && c <= 'z')
+			c = static_cast<char> (c - 'a' + 'A');
+	}
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+void StringListSearchIndex::buildPrefixIndex ()
+{
+	if (!stringList)
+		return;
+	// catch strings added or removed without calling invalidate ()
+	if (stringStart.size () != stringList->size ())
+		invalidate ();
+	else if (!stringStart.empty ())
+		return;
+	size_t textSize = 0;
+	for (const auto& str : *stringList)
+		textSize += str.length () + 1;
+	text.reserve (textSize);
+	stringStart.reserve (stringList->size ());
+	for (const auto& str : *stringList)
+	{
+		stringStart.emplace_back (static_cast<uint32_t> (text.size ()));
+		text += fold (str.getString ());
+		text += '\0';
+	}
+
+	sortedStrings.resize (stringList->size ());
+	for (uint32_t i = 0; i < sortedStrings.size (); ++i)
+		sortedStrings[i] = i;
+	auto textData = text.data ();
+	std::stable_sort (sortedStrings.begin (), sortedStrings.end (), [&] (uint32_t lhs, uint32_t rhs) {
+		return strcmp (textData + stringStart[lhs], textData + stringStart[rhs]) < 0;
+	});
+}
+
+//-----------------------------------------------------------------------------
+void StringListSearchIndex::buildMinimumTree ()
+{
+	buildPrefixIndex ();
+	if (!minimumTree.empty ())
+		return;
+	auto size = sortedStrings.size ();
+	minimumTree.resize (size * 2);
+	std::copy (sortedStrings.begin (), sortedStrings.end (), minimumTree.begin () + size);
+	for (auto i = size; i-- > 1;)
+		minimumTree[i] = std::min (minimumTree[i * 2], minimumTree[i * 2 + 1]);
+}
+
+//-----------------------------------------------------------------------------
+void StringListSearchIndex::buildSuffixArray ()
+{
+	buildPrefixIndex ();
+	if (!suffixArray.empty () || text.size () == stringStart.size ())
+		return;
+
+	// prefix doubling with counting sorts in O(n log m), m being the length of the longest string.
+	// The terminators get unique ranks below all characters, so no suffix is compared beyond the
+	// end of its string.
+	const auto size = static_cast<uint32_t> (text.size ());
+	const auto numStrings = static_cast<uint32_t> (stringStart.size ());
+	uint32_t numRanks = numStrings + 256;
+	IndexList sa (size);
+	IndexList rank (size);
+	IndexList tmp (size);
+	IndexList count (std::max (size, numRanks));
+
+	uint32_t terminator = 0;
+	for (uint32_t i = 0; i < size; ++i)
+	{
+		auto c = static_cast<uint8_t> (text[i]);
+		rank[i] = c ? numStrings + c : terminator++;
+		++count[rank[i]];
+	}
+	for (uint32_t i = 1; i < numRanks; ++i)
+		count[i] += count[i - 1];
+	for (uint32_t i = size; i-- > 0;)
+		sa[--count[rank[i]]] = i;
+
+	for (uint32_t k = 1;; k <<= 1)
+	{
+		// order by the second half, suffixes without a second half first
+		uint32_t index = 0;
+		for (uint32_t i = size - std::min (k, size); i < size; ++i)
+			tmp[index++] = i;
+		for (uint32_t i = 0; i < size; ++i)
+		{
+			if (sa[i] >= k)
+				tmp[index++] = sa[i] - k;
+		}
+		// stable sort by the first half
+		std::fill (count.begin (), count.begin () + numRanks, 0);
+		for (uint32_t i = 0; i < size; ++i)
+			++count[rank[i]];
+		for (uint32_t i = 1; i < numRanks; ++i)
+			count[i] += count[i - 1];
+		for (uint32_t i = size; i-- > 0;)
+			sa[--count[rank[tmp[i]]]] = tmp[i];
+		// rank the suffixes by their first 2k characters
+		tmp[sa[0]] = 0;
+		numRanks = 1;
+		for (uint32_t i = 1; i < size; ++i)
+		{
+			auto cur = sa[i];
+			auto prev = sa[i - 1];
+			bool equal = rank[cur] == rank[prev] && cur + k < size && prev + k < size &&
+			             rank[cur + k] == rank[prev + k];
+			tmp[cur] = equal ? numRanks - 1 : numRanks++;
+		}
+		rank.swap (tmp);
+		if (numRanks == size)
+			break;
+	}
+
+	suffixArray.reserve (size - numStrings);
+	for (auto pos : sa)
+	{
+		if (text[pos] != '\0')
+			suffixArray.emplace_back (pos);
+	}
+}
+
+//-----------------------------------------------------------------------------
+uint32_t StringListSearchIndex::stringIndexAt (uint32_t textPosition) const
+{
+	auto it = std::upper_bound (stringStart.begin (), stringStart.end (), textPosition);
+	return static_cast<uint32_t> (std::distance (stringStart.begin (), it) - 1);
+}
+
+//-----------------------------------------------------------------------------
+auto StringListSearchIndex::findPrefixRange (const std::string& foldedPrefix) -> Range
+{
+	buildPrefixIndex ();
+	auto textData = text.data ();
+	auto prefix = foldedPrefix.data ();
+	auto length = foldedPrefix.size ();
+	auto first = std::lower_bound (sortedStrings.begin (), sortedStrings.end (), prefix,
+	                               [&] (uint32_t index, const char* p) {
+		                               return strncmp (textData + stringStart[index], p, length) < 0;
+	                               });
+	auto last = std::upper_bound (first, sortedStrings.end (), prefix,
+	                              [&] (const char* p, uint32_t index) {
+		                              return strncmp (textData + stringStart[index], p, length) > 0;
+	                              });
+	return {first, last};
+}
+
+//-----------------------------------------------------------------------------
+int32_t StringListSearchIndex::findFirstWithPrefix (const std::string& prefix)
+{
+	auto range = findPrefixRange (fold (prefix));
+	if (range.first == range.second)
+		return -1;
+	// the lowest string index in the range in O(log n) instead of visiting every match
+	buildMinimumTree ();
+	auto size = sortedStrings.size ();
+	auto first = static_cast<size_t> (std::distance (sortedStrings.cbegin (), range.first)) + size;
+	auto last = static_cast<size_t> (std::distance (sortedStrings.cbegin (), range.second)) + size;
+	auto result = std::numeric_limits<uint32_t>::max ();
+	for (; first < last; first /= 2, last /= 2)
+	{
+		if (first & 1)
+			result = std::min (result, minimumTree[first++]);
+		if (last & 1)
+			result = std::min (result, minimumTree[--last]);
+	}
+	return static_cast<int32_t> (result);
+}
+
+//-----------------------------------------------------------------------------
+void StringListSearchIndex::findAllWithPrefix (const std::string& prefix, IndexList& result)
+{
+	auto range = findPrefixRange (fold (prefix));
+	result.assign (range.first, range.second);
+	std::sort (result.begin (), result.end ());
+}
+
+//-----------------------------------------------------------------------------
+void StringListSearchIndex::findAllContaining (const std::string& substring, IndexList& result)
+{
+	result.clear ();
+	if (substring.empty ())
+	{
+		if (stringList)
+		{
+			result.resize (stringList->size ());
+			for (uint32_t i = 0; i < result.size (); ++i)
+				result[i] = i;
+		}
+		return;
+	}
+	buildSuffixArray ();
+	auto folded = fold (substring);
+	auto textData = text.data ();
+	auto length = folded.size ();
+	auto first = std::lower_bound (suffixArray.begin (), suffixArray.end (), folded.data (),
+	                               [&] (uint32_t pos, const char* p) {
+		                               return strncmp (textData + pos, p, length) < 0;
+	                               });
+	auto last = std::upper_bound (first, suffixArray.end (), folded.data (),
+	                              [&] (const char* p, uint32_t pos) {
+		                              return strncmp (textData + pos, p, length) > 0;
+	                              });
+	result.reserve (static_cast<size_t> (std::distance (first, last)));
+	for (auto it = first; it != last; ++it)
+		result.emplace_back (stringIndexAt (*it));
+	std::sort (result.begin (), result.end ());
+	result.erase (std::unique (result.begin (), result.end ()), result.end ());
+}
+
+//------------------------------------------------------------------------
+} // VSTGUI
@@ -0,0 +1,71 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#pragma once
+
+#include "cstring.h"
+#include <string>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+namespace VSTGUI {
+
+//-----------------------------------------------------------------------------
+/** Case insensitive search index over a list of strings
+ *
+ *	Prefix searches use the indices of the strings sorted by their case folded content, substring
+ *	searches use a suffix array over the case folded content of all strings. Both are built lazily
+ *	on the first search of the kind and searching costs O(m log n) plus the number of results.
+ *
+ *	The index does not own nor copy the strings. If the strings change, call invalidate ().
+ *	Case folding only applies to ASCII characters.
+ */
+class StringListSearchIndex
+{
+public:
+	using StringVector = std::vector<UTF8String>;
+	using IndexList = std::vector<uint32_t>;
+
+	explicit StringListSearchIndex (const StringVector* stringList = nullptr);
+
+	void setStringList (const StringVector* stringList);
+	const StringVector* getStringList () const { return stringList; }
+	/** the content of the string list has changed */
+	void invalidate ();
+
+	/** the lowest index of a string starting with prefix or -1 if there's none */
+	int32_t findFirstWithPrefix (const std::string& prefix);
+	/** the indices of all strings starting with prefix in ascending order */
+	void findAllWithPrefix (const std::string& prefix, IndexList& result);
+	/** the indices of all strings containing substring in ascending order */
+	void findAllContaining (const std::string& substring, IndexList& result);
+
+	static std::string fold (const std::string& str);
+
+private:
+	using Range = std::pair<IndexList::const_iterator, IndexList::const_iterator>;
+
+	void buildPrefixIndex ();
+	void buildMinimumTree ();
+	void buildSuffixArray ();
+	Range findPrefixRange (const std::string& foldedPrefix);
+	uint32_t stringIndexAt (uint32_t textPosition) const;
+
+	const StringVector* stringList;
+
+	/** the case folded strings, each terminated by a zero */
+	std::string text;
+	/** position of every string in text */
+	IndexList stringStart;
+	/** string indices sorted by their folded content */
+	IndexList sortedStrings;
+	/** segment tree over sortedStrings with the lowest string index of every node, the leaves
+	 *	start at sortedStrings.size () */
+	IndexList minimumTree;
+	/** positions in text sorted by the suffix starting at the position */
+	IndexList suffixArray;
+};
+
+//------------------------------------------------------------------------
+} // VSTGUI
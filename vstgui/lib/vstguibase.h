@@ -175,6 +175,10 @@
 	#define VSTGUI_ENABLE_XML_PARSER 1
 #endif
 
+#ifndef VSTGUI_ENABLE_TRACING
+	#define VSTGUI_ENABLE_TRACING 0
+#endif
+
 #if VSTGUI_ENABLE_DEPRECATED_METHODS
 	#define VSTGUI_OVERRIDE_VMETHOD	override
 	#define VSTGUI_FINAL_VMETHOD final
@@ -175,6 +175,9 @@ class ITouchEvent;
 // classes
 class CBitmap;
 class CNinePartTiledBitmap;
+class CAtlasBitmap;
+class CBitmapAtlas;
+class CFilmstripBitmap;
 class CResourceDescription;
 class CLineStyle;
 class CDrawContext;
@@ -185,6 +188,7 @@ class CNewFileSelector;
 class CFontDesc;
 class VSTGUIEditorInterface;
 class CTooltipSupport;
+class CDrawProfiler;
 class CGraphicsPath;
 class CGradient;
 class UTF8String;
@@ -281,6 +285,7 @@ class ViewSizeAnimation;
 class ExchangeViewAnimation;
 class ControlValueAnimation;
 class Animator;
+class FrameClock;
 class TimingFunctionBase;
 class LinearTimingFunction;
 class PowerTimingFunction;
@@ -0,0 +1,286 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "vstguitrace.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#if defined(__GNUC__) || defined(__clang__)
+#include <cxxabi.h>
+#include <cstdlib>
+#endif
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace Trace {
+namespace Detail {
+
+std::atomic<bool> enabled {false};
+
+} // Detail
+
+//------------------------------------------------------------------------
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+//------------------------------------------------------------------------
+struct ThreadBuffer
+{
+	std::array<Event, kThreadBufferSize> events;
+	/** total number of events recorded since the last clear */
+	std::atomic<uint64_t> writeIndex {0};
+	uint32_t threadID {0};
+};
+
+//------------------------------------------------------------------------
+struct Registry
+{
+	static Registry& instance ()
+	{
+		static Registry gInstance;
+		return gInstance;
+	}
+
+	ThreadBuffer* createBuffer ()
+	{
+		std::lock_guard<std::mutex> guard (mutex);
+		buffers.emplace_back (std::make_unique<ThreadBuffer> ());
+		buffers.back ()->threadID = static_cast<uint32_t> (buffers.size ());
+		return buffers.back ().get ();
+	}
+
+	template<typename Proc>
+	void forEach (Proc proc)
+	{
+		std::lock_guard<std::mutex> guard (mutex);
+		for (auto& buffer : buffers)
+			proc (*buffer);
+	}
+
+	const Clock::time_point epoch {Clock::now ()};
+
+private:
+	std::mutex mutex;
+	// the buffers are kept when their thread ends, so that its events can still be written
+	std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+};
+
+thread_local ThreadBuffer* threadBuffer = nullptr;
+
+//------------------------------------------------------------------------
+void appendEscaped (std::string& str, const char* text)
+{
+	for (auto p = text; p && *p; ++p)
+	{
+		auto c = *p;
+		if (c == '"' || c == '\\')
+			str += '\\';
+		if (static_cast<unsigned char> (c) < 0x20)
+			continue;
+		str += c;
+	}
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+std::string demangleTypeName (const char* name)
+{
+	if (!name)
+		return {};
+#if defined(__GNUC__) || defined(__clang__)
+	int status = 0;
+	if (auto result = abi::__cxa_demangle (name, nullptr, nullptr, &status))
+	{
+		std::string str (result);
+		std::free (result);
+		return str;
+	}
+	return name;
+#else
+	// MSVC returns "class VSTGUI::CKnob"
+	if (strncmp (name, "class ", 6) == 0)
+		return name + 6;
+	return name;
+#endif
+}
+
+//------------------------------------------------------------------------
+void setEnabled (bool state)
+{
+	// make sure the epoch is initialized before the first event is recorded
+	Registry::instance ();
+	Detail::enabled.store (state);
+}
+
+//------------------------------------------------------------------------
+void clear ()
+{
+	Registry::instance ().forEach ([] (ThreadBuffer& buffer) { buffer.writeIndex = 0; });
+}
+
+//------------------------------------------------------------------------
+uint64_t now ()
+{
+	auto duration = Clock::now () - Registry::instance ().epoch;
+	// zero is used as invalid time by Scope
+	return static_cast<uint64_t> (
+			   std::chrono::duration_cast<std::chrono::nanoseconds> (duration).count ()) +
+		   1;
+}
+
+//------------------------------------------------------------------------
+void record (const char* name, const char* detail, const void* object, uint64_t begin,
+			 uint64_t end)
+{
+	if (!threadBuffer)
+		threadBuffer = Registry::instance ().createBuffer ();
+	auto index = threadBuffer->writeIndex.load (std::memory_order_relaxed);
+	auto& event = threadBuffer->events[index % kThreadBufferSize];
+	event.begin = begin;
+	event.duration = end > begin ? end - begin : 0;
+	event.name = name;
+	event.detail = detail;
+	event.object = object;
+	event.threadID = threadBuffer->threadID;
+	threadBuffer->writeIndex.store (index + 1, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------
+EventList collectEvents ()
+{
+	EventList result;
+	Registry::instance ().forEach ([&] (ThreadBuffer& buffer) {
+		auto writeIndex = buffer.writeIndex.load (std::memory_order_acquire);
+		auto numEvents = std::min<uint64_t> (writeIndex, kThreadBufferSize);
+		auto first = result.size ();
+		for (auto i = writeIndex - numEvents; i < writeIndex; ++i)
+			result.emplace_back (buffer.events[i % kThreadBufferSize]);
+		// events are recorded when their scope ends, so parents follow their children
+		std::sort (result.begin () + first, result.end (), [] (const Event& a, const Event& b) {
+			if (a.begin == b.begin)
+				return a.duration > b.duration;
+			return a.begin < b.begin;
+		});
+	});
+	return result;
+}
+
+//------------------------------------------------------------------------
+ViewDrawTimeList collectViewDrawTimes (const EventList& events)
+{
+	std::unordered_map<const void*, size_t> viewIndices;
+	ViewDrawTimeList result;
+	// stack of the enclosing view draw events of the current thread
+	std::vector<std::pair<size_t, uint64_t>> stack; // index in result and end time
+	uint32_t threadID = 0;
+	for (const auto& event : events)
+	{
+		if (event.threadID != threadID)
+		{
+			stack.clear ();
+			threadID = event.threadID;
+		}
+		if (!event.name || strcmp (event.name, kViewDrawEventName) != 0)
+			continue;
+		while (!stack.empty () && stack.back ().second <= event.begin)
+			stack.pop_back ();
+
+		auto it = viewIndices.find (event.object);
+		if (it == viewIndices.end ())
+		{
+			it = viewIndices.emplace (event.object, result.size ()).first;
+			result.emplace_back ();
+			result.back ().view = event.object;
+			result.back ().className = demangleTypeName (event.detail);
+		}
+		auto& entry = result[it->second];
+		++entry.numDraws;
+		entry.totalTime += event.duration;
+		entry.selfTime += event.duration;
+		if (!stack.empty ())
+		{
+			auto& parent = result[stack.back ().first];
+			parent.selfTime -= std::min (parent.selfTime, event.duration);
+		}
+		stack.emplace_back (it->second, event.begin + event.duration);
+	}
+	std::sort (result.begin (), result.end (), [] (const ViewDrawTime& a, const ViewDrawTime& b) {
+		return a.selfTime > b.selfTime;
+	});
+	return result;
+}
+
+//------------------------------------------------------------------------
+std::string toChromeTraceJSON (const EventList& events)
+{
+	std::unordered_map<const char*, std::string> classNames;
+	std::string str;
+	str.reserve (events.size () * 128 + 64);
+	str += "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+	char buffer[128];
+	bool first = true;
+	for (const auto& event : events)
+	{
+		if (!first)
+			str += ',';
+		first = false;
+		str += "\n{\"name\":\"";
+		appendEscaped (str, event.name);
+		snprintf (buffer, sizeof (buffer),
+				  "\",\"cat\":\"vstgui\",\"ph\":\"X\",\"pid\":1,\"tid\":%" PRIu32
+				  ",\"ts\":%.3f,\"dur\":%.3f",
+				  event.threadID, static_cast<double> (event.begin) / 1000.,
+				  static_cast<double> (event.duration) / 1000.);
+		str += buffer;
+		if (event.object || event.detail)
+		{
+			str += ",\"args\":{";
+			if (event.object)
+			{
+				snprintf (buffer, sizeof (buffer), "\"object\":\"%p\"", event.object);
+				str += buffer;
+			}
+			if (event.detail)
+			{
+				auto it = classNames.find (event.detail);
+				if (it == classNames.end ())
+					it = classNames.emplace (event.detail, demangleTypeName (event.detail)).first;
+				if (event.object)
+					str += ',';
+				str += "\"class\":\"";
+				appendEscaped (str, it->second.data ());
+				str += '"';
+			}
+			str += '}';
+		}
+		str += '}';
+	}
+	str += "\n]}\n";
+	return str;
+}
+
+//------------------------------------------------------------------------
+bool writeChromeTrace (UTF8StringPtr filePath)
+{
+	std::ofstream stream (filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!stream.is_open ())
+		return false;
+	stream << toChromeTraceJSON ();
+	return static_cast<bool> (stream);
+}
+
+//------------------------------------------------------------------------
+} // Trace
+} // VSTGUI
@@ -0,0 +1,147 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#pragma once
+
+#include "vstguibase.h"
+#include <atomic>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace Trace {
+
+/** Scoped tracing of the hot paths
+ *
+ *	The library is instrumented with the VSTGUI_TRACE_SCOPE and VSTGUI_TRACE_VIEW_DRAW macros,
+ *	which only record anything when the library is compiled with VSTGUI_ENABLE_TRACING=1 and
+ *	tracing was enabled at runtime via Trace::setEnabled (true).
+ *
+ *	Every thread records into its own fixed size ring buffer, which is allocated once when the
+ *	thread records its first event. Names and details must be string literals or otherwise live as
+ *	long as the trace, as only the pointers are stored. When a buffer is full the oldest events
+ *	are overwritten.
+ *
+ *	The recorded events can be written in the Chrome trace event format, which can be loaded in
+ *	chrome://tracing or https://ui.perfetto.dev. Collecting the events while other threads record
+ *	may return partially written events, so tracing should be disabled before.
+ */
+
+//------------------------------------------------------------------------
+struct Event
+{
+	/** time in nanoseconds since the start of the process */
+	uint64_t begin {0};
+	uint64_t duration {0};
+	const char* name {nullptr};
+	const char* detail {nullptr};
+	const void* object {nullptr};
+	uint32_t threadID {0};
+};
+using EventList = std::vector<Event>;
+
+//------------------------------------------------------------------------
+struct ViewDrawTime
+{
+	const void* view {nullptr};
+	/** the demangled class name of the view */
+	std::string className;
+	uint64_t numDraws {0};
+	/** nanoseconds including the time for drawing the children */
+	uint64_t totalTime {0};
+	/** nanoseconds without the time for drawing the children */
+	uint64_t selfTime {0};
+};
+using ViewDrawTimeList = std::vector<ViewDrawTime>;
+
+/** the name of events recorded via VSTGUI_TRACE_VIEW_DRAW */
+static constexpr auto kViewDrawEventName = "CView::drawRect";
+/** number of events a thread buffer can hold */
+static constexpr size_t kThreadBufferSize = 1 << 14;
+
+namespace Detail {
+extern std::atomic<bool> enabled;
+} // Detail
+
+//------------------------------------------------------------------------
+inline bool isEnabled () { return Detail::enabled.load (std::memory_order_relaxed); }
+void setEnabled (bool state);
+/** remove all recorded events */
+void clear ();
+
+/** current time in nanoseconds since the start of the process */
+uint64_t now ();
+/** record an event into the buffer of the calling thread */
+void record (const char* name, const char* detail, const void* object, uint64_t begin,
+			 uint64_t end);
+
+/** all recorded events, sorted by thread and begin time */
+EventList collectEvents ();
+/** the draw times of all views, sorted by self time, the most expensive first */
+ViewDrawTimeList collectViewDrawTimes (const EventList& events);
+inline ViewDrawTimeList collectViewDrawTimes () { return collectViewDrawTimes (collectEvents ()); }
+
+/** the events in the Chrome trace event JSON format */
+std::string toChromeTraceJSON (const EventList& events);
+inline std::string toChromeTraceJSON () { return toChromeTraceJSON (collectEvents ()); }
+/** write all recorded events in the Chrome trace event JSON format to a file */
+bool writeChromeTrace (UTF8StringPtr filePath);
+
+/** the readable name of a type from std::type_info::name () */
+std::string demangleTypeName (const char* name);
+
+//------------------------------------------------------------------------
+class Scope
+{
+public:
+	explicit Scope (const char* name, const void* object = nullptr,
+					const char* detail = nullptr) noexcept
+	: name (name), detail (detail), object (object), begin (isEnabled () ? now () : 0)
+	{
+	}
+	~Scope () noexcept
+	{
+		if (begin)
+			record (name, detail, object, begin, now ());
+	}
+
+	Scope (const Scope&) = delete;
+	Scope& operator= (const Scope&) = delete;
+
+private:
+	const char* name;
+	const char* detail;
+	const void* object;
+	uint64_t begin;
+};
+
+//------------------------------------------------------------------------
+} // Trace
+} // VSTGUI
+
+#if VSTGUI_ENABLE_TRACING
+#include <typeinfo>
+
+#define VSTGUI_TRACE_CONCAT_PRIVATE_DONT_USE(x, y) x##y
+#define VSTGUI_TRACE_CONCAT(x, y) VSTGUI_TRACE_CONCAT_PRIVATE_DONT_USE (x, y)
+
+/** record the time until the end of the current scope */
+#define VSTGUI_TRACE_SCOPE(name)                                                                   \
+	VSTGUI::Trace::Scope VSTGUI_TRACE_CONCAT (vstguiTraceScope, __LINE__) (name)
+/** record the time until the end of the current scope and attribute it to the object */
+#define VSTGUI_TRACE_OBJECT_SCOPE(name, object)                                                    \
+	VSTGUI::Trace::Scope VSTGUI_TRACE_CONCAT (vstguiTraceScope, __LINE__) (name, object)
+/** record the time until the end of the current scope as draw time of the view */
+#define VSTGUI_TRACE_VIEW_DRAW(view)                                                               \
+	VSTGUI::Trace::Scope VSTGUI_TRACE_CONCAT (vstguiTraceScope, __LINE__) (                        \
+		VSTGUI::Trace::kViewDrawEventName, view, typeid (*view).name ())
+
+#else
+
+#define VSTGUI_TRACE_SCOPE(name)
+#define VSTGUI_TRACE_OBJECT_SCOPE(name, object)
+#define VSTGUI_TRACE_VIEW_DRAW(view)
+
+#endif // VSTGUI_ENABLE_TRACING
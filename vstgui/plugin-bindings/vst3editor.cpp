@@ -1237,9 +1237,12 @@ bool PLUGIN_API VST3Editor::open (void* parent, const PlatformType& type)
 	getFrame ()->registerKeyboardHook (keyboardHook);
 #endif
 	getFrame ()->enableTooltips (tooltipsEnabled);
+	if (description->getLazyBitmapLoading ())
+		getFrame ()->registerScaleFactorChangedListener (description);
 
 	if (!enableEditing (false))
 	{
+		getFrame ()->unregisterScaleFactorChangedListener (description);
 		getFrame ()->forget ();
 		return false;
 	}
@@ -1252,6 +1255,8 @@ bool PLUGIN_API VST3Editor::open (void* parent, const PlatformType& type)
 #endif
 
 	getFrame ()->open (parent, type, config);
+	if (description->getLazyBitmapLoading ())
+		description->setBitmapScaleFactor (getFrame ()->getScaleFactor ());
 
 	if (delegate)
 		delegate->didOpen (this);
@@ -1286,6 +1291,7 @@ void PLUGIN_API VST3Editor::close ()
 		openUIEditorController = nullptr;
 #endif
 		getFrame ()->unregisterMouseObserver (this);
+		getFrame ()->unregisterScaleFactorChangedListener (description);
 		getFrame ()->removeAll (true);
 		int32_t refCount = getFrame ()->getNbReference ();
 		if (refCount == 1)
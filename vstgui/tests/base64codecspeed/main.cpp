@@ -1,29 +1,115 @@
-// This file is part of VSTGUI. It is subject to the license terms 
+// This file is part of VSTGUI. It is subject to the license terms
 // in the LICENSE file found in the top-level directory of this
 // distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
 
 #include "vstgui/uidescription/base64codec.h"
 #include "vstgui/lib/malloc.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
 #include <random>
 
 using namespace VSTGUI;
 
-int main ()
+//------------------------------------------------------------------------
+/*	Usage: base64codecspeed [size in MB] [iterations]
+
+	Measures the throughput of every base64 kernel supported by the CPU, for encoding and decoding
+	into a caller provided buffer and for decoding into an OutputStream. All numbers are given in
+	GB/s of binary (decoded) data, the best run of all iterations is reported.
+*/
+
+//------------------------------------------------------------------------
+namespace {
+
+//------------------------------------------------------------------------
+struct NullOutputStream : OutputStream
+{
+	bool operator<< (const std::string& str) override { return true; }
+	uint32_t writeRaw (const void* buffer, uint32_t size) override
+	{
+		written += size;
+		return size;
+	}
+
+	size_t written {0};
+};
+
+//------------------------------------------------------------------------
+template<typename Proc>
+double measureGBPerSecond (size_t bytes, uint32_t iterations, Proc proc)
+{
+	using Clock = std::chrono::high_resolution_clock;
+	double best = 0.;
+	for (auto i = 0u; i < iterations; ++i)
+	{
+		auto start = Clock::now ();
+		proc ();
+		std::chrono::duration<double> duration = Clock::now () - start;
+		if (duration.count () > 0.)
+			best = std::max (best, static_cast<double> (bytes) / duration.count () / 1e9);
+	}
+	return best;
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+int main (int argc, char* argv[])
 {
+	size_t megaBytes = argc > 1 ? static_cast<size_t> (std::atoi (argv[1])) : 64;
+	uint32_t iterations = argc > 2 ? static_cast<uint32_t> (std::atoi (argv[2])) : 10;
+	if (megaBytes == 0 || iterations == 0)
+		return -1;
+
 	Buffer<uint8_t> origData;
-	origData.allocate (1024*1024*500);
+	origData.allocate (1024 * 1024 * megaBytes);
 
 	std::independent_bits_engine<std::default_random_engine, sizeof (uint16_t) * 8, uint16_t> rbe;
 	std::generate (origData.get (), origData.get () + origData.size (), std::ref (rbe));
 
-	auto encoderResult = Base64Codec::encode (origData.get (), origData.size ());
-	auto decoderResult = Base64Codec::decode (encoderResult.data.get (), encoderResult.dataSize);
+	Buffer<uint8_t> encoded (Base64Codec::getEncodedSize (origData.size ()));
+	Buffer<uint8_t> decoded (Base64Codec::getMaxDecodedSize (encoded.size ()));
 
-	if (origData.size () != decoderResult.dataSize)
-		return -1;
+	printf ("base64codecspeed: %zu MB, %u iterations, GB/s of binary data\n", megaBytes,
+	        iterations);
+	printf ("%-8s %10s %10s %10s\n", "kernel", "encode", "decode", "stream");
 
-	if (memcmp (origData.get (), decoderResult.data.get (), origData.size ()) != 0)
-		return -1;
-	return 0;
+	int result = 0;
+	using Kernel = Base64Codec::Kernel;
+	for (auto kernel : {Kernel::Scalar, Kernel::SSSE3, Kernel::AVX2, Kernel::NEON})
+	{
+		if (!Base64Codec::isKernelSupported (kernel))
+			continue;
+		size_t encodedSize = 0;
+		auto encodeSpeed = measureGBPerSecond (origData.size (), iterations, [&] () {
+			encodedSize = Base64Codec::encode (origData.get (), origData.size (), encoded.get (),
+			                                   encoded.size (), kernel);
+		});
+		size_t decodedSize = 0;
+		auto decodeSpeed = measureGBPerSecond (origData.size (), iterations, [&] () {
+			decodedSize = Base64Codec::decode (encoded.get (), encodedSize, decoded.get (),
+			                                   decoded.size (), kernel);
+		});
+		NullOutputStream stream;
+		auto streamSpeed = measureGBPerSecond (origData.size (), iterations, [&] () {
+			Base64Codec::decode (encoded.get (), encodedSize, stream, kernel);
+		});
+
+		printf ("%-8s %10.3f %10.3f %10.3f\n", Base64Codec::getKernelName (kernel), encodeSpeed,
+		        decodeSpeed, streamSpeed);
+
+		if (encodedSize != encoded.size () || decodedSize != origData.size () ||
+		    stream.written != origData.size () * iterations ||
+		    memcmp (origData.get (), decoded.get (), origData.size ()) != 0)
+		{
+			printf ("%s: roundtrip failed\n", Base64Codec::getKernelName (kernel));
+			result = -1;
+		}
+	}
+	return result;
 }
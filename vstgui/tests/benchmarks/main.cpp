@@ -0,0 +1,780 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "vstgui/lib/animation/animations.h"
+#include "vstgui/lib/animation/animator.h"
+#include "vstgui/lib/animation/itimingfunction.h"
+#include "vstgui/lib/animation/timingfunctions.h"
+#include "vstgui/lib/cbitmap.h"
+#include "vstgui/lib/cbitmapatlas.h"
+#include "vstgui/lib/cbitmapfilter.h"
+#include "vstgui/lib/coffscreencontext.h"
+#include "vstgui/lib/cshadowviewcontainer.h"
+#include "vstgui/lib/controls/ctextlabel.h"
+#include "vstgui/lib/cviewcontainer.h"
+#include "vstgui/lib/finally.h"
+#include "vstgui/lib/platform/common/viewlayercompositor.h"
+#include "vstgui/lib/platform/platformfactory.h"
+#include "vstgui/lib/vstguiinit.h"
+#include "vstgui/uidescription/cstream.h"
+#include "vstgui/uidescription/uicontentprovider.h"
+#include "vstgui/uidescription/uidescription.h"
+
+#define RAPIDJSON_HAS_STDSTRING 1
+#include "vstgui/uidescription/rapidjson/include/rapidjson/document.h"
+#include "vstgui/uidescription/rapidjson/include/rapidjson/istreamwrapper.h"
+#include "vstgui/uidescription/rapidjson/include/rapidjson/prettywriter.h"
+#include "vstgui/uidescription/rapidjson/include/rapidjson/stringbuffer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if MAC
+#include <CoreFoundation/CoreFoundation.h>
+#elif WINDOWS
+struct IUnknown;
+#include <windows.h>
+#endif
+
+using namespace VSTGUI;
+
+//------------------------------------------------------------------------
+/*	Usage: vstgui_benchmarks [options]
+
+	--size N          the synthetic editor has N x N controls in N nested rows (default 16)
+	--iterations N    runs of every benchmark (default 20)
+	--filter TEXT     only run the benchmarks whose name contains TEXT
+	--output FILE     write the results as JSON to FILE
+	--baseline FILE   compare the results with a JSON file written by --output
+	--tolerance P     a benchmark regressed if its median is P percent slower than the baseline
+	                  (default 10), the exit code is 1 if any benchmark regressed
+
+	Every benchmark runs on a generated editor. Drawing goes into an offscreen context, so no
+	display is needed. The minimum, median and mean time of all iterations are reported in
+	milliseconds.
+*/
+
+//------------------------------------------------------------------------
+namespace {
+
+static constexpr CCoord kCellWidth = 64.;
+static constexpr CCoord kCellHeight = 40.;
+static constexpr uint32_t kBitmapSize = 512;
+static constexpr uint32_t kNumTimingFunctionEvaluations = 10000;
+static constexpr uint32_t kNumIcons = 256;
+static constexpr CCoord kIconSize = 16.;
+static constexpr uint32_t kPanelColumns = 5;
+static constexpr uint32_t kPanelRows = 10;
+static constexpr uint32_t kNumSlideTicks = 30;
+static constexpr uint32_t kNumShadowContainers = 16;
+static constexpr uint32_t kNumNinePartPanels = 12;
+static constexpr uint32_t kNumResizeSteps = 30;
+static constexpr auto kEditorTemplate = "editor";
+
+//------------------------------------------------------------------------
+struct Options
+{
+	uint32_t size {16};
+	uint32_t iterations {20};
+	double tolerance {10.};
+	std::string filter;
+	std::string outputPath;
+	std::string baselinePath;
+};
+
+//------------------------------------------------------------------------
+struct Result
+{
+	std::string name;
+	double min {0.};
+	double median {0.};
+	double mean {0.};
+};
+
+//------------------------------------------------------------------------
+using Clock = std::chrono::high_resolution_clock;
+
+//------------------------------------------------------------------------
+template<typename Proc>
+Result measure (const std::string& name, uint32_t iterations, Proc proc)
+{
+	std::vector<double> durations;
+	durations.reserve (iterations);
+	for (auto i = 0u; i < iterations; ++i)
+	{
+		auto start = Clock::now ();
+		proc ();
+		std::chrono::duration<double, std::milli> duration = Clock::now () - start;
+		durations.emplace_back (duration.count ());
+	}
+	std::sort (durations.begin (), durations.end ());
+	Result result;
+	result.name = name;
+	result.min = durations.front ();
+	result.median = durations[durations.size () / 2];
+	for (auto d : durations)
+		result.mean += d;
+	result.mean /= static_cast<double> (durations.size ());
+	return result;
+}
+
+//------------------------------------------------------------------------
+std::string createDescription (uint32_t size)
+{
+	static const char* controls[] = {
+	    "class=\"CKnob\"",
+	    "class=\"CSlider\" orientation=\"horizontal\"",
+	    "class=\"CTextLabel\" title=\"Label\"",
+	    "class=\"CCheckBox\" title=\"Check\"",
+	    "class=\"CTextButton\" title=\"Button\"",
+	};
+	constexpr auto numControls = sizeof (controls) / sizeof (controls[0]);
+
+	auto width = std::to_string (static_cast<uint32_t> (size * kCellWidth));
+	auto height = std::to_string (static_cast<uint32_t> (size * kCellHeight));
+	std::string xml =
+	    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<vstgui-ui-description version=\"1\">\n";
+	xml += "\t<template name=\"" + std::string (kEditorTemplate) +
+	       "\" class=\"CViewContainer\" origin=\"0, 0\" size=\"" + width + ", " + height +
+	       "\" background-color=\"~ BlackCColor\">\n";
+	for (auto row = 0u; row < size; ++row)
+	{
+		xml += "\t\t<view class=\"CViewContainer\" origin=\"0, " +
+		       std::to_string (static_cast<uint32_t> (row * kCellHeight)) + "\" size=\"" + width +
+		       ", " + std::to_string (static_cast<uint32_t> (kCellHeight)) +
+		       "\" transparent=\"true\">\n";
+		for (auto column = 0u; column < size; ++column)
+		{
+			xml += "\t\t\t<view " + std::string (controls[(row + column) % numControls]) +
+			       " origin=\"" + std::to_string (static_cast<uint32_t> (column * kCellWidth)) +
+			       ", 0\" size=\"" + std::to_string (static_cast<uint32_t> (kCellWidth - 4)) +
+			       ", " + std::to_string (static_cast<uint32_t> (kCellHeight - 4)) + "\"/>\n";
+		}
+		xml += "\t\t</view>\n";
+	}
+	xml += "\t</template>\n</vstgui-ui-description>\n";
+	return xml;
+}
+
+//------------------------------------------------------------------------
+SharedPointer<UIDescription> parseDescription (IContentProvider& provider)
+{
+	provider.rewind ();
+	auto description = makeOwned<UIDescription> (&provider);
+	if (!description->parse ())
+		return nullptr;
+	return description;
+}
+
+//------------------------------------------------------------------------
+SharedPointer<CViewContainer> createEditor (const UIDescription& description)
+{
+	auto view = description.createView (kEditorTemplate, nullptr);
+	auto container = view ? view->asViewContainer () : nullptr;
+	if (!container)
+	{
+		if (view)
+			view->forget ();
+		return nullptr;
+	}
+	return owned (container);
+}
+
+//------------------------------------------------------------------------
+/** advances the animation on every tick, independent of the resolution of the platform ticks */
+class SteppingTimingFunction : public Animation::ITimingFunction
+{
+public:
+	float getPosition (uint32_t) override
+	{
+		step = (step + 1) % 1000;
+		return static_cast<float> (step) / 1000.f;
+	}
+	bool isDone (uint32_t) override { return false; }
+
+private:
+	uint32_t step {0};
+};
+
+//------------------------------------------------------------------------
+template<typename Proc>
+void forEachControl (CViewContainer* editor, Proc proc)
+{
+	editor->forEachChild ([&] (CView* row) {
+		if (auto rowContainer = row->asViewContainer ())
+			rowContainer->forEachChild (proc);
+	});
+}
+
+//------------------------------------------------------------------------
+SharedPointer<CBitmap> createFilterBitmap ()
+{
+	auto bitmap = makeOwned<CBitmap> (CPoint (kBitmapSize, kBitmapSize));
+	if (auto pixelAccess = owned (CBitmapPixelAccess::create (bitmap)))
+	{
+		CColor color;
+		for (auto y = 0u; y < kBitmapSize; ++y)
+		{
+			pixelAccess->setPosition (0, y);
+			for (auto x = 0u; x < kBitmapSize; ++x, ++(*pixelAccess))
+			{
+				color.red = static_cast<uint8_t> (x);
+				color.green = static_cast<uint8_t> (y);
+				color.blue = static_cast<uint8_t> (x ^ y);
+				color.alpha = 255;
+				pixelAccess->setColor (color);
+			}
+		}
+	}
+	return bitmap;
+}
+
+//------------------------------------------------------------------------
+using FilterSetupFunc = std::function<void (BitmapFilter::IFilter* filter)>;
+
+//------------------------------------------------------------------------
+bool runFilter (IdStringPtr name, CBitmap* input, const FilterSetupFunc& setup = nullptr)
+{
+	auto filter = owned (BitmapFilter::Factory::getInstance ().createFilter (name));
+	if (!filter)
+		return false;
+	filter->setProperty (BitmapFilter::Standard::Property::kInputBitmap, input);
+	if (setup)
+		setup (filter);
+	return filter->run ();
+}
+
+//------------------------------------------------------------------------
+class BenchmarkRunner
+{
+public:
+	explicit BenchmarkRunner (const Options& options) : options (options) {}
+
+	template<typename Proc>
+	void run (const std::string& name, Proc proc)
+	{
+		if (!options.filter.empty () && name.find (options.filter) == std::string::npos)
+			return;
+		results.emplace_back (measure (name, options.iterations, proc));
+		const auto& r = results.back ();
+		printf ("%-28s %12.4f %12.4f %12.4f\n", r.name.data (), r.min, r.median, r.mean);
+	}
+
+	const std::vector<Result>& getResults () const { return results; }
+
+private:
+	const Options& options;
+	std::vector<Result> results;
+};
+
+//------------------------------------------------------------------------
+class OffscreenLayerSurface : public IViewLayerSurface
+{
+public:
+	OffscreenLayerSurface (const CPoint& size, double scaleFactor)
+	: context (COffscreenContext::create (size / scaleFactor, scaleFactor))
+	{
+	}
+
+	bool isValid () const { return context != nullptr; }
+	CDrawContext& getDrawContext () override { return *context; }
+	void drawInto (CDrawContext& c, const CPoint& pos, float alpha) override
+	{
+		auto bitmap = context->getBitmap ();
+		c.drawBitmap (bitmap, CRect (pos, bitmap->getSize ()), CPoint (), alpha);
+	}
+
+private:
+	SharedPointer<COffscreenContext> context;
+};
+
+//------------------------------------------------------------------------
+struct ViewLayerDelegate : IPlatformViewLayerDelegate
+{
+	explicit ViewLayerDelegate (CView* view) : view (view) {}
+
+	void drawViewLayer (CDrawContext* context, const CRect& dirtyRect) override
+	{
+		view->drawRect (context, dirtyRect);
+	}
+
+	CView* view;
+};
+
+//------------------------------------------------------------------------
+bool runBenchmarks (const Options& options, BenchmarkRunner& runner, uint32_t& numViews)
+{
+	auto xml = createDescription (options.size);
+	MemoryContentProvider provider (xml.data (), static_cast<uint32_t> (xml.size ()));
+	runner.run ("uidesc_parse", [&] () { parseDescription (provider); });
+
+	auto description = parseDescription (provider);
+	if (!description)
+	{
+		printf ("parsing the description failed\n");
+		return false;
+	}
+	runner.run ("template_instantiation", [&] () { createEditor (*description); });
+
+	auto editor = createEditor (*description);
+	if (!editor)
+	{
+		printf ("creating the editor failed\n");
+		return false;
+	}
+	numViews = 0;
+	forEachControl (editor, [&] (CView*) { ++numViews; });
+
+	auto editorSize = editor->getViewSize ();
+	auto context = COffscreenContext::create (editorSize.getSize ());
+	if (!context)
+	{
+		printf ("creating the offscreen context failed\n");
+		return false;
+	}
+	runner.run ("full_repaint", [&] () {
+		context->beginDraw ();
+		editor->drawRect (context, editorSize);
+		context->endDraw ();
+	});
+
+	auto center = editorSize.getCenter ();
+	CRect cell (center, CPoint (kCellWidth, kCellHeight));
+	runner.run ("partial_repaint", [&] () {
+		context->beginDraw ();
+		editor->drawRect (context, cell);
+		context->endDraw ();
+	});
+
+	runner.run ("hit_test", [&] () {
+		for (auto y = kCellHeight / 2.; y < editorSize.bottom; y += kCellHeight)
+		{
+			for (auto x = kCellWidth / 2.; x < editorSize.right; x += kCellWidth)
+				editor->getViewAt (CPoint (x, y), GetViewOptions ().deep ());
+		}
+	});
+
+	auto animator = makeOwned<Animation::Animator> ();
+	forEachControl (editor, [&] (CView* view) {
+		animator->addAnimation (view, "benchmark", new Animation::AlphaValueAnimation (0.f),
+		                        new SteppingTimingFunction);
+	});
+	runner.run ("animation_tick", [&] () { animator->onTimer (); });
+	forEachControl (editor, [&] (CView* view) { animator->removeAnimations (view); });
+
+	// sliding a panel of 50 labels by its width, the parent is redrawn on every tick
+	CRect panelRect (0., 0., kPanelColumns * kCellWidth, kPanelRows * kCellHeight);
+	auto slideParent = makeOwned<CViewContainer> (
+		CRect (0., 0., panelRect.getWidth () * 2., panelRect.getHeight ()));
+	auto panel = new CViewContainer (panelRect);
+	for (auto i = 0u; i < kPanelColumns * kPanelRows; ++i)
+	{
+		CRect r (CPoint ((i % kPanelColumns) * kCellWidth, (i / kPanelColumns) * kCellHeight),
+				 CPoint (kCellWidth, kCellHeight));
+		panel->addView (new CTextLabel (r, "Label"));
+	}
+	slideParent->addView (panel);
+	auto slideContext = COffscreenContext::create (slideParent->getViewSize ().getSize ());
+	auto slidePanel = [&] (bool useOffscreenLayer) {
+		auto target = panel->getViewSize ();
+		target.offset (target.left == 0. ? panelRect.getWidth () : -panelRect.getWidth (), 0.);
+		Animation::ViewSizeAnimation animation (target, false, useOffscreenLayer);
+		animation.animationStart (panel, "slide");
+		for (auto i = 1u; i <= kNumSlideTicks; ++i)
+		{
+			animation.animationTick (panel, "slide", static_cast<float> (i) / kNumSlideTicks);
+			slideContext->beginDraw ();
+			slideParent->drawRect (slideContext, slideParent->getViewSize ());
+			slideContext->endDraw ();
+		}
+		animation.animationFinished (panel, "slide", false);
+	};
+	if (slideContext)
+	{
+		runner.run ("panel_slide", [&] () { slidePanel (false); });
+		runner.run ("panel_slide_layer", [&] () { slidePanel (true); });
+	}
+
+	// moving the panel over the editor, by redrawing the editor below it on every tick and by
+	// compositing it as a view layer over a base buffer of the editor
+	auto overlayPanel = makeOwned<CViewContainer> (panelRect);
+	for (auto i = 0u; i < kPanelColumns * kPanelRows; ++i)
+	{
+		CRect r (CPoint ((i % kPanelColumns) * kCellWidth, (i / kPanelColumns) * kCellHeight),
+				 CPoint (kCellWidth, kCellHeight));
+		overlayPanel->addView (new CTextLabel (r, "Label"));
+	}
+	auto overlayRect = [&] (uint32_t tick) {
+		CRect r (panelRect);
+		r.offset (tick * (editorSize.getWidth () - panelRect.getWidth ()) / kNumSlideTicks, 0.);
+		return r;
+	};
+	runner.run ("layer_move_redraw", [&] () {
+		for (auto i = 1u; i <= kNumSlideTicks; ++i)
+		{
+			CRect dirty (overlayRect (i - 1));
+			dirty.unite (overlayRect (i));
+			context->beginDraw ();
+			editor->drawRect (context, dirty);
+			context->setClipRect (dirty);
+			CDrawContext::Transform t (*context,
+									   CGraphicsTransform ().translate (overlayRect (i).getTopLeft ()));
+			overlayPanel->drawRect (context, panelRect);
+			context->endDraw ();
+		}
+	});
+	auto baseContext = COffscreenContext::create (editorSize.getSize ());
+	if (baseContext)
+	{
+		baseContext->beginDraw ();
+		editor->drawRect (baseContext, editorSize);
+		baseContext->endDraw ();
+		auto baseBitmap = baseContext->getBitmap ();
+		CRect compositeRect;
+		ViewLayerCompositor compositor (
+			[] (const CPoint& size, double scaleFactor) {
+				auto surface = std::make_unique<OffscreenLayerSurface> (size, scaleFactor);
+				return surface->isValid () ? std::move (surface) : nullptr;
+			},
+			[&] (const CRect& r) {
+				if (compositeRect.isEmpty ())
+					compositeRect = r;
+				else
+					compositeRect.unite (r);
+			});
+		ViewLayerDelegate layerDelegate (overlayPanel);
+		auto layer = compositor.createLayer (&layerDelegate);
+		runner.run ("layer_move_composite", [&] () {
+			for (auto i = 1u; i <= kNumSlideTicks; ++i)
+			{
+				compositeRect = {};
+				layer->setSize (overlayRect (i));
+				compositor.render ();
+				context->beginDraw ();
+				context->setClipRect (compositeRect);
+				context->drawBitmap (baseBitmap, compositeRect, compositeRect.getTopLeft ());
+				compositor.composite (*context, compositeRect);
+				context->endDraw ();
+			}
+		});
+	}
+
+	// the first draw of 16 shadow containers with the same content, with different blur sizes every
+	// shadow is blurred, otherwise the shadow is blurred once and shared
+	auto drawShadowContainers = [&] (bool sameBlurSize) {
+		auto shadowParent = makeOwned<CViewContainer> (
+			CRect (0., 0., kNumShadowContainers * kCellWidth * 2., kCellHeight * 2.));
+		for (auto i = 0u; i < kNumShadowContainers; ++i)
+		{
+			CRect r (CPoint (i * kCellWidth * 2., 0.), CPoint (kCellWidth * 2., kCellHeight * 2.));
+			auto container = new CShadowViewContainer (r);
+			container->setShadowBlurSize (sameBlurSize ? 4. : 4. + i * 0.25);
+			container->addView (new CTextLabel (CRect (8., 8., kCellWidth, kCellHeight), "Label"));
+			shadowParent->addView (container);
+		}
+		auto shadowContext = COffscreenContext::create (shadowParent->getViewSize ().getSize ());
+		shadowContext->beginDraw ();
+		shadowParent->drawRect (shadowContext, shadowParent->getViewSize ());
+		shadowContext->endDraw ();
+	};
+	runner.run ("shadow_draw_unique", [&] () { drawShadowContainers (false); });
+	runner.run ("shadow_draw_shared", [&] () { drawShadowContainers (true); });
+
+	// a window full of panels with a nine-part background, redrawn while it is resized and redrawn
+	// at the same size, with and without the composed bitmap cache
+	auto ninePartBitmap = makeOwned<CNinePartTiledBitmap> (
+		getPlatformFactory ().createBitmap (CPoint (24., 24.)),
+		CNinePartTiledDescription (8., 8., 8., 8.));
+	auto ninePartWindow = makeOwned<CViewContainer> (CRect ());
+	for (auto i = 0u; i < kNumNinePartPanels; ++i)
+	{
+		auto panel = new CViewContainer (CRect ());
+		panel->setBackground (ninePartBitmap);
+		ninePartWindow->addView (panel);
+	}
+	auto ninePartContext = COffscreenContext::create (CPoint (1200., 600.));
+	auto layoutNinePartWindow = [&] (CPoint size) {
+		ninePartWindow->setViewSize (CRect (CPoint (), size));
+		auto panelSize = CPoint (size.x / 4., size.y / 3.);
+		auto index = 0u;
+		ninePartWindow->forEachChild ([&] (CView* panel) {
+			panel->setViewSize (CRect (
+				CPoint ((index % 4) * panelSize.x, (index / 4) * panelSize.y), panelSize));
+			++index;
+		});
+	};
+	// the resize step counts on over all iterations, so that a size is never drawn twice
+	uint32_t resizeStep = 0;
+	auto nextResizeSize = [&] () {
+		auto step = resizeStep++;
+		return CPoint (600. + (step % 600), 300. + (step / 600));
+	};
+	auto redrawNinePartWindow = [&] (bool resize) {
+		for (auto i = 0u; i < kNumResizeSteps; ++i)
+		{
+			layoutNinePartWindow (resize ? nextResizeSize () : CPoint (1200., 600.));
+			ninePartContext->beginDraw ();
+			ninePartWindow->drawRect (ninePartContext, ninePartWindow->getViewSize ());
+			ninePartContext->endDraw ();
+		}
+	};
+	if (ninePartContext)
+	{
+		runner.run ("ninepart_resize", [&] () { redrawNinePartWindow (true); });
+		runner.run ("ninepart_redraw", [&] () { redrawNinePartWindow (false); });
+		CNinePartTiledBitmap::setCacheBudget (0);
+		runner.run ("ninepart_resize_uncached", [&] () { redrawNinePartWindow (true); });
+		runner.run ("ninepart_redraw_uncached", [&] () { redrawNinePartWindow (false); });
+		CNinePartTiledBitmap::setCacheBudget (CNinePartTiledBitmap::kDefaultCacheBudget);
+	}
+
+	// the positions of 10000 animations in one frame, directly and via a lookup table
+	auto runTimingFunction = [&] (const std::string& name, Animation::ITimingFunction& tf) {
+		volatile float sum = 0.f;
+		runner.run (name, [&] () {
+			float s = 0.f;
+			for (auto i = 0u; i < kNumTimingFunctionEvaluations; ++i)
+				s += tf.getPosition (i % 1000);
+			sum = s;
+		});
+	};
+	Animation::CubicBezierTimingFunction bezier (1000, CPoint (0.25, 0.1), CPoint (0.25, 1.));
+	Animation::PowerTimingFunction power (1000, 2.5f);
+	Animation::InterpolationTimingFunction interpolation (1000);
+	for (auto i = 1; i < 8; ++i)
+		interpolation.addPoint (i / 8.f, (i * i) / 64.f);
+	runTimingFunction ("timing_cubic_bezier", bezier);
+	runTimingFunction ("timing_cubic_bezier_lut",
+					   *std::unique_ptr<Animation::ITimingFunction> (
+						   Animation::LookupTableTimingFunction::cubicBezier (
+							   1000, CPoint (0.25, 0.1), CPoint (0.25, 1.))));
+	runTimingFunction ("timing_power", power);
+	runTimingFunction ("timing_power_lut", *std::unique_ptr<Animation::ITimingFunction> (
+											   Animation::LookupTableTimingFunction::power (1000, 2.5f)));
+	runTimingFunction ("timing_interpolation", interpolation);
+	runTimingFunction ("timing_interpolation_lut",
+					   *std::unique_ptr<Animation::ITimingFunction> (
+						   Animation::LookupTableTimingFunction::bake (interpolation)));
+
+	// many small icons as separate bitmaps and packed into an atlas
+	CBitmapAtlas::NamedBitmapList icons;
+	for (auto i = 0u; i < kNumIcons; ++i)
+		icons.emplace_back (std::to_string (i), makeOwned<CBitmap> (CPoint (kIconSize, kIconSize)));
+	auto atlas = CBitmapAtlas::pack (icons);
+	auto iconContext = COffscreenContext::create (CPoint (kIconSize * 16., kIconSize * 16.));
+	auto drawIcons = [&] (const CBitmapAtlas::NamedBitmapList& list) {
+		iconContext->beginDraw ();
+		for (auto i = 0u; i < list.size (); ++i)
+		{
+			CRect r (CPoint ((i % 16) * kIconSize, (i / 16) * kIconSize),
+					 CPoint (kIconSize, kIconSize));
+			list[i].second->draw (iconContext, r);
+		}
+		iconContext->endDraw ();
+	};
+	if (iconContext)
+	{
+		CBitmapAtlas::NamedBitmapList atlasIcons;
+		for (const auto& entry : atlas->getEntries ())
+			atlasIcons.emplace_back (entry.name, entry.bitmap);
+		runner.run ("icons_draw_bitmaps", [&] () { drawIcons (icons); });
+		runner.run ("icons_draw_atlas", [&] () { drawIcons (atlasIcons); });
+	}
+
+	auto bitmap = createFilterBitmap ();
+	runner.run ("filter_box_blur", [&] () {
+		runFilter (BitmapFilter::Standard::kBoxBlur, bitmap, [] (BitmapFilter::IFilter* filter) {
+			filter->setProperty (BitmapFilter::Standard::Property::kRadius, 8);
+		});
+	});
+	runner.run ("filter_grayscale", [&] () {
+		runFilter (BitmapFilter::Standard::kGrayscale, bitmap);
+	});
+	runner.run ("filter_scale_bilinear", [&] () {
+		runFilter (BitmapFilter::Standard::kScaleBilinear, bitmap,
+		           [] (BitmapFilter::IFilter* filter) {
+			           filter->setProperty (BitmapFilter::Standard::Property::kOutputRect,
+			                                CRect (0, 0, kBitmapSize / 2, kBitmapSize / 2));
+		           });
+	});
+	return true;
+}
+
+//------------------------------------------------------------------------
+bool writeResults (const std::string& path, const Options& options, uint32_t numViews,
+                   const std::vector<Result>& results)
+{
+	rapidjson::StringBuffer buffer;
+	rapidjson::PrettyWriter<rapidjson::StringBuffer> writer (buffer);
+	writer.StartObject ();
+	writer.Key ("size");
+	writer.Uint (options.size);
+	writer.Key ("iterations");
+	writer.Uint (options.iterations);
+	writer.Key ("views");
+	writer.Uint (numViews);
+	writer.Key ("results");
+	writer.StartArray ();
+	for (const auto& result : results)
+	{
+		writer.StartObject ();
+		writer.Key ("name");
+		writer.String (result.name);
+		writer.Key ("min_ms");
+		writer.Double (result.min);
+		writer.Key ("median_ms");
+		writer.Double (result.median);
+		writer.Key ("mean_ms");
+		writer.Double (result.mean);
+		writer.EndObject ();
+	}
+	writer.EndArray ();
+	writer.EndObject ();
+
+	CFileStream stream;
+	if (!stream.open (path.data (), CFileStream::kWriteMode | CFileStream::kTruncateMode))
+		return false;
+	stream << std::string (buffer.GetString (), buffer.GetSize ());
+	return true;
+}
+
+//------------------------------------------------------------------------
+bool readBaseline (const std::string& path, std::map<std::string, double>& medians)
+{
+	std::ifstream stream (path);
+	if (!stream.is_open ())
+		return false;
+	rapidjson::IStreamWrapper wrapper (stream);
+	rapidjson::Document document;
+	document.ParseStream (wrapper);
+	if (document.HasParseError () || !document.IsObject ())
+		return false;
+	auto results = document.FindMember ("results");
+	if (results == document.MemberEnd () || !results->value.IsArray ())
+		return false;
+	for (const auto& entry : results->value.GetArray ())
+	{
+		auto name = entry.FindMember ("name");
+		auto median = entry.FindMember ("median_ms");
+		if (name == entry.MemberEnd () || median == entry.MemberEnd () ||
+		    !name->value.IsString () || !median->value.IsNumber ())
+			continue;
+		medians[name->value.GetString ()] = median->value.GetDouble ();
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------
+/** returns the number of regressed benchmarks */
+uint32_t compareWithBaseline (const std::map<std::string, double>& baseline,
+                              const std::vector<Result>& results, double tolerance)
+{
+	printf ("\n%-28s %12s %12s %12s\n", "compared to baseline", "baseline", "median", "change %");
+	uint32_t numRegressions = 0;
+	for (const auto& result : results)
+	{
+		auto it = baseline.find (result.name);
+		if (it == baseline.end () || it->second <= 0.)
+		{
+			printf ("%-28s %12s %12.4f\n", result.name.data (), "-", result.median);
+			continue;
+		}
+		auto change = (result.median / it->second - 1.) * 100.;
+		bool regressed = change > tolerance;
+		if (regressed)
+			++numRegressions;
+		printf ("%-28s %12.4f %12.4f %+12.1f%s\n", result.name.data (), it->second, result.median,
+		        change, regressed ? "  REGRESSION" : "");
+	}
+	return numRegressions;
+}
+
+//------------------------------------------------------------------------
+bool parseOptions (int argc, char* argv[], Options& options)
+{
+	for (auto i = 1; i < argc; ++i)
+	{
+		std::string arg (argv[i]);
+		if (i + 1 >= argc)
+			return false;
+		std::string value (argv[++i]);
+		if (arg == "--size")
+			options.size = static_cast<uint32_t> (std::atoi (value.data ()));
+		else if (arg == "--iterations")
+			options.iterations = static_cast<uint32_t> (std::atoi (value.data ()));
+		else if (arg == "--tolerance")
+			options.tolerance = std::atof (value.data ());
+		else if (arg == "--filter")
+			options.filter = value;
+		else if (arg == "--output")
+			options.outputPath = value;
+		else if (arg == "--baseline")
+			options.baselinePath = value;
+		else
+			return false;
+	}
+	return options.size > 0 && options.iterations > 0;
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+int main (int argc, char* argv[])
+{
+	Options options;
+	if (!parseOptions (argc, argv, options))
+	{
+		printf ("usage: vstgui_benchmarks [--size N] [--iterations N] [--filter TEXT] "
+		        "[--output FILE] [--baseline FILE] [--tolerance PERCENT]\n");
+		return -1;
+	}
+
+#if MAC
+	VSTGUI::init (CFBundleGetMainBundle ());
+#elif WINDOWS
+	CoInitialize (nullptr);
+	VSTGUI::init (GetModuleHandle (nullptr));
+#elif LINUX
+	VSTGUI::init (nullptr);
+#endif
+	auto cleanup = finally ([] () { VSTGUI::exit (); });
+
+	printf ("vstgui_benchmarks: %u x %u controls, %u iterations, milliseconds\n", options.size,
+	        options.size, options.iterations);
+	printf ("%-28s %12s %12s %12s\n", "benchmark", "min", "median", "mean");
+
+	BenchmarkRunner runner (options);
+	uint32_t numViews = 0;
+	if (!runBenchmarks (options, runner, numViews))
+		return -1;
+
+	if (!options.outputPath.empty () &&
+	    !writeResults (options.outputPath, options, numViews, runner.getResults ()))
+	{
+		printf ("writing %s failed\n", options.outputPath.data ());
+		return -1;
+	}
+	if (!options.baselinePath.empty ())
+	{
+		std::map<std::string, double> baseline;
+		if (!readBaseline (options.baselinePath, baseline))
+		{
+			printf ("reading %s failed\n", options.baselinePath.data ());
+			return -1;
+		}
+		if (compareWithBaseline (baseline, runner.getResults (), options.tolerance) > 0)
+			return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,204 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "vstgui/lib/cdatabrowser.h"
+#include "vstgui/lib/cdrawcontext.h"
+#include "vstgui/lib/finally.h"
+#include "vstgui/lib/idatabrowserdelegate.h"
+#include "vstgui/lib/vstguiinit.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#if MAC
+#include <CoreFoundation/CoreFoundation.h>
+#elif WINDOWS
+struct IUnknown;
+#include <windows.h>
+#endif
+
+using namespace VSTGUI;
+
+//------------------------------------------------------------------------
+/*	Usage: databrowserspeed [rows] [selected rows] [draws]
+
+	Creates a data browser with the given number of rows of which every n-th row is selected and
+	measures the time to select the rows, to scroll through the list drawing the visible area
+	after every scroll step and to unselect every other selected row. Drawing happens into a context which does not render anything, so
+	only the cost of the data browser itself is measured.
+*/
+
+//------------------------------------------------------------------------
+namespace {
+
+static constexpr auto kNumColumns = 4;
+static constexpr CCoord kRowHeight = 20.;
+static constexpr CCoord kColumnWidth = 100.;
+
+//------------------------------------------------------------------------
+class NullDrawContext : public CDrawContext
+{
+public:
+	explicit NullDrawContext (const CRect& size) : CDrawContext (size) { init (); }
+
+	void drawLine (const LinePair& line) override { ++numLines; }
+	void drawLines (const LineList& lines) override { numLines += lines.size (); }
+	void drawPolygon (const PointList& polygonPointList, const CDrawStyle drawStyle) override {}
+	void drawRect (const CRect& rect, const CDrawStyle drawStyle) override {}
+	void drawArc (const CRect& rect, const float startAngle1, const float endAngle2,
+	              const CDrawStyle drawStyle) override
+	{
+	}
+	void drawEllipse (const CRect& rect, const CDrawStyle drawStyle) override {}
+	void drawPoint (const CPoint& point, const CColor& color) override {}
+	void drawBitmap (CBitmap* bitmap, const CRect& dest, const CPoint& offset, float alpha) override
+	{
+	}
+	void clearRect (const CRect& rect) override {}
+	CGraphicsPath* createGraphicsPath () override { return nullptr; }
+	CGraphicsPath* createTextPath (const CFontRef font, UTF8StringPtr text) override
+	{
+		return nullptr;
+	}
+	void drawGraphicsPath (CGraphicsPath* path, PathDrawMode mode,
+	                       CGraphicsTransform* transformation) override
+	{
+	}
+	void fillLinearGradient (CGraphicsPath* path, const CGradient& gradient,
+	                         const CPoint& startPoint, const CPoint& endPoint, bool evenOdd,
+	                         CGraphicsTransform* transformation) override
+	{
+	}
+	void fillRadialGradient (CGraphicsPath* path, const CGradient& gradient, const CPoint& center,
+	                         CCoord radius, const CPoint& originOffset, bool evenOdd,
+	                         CGraphicsTransform* transformation) override
+	{
+	}
+
+	size_t numLines {0};
+};
+
+//------------------------------------------------------------------------
+class Delegate : public DataBrowserDelegateAdapter
+{
+public:
+	explicit Delegate (int32_t numRows) : numRows (numRows) {}
+
+	int32_t dbGetNumRows (CDataBrowser* browser) override { return numRows; }
+	int32_t dbGetNumColumns (CDataBrowser* browser) override { return kNumColumns; }
+	CCoord dbGetRowHeight (CDataBrowser* browser) override { return kRowHeight; }
+	CCoord dbGetCurrentColumnWidth (int32_t index, CDataBrowser* browser) override
+	{
+		return kColumnWidth;
+	}
+	bool dbGetLineWidthAndColor (CCoord& width, CColor& color, CDataBrowser* browser) override
+	{
+		width = 1.;
+		color = kGreyCColor;
+		return true;
+	}
+	void dbDrawHeader (CDrawContext* context, const CRect& size, int32_t column, int32_t flags,
+	                   CDataBrowser* browser) override
+	{
+	}
+	void dbDrawCell (CDrawContext* context, const CRect& size, int32_t row, int32_t column,
+	                 int32_t flags, CDataBrowser* browser) override
+	{
+		++drawnCells;
+		if (flags & kRowSelected)
+			++drawnSelectedCells;
+	}
+
+	int32_t numRows;
+	size_t drawnCells {0};
+	size_t drawnSelectedCells {0};
+};
+
+//------------------------------------------------------------------------
+template<typename Proc>
+double measureMilliseconds (Proc proc)
+{
+	using Clock = std::chrono::high_resolution_clock;
+	auto start = Clock::now ();
+	proc ();
+	std::chrono::duration<double, std::milli> duration = Clock::now () - start;
+	return duration.count ();
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+int main (int argc, char* argv[])
+{
+#if MAC
+	VSTGUI::init (CFBundleGetMainBundle ());
+#elif WINDOWS
+	CoInitialize (nullptr);
+	VSTGUI::init (GetModuleHandle (nullptr));
+#elif LINUX
+	VSTGUI::init (nullptr);
+#endif
+	auto cleanup = finally ([] () { VSTGUI::exit (); });
+
+	int32_t numRows = argc > 1 ? std::atoi (argv[1]) : 1000000;
+	int32_t numSelected = argc > 2 ? std::atoi (argv[2]) : 10000;
+	int32_t numDraws = argc > 3 ? std::atoi (argv[3]) : 1000;
+	if (numRows <= 0 || numSelected <= 0 || numSelected > numRows || numDraws <= 0)
+		return -1;
+
+	Delegate delegate (numRows);
+	CRect size (0, 0, kNumColumns * (kColumnWidth + 1) + 16, 600);
+	auto browser = makeOwned<CDataBrowser> (size, &delegate,
+	                                        CDataBrowser::kDrawRowLines |
+	                                            CDataBrowser::kMultiSelectionStyle |
+	                                            CScrollView::kVerticalScrollbar);
+	browser->recalculateLayout (true);
+
+	auto selectionStep = numRows / numSelected;
+	auto selectTime = measureMilliseconds ([&] () {
+		for (auto i = 0; i < numSelected; ++i)
+			browser->selectRow (i * selectionStep);
+	});
+
+	NullDrawContext context (size);
+	auto rowStep = std::max (1, numRows / numDraws);
+	auto drawTime = measureMilliseconds ([&] () {
+		for (auto i = 0; i < numDraws; ++i)
+		{
+			browser->makeRowVisible (std::min (numRows - 1, i * rowStep));
+			browser->draw (&context);
+		}
+	});
+
+	// unselect every other row in the order they were selected
+	auto unselectTime = measureMilliseconds ([&] () {
+		for (auto i = 0; i < numSelected; i += 2)
+			browser->unselectRow (i * selectionStep);
+	});
+	auto numRemaining = static_cast<size_t> (numSelected / 2);
+	bool selectionOrderValid = browser->getSelection ().size () == numRemaining;
+	for (auto i = 0u; selectionOrderValid && i < numRemaining; ++i)
+		selectionOrderValid = browser->getSelection ()[i] == static_cast<int32_t> (i * 2 + 1) * selectionStep;
+
+	auto visibleRows = static_cast<size_t> (size.getHeight () / (kRowHeight + 1.)) + 2;
+	printf ("databrowserspeed: %d rows, %d selected, %d draws, milliseconds\n", numRows,
+	        numSelected, numDraws);
+	printf ("%-24s %12.3f\n", "select rows", selectTime);
+	printf ("%-24s %12.3f\n", "unselect half the rows", unselectTime);
+	printf ("%-24s %12.3f\n", "draw (per draw)", drawTime / numDraws);
+	printf ("%-24s %12.1f\n", "cells drawn (per draw)",
+	        static_cast<double> (delegate.drawnCells) / numDraws);
+	printf ("%-24s %12.1f\n", "lines drawn (per draw)",
+	        static_cast<double> (context.numLines) / numDraws);
+
+	if (!selectionOrderValid || delegate.drawnCells == 0 ||
+	    delegate.drawnCells > visibleRows * kNumColumns * static_cast<size_t> (numDraws))
+	{
+		printf ("unexpected result\n");
+		return -1;
+	}
+	return 0;
+}
@@ -0,0 +1,212 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "vstgui/lib/controls/coptionmenu.h"
+#include "vstgui/lib/controls/coptionmenumodel.h"
+#include "vstgui/lib/finally.h"
+#include "vstgui/lib/vstguiinit.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+#if MAC
+#include <CoreFoundation/CoreFoundation.h>
+#elif WINDOWS
+struct IUnknown;
+#include <windows.h>
+#endif
+
+using namespace VSTGUI;
+
+//------------------------------------------------------------------------
+/*	Usage: optionmenuspeed [folders] [subfolders] [items]
+
+	Builds a menu tree of folders with subfolders containing the given number of items once with
+	CMenuItems and COptionMenus and once with a COptionMenuModel and measures the time and the heap
+	memory needed for building it, for opening one submenu and for destroying it.
+*/
+
+//------------------------------------------------------------------------
+namespace {
+
+size_t allocatedBytes = 0;
+size_t numAllocations = 0;
+
+// every allocation is prefixed with its size, so the count is exact on all platforms
+constexpr size_t kHeaderSize = alignof (std::max_align_t);
+
+} // anonymous
+
+//------------------------------------------------------------------------
+void* operator new (size_t size)
+{
+	auto ptr = static_cast<char*> (std::malloc (size + kHeaderSize));
+	if (!ptr)
+		throw std::bad_alloc ();
+	*reinterpret_cast<size_t*> (ptr) = size;
+	allocatedBytes += size;
+	++numAllocations;
+	return ptr + kHeaderSize;
+}
+
+//------------------------------------------------------------------------
+void operator delete (void* p) noexcept
+{
+	if (!p)
+		return;
+	auto ptr = static_cast<char*> (p) - kHeaderSize;
+	allocatedBytes -= *reinterpret_cast<size_t*> (ptr);
+	std::free (ptr);
+}
+
+//------------------------------------------------------------------------
+void operator delete (void* p, size_t) noexcept
+{
+	operator delete (p);
+}
+
+//------------------------------------------------------------------------
+namespace {
+
+using Clock = std::chrono::high_resolution_clock;
+
+//------------------------------------------------------------------------
+struct Result
+{
+	double buildTime {0.};
+	double openTime {0.};
+	double destroyTime {0.};
+	size_t bytes {0};
+	size_t allocations {0};
+};
+
+//------------------------------------------------------------------------
+template<typename Proc>
+double measureMilliseconds (Proc proc)
+{
+	auto start = Clock::now ();
+	proc ();
+	std::chrono::duration<double, std::milli> duration = Clock::now () - start;
+	return duration.count ();
+}
+
+//------------------------------------------------------------------------
+std::string title (const char* prefix, int32_t index)
+{
+	return prefix + std::to_string (index);
+}
+
+//------------------------------------------------------------------------
+Result buildWithMenuItems (int32_t numFolders, int32_t numSubFolders, int32_t numItems)
+{
+	Result result;
+	SharedPointer<COptionMenu> menu;
+	auto bytesBefore = allocatedBytes;
+	auto allocationsBefore = numAllocations;
+	result.buildTime = measureMilliseconds ([&] () {
+		menu = makeOwned<COptionMenu> ();
+		int32_t tag = 0;
+		for (auto i = 0; i < numFolders; ++i)
+		{
+			auto folder = makeOwned<COptionMenu> ();
+			for (auto j = 0; j < numSubFolders; ++j)
+			{
+				auto subFolder = makeOwned<COptionMenu> ();
+				for (auto k = 0; k < numItems; ++k)
+					subFolder->addEntry (new CMenuItem (title ("Preset ", k), tag++));
+				folder->addEntry (subFolder, title ("Category ", j).data ());
+			}
+			menu->addEntry (folder, title ("Folder ", i).data ());
+		}
+	});
+	result.bytes = allocatedBytes - bytesBefore;
+	result.allocations = numAllocations - allocationsBefore;
+	result.openTime = measureMilliseconds ([&] () {
+		auto subFolder = menu->getSubMenu (numFolders / 2)->getSubMenu (numSubFolders / 2);
+		if (subFolder->getNbEntries () != numItems)
+			std::abort ();
+	});
+	result.destroyTime = measureMilliseconds ([&] () { menu = nullptr; });
+	return result;
+}
+
+//------------------------------------------------------------------------
+Result buildWithModel (int32_t numFolders, int32_t numSubFolders, int32_t numItems)
+{
+	Result result;
+	SharedPointer<COptionMenu> menu;
+	auto bytesBefore = allocatedBytes;
+	auto allocationsBefore = numAllocations;
+	result.buildTime = measureMilliseconds ([&] () {
+		auto model = makeOwned<COptionMenuModel> ();
+		int32_t tag = 0;
+		for (auto i = 0; i < numFolders; ++i)
+		{
+			auto folder =
+			    model->addSubmenu (COptionMenuModel::kRootIndex, title ("Folder ", i).data ());
+			for (auto j = 0; j < numSubFolders; ++j)
+			{
+				auto subFolder = model->addSubmenu (folder, title ("Category ", j).data ());
+				for (auto k = 0; k < numItems; ++k)
+					model->addItem (subFolder, title ("Preset ", k).data (), tag++);
+			}
+		}
+		menu = makeOwned<COptionMenu> ();
+		menu->setModel (model);
+	});
+	result.bytes = allocatedBytes - bytesBefore;
+	result.allocations = numAllocations - allocationsBefore;
+	result.openTime = measureMilliseconds ([&] () {
+		auto subFolder = menu->getSubMenu (numFolders / 2)->getSubMenu (numSubFolders / 2);
+		if (subFolder->getEntry (numItems - 1) == nullptr)
+			std::abort ();
+	});
+	result.destroyTime = measureMilliseconds ([&] () { menu = nullptr; });
+	return result;
+}
+
+//------------------------------------------------------------------------
+void printResult (const char* name, const Result& result)
+{
+	printf ("%-12s %12.3f %12.3f %12.3f %12.1f %12zu\n", name, result.buildTime, result.openTime,
+	        result.destroyTime, static_cast<double> (result.bytes) / 1024., result.allocations);
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+int main (int argc, char* argv[])
+{
+#if MAC
+	VSTGUI::init (CFBundleGetMainBundle ());
+#elif WINDOWS
+	CoInitialize (nullptr);
+	VSTGUI::init (GetModuleHandle (nullptr));
+#elif LINUX
+	VSTGUI::init (nullptr);
+#endif
+	auto cleanup = finally ([] () { VSTGUI::exit (); });
+
+	int32_t numFolders = argc > 1 ? std::atoi (argv[1]) : 30;
+	int32_t numSubFolders = argc > 2 ? std::atoi (argv[2]) : 10;
+	int32_t numItems = argc > 3 ? std::atoi (argv[3]) : 100;
+	if (numFolders <= 0 || numSubFolders <= 0 || numItems <= 0)
+		return -1;
+
+	auto menuItems = buildWithMenuItems (numFolders, numSubFolders, numItems);
+	auto model = buildWithModel (numFolders, numSubFolders, numItems);
+
+	printf ("optionmenuspeed: %d folders, %d subfolders, %d items, %d entries in total\n",
+	        numFolders, numSubFolders, numItems,
+	        numFolders * (1 + numSubFolders * (1 + numItems)));
+	printf ("%-12s %12s %12s %12s %12s %12s\n", "", "build ms", "open ms", "destroy ms", "KiB",
+	        "allocations");
+	printResult ("CMenuItem", menuItems);
+	printResult ("model", model);
+	return 0;
+}
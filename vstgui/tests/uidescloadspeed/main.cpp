@@ -0,0 +1,291 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "vstgui/lib/cbitmap.h"
+#include "vstgui/lib/cresourcedescription.h"
+#include "vstgui/lib/cview.h"
+#include "vstgui/lib/finally.h"
+#include "vstgui/lib/platform/iplatformbitmap.h"
+#include "vstgui/lib/platform/platformfactory.h"
+#include "vstgui/lib/vstguiinit.h"
+#include "vstgui/uidescription/base64codec.h"
+#include "vstgui/uidescription/compresseduidescription.h"
+#include "vstgui/uidescription/cstream.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <random>
+#include <string>
+#include <utility>
+
+#if MAC
+#include <CoreFoundation/CoreFoundation.h>
+#elif WINDOWS
+struct IUnknown;
+#include <windows.h>
+#endif
+
+using namespace VSTGUI;
+
+//------------------------------------------------------------------------
+/*	Usage: uidescloadspeed [templates] [bitmaps] [iterations]
+
+	Generates a description with the given number of templates (each with a few hundred views) and
+	embedded bitmaps, saves it as single stream compressed description and as chunked container
+	and measures for both the time to the first view (parsing the file and creating the view of
+	the first template including its bitmap) and the time until the views of all templates are
+	created. The best run of all iterations is reported in milliseconds.
+	While the views of all templates are created the peak heap memory and the heap memory still in
+	use by the description afterwards are measured in kilobytes. Only allocations made with
+	operator new are counted, memory the system allocates for platform bitmaps is not included.
+*/
+
+//------------------------------------------------------------------------
+namespace {
+
+std::atomic<size_t> allocatedBytes {0};
+std::atomic<size_t> peakBytes {0};
+
+// every allocation is prefixed with its size, so the count is exact on all platforms
+constexpr size_t kHeaderSize = alignof (std::max_align_t);
+
+} // anonymous
+
+//------------------------------------------------------------------------
+void* operator new (size_t size)
+{
+	auto ptr = static_cast<char*> (std::malloc (size + kHeaderSize));
+	if (!ptr)
+		throw std::bad_alloc ();
+	*reinterpret_cast<size_t*> (ptr) = size;
+	auto bytes = allocatedBytes += size;
+	auto peak = peakBytes.load ();
+	while (bytes > peak && !peakBytes.compare_exchange_weak (peak, bytes))
+		;
+	return ptr + kHeaderSize;
+}
+
+//------------------------------------------------------------------------
+void operator delete (void* p) noexcept
+{
+	if (!p)
+		return;
+	auto ptr = static_cast<char*> (p) - kHeaderSize;
+	allocatedBytes -= *reinterpret_cast<size_t*> (ptr);
+	std::free (ptr);
+}
+
+//------------------------------------------------------------------------
+void operator delete (void* p, size_t) noexcept
+{
+	operator delete (p);
+}
+
+//------------------------------------------------------------------------
+namespace {
+
+static constexpr auto kViewsPerTemplate = 256u;
+static constexpr auto kBitmapSize = 256u;
+
+//------------------------------------------------------------------------
+std::string templateName (uint32_t index) { return "template" + std::to_string (index); }
+std::string bitmapName (uint32_t index) { return "bitmap" + std::to_string (index); }
+
+//------------------------------------------------------------------------
+std::string createBitmapData (std::default_random_engine& engine)
+{
+	auto bitmap = getPlatformFactory ().createBitmap (CPoint (kBitmapSize, kBitmapSize));
+	if (!bitmap)
+		return {};
+	if (auto pixelAccess = bitmap->lockPixels (true))
+	{
+		auto address = pixelAccess->getAddress ();
+		for (auto y = 0u; y < kBitmapSize; ++y, address += pixelAccess->getBytesPerRow ())
+			std::generate (address, address + kBitmapSize * 4, [&] () {
+				return static_cast<uint8_t> (engine () & 0xff);
+			});
+	}
+	auto png = getPlatformFactory ().createBitmapMemoryPNGRepresentation (bitmap);
+	auto base64 = Base64Codec::encode (png.data (), png.size ());
+	return {reinterpret_cast<const char*> (base64.data.get ()), base64.dataSize};
+}
+
+//------------------------------------------------------------------------
+bool writeDescription (const std::string& path, uint32_t numTemplates, uint32_t numBitmaps)
+{
+	CFileStream stream;
+	if (!stream.open (path.data (), CFileStream::kWriteMode | CFileStream::kTruncateMode))
+		return false;
+	std::default_random_engine engine;
+	stream << std::string ("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+	stream << std::string ("<vstgui-ui-description version=\"1\">\n\t<bitmaps>\n");
+	for (auto i = 0u; i < numBitmaps; ++i)
+	{
+		stream << "\t\t<bitmap name=\"" + bitmapName (i) + "\" path=\"" + bitmapName (i) +
+		              ".png\">\n\t\t\t<data encoding=\"base64\">";
+		stream << createBitmapData (engine);
+		stream << std::string ("</data>\n\t\t</bitmap>\n");
+	}
+	stream << std::string ("\t</bitmaps>\n");
+	for (auto i = 0u; i < numTemplates; ++i)
+	{
+		stream << "\t<template name=\"" + templateName (i) +
+		              "\" class=\"CViewContainer\" origin=\"0, 0\" size=\"1024, 1024\" bitmap=\"" +
+		              bitmapName (numBitmaps ? i % numBitmaps : 0) + "\">\n";
+		for (auto v = 0u; v < kViewsPerTemplate; ++v)
+		{
+			auto x = std::to_string ((v % 16) * 64);
+			auto y = std::to_string ((v / 16) * 64);
+			stream << "\t\t<view class=\"CTextLabel\" origin=\"" + x + ", " + y +
+			              "\" size=\"60, 20\" title=\"Label " + std::to_string (v) +
+			              "\" font-color=\"~ WhiteCColor\" transparent=\"true\"/>\n";
+		}
+		stream << std::string ("\t</template>\n");
+	}
+	stream << std::string ("</vstgui-ui-description>\n");
+	return true;
+}
+
+//------------------------------------------------------------------------
+bool convert (const std::string& input, const std::string& output, int32_t flags)
+{
+	CompressedUIDescription desc (CResourceDescription (input.data ()));
+	if (!desc.parse ())
+		return false;
+	flags |= UIDescription::kWriteImagesIntoUIDescFile | UIDescription::kDoNotVerifyImageData |
+	         CompressedUIDescription::kNoPlainUIDescFileBackup |
+	         CompressedUIDescription::kForceWriteCompressedDesc;
+	return desc.save (output.data (), flags);
+}
+
+//------------------------------------------------------------------------
+struct HeapUsage
+{
+	size_t peakBytes {0};
+	size_t keptBytes {0};
+};
+
+//------------------------------------------------------------------------
+bool createViews (const std::string& path, uint32_t numTemplates, HeapUsage* heapUsage = nullptr)
+{
+	auto bytesBefore = allocatedBytes.load ();
+	peakBytes = bytesBefore;
+	auto desc = makeOwned<CompressedUIDescription> (CResourceDescription (path.data ()));
+	if (!desc->parse ())
+		return false;
+	for (auto i = 0u; i < numTemplates; ++i)
+	{
+		auto view = desc->createView (templateName (i).data (), nullptr);
+		if (!view)
+			return false;
+		auto bitmap = view->getBackground ();
+		bool valid = bitmap && bitmap->getWidth () == kBitmapSize;
+		view->forget ();
+		if (!valid)
+			return false;
+	}
+	if (heapUsage)
+	{
+		heapUsage->peakBytes = peakBytes - bytesBefore;
+		heapUsage->keptBytes = allocatedBytes - bytesBefore;
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------
+template<typename Proc>
+double measureMilliseconds (uint32_t iterations, Proc proc)
+{
+	using Clock = std::chrono::high_resolution_clock;
+	double best = 0.;
+	for (auto i = 0u; i < iterations; ++i)
+	{
+		auto start = Clock::now ();
+		if (!proc ())
+			return -1.;
+		std::chrono::duration<double, std::milli> duration = Clock::now () - start;
+		if (i == 0 || duration.count () < best)
+			best = duration.count ();
+	}
+	return best;
+}
+
+//------------------------------------------------------------------------
+size_t fileSize (const std::string& path)
+{
+	CFileStream stream;
+	if (!stream.open (path.data (), CFileStream::kReadMode | CFileStream::kBinaryMode))
+		return 0;
+	return static_cast<size_t> (stream.seek (0, SeekableStream::SeekMode::kSeekEnd));
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+int main (int argc, char* argv[])
+{
+#if MAC
+	VSTGUI::init (CFBundleGetMainBundle ());
+#elif WINDOWS
+	CoInitialize (nullptr);
+	VSTGUI::init (GetModuleHandle (nullptr));
+#elif LINUX
+	VSTGUI::init (nullptr);
+#endif
+	auto cleanup = finally ([] () { VSTGUI::exit (); });
+
+	uint32_t numTemplates = argc > 1 ? static_cast<uint32_t> (std::atoi (argv[1])) : 64;
+	uint32_t numBitmaps = argc > 2 ? static_cast<uint32_t> (std::atoi (argv[2])) : 64;
+	uint32_t iterations = argc > 3 ? static_cast<uint32_t> (std::atoi (argv[3])) : 5;
+	if (numTemplates == 0 || numBitmaps == 0 || iterations == 0)
+		return -1;
+
+	const std::string plainPath = "uidescloadspeed.uidesc";
+	const std::string compressedPath = "uidescloadspeed_compressed.uidesc";
+	const std::string chunkedPath = "uidescloadspeed_chunked.uidesc";
+	auto removeFiles = finally ([&] () {
+		std::remove (plainPath.data ());
+		std::remove (compressedPath.data ());
+		std::remove (chunkedPath.data ());
+	});
+
+	if (!writeDescription (plainPath, numTemplates, numBitmaps) ||
+	    !convert (plainPath, compressedPath, 0) ||
+	    !convert (plainPath, chunkedPath, CompressedUIDescription::kWriteChunkedContainer))
+	{
+		printf ("creating the descriptions failed\n");
+		return -1;
+	}
+
+	printf ("uidescloadspeed: %u templates, %u bitmaps, %u iterations, milliseconds\n",
+	        numTemplates, numBitmaps, iterations);
+	printf ("%-12s %12s %12s %12s %12s %12s\n", "format", "file size", "first view", "all views",
+	        "peak heap", "kept heap");
+
+	int result = 0;
+	const std::pair<const char*, std::string> files[] = {
+	    {"plain", plainPath}, {"compressed", compressedPath}, {"chunked", chunkedPath}};
+	for (const auto& [name, path] : files)
+	{
+		auto firstView = measureMilliseconds (iterations, [&] () { return createViews (path, 1); });
+		auto allViews =
+		    measureMilliseconds (iterations, [&] () { return createViews (path, numTemplates); });
+		HeapUsage heapUsage;
+		auto heapMeasured = createViews (path, numTemplates, &heapUsage);
+		printf ("%-12s %12zu %12.2f %12.2f %12zu %12zu\n", name, fileSize (path), firstView,
+		        allViews, heapUsage.peakBytes / 1024, heapUsage.keptBytes / 1024);
+		if (firstView < 0. || allViews < 0. || !heapMeasured)
+		{
+			printf ("%s: loading failed\n", name);
+			result = -1;
+		}
+	}
+	return result;
+}
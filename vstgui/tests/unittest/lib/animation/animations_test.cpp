@@ -72,6 +72,85 @@ TEST_CASE (ViewSizeAnimationTest, UnfinishedAnimation)
 	EXPECT (view.getViewSize () == CRect (10, 10, 100, 100));
 }
 
+//-----------------------------------------------------------------------------
+TEST_CASE (ViewSizeAnimationTest, OffscreenLayer)
+{
+	CRect r (0, 0, 200, 100);
+	auto parentContainer = owned (new CViewContainer (r));
+	auto container = new CViewContainer (r);
+	container->attached (parentContainer);
+	auto panel = new CViewContainer (CRect (0, 0, 100, 100));
+	panel->addView (new CView (CRect (10, 10, 20, 20)));
+	container->addView (panel);
+	ViewSizeAnimation a (CRect (100, 0, 200, 100), false, true);
+	a.animationStart (panel, "");
+	EXPECT (container->getNbViews () == 2);
+	EXPECT (panel->isVisible () == false);
+	auto layer = container->getView (0);
+	EXPECT (layer != panel);
+	EXPECT (layer->getMouseEnabled () == false);
+	a.animationTick (panel, "", 0.5f);
+	EXPECT (layer->getViewSize () == CRect (50, 0, 150, 100));
+	EXPECT (panel->getViewSize () == CRect (0, 0, 100, 100));
+	a.animationTick (panel, "", 1.f);
+	a.animationFinished (panel, "", false);
+	EXPECT (container->getNbViews () == 1);
+	EXPECT (panel->isVisible ());
+	EXPECT (panel->getViewSize () == CRect (100, 0, 200, 100));
+	container->removed (parentContainer);
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE (ViewSizeAnimationTest, CanceledOffscreenLayerAnimation)
+{
+	CRect r (0, 0, 200, 100);
+	auto parentContainer = owned (new CViewContainer (r));
+	auto container = new CViewContainer (r);
+	container->attached (parentContainer);
+	auto view = new CView (CRect (0, 0, 100, 100));
+	container->addView (view);
+	ViewSizeAnimation a (CRect (100, 0, 200, 100), false, true);
+	a.animationStart (view, "");
+	a.animationTick (view, "", 0.5f);
+	a.animationFinished (view, "", true);
+	EXPECT (container->getNbViews () == 1);
+	EXPECT (view->isVisible ());
+	EXPECT (view->getViewSize () == CRect (50, 0, 150, 100));
+	container->removed (parentContainer);
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE (ViewSizeAnimationTest, OffscreenLayerNeedsParent)
+{
+	TestView view;
+	ViewSizeAnimation a (CRect (10, 10, 100, 100), false, true);
+	a.animationStart (&view, "");
+	a.animationTick (&view, "", 0.5f);
+	EXPECT (view.getViewSize () == CRect (5, 5, 50, 50));
+	a.animationFinished (&view, "", false);
+	EXPECT (view.getViewSize () == CRect (10, 10, 100, 100));
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE (ViewSizeAnimationTest, OffscreenLayerKeepsHiddenViewHidden)
+{
+	CRect r (0, 0, 200, 100);
+	auto parentContainer = owned (new CViewContainer (r));
+	auto container = new CViewContainer (r);
+	container->attached (parentContainer);
+	auto view = new CView (CRect (0, 0, 100, 100));
+	view->setVisible (false);
+	container->addView (view);
+	ViewSizeAnimation a (CRect (100, 0, 200, 100), false, true);
+	a.animationStart (view, "");
+	a.animationTick (view, "", 1.f);
+	a.animationFinished (view, "", false);
+	EXPECT (container->getNbViews () == 1);
+	EXPECT (view->isVisible () == false);
+	EXPECT (view->getViewSize () == CRect (100, 0, 200, 100));
+	container->removed (parentContainer);
+}
+
 //-----------------------------------------------------------------------------
 TEST_CASE (ControlValueAnimationTest, Animation)
 {
@@ -244,4 +323,31 @@ TEST_CASE (ExchangeViewAnimationTest, PushInOutFromRight)
 	container->removed (parentContainer);
 }
 
+//-----------------------------------------------------------------------------
+TEST_CASE (ExchangeViewAnimationTest, PushInOutFromLeftWithOffscreenLayer)
+{
+	CRect r (0, 0, 100, 100);
+	auto parentContainer = owned (new CViewContainer (r));
+	auto container = new CViewContainer (r);
+	container->attached (parentContainer);
+	auto oldView = new CView (r);
+	auto newView = new CView (r);
+	container->addView (oldView);
+	ExchangeViewAnimation a (oldView, newView, ExchangeViewAnimation::kPushInOutFromLeft, true);
+	a.animationStart (container, "");
+	EXPECT (container->getNbViews () == 4);
+	EXPECT (oldView->isVisible () == false);
+	EXPECT (newView->isVisible () == false);
+	a.animationTick (container, "", 0.5f);
+	EXPECT (oldView->getViewSize () == r);
+	EXPECT (newView->getViewSize () == CRect (-100, 0, 0, 100));
+	a.animationTick (container, "", 1.f);
+	a.animationFinished (container, "", false);
+	EXPECT (container->getNbViews () == 1);
+	EXPECT (oldView->isAttached () == false);
+	EXPECT (newView->isVisible ());
+	EXPECT (newView->getViewSize () == r);
+	container->removed (parentContainer);
+}
+
 } // VSTGUI
@@ -4,6 +4,7 @@
 
 #include "../../../../lib/animation/animations.h"
 #include "../../../../lib/animation/animator.h"
+#include "../../../../lib/animation/frameclock.h"
 #include "../../../../lib/animation/timingfunctions.h"
 #include "../../../../lib/cview.h"
 #include "../../unittests.h"
@@ -118,3 +119,36 @@ TEST_CASE (AnimatorTest, AnimationMessage)
 } // VSTGUI
 
 #endif // MAC
+
+namespace VSTGUI {
+using namespace Animation;
+
+//-----------------------------------------------------------------------------
+TEST_CASE (AnimatorTest, OnTimerUsesTheFrameClock)
+{
+	auto a = owned (new Animator ());
+	auto view = owned (new CView (CRect (0, 0, 0, 0)));
+	a->addAnimation (view, "Test", new AlphaValueAnimation (0.f), new LinearTimingFunction (1000));
+	// the animation timer runs the animations at the frame time of the clock, which is ahead of
+	// the current time
+	auto& clock = FrameClock::getShared ();
+	clock.tick ();
+	a->onFrame (clock.getFrameTicks ());
+	a->onTimer ();
+	EXPECT_TRUE (view->getAlphaValue () > 0.5f);
+	a->removeAnimations (view);
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE (AnimatorTest, OnTimerDoesNotTickARunningClock)
+{
+	auto a = owned (new Animator ());
+	auto& clock = FrameClock::getShared ();
+	clock.tick ();
+	EXPECT_TRUE (clock.isRunning ());
+	auto numTicks = clock.getStatistics ().numTicks;
+	a->onTimer ();
+	EXPECT_EQ (clock.getStatistics ().numTicks, numTicks);
+}
+
+} // VSTGUI
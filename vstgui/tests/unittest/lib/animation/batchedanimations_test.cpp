@@ -0,0 +1,251 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "../../../../lib/animation/animations.h"
+#include "../../../../lib/animation/batchedanimations.h"
+#include "../../../../lib/animation/timingfunctions.h"
+#include "../../../../lib/controls/ccontrol.h"
+#include "../../../../lib/cview.h"
+#include "../../unittests.h"
+#include <cmath>
+#include <vector>
+
+namespace VSTGUI {
+using namespace Animation;
+using namespace Animation::Detail;
+
+namespace {
+
+//-----------------------------------------------------------------------------
+class TestControl : public CControl
+{
+public:
+	TestControl () : CControl (CRect (0, 0, 0, 0)) {}
+	void draw (CDrawContext* pContext) override {}
+
+	CLASS_METHODS (TestControl, CControl)
+};
+
+//-----------------------------------------------------------------------------
+class CustomTimingFunction : public LinearTimingFunction
+{
+public:
+	using LinearTimingFunction::LinearTimingFunction;
+	float getPosition (uint32_t milliseconds) override { return 0.5f; }
+};
+
+//-----------------------------------------------------------------------------
+class CustomAlphaValueAnimation : public AlphaValueAnimation
+{
+public:
+	using AlphaValueAnimation::AlphaValueAnimation;
+	void animationTick (CView* view, IdStringPtr name, float pos) override {}
+};
+
+//-----------------------------------------------------------------------------
+/** runs the same animation via the virtual interfaces and batched and compares the alpha values */
+void compareWithVirtualPath (UnitTest::Context* context, ITimingFunction* virtualTiming,
+							 ITimingFunction* batchedTiming, uint32_t length)
+{
+	auto virtualView = makeOwned<CView> (CRect (0, 0, 10, 10));
+	auto batchedView = makeOwned<CView> (CRect (0, 0, 10, 10));
+	virtualView->setAlphaValue (0.2f);
+	batchedView->setAlphaValue (0.2f);
+	auto virtualTarget = makeOwned<AlphaValueAnimation> (0.9f);
+
+	BatchedAnimations batched;
+	DoneFunction notification;
+	EXPECT_TRUE (batched.add (batchedView, internAnimationName ("Test"), "Test",
+							  new AlphaValueAnimation (0.9f), batchedTiming, notification, false));
+	virtualTarget->animationStart (virtualView, "Test");
+	constexpr uint64_t startTicks = 1000;
+	for (uint32_t time = 0; time <= length; time += 7)
+	{
+		batched.tick (startTicks + time);
+		virtualTarget->animationTick (virtualView, "Test", virtualTiming->getPosition (time));
+		if (virtualTiming->isDone (time))
+			virtualTarget->animationFinished (virtualView, "Test", false);
+		EXPECT_TRUE (std::abs (virtualView->getAlphaValue () - batchedView->getAlphaValue ()) <
+					 1e-5f);
+	}
+	batched.tick (startTicks + length);
+	EXPECT_TRUE (batched.empty ());
+	EXPECT_EQ (batchedView->getAlphaValue (), 0.9f);
+	delete virtualTiming;
+}
+
+} // anonymous
+
+//-----------------------------------------------------------------------------
+TEST_CASE (BatchedAnimationsTest, InternNames)
+{
+	auto id = internAnimationName ("BatchedAnimationsTest");
+	EXPECT_NE (id, kInvalidNameID);
+	EXPECT_EQ (internAnimationName ("BatchedAnimationsTest"), id);
+	EXPECT_EQ (findAnimationName ("BatchedAnimationsTest"), id);
+	EXPECT_EQ (findAnimationName ("BatchedAnimationsTest_NeverAdded"), kInvalidNameID);
+	IdStringPtr interned = nullptr;
+	internAnimationName (std::string ("BatchedAnimationsTest").data (), &interned);
+	EXPECT_EQ (std::string (interned), "BatchedAnimationsTest");
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE (BatchedAnimationsTest, CanBatch)
+{
+	AlphaValueAnimation alpha (1.f);
+	LinearTimingFunction linear (100);
+	CustomTimingFunction custom (100);
+	PowerTimingFunction power (100, 2.f);
+	InterpolationTimingFunction interpolation (100);
+	EXPECT_TRUE (BatchedAnimations::canBatch (&alpha, &linear));
+	EXPECT_TRUE (BatchedAnimations::canBatch (&alpha, &power));
+	EXPECT_FALSE (BatchedAnimations::canBatch (&alpha, &custom));
+	EXPECT_FALSE (BatchedAnimations::canBatch (&alpha, &interpolation));
+	CustomAlphaValueAnimation customAlpha (1.f);
+	EXPECT_FALSE (BatchedAnimations::canBatch (&customAlpha, &linear));
+	ViewSizeAnimation viewSize (CRect (0, 0, 10, 10));
+	EXPECT_TRUE (BatchedAnimations::canBatch (&viewSize, &linear));
+	ViewSizeAnimation layeredViewSize (CRect (0, 0, 10, 10), false, true);
+	EXPECT_FALSE (BatchedAnimations::canBatch (&layeredViewSize, &linear));
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE (BatchedAnimationsTest, LinearMatchesVirtualPath)
+{
+	compareWithVirtualPath (context, new LinearTimingFunction (300), new LinearTimingFunction (300),
+							300);
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE (BatchedAnimationsTest, PowerMatchesVirtualPath)
+{
+	compareWithVirtualPath (context, new PowerTimingFunction (250, 2.5f),
+							new PowerTimingFunction (250, 2.5f), 250);
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE (BatchedAnimationsTest, CubicBezierMatchesVirtualPath)
+{
+	auto timing = CubicBezierTimingFunction::easyInOut (400);
+	compareWithVirtualPath (context, new CubicBezierTimingFunction (timing),
+							new CubicBezierTimingFunction (timing), 400);
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE (BatchedAnimationsTest, ViewSizeAndControlValue)
+{
+	auto view = makeOwned<CView> (CRect (0, 0, 0, 0));
+	auto control = makeOwned<TestControl> ();
+	BatchedAnimations batched;
+	DoneFunction notification;
+	batched.add (view, internAnimationName ("Size"), "Size",
+				 new ViewSizeAnimation (CRect (10, 10, 100, 100)), new LinearTimingFunction (100),
+				 notification, false);
+	batched.add (control, internAnimationName ("Value"), "Value", new ControlValueAnimation (1.f),
+				 new LinearTimingFunction (100), notification, false);
+	EXPECT_EQ (batched.size (), 2u);
+	batched.tick (10);
+	batched.tick (60);
+	EXPECT (view->getViewSize () == CRect (5, 5, 50, 50));
+	EXPECT_EQ (control->getValue (), 0.5f);
+	batched.tick (110);
+	EXPECT (view->getViewSize () == CRect (10, 10, 100, 100));
+	EXPECT_EQ (control->getValue (), 1.f);
+	EXPECT_TRUE (batched.empty ());
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE (BatchedAnimationsTest, CancelAndNotifications)
+{
+	auto view = makeOwned<CView> (CRect (0, 0, 0, 0));
+	auto nameID = internAnimationName ("Test");
+	BatchedAnimations batched;
+	uint32_t numNotifications = 0;
+	auto add = [&] (bool notifyOnCancel, bool forceEndValue) {
+		DoneFunction notification = [&] (CView*, IdStringPtr name, IAnimationTarget*) {
+			EXPECT_EQ (std::string (name), "Test");
+			++numNotifications;
+		};
+		batched.add (view, nameID, "Test", new AlphaValueAnimation (0.f, forceEndValue),
+					 new LinearTimingFunction (100), notification, notifyOnCancel);
+	};
+
+	add (false, false);
+	batched.tick (10);
+	batched.tick (60);
+	EXPECT_TRUE (batched.remove (view, nameID));
+	EXPECT_FALSE (batched.remove (view, nameID));
+	EXPECT_EQ (numNotifications, 0u);
+	EXPECT_EQ (view->getAlphaValue (), 0.5f);
+
+	add (true, true);
+	batched.tick (100);
+	EXPECT_TRUE (batched.remove (view, nameID));
+	EXPECT_EQ (numNotifications, 1u);
+	EXPECT_EQ (view->getAlphaValue (), 0.f);
+
+	// removing all animations of a view keeps the notifications
+	add (false, false);
+	batched.removeAll (view);
+	EXPECT_EQ (numNotifications, 2u);
+	EXPECT_TRUE (batched.empty ());
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE (BatchedAnimationsTest, ChangesWhileTicking)
+{
+	auto view1 = makeOwned<CView> (CRect (0, 0, 0, 0));
+	auto view2 = makeOwned<CView> (CRect (0, 0, 0, 0));
+	auto nameID = internAnimationName ("Test");
+	BatchedAnimations batched;
+	DoneFunction notification = [&] (CView*, IdStringPtr, IAnimationTarget*) {
+		// the second animation is canceled by the notification of the first and a new one is added
+		batched.remove (view2, nameID);
+		DoneFunction none;
+		batched.add (view1, nameID, "Test", new AlphaValueAnimation (1.f),
+					 new LinearTimingFunction (100), none, false);
+	};
+	batched.add (view1, nameID, "Test", new AlphaValueAnimation (0.f),
+				 new LinearTimingFunction (50), notification, false);
+	DoneFunction none;
+	batched.add (view2, nameID, "Test", new AlphaValueAnimation (0.f),
+				 new LinearTimingFunction (100), none, false);
+	batched.tick (10);
+	batched.tick (60);
+	EXPECT_EQ (view1->getAlphaValue (), 0.f);
+	EXPECT_EQ (view2->getAlphaValue (), 0.5f);
+	EXPECT_EQ (batched.size (), 1u);
+	batched.tick (70);
+	batched.tick (120);
+	EXPECT_EQ (view1->getAlphaValue (), 0.5f);
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE (BatchedAnimationsTest, RemoveMovedAnimations)
+{
+	// removing an animation moves the last one into its place, the index must follow it
+	std::vector<SharedPointer<CView>> views;
+	auto nameID = internAnimationName ("Test");
+	BatchedAnimations batched;
+	for (auto i = 0u; i < 5; ++i)
+	{
+		views.emplace_back (makeOwned<CView> (CRect (0, 0, 0, 0)));
+		DoneFunction none;
+		batched.add (views.back (), nameID, "Test", new AlphaValueAnimation (0.f),
+					 new LinearTimingFunction (100), none, false);
+	}
+	batched.tick (10);
+	batched.tick (60);
+	EXPECT_TRUE (batched.remove (views[1], nameID));
+	EXPECT_TRUE (batched.remove (views[0], nameID));
+	EXPECT_FALSE (batched.remove (views[1], nameID));
+	EXPECT_EQ (batched.size (), 3u);
+	batched.tick (110);
+	EXPECT_TRUE (batched.empty ());
+	EXPECT_EQ (views[0]->getAlphaValue (), 0.5f);
+	EXPECT_EQ (views[4]->getAlphaValue (), 0.f);
+	EXPECT_FALSE (batched.remove (views[4], nameID));
+}
+
+} // VSTGUI
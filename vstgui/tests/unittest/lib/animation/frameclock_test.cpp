@@ -0,0 +1,207 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "../../../../lib/animation/frameclock.h"
+#include "../../unittests.h"
+#include <cmath>
+
+namespace VSTGUI {
+using namespace Animation;
+
+namespace {
+
+constexpr double kInterval = FrameClock::kDefaultFrameInterval;
+
+//-----------------------------------------------------------------------------
+struct FakeTime
+{
+	double now {1000.};
+
+	FrameClock::TimeSource source ()
+	{
+		return [this] () { return now; };
+	}
+};
+
+//-----------------------------------------------------------------------------
+bool equals (double a, double b)
+{
+	return std::abs (a - b) < 0.0001;
+}
+
+} // anonymous
+
+//-----------------------------------------------------------------------------
+TEST_CASE (FrameClockTest, FirstTickStartsTheGrid)
+{
+	FakeTime time;
+	FrameClock clock (time.source ());
+	EXPECT_TRUE (clock.tick ());
+	EXPECT_EQ (clock.getFrameIndex (), 0u);
+	EXPECT_TRUE (equals (clock.getFrameTime (), 1000. + kInterval));
+	EXPECT_EQ (clock.getFrameTicks (), 1017u);
+	EXPECT_EQ (clock.getNumDroppedFrames (), 0u);
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE (FrameClockTest, JitteryTicksAdvanceOneFrame)
+{
+	FakeTime time;
+	FrameClock clock (time.source ());
+	clock.tick ();
+	// the timer fires up to 4 ms early or late
+	const double delays[] = {0., 4., -1., 3., -4., 2., 4., 0., -3., 1.};
+	for (auto i = 1u; i < 60; ++i)
+	{
+		time.now = 1000. + i * kInterval + delays[i % 10];
+		EXPECT_TRUE (clock.tick ());
+		EXPECT_EQ (clock.getFrameIndex (), i);
+		EXPECT_EQ (clock.getNumDroppedFrames (), 0u);
+		EXPECT_TRUE (equals (clock.getFrameTime (), 1000. + (i + 1) * kInterval));
+	}
+	const auto& statistics = clock.getStatistics ();
+	EXPECT_EQ (statistics.numTicks, 60u);
+	EXPECT_EQ (statistics.numFrames, 60u);
+	EXPECT_EQ (statistics.numSkippedTicks, 0u);
+	EXPECT_EQ (statistics.numDroppedFrames, 0u);
+	// the largest difference between two consecutive delays (3 ms and -4 ms)
+	EXPECT_TRUE (equals (statistics.maxJitter, 7.));
+	// the 59 differences between consecutive delays
+	EXPECT_TRUE (equals (statistics.meanJitter, 239. / 59.));
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE (FrameClockTest, TimerFasterThanFrames)
+{
+	FakeTime time;
+	FrameClock clock (time.source ());
+	clock.tick ();
+	auto lastFrameTime = clock.getFrameTime ();
+	for (auto i = 1u; i <= 100; ++i)
+	{
+		time.now = 1000. + i * 16.;
+		if (!clock.tick ())
+			continue;
+		EXPECT_TRUE (equals (clock.getFrameTime () - lastFrameTime, kInterval));
+		lastFrameTime = clock.getFrameTime ();
+	}
+	const auto& statistics = clock.getStatistics ();
+	EXPECT_EQ (statistics.numDroppedFrames, 0u);
+	// every 25th tick is in the same frame as the one before
+	EXPECT_EQ (statistics.numSkippedTicks, 4u);
+	EXPECT_EQ (clock.getFrameIndex (), 96u);
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE (FrameClockTest, FramesOfTheTimerInterval)
+{
+	FakeTime time;
+	FrameClock clock (time.source (), FrameClock::kTimerInterval);
+	clock.tick ();
+	// a timer with a period of whole milliseconds, firing up to 3 ms early or late
+	const double delays[] = {0., 3., -1., 2., -3., 1.};
+	for (auto i = 1u; i <= 1000; ++i)
+	{
+		time.now = 1000. + i * FrameClock::kTimerInterval + delays[i % 6];
+		EXPECT_TRUE (clock.tick ());
+		EXPECT_EQ (clock.getFrameIndex (), i);
+	}
+	EXPECT_EQ (clock.getStatistics ().numSkippedTicks, 0u);
+	EXPECT_EQ (clock.getStatistics ().numDroppedFrames, 0u);
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE (FrameClockTest, LateTickDropsFrames)
+{
+	FakeTime time;
+	FrameClock clock (time.source ());
+	clock.tick ();
+	time.now += kInterval;
+	EXPECT_TRUE (clock.tick ());
+	EXPECT_EQ (clock.getFrameIndex (), 1u);
+	// the main thread was blocked for 100 ms
+	time.now += 100.;
+	EXPECT_TRUE (clock.tick ());
+	EXPECT_EQ (clock.getFrameIndex (), 7u);
+	EXPECT_EQ (clock.getNumDroppedFrames (), 5u);
+	EXPECT_TRUE (equals (clock.getFrameTime (), 1000. + 8 * kInterval));
+	time.now = 1000. + 8 * kInterval;
+	EXPECT_TRUE (clock.tick ());
+	EXPECT_EQ (clock.getNumDroppedFrames (), 0u);
+	EXPECT_EQ (clock.getStatistics ().numDroppedFrames, 5u);
+	EXPECT_TRUE (equals (clock.getStatistics ().maxJitter, 100. - 6 * kInterval));
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE (FrameClockTest, SecondTickInFrameIsSkipped)
+{
+	FakeTime time;
+	FrameClock clock (time.source ());
+	clock.tick ();
+	time.now += kInterval;
+	EXPECT_TRUE (clock.tick ());
+	auto frameTime = clock.getFrameTime ();
+	time.now += 3.;
+	EXPECT_FALSE (clock.tick ());
+	EXPECT_EQ (clock.getFrameTime (), frameTime);
+	EXPECT_EQ (clock.getStatistics ().numSkippedTicks, 1u);
+	// time going backwards is in the same frame too
+	time.now -= 50.;
+	EXPECT_FALSE (clock.tick ());
+	EXPECT_EQ (clock.getFrameTime (), frameTime);
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE (FrameClockTest, ResetRestartsTheGrid)
+{
+	FakeTime time;
+	FrameClock clock (time.source ());
+	clock.tick ();
+	time.now += 1000.;
+	clock.reset ();
+	EXPECT_TRUE (clock.tick ());
+	EXPECT_EQ (clock.getFrameIndex (), 0u);
+	EXPECT_EQ (clock.getNumDroppedFrames (), 0u);
+	EXPECT_TRUE (equals (clock.getFrameTime (), time.now + kInterval));
+	EXPECT_EQ (clock.getStatistics ().numDroppedFrames, 0u);
+	EXPECT_EQ (clock.getStatistics ().numFrames, 2u);
+	clock.resetStatistics ();
+	EXPECT_EQ (clock.getStatistics ().numTicks, 0u);
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE (FrameClockTest, ResetStatisticsWhileRunning)
+{
+	FakeTime time;
+	FrameClock clock (time.source ());
+	clock.tick ();
+	clock.resetStatistics ();
+	time.now += kInterval + 2.;
+	EXPECT_TRUE (clock.tick ());
+	time.now += kInterval;
+	EXPECT_TRUE (clock.tick ());
+	const auto& statistics = clock.getStatistics ();
+	EXPECT_EQ (statistics.numFrames, 2u);
+	EXPECT_TRUE (equals (statistics.maxJitter, 2.));
+	EXPECT_TRUE (equals (statistics.meanJitter, 1.));
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE (FrameClockTest, ChangeFrameInterval)
+{
+	FakeTime time;
+	FrameClock clock (time.source ());
+	clock.tick ();
+	time.now += kInterval;
+	clock.tick ();
+	clock.setFrameInterval (10.);
+	EXPECT_EQ (clock.getFrameInterval (), 10.);
+	time.now = 1000. + kInterval + 10.;
+	EXPECT_TRUE (clock.tick ());
+	EXPECT_EQ (clock.getFrameIndex (), 2u);
+	EXPECT_EQ (clock.getNumDroppedFrames (), 0u);
+	EXPECT_TRUE (equals (clock.getFrameTime (), 1000. + kInterval + 20.));
+}
+
+} // VSTGUI
@@ -7,6 +7,8 @@
 #include "../../../../lib/cview.h"
 #include "../../../../lib/cviewcontainer.h"
 #include "../../unittests.h"
+#include <cmath>
+#include <memory>
 
 namespace VSTGUI {
 using namespace Animation;
@@ -95,4 +97,66 @@ TEST_CASE (TimingFunctionTest, CubicBezierTimingFunction)
 	EXPECT (f.getPosition (100) == 1.0f);
 }
 
+TEST_CASE (TimingFunctionTest, LookupTableCubicBezierSolvesForX)
+{
+	// the CSS ease timing function
+	auto table = TimingFunctionLookupTable::cubicBezier (CPoint (0.25, 0.1), CPoint (0.25, 1.));
+	EXPECT (table->getPosition (0.f) == 0.f);
+	EXPECT (table->getPosition (1.f) == 1.f);
+	EXPECT (std::abs (table->getPosition (0.25f) - 0.4094f) < 0.001f);
+	EXPECT (std::abs (table->getPosition (0.5f) - 0.8024f) < 0.001f);
+	// ease-in-out is symmetric
+	table = TimingFunctionLookupTable::cubicBezier (CPoint (0.42, 0.), CPoint (0.58, 1.));
+	EXPECT (std::abs (table->getPosition (0.5f) - 0.5f) < 0.0001f);
+	EXPECT (std::abs (table->getPosition (0.2f) + table->getPosition (0.8f) - 1.f) < 0.0001f);
+	// linear
+	table = TimingFunctionLookupTable::cubicBezier (CPoint (0.3, 0.3), CPoint (0.7, 0.7));
+	EXPECT (std::abs (table->getPosition (0.3f) - 0.3f) < 0.0001f);
+}
+
+TEST_CASE (TimingFunctionTest, LookupTablesAreShared)
+{
+	auto a = TimingFunctionLookupTable::cubicBezier (CPoint (0.1, 0.2), CPoint (0.3, 0.4));
+	auto b = TimingFunctionLookupTable::cubicBezier (CPoint (0.1, 0.2), CPoint (0.3, 0.4));
+	auto c = TimingFunctionLookupTable::cubicBezier (CPoint (0.1, 0.2), CPoint (0.3, 0.4), 64);
+	auto d = TimingFunctionLookupTable::power (2.f);
+	auto e = TimingFunctionLookupTable::power (2.f);
+	EXPECT (a == b);
+	EXPECT (a != c);
+	EXPECT (c->getResolution () == 64);
+	EXPECT (d == e);
+
+	InterpolationTimingFunction interpolation (100);
+	EXPECT (TimingFunctionLookupTable::bake (interpolation) !=
+			TimingFunctionLookupTable::bake (interpolation));
+	EXPECT (TimingFunctionLookupTable::bake (interpolation, 32, "linear") ==
+			TimingFunctionLookupTable::bake (interpolation, 32, "linear"));
+}
+
+TEST_CASE (TimingFunctionTest, LookupTableTimingFunctionPower)
+{
+	std::unique_ptr<LookupTableTimingFunction> tf (LookupTableTimingFunction::power (100, 2.f));
+	PowerTimingFunction power (100, 2.f);
+	for (auto ms = 0u; ms <= 100; ms += 5)
+		EXPECT (std::abs (tf->getPosition (ms) - power.getPosition (ms)) < 0.0001f);
+	EXPECT (tf->getPosition (200) == 1.f);
+	EXPECT (tf->isDone (99) == false);
+	EXPECT (tf->isDone (100) == true);
+}
+
+TEST_CASE (TimingFunctionTest, LookupTableTimingFunctionBake)
+{
+	InterpolationTimingFunction interpolation (200);
+	interpolation.addPoint (0.5f, 0.8f);
+	std::unique_ptr<LookupTableTimingFunction> tf (
+		LookupTableTimingFunction::bake (interpolation, 100));
+	EXPECT (tf->getLength () == 200);
+	EXPECT (tf->getTable ()->getResolution () == 100);
+	EXPECT (tf->getPosition (0) == 0.f);
+	EXPECT (std::abs (tf->getPosition (50) - 0.4f) < 0.0001f);
+	EXPECT (std::abs (tf->getPosition (100) - 0.8f) < 0.0001f);
+	EXPECT (std::abs (tf->getPosition (150) - 0.9f) < 0.0001f);
+	EXPECT (tf->getPosition (200) == 1.f);
+}
+
 } // VSTGUI
@@ -0,0 +1,195 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "../../../lib/backgroundpopulator.h"
+#include "../../../lib/cdatabrowser.h"
+#include "../../../lib/controls/clistcontrol.h"
+#include "../../../lib/idatabrowserdelegate.h"
+#include "../unittests.h"
+#include <chrono>
+#include <thread>
+
+namespace VSTGUI {
+
+namespace {
+
+constexpr auto kNumEntries = 500000;
+constexpr CCoord kRowHeight = 20.;
+
+//------------------------------------------------------------------------
+class StringListDelegate : public DataBrowserDelegateAdapter
+{
+public:
+	int32_t dbGetNumRows (CDataBrowser* browser) override
+	{
+		return static_cast<int32_t> (strings.size ());
+	}
+	int32_t dbGetNumColumns (CDataBrowser* browser) override { return 1; }
+	CCoord dbGetRowHeight (CDataBrowser* browser) override { return kRowHeight; }
+	CCoord dbGetCurrentColumnWidth (int32_t index, CDataBrowser* browser) override { return 100.; }
+	bool dbGetLineWidthAndColor (CCoord& width, CColor& color, CDataBrowser* browser) override
+	{
+		return false;
+	}
+	void dbDrawHeader (CDrawContext* context, const CRect& size, int32_t column, int32_t flags,
+	                   CDataBrowser* browser) override
+	{
+	}
+	void dbDrawCell (CDrawContext* context, const CRect& size, int32_t row, int32_t column,
+	                 int32_t flags, CDataBrowser* browser) override
+	{
+	}
+
+	std::vector<std::string> strings;
+};
+
+//------------------------------------------------------------------------
+class FixedHeightConfigurator : public IListControlConfigurator, public NonAtomicReferenceCounted
+{
+public:
+	CListControlRowDesc getRowDesc (int32_t row) const override
+	{
+		return {kRowHeight, CListControlRowDesc::Selectable};
+	}
+};
+
+//------------------------------------------------------------------------
+using Clock = std::chrono::high_resolution_clock;
+using Milliseconds = std::chrono::duration<double, std::milli>;
+
+//------------------------------------------------------------------------
+template<typename T>
+Milliseconds runMergeLoop (BackgroundPopulator<T>& populator, uint32_t& numFrames)
+{
+	Milliseconds longestStall {0.};
+	numFrames = 0;
+	bool running = true;
+	while (running)
+	{
+		auto start = Clock::now ();
+		running = populator.merge ();
+		longestStall = std::max<Milliseconds> (longestStall, Clock::now () - start);
+		++numFrames;
+		if (running)
+			std::this_thread::sleep_for (std::chrono::milliseconds (1));
+	}
+	return longestStall;
+}
+
+} // anonymous
+
+//------------------------------------------------------------------------
+TEST_CASE (BackgroundPopulatorTest, DataBrowser)
+{
+	StringListDelegate delegate;
+	auto browser = makeOwned<CDataBrowser> (CRect (0, 0, 120, 400), &delegate,
+	                                        CScrollView::kVerticalScrollbar);
+	browser->recalculateLayout ();
+
+	constexpr size_t maxItemsPerMerge = 20000;
+	bool done = false;
+	size_t numBatches = 0;
+	size_t largestBatch = 0;
+	auto populator = makeOwned<BackgroundPopulator<std::string>> (
+	    [&] (BackgroundPopulator<std::string>::Items& items) {
+		    ++numBatches;
+		    largestBatch = std::max (largestBatch, items.size ());
+		    std::move (items.begin (), items.end (), std::back_inserter (delegate.strings));
+		    browser->rowsAppended ();
+	    },
+	    [&] () { done = true; });
+	populator->setMaxItemsPerMerge (maxItemsPerMerge);
+	populator->start (
+	    [] (BackgroundPopulator<std::string>::Sink& sink) {
+		    for (auto i = 0; i < kNumEntries && !sink.isCancelled (); ++i)
+			    sink.push ("Entry " + std::to_string (i));
+	    },
+	    0);
+
+	uint32_t numFrames = 0;
+	auto longestStall = runMergeLoop (*populator, numFrames);
+	EXPECT_TRUE (done);
+	EXPECT_FALSE (populator->isRunning ());
+	EXPECT_EQ (populator->getNumMergedItems (), static_cast<size_t> (kNumEntries));
+	EXPECT_EQ (delegate.strings.size (), static_cast<size_t> (kNumEntries));
+	EXPECT_EQ (delegate.strings[1234], "Entry 1234");
+	EXPECT_EQ (delegate.strings.back (), "Entry " + std::to_string (kNumEntries - 1));
+	EXPECT_EQ (browser->getContainerSize ().getHeight (), kRowHeight * kNumEntries);
+	EXPECT_TRUE (numFrames > 1);
+	// no merge step handles more than maxItemsPerMerge items on the UI thread
+	EXPECT_TRUE (largestBatch <= maxItemsPerMerge);
+	EXPECT_TRUE (numBatches >= kNumEntries / maxItemsPerMerge);
+
+	// the same amount of entries populated synchronously on the UI thread
+	StringListDelegate syncDelegate;
+	auto syncBrowser = makeOwned<CDataBrowser> (CRect (0, 0, 120, 400), &syncDelegate,
+	                                            CScrollView::kVerticalScrollbar);
+	auto start = Clock::now ();
+	for (auto i = 0; i < kNumEntries; ++i)
+		syncDelegate.strings.emplace_back ("Entry " + std::to_string (i));
+	syncBrowser->recalculateLayout ();
+	Milliseconds syncStall = Clock::now () - start;
+
+	context->print ("%d entries in %u frames (%zu batches), longest stall: %.2f ms, "
+	                "synchronous: %.2f ms\n",
+	                kNumEntries, numFrames, numBatches, longestStall.count (), syncStall.count ());
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (BackgroundPopulatorTest, ListControl)
+{
+	auto listControl = makeOwned<CListControl> (CRect (0, 0, 100, 100));
+	listControl->setMin (0.f);
+	listControl->setMax (0.f);
+	listControl->setConfigurator (makeOwned<FixedHeightConfigurator> ());
+
+	size_t numRows = 0;
+	auto populator = makeOwned<BackgroundPopulator<int32_t>> (
+	    [&] (BackgroundPopulator<int32_t>::Items& items) {
+		    numRows += items.size ();
+		    listControl->setMax (static_cast<float> (numRows - 1));
+		    listControl->rowsAppended ();
+	    });
+	populator->start (
+	    [] (BackgroundPopulator<int32_t>::Sink& sink) {
+		    for (auto i = 0; i < kNumEntries && !sink.isCancelled (); ++i)
+			    sink.push (std::move (i));
+	    },
+	    0);
+
+	uint32_t numFrames = 0;
+	auto longestStall = runMergeLoop (*populator, numFrames);
+	EXPECT_EQ (listControl->getNumRows (), kNumEntries);
+	EXPECT_EQ (listControl->getHeight (), kRowHeight * kNumEntries);
+	auto rect = listControl->getRowRect (kNumEntries - 1);
+	EXPECT_TRUE (rect && rect->top == kRowHeight * (kNumEntries - 1));
+	context->print ("%d rows in %u frames, longest stall: %.2f ms\n", kNumEntries, numFrames,
+	                longestStall.count ());
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (BackgroundPopulatorTest, Cancel)
+{
+	size_t numMerged = 0;
+	bool done = false;
+	auto populator = makeOwned<BackgroundPopulator<int32_t>> (
+	    [&] (BackgroundPopulator<int32_t>::Items& items) { numMerged += items.size (); },
+	    [&] () { done = true; });
+	populator->setChunkSize (10);
+	populator->start (
+	    [] (BackgroundPopulator<int32_t>::Sink& sink) {
+		    int32_t i = 0;
+		    while (!sink.isCancelled ())
+			    sink.push (i++);
+	    },
+	    0);
+	while (numMerged == 0)
+		populator->merge ();
+	populator->cancel ();
+	EXPECT_FALSE (populator->isRunning ());
+	EXPECT_FALSE (populator->merge ());
+	EXPECT_FALSE (done);
+}
+
+} // VSTGUI
@@ -4,6 +4,9 @@
 
 #include "../../../lib/cbitmap.h"
 #include "../../../lib/ccolor.h"
+#include "../../../lib/cdrawcontext.h"
+#include "../../../lib/coffscreencontext.h"
+#include "../../../lib/finally.h"
 #include "../../../lib/platform/iplatformbitmap.h"
 #include "../../../lib/platform/platformfactory.h"
 #include "../unittests.h"
@@ -33,6 +36,69 @@ TEST_CASE (CBitmap, ScaleFactor)
 	EXPECT_EQ (bitmap.getBestPlatformBitmapForScaleFactor (2.6), b2);
 }
 
+//------------------------------------------------------------------------
+TEST_CASE (CBitmap, LazyBitmaps)
+{
+	auto b1 = getPlatformFactory ().createBitmap (CPoint (10, 10));
+	CBitmap bitmap (b1);
+	uint32_t numLoads1 = 0;
+	uint32_t numLoads2 = 0;
+	bitmap.addLazyBitmap (1., [&] () {
+		++numLoads1;
+		return getPlatformFactory ().createBitmap (CPoint (10, 10));
+	});
+	bitmap.addLazyBitmap (2., [&] () {
+		++numLoads2;
+		return getPlatformFactory ().createBitmap (CPoint (20, 20));
+	});
+	EXPECT_TRUE (bitmap.hasLazyBitmaps ());
+	EXPECT_EQ (numLoads2, 0u);
+	EXPECT_EQ (bitmap.getUnloadedMemorySize (), 20u * 20u * 4u);
+
+	bitmap.selectScaleFactor (1.);
+	EXPECT_EQ (numLoads1, 0u);
+	EXPECT_EQ (numLoads2, 0u);
+	EXPECT_EQ (bitmap.getPlatformBitmap (), b1);
+
+	bitmap.selectScaleFactor (2.);
+	EXPECT_EQ (numLoads2, 1u);
+	EXPECT_EQ (bitmap.getPlatformBitmap ()->getScaleFactor (), 2.);
+	EXPECT_EQ (std::distance (bitmap.begin (), bitmap.end ()), 1);
+	EXPECT_EQ (bitmap.getSize (), CPoint (10, 10));
+	EXPECT_EQ (bitmap.getUnloadedMemorySize (), 10u * 10u * 4u);
+	bitmap.selectScaleFactor (1.5);
+	EXPECT_EQ (numLoads1, 0u);
+	EXPECT_EQ (numLoads2, 1u);
+
+	bitmap.selectScaleFactor (1.);
+	EXPECT_EQ (numLoads1, 1u);
+	EXPECT_EQ (bitmap.getPlatformBitmap ()->getScaleFactor (), 1.);
+	EXPECT_EQ (bitmap.getBestPlatformBitmapForScaleFactor (2.)->getScaleFactor (), 1.);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CBitmap, LazyBitmapLoadFails)
+{
+	auto b1 = getPlatformFactory ().createBitmap (CPoint (10, 10));
+	CBitmap bitmap (b1);
+	uint32_t numLoads = 0;
+	bitmap.addLazyBitmap (1., [] () { return getPlatformFactory ().createBitmap (CPoint (10, 10)); });
+	bitmap.addLazyBitmap (2., [&] () {
+		++numLoads;
+		return getPlatformFactory ().createBitmap (CPoint (21, 21));
+	});
+	bitmap.addLazyBitmap (3., [] () { return PlatformBitmapPtr (); });
+	// the wrong sized variant is not used and the bitmap is kept
+	bitmap.selectScaleFactor (2.);
+	EXPECT_EQ (bitmap.getPlatformBitmap (), b1);
+	EXPECT_EQ (std::distance (bitmap.begin (), bitmap.end ()), 1);
+	bitmap.selectScaleFactor (3.);
+	EXPECT_EQ (bitmap.getPlatformBitmap (), b1);
+	bitmap.selectScaleFactor (2.);
+	EXPECT_EQ (numLoads, 1u);
+	EXPECT_EQ (bitmap.getUnloadedMemorySize (), 0u);
+}
+
 //------------------------------------------------------------------------
 TEST_CASE (CBitmap, PixelAccess)
 {
@@ -91,4 +157,127 @@ TEST_CASE (CBitmap, PixelAccess2)
 	}
 }
 
+//------------------------------------------------------------------------
+TEST_CASE (CNinePartTiledBitmap, ComposeOnSecondDraw)
+{
+	CNinePartTiledBitmap bitmap (getPlatformFactory ().createBitmap (CPoint (30, 30)),
+								 CNinePartTiledDescription (10, 10, 10, 10));
+	auto drawContext = COffscreenContext::create (CPoint (200, 200));
+	bitmap.draw (drawContext, CRect (0, 0, 100, 50));
+	EXPECT_EQ (bitmap.getNumCachedBitmaps (), 0u);
+	bitmap.draw (drawContext, CRect (50, 50, 150, 100));
+	EXPECT_EQ (bitmap.getNumCachedBitmaps (), 1u);
+	EXPECT_EQ (CNinePartTiledBitmap::getCacheMemorySize (), 100u * 50u * 4u);
+	bitmap.draw (drawContext, CRect (0, 0, 100, 50));
+	EXPECT_EQ (bitmap.getNumCachedBitmaps (), 1u);
+
+	bitmap.draw (drawContext, CRect (0, 0, 80, 50));
+	bitmap.draw (drawContext, CRect (0, 0, 80, 50));
+	EXPECT_EQ (bitmap.getNumCachedBitmaps (), 2u);
+
+	bitmap.setPartOffsets (CNinePartTiledDescription (5, 5, 5, 5));
+	EXPECT_EQ (bitmap.getNumCachedBitmaps (), 0u);
+	EXPECT_EQ (CNinePartTiledBitmap::getCacheMemorySize (), 0u);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CNinePartTiledBitmap, CacheBudget)
+{
+	auto restoreBudget = finally ([] () {
+		CNinePartTiledBitmap::setCacheBudget (CNinePartTiledBitmap::kDefaultCacheBudget);
+	});
+	CNinePartTiledBitmap bitmap (getPlatformFactory ().createBitmap (CPoint (30, 30)),
+								 CNinePartTiledDescription (10, 10, 10, 10));
+	auto drawContext = COffscreenContext::create (CPoint (200, 200));
+	CNinePartTiledBitmap::setCacheBudget (30000);
+	for (auto i = 0; i < 2; ++i)
+		bitmap.draw (drawContext, CRect (0, 0, 100, 50));
+	for (auto i = 0; i < 2; ++i)
+		bitmap.draw (drawContext, CRect (0, 0, 50, 100));
+	// the least recently used one was removed
+	EXPECT_EQ (bitmap.getNumCachedBitmaps (), 1u);
+	EXPECT_EQ (CNinePartTiledBitmap::getCacheMemorySize (), 20000u);
+
+	// larger than the budget
+	for (auto i = 0; i < 2; ++i)
+		bitmap.draw (drawContext, CRect (0, 0, 200, 200));
+	EXPECT_EQ (bitmap.getNumCachedBitmaps (), 1u);
+
+	CNinePartTiledBitmap::setCacheBudget (0);
+	EXPECT_EQ (bitmap.getNumCachedBitmaps (), 0u);
+	for (auto i = 0; i < 2; ++i)
+		bitmap.draw (drawContext, CRect (0, 0, 100, 50));
+	EXPECT_EQ (bitmap.getNumCachedBitmaps (), 0u);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CNinePartTiledBitmap, SharedCacheBudget)
+{
+	auto restoreBudget = finally ([] () {
+		CNinePartTiledBitmap::setCacheBudget (CNinePartTiledBitmap::kDefaultCacheBudget);
+	});
+	CNinePartTiledBitmap bitmap1 (getPlatformFactory ().createBitmap (CPoint (30, 30)),
+								  CNinePartTiledDescription (10, 10, 10, 10));
+	auto bitmap2 = makeOwned<CNinePartTiledBitmap> (
+		getPlatformFactory ().createBitmap (CPoint (30, 30)),
+		CNinePartTiledDescription (10, 10, 10, 10));
+	auto drawContext = COffscreenContext::create (CPoint (200, 200));
+	CNinePartTiledBitmap::setCacheBudget (30000);
+	for (auto i = 0; i < 2; ++i)
+		bitmap1.draw (drawContext, CRect (0, 0, 100, 50));
+	for (auto i = 0; i < 2; ++i)
+		bitmap2->draw (drawContext, CRect (0, 0, 100, 50));
+	// both bitmaps together exceed the budget, so the least recently used one was removed
+	EXPECT_EQ (bitmap1.getNumCachedBitmaps (), 0u);
+	EXPECT_EQ (bitmap2->getNumCachedBitmaps (), 1u);
+	EXPECT_EQ (CNinePartTiledBitmap::getCacheMemorySize (), 20000u);
+
+	bitmap2 = nullptr;
+	EXPECT_EQ (CNinePartTiledBitmap::getCacheMemorySize (), 0u);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CNinePartTiledBitmap, Transform)
+{
+	CNinePartTiledBitmap bitmap (getPlatformFactory ().createBitmap (CPoint (30, 30)),
+								 CNinePartTiledDescription (10, 10, 10, 10));
+	auto drawContext = COffscreenContext::create (CPoint (200, 200));
+	{
+		CDrawContext::Transform t (*drawContext, CGraphicsTransform ().scale (2., 2.));
+		for (auto i = 0; i < 2; ++i)
+			bitmap.draw (drawContext, CRect (0, 0, 50, 25));
+		EXPECT_EQ (CNinePartTiledBitmap::getCacheMemorySize (), 100u * 50u * 4u);
+	}
+	{
+		CDrawContext::Transform t (*drawContext, CGraphicsTransform ().rotate (45.));
+		for (auto i = 0; i < 2; ++i)
+			bitmap.draw (drawContext, CRect (0, 0, 40, 40));
+		EXPECT_EQ (bitmap.getNumCachedBitmaps (), 1u);
+	}
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CNinePartTiledBitmap, OnlyComposedOnDevicePixels)
+{
+	CNinePartTiledBitmap bitmap (getPlatformFactory ().createBitmap (CPoint (30, 30)),
+								 CNinePartTiledDescription (10, 10, 10, 10));
+	auto drawContext = COffscreenContext::create (CPoint (200, 200));
+	for (auto i = 0; i < 2; ++i)
+		bitmap.draw (drawContext, CRect (0.5, 0, 100.5, 50));
+	EXPECT_EQ (bitmap.getNumCachedBitmaps (), 0u);
+	{
+		CDrawContext::Transform t (*drawContext, CGraphicsTransform ().translate (0.25, 0.));
+		for (auto i = 0; i < 2; ++i)
+			bitmap.draw (drawContext, CRect (0, 0, 100, 50));
+		EXPECT_EQ (bitmap.getNumCachedBitmaps (), 0u);
+	}
+	{
+		// half a point is a device pixel with a scale of 2
+		CDrawContext::Transform t (*drawContext, CGraphicsTransform ().scale (2., 2.));
+		for (auto i = 0; i < 2; ++i)
+			bitmap.draw (drawContext, CRect (0.5, 0, 50.5, 25));
+		EXPECT_EQ (bitmap.getNumCachedBitmaps (), 1u);
+	}
+}
+
 } // VSTGUI
@@ -0,0 +1,236 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "../../../lib/cbitmapatlas.h"
+#include "../../../lib/coffscreencontext.h"
+#include "../../../lib/platform/iplatformbitmap.h"
+#include "../../../lib/platform/platformfactory.h"
+#include "../unittests.h"
+
+namespace VSTGUI {
+
+namespace {
+
+//------------------------------------------------------------------------
+PlatformBitmapPtr createPlatformBitmap (CPoint size, double scaleFactor, uint8_t value)
+{
+	auto bitmap = getPlatformFactory ().createBitmap (
+		CPoint (size.x * scaleFactor, size.y * scaleFactor));
+	bitmap->setScaleFactor (scaleFactor);
+	auto access = bitmap->lockPixels (true);
+	for (auto y = 0u; y < bitmap->getSize ().y; ++y)
+	{
+		auto row = reinterpret_cast<uint32_t*> (access->getAddress () + y * access->getBytesPerRow ());
+		for (auto x = 0u; x < bitmap->getSize ().x; ++x)
+			row[x] = value * 0x01010101u;
+	}
+	return bitmap;
+}
+
+//------------------------------------------------------------------------
+SharedPointer<CBitmap> createBitmap (CPoint size, uint8_t value, bool withScaleFactor2 = true)
+{
+	auto bitmap = makeOwned<CBitmap> (createPlatformBitmap (size, 1., value));
+	if (withScaleFactor2)
+		bitmap->addBitmap (createPlatformBitmap (size, 2., value));
+	return bitmap;
+}
+
+//------------------------------------------------------------------------
+bool pageContains (IPlatformBitmap* page, const CRect& rect, uint8_t value)
+{
+	auto scaleFactor = page->getScaleFactor ();
+	auto access = page->lockPixels (true);
+	for (auto y = static_cast<uint32_t> (rect.top * scaleFactor);
+		 y < static_cast<uint32_t> (rect.bottom * scaleFactor); ++y)
+	{
+		auto row = reinterpret_cast<const uint32_t*> (access->getAddress () +
+													  y * access->getBytesPerRow ());
+		for (auto x = static_cast<uint32_t> (rect.left * scaleFactor);
+			 x < static_cast<uint32_t> (rect.right * scaleFactor); ++x)
+		{
+			if (row[x] != value * 0x01010101u)
+				return false;
+		}
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------
+CBitmapAtlas::NamedBitmapList createIcons ()
+{
+	CBitmapAtlas::NamedBitmapList icons;
+	for (auto i = 0u; i < 20; ++i)
+	{
+		CPoint size (8 + (i % 5) * 4, 8 + (i % 3) * 6);
+		icons.emplace_back ("icon" + std::to_string (i), createBitmap (size, i + 1));
+	}
+	return icons;
+}
+
+//------------------------------------------------------------------------
+/** four bitmaps of 10 x 10 which touch each other in the page */
+SharedPointer<CBitmapAtlas> createAdjacentBitmaps ()
+{
+	CBitmapAtlas::Config config;
+	config.padding = 0.;
+	CBitmapAtlas::NamedBitmapList bitmaps;
+	for (auto i = 0u; i < 4; ++i)
+		bitmaps.emplace_back (std::to_string (i), createBitmap (CPoint (10, 10), i + 1));
+	return CBitmapAtlas::pack (bitmaps, config);
+}
+
+} // anonymous
+
+//------------------------------------------------------------------------
+TEST_CASE (CBitmapAtlasTest, Pack)
+{
+	auto icons = createIcons ();
+	auto atlas = CBitmapAtlas::pack (icons);
+	EXPECT_EQ (atlas->getPages ().size (), 1u);
+	EXPECT_EQ (atlas->getNumPackedBitmaps (), icons.size ());
+	auto page = atlas->getPages ().front ();
+	EXPECT_EQ (page->getBestPlatformBitmapForScaleFactor (2.)->getScaleFactor (), 2.);
+	const auto& entries = atlas->getEntries ();
+	for (auto i = 0u; i < entries.size (); ++i)
+	{
+		const auto& entry = entries[i];
+		EXPECT_EQ (entry.name, icons[i].first);
+		EXPECT_EQ (atlas->getBitmap (entry.name), entry.bitmap);
+		EXPECT_EQ (entry.bitmap->getSize (), icons[i].second->getSize ());
+		auto atlasBitmap = entry.bitmap.cast<CAtlasBitmap> ();
+		EXPECT_TRUE (atlasBitmap);
+		EXPECT_EQ (atlasBitmap->getPage (), page);
+		for (const auto& platformBitmap : *page)
+			EXPECT_TRUE (pageContains (platformBitmap, entry.rect, static_cast<uint8_t> (i + 1)));
+		for (auto j = i + 1; j < entries.size (); ++j)
+		{
+			auto other = entries[j].rect;
+			// the padding is between the bitmaps
+			other.extend (0.5, 0.5);
+			EXPECT_FALSE (entry.rect.rectOverlap (other));
+		}
+	}
+	EXPECT_TRUE (atlas->getPageMemorySize () < atlas->getUnpackedMemorySize () * 2);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CBitmapAtlasTest, KeepBitmapsWhichCannotBePacked)
+{
+	CBitmapAtlas::NamedBitmapList bitmaps;
+	bitmaps.emplace_back ("small", createBitmap (CPoint (10, 10), 1));
+	bitmaps.emplace_back ("large", createBitmap (CPoint (300, 10), 2));
+	bitmaps.emplace_back ("noScaleFactor2", createBitmap (CPoint (10, 10), 3, false));
+	bitmaps.emplace_back ("none", nullptr);
+	auto atlas = CBitmapAtlas::pack (bitmaps);
+	EXPECT_EQ (atlas->getNumPackedBitmaps (), 1u);
+	EXPECT_TRUE (atlas->getBitmap ("small")->getPlatformBitmap () == nullptr);
+	EXPECT_EQ (atlas->getBitmap ("large"), bitmaps[1].second);
+	EXPECT_EQ (atlas->getBitmap ("noScaleFactor2"), bitmaps[2].second);
+	EXPECT_EQ (atlas->getBitmap ("none"), nullptr);
+	EXPECT_EQ (atlas->getBitmap ("unknown"), nullptr);
+	EXPECT_EQ (atlas->getEntries ()[1].page, CBitmapAtlas::kNotPacked);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CBitmapAtlasTest, MultiplePages)
+{
+	CBitmapAtlas::Config config;
+	config.maxPageSize = 32.;
+	CBitmapAtlas::NamedBitmapList bitmaps;
+	for (auto i = 0u; i < 10; ++i)
+		bitmaps.emplace_back (std::to_string (i), createBitmap (CPoint (15, 15), i + 1));
+	auto atlas = CBitmapAtlas::pack (bitmaps, config);
+	EXPECT_EQ (atlas->getNumPackedBitmaps (), 10u);
+	// four bitmaps fit into one page
+	EXPECT_EQ (atlas->getPages ().size (), 3u);
+	EXPECT_EQ (atlas->getPages ()[0]->getSize (), CPoint (31, 31));
+	EXPECT_EQ (atlas->getPages ()[2]->getSize (), CPoint (31, 15));
+	for (const auto& entry : atlas->getEntries ())
+	{
+		auto value = static_cast<uint8_t> (std::stoi (entry.name) + 1);
+		EXPECT_TRUE (pageContains (atlas->getPages ()[entry.page]->getPlatformBitmap (),
+								   entry.rect, value));
+	}
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CBitmapAtlasTest, DrawBitmap)
+{
+	auto atlas = createAdjacentBitmaps ();
+	EXPECT_EQ (atlas->getNumPackedBitmaps (), 4u);
+	CRect rect (0, 0, 40, 40);
+	auto drawContext = COffscreenContext::create (rect.getSize ());
+	for (const auto& entry : atlas->getEntries ())
+	{
+		auto value = static_cast<uint8_t> (std::stoi (entry.name) + 1);
+		// the rect is larger than the bitmap, the neighbours in the page must not be drawn
+		drawContext->beginDraw ();
+		drawContext->clearRect (rect);
+		drawContext->drawBitmap (entry.bitmap, CRect (5, 5, 35, 35));
+		drawContext->endDraw ();
+		auto platformBitmap = drawContext->getBitmap ()->getPlatformBitmap ();
+		EXPECT_TRUE (pageContains (platformBitmap, CRect (5, 5, 15, 15), value));
+		EXPECT_TRUE (pageContains (platformBitmap, CRect (15, 0, 40, 40), 0));
+		EXPECT_TRUE (pageContains (platformBitmap, CRect (0, 15, 15, 40), 0));
+
+		drawContext->beginDraw ();
+		drawContext->clearRect (rect);
+		drawContext->drawBitmap (entry.bitmap, CRect (5, 5, 35, 35), CPoint (7, 4));
+		drawContext->endDraw ();
+		EXPECT_TRUE (pageContains (platformBitmap, CRect (5, 5, 8, 11), value));
+		EXPECT_TRUE (pageContains (platformBitmap, CRect (8, 0, 40, 40), 0));
+		EXPECT_TRUE (pageContains (platformBitmap, CRect (0, 11, 8, 40), 0));
+	}
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CBitmapAtlasTest, FillRectAndNinePartTiled)
+{
+	auto atlas = createAdjacentBitmaps ();
+	auto bitmap = atlas->getBitmap ("2");
+	CRect rect (0, 0, 40, 40);
+	auto drawContext = COffscreenContext::create (rect.getSize ());
+	auto platformBitmap = drawContext->getBitmap ()->getPlatformBitmap ();
+
+	drawContext->beginDraw ();
+	drawContext->clearRect (rect);
+	drawContext->fillRectWithBitmap (bitmap, CRect (2, 2, 8, 8), CRect (0, 0, 27, 27), 1.f);
+	drawContext->endDraw ();
+	EXPECT_TRUE (pageContains (platformBitmap, CRect (0, 0, 27, 27), 3));
+	EXPECT_TRUE (pageContains (platformBitmap, CRect (27, 0, 40, 40), 0));
+	EXPECT_TRUE (pageContains (platformBitmap, CRect (0, 27, 27, 40), 0));
+
+	drawContext->beginDraw ();
+	drawContext->clearRect (rect);
+	drawContext->drawBitmapNinePartTiled (bitmap, CRect (4, 4, 36, 36),
+										  CNinePartTiledDescription (3, 3, 3, 3));
+	drawContext->endDraw ();
+	EXPECT_TRUE (pageContains (platformBitmap, CRect (4, 4, 36, 36), 3));
+	EXPECT_TRUE (pageContains (platformBitmap, CRect (0, 0, 40, 4), 0));
+	EXPECT_TRUE (pageContains (platformBitmap, CRect (36, 4, 40, 40), 0));
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CBitmapAtlasTest, Description)
+{
+	auto atlas = CBitmapAtlas::pack (createIcons ());
+	auto description = atlas->toDescription ();
+	auto restored = CBitmapAtlas::create (atlas->getPages (), description);
+	EXPECT_TRUE (restored);
+	EXPECT_EQ (restored->getEntries ().size (), atlas->getEntries ().size ());
+	for (const auto& entry : atlas->getEntries ())
+	{
+		auto bitmap = dynamic_cast<CAtlasBitmap*> (restored->getBitmap (entry.name));
+		EXPECT_TRUE (bitmap);
+		EXPECT_EQ (bitmap->getRect (), entry.rect);
+	}
+	EXPECT_EQ (restored->toDescription (), description);
+
+	EXPECT_FALSE (CBitmapAtlas::create (atlas->getPages (), "1 0 0 10 10 outOfPages\n"));
+	EXPECT_FALSE (CBitmapAtlas::create (atlas->getPages (), "0 0 0 1000 10 tooLarge\n"));
+	EXPECT_FALSE (CBitmapAtlas::create (atlas->getPages (), "0 0 0 10\n"));
+}
+
+} // VSTGUI
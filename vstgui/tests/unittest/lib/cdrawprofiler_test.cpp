@@ -0,0 +1,189 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "../../../lib/cdrawprofiler.h"
+#include "../../../lib/cframe.h"
+#include "../../../lib/coffscreencontext.h"
+#include "../../../lib/cview.h"
+#include "../../../lib/cviewcontainer.h"
+#include "../../../lib/platform/iplatformframecallback.h"
+#include "../unittests.h"
+#include <algorithm>
+#include <cmath>
+
+namespace VSTGUI {
+
+namespace {
+
+void drawFrame (CDrawProfiler& profiler, CViewContainer* container, CView* child)
+{
+	profiler.beginFrame ();
+	profiler.beginView (container);
+	profiler.beginView (child);
+	profiler.endView (child);
+	profiler.endView (container);
+	profiler.endFrame ();
+}
+
+const CDrawProfiler::Entry* findEntry (const CDrawProfiler& profiler, const CView* view)
+{
+	for (const auto& entry : profiler.getResults ())
+	{
+		if (entry.view == view)
+			return &entry;
+	}
+	return nullptr;
+}
+
+} // anonymous
+
+TEST_CASE (CDrawProfilerTest, ResultsArePublishedAfterNumFrames)
+{
+	CDrawProfiler profiler (3);
+	auto container = makeOwned<CViewContainer> (CRect (0, 0, 100, 100));
+	auto child = makeOwned<CView> (CRect (10, 10, 20, 20));
+	drawFrame (profiler, container, child);
+	drawFrame (profiler, container, child);
+	EXPECT_TRUE (profiler.getResults ().empty ());
+	EXPECT_EQ (profiler.getNumResultFrames (), 0u);
+	drawFrame (profiler, container, child);
+	EXPECT_EQ (profiler.getResults ().size (), 2u);
+	EXPECT_EQ (profiler.getNumResultFrames (), 3u);
+	for (const auto& entry : profiler.getResults ())
+	{
+		EXPECT_EQ (entry.numDraws, 3u);
+		EXPECT_TRUE (entry.selfTime <= entry.totalTime);
+	}
+	EXPECT_TRUE (profiler.getResultFrameTime () > 0.);
+}
+
+TEST_CASE (CDrawProfilerTest, SelfTimeExcludesChildren)
+{
+	CDrawProfiler profiler (1);
+	auto container = makeOwned<CViewContainer> (CRect (0, 0, 100, 100));
+	auto child = makeOwned<CView> (CRect (10, 10, 20, 20));
+	drawFrame (profiler, container, child);
+	const CDrawProfiler::Entry* containerEntry = nullptr;
+	const CDrawProfiler::Entry* childEntry = nullptr;
+	for (const auto& entry : profiler.getResults ())
+	{
+		if (entry.view == container)
+			containerEntry = &entry;
+		else if (entry.view == child)
+			childEntry = &entry;
+	}
+	EXPECT_TRUE (containerEntry && childEntry);
+	EXPECT_EQ (containerEntry->className, "VSTGUI::CViewContainer");
+	EXPECT_EQ (childEntry->className, "VSTGUI::CView");
+	EXPECT_TRUE (containerEntry->totalTime >= childEntry->totalTime);
+	EXPECT_TRUE (std::abs (containerEntry->selfTime -
+						   (containerEntry->totalTime - childEntry->totalTime)) < 1e-9);
+}
+
+TEST_CASE (CDrawProfilerTest, ForgetView)
+{
+	CDrawProfiler profiler (1);
+	auto container = makeOwned<CViewContainer> (CRect (0, 0, 100, 100));
+	auto child = makeOwned<CView> (CRect (10, 10, 20, 20));
+	drawFrame (profiler, container, child);
+	EXPECT_EQ (profiler.getResults ().size (), 2u);
+	profiler.forgetView (child);
+	EXPECT_EQ (profiler.getResults ().size (), 1u);
+	EXPECT_EQ (profiler.getResults ().front ().view, container.get ());
+
+	// a view removed while drawing is not measured
+	profiler.beginFrame ();
+	profiler.beginView (container);
+	profiler.beginView (child);
+	profiler.forgetView (child);
+	profiler.endView (child);
+	profiler.endView (container);
+	profiler.endFrame ();
+	EXPECT_EQ (profiler.getResults ().size (), 1u);
+}
+
+TEST_CASE (CDrawProfilerTest, Report)
+{
+	CDrawProfiler profiler (2);
+	EXPECT_TRUE (profiler.createReport ().empty ());
+	auto container = makeOwned<CViewContainer> (CRect (0, 0, 100, 100));
+	auto child = makeOwned<CView> (CRect (10, 10, 20, 20));
+	drawFrame (profiler, container, child);
+	drawFrame (profiler, container, child);
+	auto report = profiler.createReport ();
+	EXPECT_TRUE (report.find ("Draw profile of 2 frames") == 0);
+	EXPECT_TRUE (report.find ("VSTGUI::CViewContainer") != std::string::npos);
+	EXPECT_TRUE (report.find ("VSTGUI::CView ") != std::string::npos);
+	// header lines plus one line per view
+	EXPECT_EQ (std::count (report.begin (), report.end (), '\n'), 4);
+	report = profiler.createReport (1);
+	EXPECT_EQ (std::count (report.begin (), report.end (), '\n'), 3);
+
+	profiler.reset ();
+	EXPECT_TRUE (profiler.getResults ().empty ());
+	EXPECT_TRUE (profiler.createReport ().empty ());
+}
+
+TEST_CASE (CDrawProfilerTest, FrameProfilesOneFramePerRedraw)
+{
+	auto frame = owned (new CFrame (CRect (0, 0, 100, 100), nullptr));
+	auto container = new CViewContainer (CRect (0, 0, 100, 50));
+	auto child = new CView (CRect (10, 10, 20, 20));
+	container->addView (child);
+	frame->addView (container);
+	frame->attached (frame);
+	frame->setDrawProfilingEnabled (true, 2);
+	auto profiler = frame->getDrawProfiler ();
+	auto drawContext = COffscreenContext::create (CPoint (100, 100));
+	auto platformFrameCallback = dynamic_cast<IPlatformFrameCallback*> (frame.get ());
+
+	auto redraw = [&] () {
+		platformFrameCallback->platformOnBeginRedraw ();
+		platformFrameCallback->platformDrawRect (drawContext, CRect (0, 0, 50, 50));
+		platformFrameCallback->platformDrawRect (drawContext, CRect (50, 0, 100, 50));
+		platformFrameCallback->platformDrawRect (drawContext, CRect (0, 50, 100, 100));
+		platformFrameCallback->platformOnEndRedraw ();
+	};
+	redraw ();
+	EXPECT_TRUE (profiler->getResults ().empty ());
+	redraw ();
+	EXPECT_EQ (profiler->getNumResultFrames (), 2u);
+	EXPECT_EQ (profiler->getResults ().size (), 2u);
+
+	// the container is drawn for the first two rects of each redraw, the child only for the first
+	auto containerEntry = findEntry (*profiler, container);
+	auto childEntry = findEntry (*profiler, child);
+	EXPECT_TRUE (containerEntry && childEntry);
+	EXPECT_EQ (containerEntry->numDraws, 4u);
+	EXPECT_EQ (childEntry->numDraws, 2u);
+	EXPECT_TRUE (containerEntry->totalTime >= childEntry->totalTime);
+}
+
+TEST_CASE (CDrawProfilerTest, FrameProfilesDrawOutsideOfRedraw)
+{
+	auto frame = owned (new CFrame (CRect (0, 0, 100, 100), nullptr));
+	auto child = new CView (CRect (10, 10, 20, 20));
+	frame->addView (child);
+	frame->attached (frame);
+	auto drawContext = COffscreenContext::create (CPoint (100, 100));
+	auto platformFrameCallback = dynamic_cast<IPlatformFrameCallback*> (frame.get ());
+
+	// a redraw in which profiling was switched on is not profiled
+	platformFrameCallback->platformOnBeginRedraw ();
+	frame->setDrawProfilingEnabled (true, 1);
+	auto profiler = frame->getDrawProfiler ();
+	platformFrameCallback->platformDrawRect (drawContext, CRect (0, 0, 50, 50));
+	platformFrameCallback->platformDrawRect (drawContext, CRect (50, 50, 100, 100));
+	platformFrameCallback->platformOnEndRedraw ();
+	EXPECT_TRUE (profiler->getResults ().empty ());
+
+	// every draw without a surrounding redraw is a frame on its own
+	frame->draw (drawContext);
+	EXPECT_EQ (profiler->getNumResultFrames (), 1u);
+	auto childEntry = findEntry (*profiler, child);
+	EXPECT_TRUE (childEntry);
+	EXPECT_EQ (childEntry->numDraws, 1u);
+}
+
+} // VSTGUI
@@ -0,0 +1,218 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "../../../lib/cfilmstripbitmap.h"
+#include "../../../lib/coffscreencontext.h"
+#include "../../../lib/platform/iplatformbitmap.h"
+#include "../../../lib/platform/platformfactory.h"
+#include "../unittests.h"
+
+namespace VSTGUI {
+
+namespace {
+
+constexpr uint32_t kFrameWidth = 40;
+constexpr uint32_t kFrameHeight = 30;
+constexpr uint32_t kNumFrames = 8;
+
+//------------------------------------------------------------------------
+/** every byte of a pixel has the same value, so it is valid in every pixel format */
+uint32_t expectedPixel (uint32_t x, uint32_t y, uint32_t frame)
+{
+	// a moving block on a static background
+	uint32_t value = (x / 8 + y / 8) % 2 ? 0x40 : 0x80;
+	if (x >= frame * 4 && x < frame * 4 + 6 && y >= 10 && y < 16)
+		value = 0xff;
+	return value * 0x01010101u;
+}
+
+//------------------------------------------------------------------------
+PlatformBitmapPtr createStrip (double scaleFactor)
+{
+	auto width = static_cast<uint32_t> (kFrameWidth * scaleFactor);
+	auto height = static_cast<uint32_t> (kFrameHeight * scaleFactor);
+	auto bitmap = getPlatformFactory ().createBitmap (CPoint (width, height * kNumFrames));
+	bitmap->setScaleFactor (scaleFactor);
+	auto access = bitmap->lockPixels (true);
+	for (auto frame = 0u; frame < kNumFrames; ++frame)
+	{
+		for (auto y = 0u; y < height; ++y)
+		{
+			auto row = reinterpret_cast<uint32_t*> (access->getAddress () +
+													(frame * height + y) * access->getBytesPerRow ());
+			for (auto x = 0u; x < width; ++x)
+				row[x] = expectedPixel (x, y, frame);
+		}
+	}
+	return bitmap;
+}
+
+//------------------------------------------------------------------------
+bool frameEquals (IPlatformBitmap* bitmap, uint32_t frame, uint32_t width, uint32_t height)
+{
+	if (!bitmap || bitmap->getSize () != CPoint (width, height))
+		return false;
+	auto access = bitmap->lockPixels (true);
+	for (auto y = 0u; y < height; ++y)
+	{
+		auto row =
+			reinterpret_cast<const uint32_t*> (access->getAddress () + y * access->getBytesPerRow ());
+		for (auto x = 0u; x < width; ++x)
+		{
+			if (row[x] != expectedPixel (x, y, frame))
+				return false;
+		}
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------
+/** compares height rows of the bitmap from top on with a frame, or with transparent pixels if the
+ *	frame is kNumFrames */
+bool rowsEqual (IPlatformBitmap* bitmap, uint32_t top, uint32_t height, uint32_t frame)
+{
+	if (!bitmap || bitmap->getSize ().x != kFrameWidth || bitmap->getSize ().y < top + height)
+		return false;
+	auto access = bitmap->lockPixels (true);
+	for (auto y = 0u; y < height; ++y)
+	{
+		auto row = reinterpret_cast<const uint32_t*> (access->getAddress () +
+													  (top + y) * access->getBytesPerRow ());
+		for (auto x = 0u; x < kFrameWidth; ++x)
+		{
+			if (row[x] != (frame < kNumFrames ? expectedPixel (x, y, frame) : 0u))
+				return false;
+		}
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------
+SharedPointer<CFilmstripBitmap> createCompressedStrip ()
+{
+	auto strip = makeOwned<CFilmstripBitmap> (createStrip (1.), kNumFrames);
+	strip->compress ();
+	return strip;
+}
+
+} // anonymous
+
+//------------------------------------------------------------------------
+TEST_CASE (CFilmstripBitmapTest, Compress)
+{
+	auto strip = makeOwned<CFilmstripBitmap> (createStrip (1.), kNumFrames);
+	EXPECT_FALSE (strip->isCompressed ());
+	EXPECT_NE (strip->getPlatformBitmap (), nullptr);
+	EXPECT_TRUE (strip->compress ());
+	EXPECT_TRUE (strip->isCompressed ());
+	EXPECT_EQ (strip->getPlatformBitmap (), nullptr);
+	EXPECT_EQ (strip->getNumFrames (), kNumFrames);
+	EXPECT_EQ (strip->getWidth (), kFrameWidth);
+	EXPECT_EQ (strip->getHeight (), kFrameHeight * kNumFrames);
+	EXPECT_EQ (strip->getFrameSize (), CPoint (kFrameWidth, kFrameHeight));
+	EXPECT_EQ (strip->getUncompressedMemorySize (), kFrameWidth * kFrameHeight * kNumFrames * 4);
+	EXPECT_TRUE (strip->getResidentMemorySize () < strip->getUncompressedMemorySize () / 2);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CFilmstripBitmapTest, DecodeFrames)
+{
+	auto strip = createCompressedStrip ();
+	for (auto frame = 0u; frame < kNumFrames; ++frame)
+		EXPECT_TRUE (frameEquals (strip->getFrame (frame), frame, kFrameWidth, kFrameHeight));
+	EXPECT_EQ (strip->getFrame (kNumFrames), nullptr);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CFilmstripBitmapTest, FrameCache)
+{
+	auto strip = createCompressedStrip ();
+	auto memoryWithoutFrames = strip->getResidentMemorySize ();
+	strip->setMaxCachedFrames (2);
+	auto frame0 = strip->getFrame (0);
+	EXPECT_EQ (strip->getFrame (0), frame0);
+	strip->getFrame (1);
+	strip->getFrame (0);
+	strip->getFrame (2);
+	EXPECT_EQ (strip->getNumCachedFrames (), 2u);
+	// frame 1 was the least recently used one
+	EXPECT_EQ (strip->getFrame (0), frame0);
+	EXPECT_EQ (strip->getResidentMemorySize (),
+			   memoryWithoutFrames + 2 * kFrameWidth * kFrameHeight * 4);
+	strip->purgeCache ();
+	EXPECT_EQ (strip->getNumCachedFrames (), 0u);
+	EXPECT_EQ (strip->getResidentMemorySize (), memoryWithoutFrames);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CFilmstripBitmapTest, ScaleFactors)
+{
+	auto strip = createCompressedStrip ();
+	EXPECT_TRUE (strip->addStrip (createStrip (2.)));
+	EXPECT_EXCEPTION (strip->addStrip (createStrip (2.)), "scale factor already added");
+	EXPECT_EQ (strip->getUncompressedMemorySize (),
+			   kFrameWidth * kFrameHeight * kNumFrames * 4 * 5);
+	auto frame = strip->getFrame (3, 2.);
+	EXPECT_EQ (frame->getScaleFactor (), 2.);
+	EXPECT_TRUE (frameEquals (frame, 3, kFrameWidth * 2, kFrameHeight * 2));
+	EXPECT_EQ (strip->getFrame (3, 1.5)->getScaleFactor (), 2.);
+	EXPECT_EQ (strip->getFrame (3, 1.)->getScaleFactor (), 1.);
+	EXPECT_EQ (strip->getFrame (3, 3.)->getScaleFactor (), 2.);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CFilmstripBitmapTest, UncompressedFallback)
+{
+	// the height is not a multiple of the number of frames
+	auto strip = makeOwned<CFilmstripBitmap> (createStrip (1.), kNumFrames + 1);
+	EXPECT_FALSE (strip->compress ());
+	EXPECT_FALSE (strip->isCompressed ());
+	EXPECT_NE (strip->getPlatformBitmap (), nullptr);
+	EXPECT_EQ (strip->getHeight (), kFrameHeight * kNumFrames);
+	EXPECT_EQ (strip->getFrame (0), nullptr);
+	EXPECT_EQ (strip->getResidentMemorySize (), strip->getUncompressedMemorySize ());
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CFilmstripBitmapTest, CompressStripsOfAllScaleFactors)
+{
+	auto strip = makeOwned<CFilmstripBitmap> (createStrip (1.), kNumFrames);
+	EXPECT_TRUE (strip->addStrip (createStrip (2.)));
+	EXPECT_TRUE (strip->compress ());
+	EXPECT_EQ (strip->getFrame (5, 2.)->getScaleFactor (), 2.);
+	EXPECT_TRUE (frameEquals (strip->getFrame (5, 2.), 5, kFrameWidth * 2, kFrameHeight * 2));
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CFilmstripBitmapTest, DrawBitmap)
+{
+	auto strip = createCompressedStrip ();
+	CRect rect (0, 0, kFrameWidth, kFrameHeight * 2);
+	auto drawContext = COffscreenContext::create (rect.getSize ());
+	for (auto frame : {0u, 5u, kNumFrames - 1})
+	{
+		drawContext->beginDraw ();
+		drawContext->clearRect (rect);
+		// only the frame at the offset is drawn, not the following one
+		drawContext->drawBitmap (strip, rect, CPoint (0, frame * kFrameHeight));
+		drawContext->endDraw ();
+		auto platformBitmap = drawContext->getBitmap ()->getPlatformBitmap ();
+		EXPECT_TRUE (rowsEqual (platformBitmap, 0, kFrameHeight, frame));
+		EXPECT_TRUE (rowsEqual (platformBitmap, kFrameHeight, kFrameHeight, kNumFrames));
+	}
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CFilmstripBitmapTest, DrawPartOfFrame)
+{
+	auto strip = createCompressedStrip ();
+	CRect dest (0, 0, kFrameWidth, kFrameHeight);
+	CPoint offset (10, 3 * kFrameHeight + 5);
+	auto platformBitmap = strip->resolvePlatformBitmap (1., dest, offset);
+	EXPECT_TRUE (frameEquals (platformBitmap, 3, kFrameWidth, kFrameHeight));
+	EXPECT_EQ (offset, CPoint (10, 5));
+	EXPECT_EQ (dest, CRect (0, 0, kFrameWidth, kFrameHeight - 5));
+}
+
+} // VSTGUI
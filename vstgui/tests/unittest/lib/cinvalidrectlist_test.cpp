@@ -47,4 +47,99 @@ TEST_CASE (CInvalidRectListTest, AddMulti)
 	EXPECT_EQ (list.data ().size (), 2u);
 }
 
+TEST_CASE (CInvalidRectListTest, ScrollExposesStrip)
+{
+	CInvalidRectList list;
+	// scroll the content of {0, 0, 100, 200} down by 20 pixels
+	scrollInvalidRects (list, {0, 0, 100, 180}, {0, 20});
+	EXPECT_EQ (list.data ().size (), 1u);
+	EXPECT_EQ (list.data ().front (), CRect (0, 0, 100, 20));
+
+	list.clear ();
+	// scroll the content of {0, 0, 100, 200} left by 10 pixels
+	scrollInvalidRects (list, {10, 0, 100, 200}, {-10, 0});
+	EXPECT_EQ (list.data ().size (), 1u);
+	EXPECT_EQ (list.data ().front (), CRect (90, 0, 100, 200));
+}
+
+TEST_CASE (CInvalidRectListTest, ScrollMovesPendingRects)
+{
+	CInvalidRectList list;
+	list.add ({10, 50, 20, 60});
+	list.add ({200, 50, 210, 60});
+	scrollInvalidRects (list, {0, 20, 100, 200}, {0, -20});
+	EXPECT_EQ (list.data ().size (), 4u);
+	EXPECT_EQ (list.data ()[0], CRect (10, 50, 20, 60));
+	EXPECT_EQ (list.data ()[1], CRect (200, 50, 210, 60));
+	EXPECT_EQ (list.data ()[2], CRect (10, 30, 20, 40));
+	EXPECT_EQ (list.data ()[3], CRect (0, 180, 100, 200));
+}
+
+TEST_CASE (CInvalidRectListTest, ScrollRepaintedPixels)
+{
+	constexpr CCoord width = 400.;
+	constexpr CCoord height = 300.;
+	constexpr CCoord step = 12.;
+	constexpr auto numSteps = 100;
+
+	uint64_t repaintedPixels = 0;
+	for (auto i = 0; i < numSteps; ++i)
+	{
+		CInvalidRectList list;
+		scrollInvalidRects (list, {0, step, width, height}, {0, -step});
+		for (const auto& rect : list)
+			repaintedPixels += static_cast<uint64_t> (rect.getWidth () * rect.getHeight ());
+	}
+	auto pixelsPerStep = repaintedPixels / numSteps;
+	EXPECT_EQ (pixelsPerStep, static_cast<uint64_t> (width * step));
+	EXPECT_TRUE (pixelsPerStep * 20 < static_cast<uint64_t> (width * height));
+}
+
+TEST_CASE (CInvalidRectListTest, ScrollBlitRect)
+{
+	// what the X11 frame does for two scroll steps before the next redraw
+	CInvalidRectList dirtyRects;
+	CBlitRect scrolledRect;
+	auto scroll = [&] (const CRect& src, const CPoint& distance) {
+		CRect dest (src);
+		dest.offset (distance);
+		scrolledRect.add (dest);
+		scrollInvalidRects (dirtyRects, src, distance);
+	};
+	scroll ({0, 20, 100, 200}, {0, -20});
+	scroll ({0, 20, 100, 200}, {0, -20});
+	EXPECT_EQ (dirtyRects.data ().size (), 1u);
+	EXPECT_EQ (dirtyRects.data ().front (), CRect (0, 160, 100, 200));
+
+	// the moved content and the repainted strips are copied to the window
+	CBlitRect copyRect;
+	for (const auto& rect : dirtyRects)
+		copyRect.add (rect);
+	copyRect.add (scrolledRect);
+	EXPECT_EQ (copyRect.get (), CRect (0, 0, 100, 200));
+
+	// without a scroll only the drawn rects are copied
+	scrolledRect.clear ();
+	copyRect.clear ();
+	EXPECT_TRUE (copyRect.empty ());
+	copyRect.add ({10, 10, 20, 20});
+	copyRect.add (scrolledRect);
+	copyRect.add (CRect ());
+	EXPECT_EQ (copyRect.get (), CRect (10, 10, 20, 20));
+}
+
+TEST_CASE (CInvalidRectListTest, ScrollCopySource)
+{
+	const CRect bounds (0, 0, 100, 200);
+	// inside of the bounds the whole source is copied
+	EXPECT_EQ (getScrollCopySource (bounds, {0, 20, 100, 200}, {0, -20}), CRect (0, 20, 100, 200));
+	// the content moved outside of the bounds is not copied
+	EXPECT_EQ (getScrollCopySource (bounds, {0, 0, 100, 200}, {0, 50}), CRect (0, 0, 100, 150));
+	EXPECT_EQ (getScrollCopySource (bounds, {-50, 0, 100, 200}, {30, 0}), CRect (0, 0, 70, 200));
+	// nothing to copy if the distance is larger than the source
+	EXPECT_TRUE (getScrollCopySource (bounds, {0, 0, 100, 50}, {0, -80}).isEmpty ());
+	EXPECT_TRUE (getScrollCopySource (bounds, {0, 0, 100, 200}, {0, 250}).isEmpty ());
+	EXPECT_TRUE (getScrollCopySource (bounds, {0, 0, 100, 200}, {-120, 0}).isEmpty ());
+}
+
 } // VSTGUI
@@ -299,5 +299,53 @@ TEST_CASE (CListControlTest, PageDown)
 	parent->removeAll (false);
 }
 
+//------------------------------------------------------------------------
+class VariableHeightConfigurator : public IListControlConfigurator,
+                                   public NonAtomicReferenceCounted
+{
+public:
+	CListControlRowDesc getRowDesc (int32_t row) const override
+	{
+		return {row == changedRow ? changedHeight : 10. + (row % 3) * 10., CListControlRowDesc::Selectable};
+	}
+
+	int32_t changedRow {-1};
+	CCoord changedHeight {0.};
+};
+
+TEST_CASE (CListControlTest, VariableRowHeights)
+{
+	constexpr auto numRows = 1000;
+	auto listControl = makeOwned<CListControl> (CRect (0, 0, 100, 100));
+	auto config = makeOwned<VariableHeightConfigurator> ();
+	listControl->setMin (0.f);
+	listControl->setMax (static_cast<float> (numRows - 1));
+	listControl->setConfigurator (config);
+
+	CCoord top = 0.;
+	for (auto row = 0; row < numRows; ++row)
+	{
+		auto height = 10. + (row % 3) * 10.;
+		auto rect = listControl->getRowRect (row);
+		EXPECT (rect);
+		EXPECT (rect->top == top && rect->getHeight () == height);
+		EXPECT (*listControl->getRowAtPoint ({0., top}) == row);
+		EXPECT (*listControl->getRowAtPoint ({0., top + height - 1.}) == row);
+		top += height;
+	}
+	EXPECT (listControl->getHeight () == top);
+	EXPECT (!listControl->getRowAtPoint ({0., top}));
+
+	config->changedRow = 10;
+	config->changedHeight = 100.;
+	listControl->updateRowDesc (10);
+	auto oldHeight = 10. + (10 % 3) * 10.;
+	EXPECT (listControl->getHeight () == top - oldHeight + 100.);
+	auto rect = listControl->getRowRect (11);
+	EXPECT (rect && rect->top == listControl->getRowRect (10)->top + 100.);
+	EXPECT (*listControl->getRowAtPoint ({0., rect->top - 1.}) == 10);
+	EXPECT (*listControl->getRowAtPoint ({0., rect->top}) == 11);
+}
+
 //------------------------------------------------------------------------
 } // VSTGUI
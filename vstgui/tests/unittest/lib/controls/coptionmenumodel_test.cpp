@@ -0,0 +1,126 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "../../../../lib/controls/coptionmenu.h"
+#include "../../../../lib/controls/coptionmenumodel.h"
+#include "../../unittests.h"
+
+namespace VSTGUI {
+
+namespace {
+
+//------------------------------------------------------------------------
+SharedPointer<COptionMenuModel> makeTestModel ()
+{
+	auto model = makeOwned<COptionMenuModel> ();
+	model->addItem (COptionMenuModel::kRootIndex, "One", 1);
+	model->addItem (COptionMenuModel::kRootIndex, "-");
+	auto sub = model->addSubmenu (COptionMenuModel::kRootIndex, "Sub");
+	model->addItem (sub, "Two", 2, CMenuItem::kChecked);
+	auto subSub = model->addSubmenu (sub, "SubSub");
+	model->addItem (subSub, "Three", 3);
+	model->addItem (COptionMenuModel::kRootIndex, "Four", 4, CMenuItem::kDisabled);
+	return model;
+}
+
+} // anonymous
+
+//------------------------------------------------------------------------
+TEST_CASE (COptionMenuModelTest, Structure)
+{
+	auto model = makeTestModel ();
+	EXPECT_EQ (model->getTotalNumItems (), 7u);
+	EXPECT_EQ (model->getNumItems (COptionMenuModel::kRootIndex), 4u);
+
+	auto item = model->getFirstItem (COptionMenuModel::kRootIndex);
+	EXPECT_EQ (model->getTitle (item), "One");
+	EXPECT_EQ (model->getTag (item), 1);
+	item = model->getNextItem (item);
+	EXPECT_EQ (model->getFlags (item), CMenuItem::kSeparator);
+	item = model->getNextItem (item);
+	EXPECT_TRUE (model->isSubmenu (item));
+	EXPECT_EQ (model->getNumItems (item), 2u);
+	item = model->getNextItem (item);
+	EXPECT_EQ (model->getTitle (item), "Four");
+	EXPECT_EQ (model->getFlags (item), CMenuItem::kDisabled);
+	EXPECT_EQ (model->getNextItem (item), COptionMenuModel::kInvalidIndex);
+
+	model->clear ();
+	EXPECT_EQ (model->getTotalNumItems (), 0u);
+	EXPECT_EQ (model->getFirstItem (COptionMenuModel::kRootIndex), COptionMenuModel::kInvalidIndex);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (COptionMenuModelTest, LazyEntries)
+{
+	auto menu = makeOwned<COptionMenu> ();
+	menu->addEntry ("Removed");
+	menu->setModel (makeTestModel ());
+	EXPECT_EQ (menu->getNbEntries (), 4);
+	EXPECT_EQ (menu->getMax (), 3.f);
+
+	auto entry = menu->getEntry (0);
+	EXPECT_EQ (entry->getTitle (), "One");
+	EXPECT_EQ (entry->getTag (), 1);
+	EXPECT_TRUE (menu->getEntry (1)->isSeparator ());
+	EXPECT_FALSE (menu->getEntry (3)->isEnabled ());
+
+	auto sub = menu->getSubMenu (2);
+	EXPECT_TRUE (sub != nullptr);
+	EXPECT_EQ (menu->getEntry (2)->getTitle (), "Sub");
+	// the submenu is not filled before its entries are needed
+	EXPECT_TRUE (sub->getModel () == menu->getModel ());
+	EXPECT_EQ (sub->getNbEntries (), 2);
+	EXPECT_TRUE (sub->getEntry (0)->isChecked ());
+	EXPECT_EQ (sub->getSubMenu (1)->getEntry (0)->getTitle (), "Three");
+	EXPECT_EQ (sub->getSubMenu (1)->getEntry (0)->getTag (), 3);
+
+	menu->addEntry ("Five");
+	EXPECT_EQ (menu->getNbEntries (), 5);
+	EXPECT_TRUE (menu->removeEntry (0));
+	EXPECT_EQ (menu->getEntry (0)->isSeparator (), true);
+
+	menu->removeAllEntry ();
+	EXPECT_EQ (menu->getNbEntries (), 0);
+	EXPECT_TRUE (menu->getModel () == nullptr);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (COptionMenuModelTest, Copy)
+{
+	auto menu = makeOwned<COptionMenu> ();
+	menu->setModel (makeTestModel ());
+	auto copy = makeOwned<COptionMenu> (*menu);
+	EXPECT_EQ (copy->getNbEntries (), 4);
+	EXPECT_EQ (copy->getEntry (3)->getTitle (), "Four");
+	EXPECT_EQ (menu->getEntry (3)->getTitle (), "Four");
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (COptionMenuModelTest, LargeTree)
+{
+	constexpr auto kNumSubmenus = 100;
+	constexpr auto kNumItems = 300;
+	auto model = makeOwned<COptionMenuModel> ();
+	model->reserve (kNumSubmenus * (kNumItems + 1));
+	for (auto i = 0; i < kNumSubmenus; ++i)
+	{
+		auto sub = model->addSubmenu (COptionMenuModel::kRootIndex,
+		                              ("Folder " + std::to_string (i)).data ());
+		for (auto j = 0; j < kNumItems; ++j)
+			model->addItem (sub, ("Preset " + std::to_string (j)).data (), i * kNumItems + j);
+	}
+	EXPECT_EQ (model->getTotalNumItems (), static_cast<size_t> (kNumSubmenus * (kNumItems + 1)));
+
+	auto menu = makeOwned<COptionMenu> ();
+	menu->setModel (model);
+	EXPECT_EQ (menu->getNbEntries (), kNumSubmenus);
+	auto sub = menu->getSubMenu (42);
+	EXPECT_EQ (menu->getEntry (42)->getTitle (), "Folder 42");
+	EXPECT_EQ (sub->getNbEntries (), kNumItems);
+	EXPECT_EQ (sub->getEntry (7)->getTitle (), "Preset 7");
+	EXPECT_EQ (sub->getEntry (7)->getTag (), 42 * kNumItems + 7);
+}
+
+} // VSTGUI
@@ -0,0 +1,70 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "../../../lib/crowheightindex.h"
+#include "../unittests.h"
+
+namespace VSTGUI {
+
+TEST_CASE (CRowHeightIndexTest, Empty)
+{
+	CRowHeightIndex index;
+	index.build (0, [] (size_t) { return 10.; });
+	EXPECT_EQ (index.size (), 0u);
+	EXPECT_EQ (index.getTotalHeight (), 0.);
+	EXPECT_EQ (index.getRowAt (5.), 0u);
+}
+
+TEST_CASE (CRowHeightIndexTest, OffsetsAndRows)
+{
+	constexpr size_t numRows = 1000;
+	CRowHeightIndex index;
+	index.build (numRows, [] (size_t row) { return static_cast<CCoord> (row % 7 + 1); });
+	CCoord offset = 0.;
+	for (size_t row = 0; row < numRows; ++row)
+	{
+		EXPECT_EQ (index.getOffset (row), offset);
+		EXPECT_EQ (index.getRowAt (offset), row);
+		EXPECT_EQ (index.getRowAt (offset + index.getHeight (row) - 0.5), row);
+		offset += index.getHeight (row);
+	}
+	EXPECT_EQ (index.getTotalHeight (), offset);
+	EXPECT_EQ (index.getRowAt (offset), numRows);
+	EXPECT_EQ (index.getRowAt (-1.), 0u);
+}
+
+TEST_CASE (CRowHeightIndexTest, SetHeight)
+{
+	CRowHeightIndex index;
+	index.build (100, [] (size_t) { return 10.; });
+	index.setHeight (50, 100.);
+	EXPECT_EQ (index.getTotalHeight (), 1090.);
+	EXPECT_EQ (index.getOffset (50), 500.);
+	EXPECT_EQ (index.getOffset (51), 600.);
+	EXPECT_EQ (index.getRowAt (599.), 50u);
+	EXPECT_EQ (index.getRowAt (600.), 51u);
+	index.setHeight (0, 0.);
+	EXPECT_EQ (index.getRowAt (0.), 1u);
+	EXPECT_EQ (index.getOffset (51), 590.);
+}
+
+TEST_CASE (CRowHeightIndexTest, Append)
+{
+	constexpr size_t numRows = 777;
+	auto height = [] (size_t row) { return static_cast<CCoord> (row % 5 + 1); };
+	CRowHeightIndex built;
+	built.build (numRows, height);
+	CRowHeightIndex appended;
+	for (size_t row = 0; row < numRows; ++row)
+		appended.append (height (row));
+	EXPECT_EQ (appended.size (), numRows);
+	EXPECT_EQ (appended.getTotalHeight (), built.getTotalHeight ());
+	for (size_t row = 0; row < numRows; ++row)
+	{
+		EXPECT_EQ (appended.getOffset (row), built.getOffset (row));
+		EXPECT_EQ (appended.getRowAt (built.getOffset (row)), row);
+	}
+}
+
+} // VSTGUI
@@ -0,0 +1,125 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "../../../lib/cshadowviewcontainer.h"
+#include "../../../lib/cbitmap.h"
+#include "../../../lib/coffscreencontext.h"
+#include "../unittests.h"
+#include <chrono>
+#include <thread>
+
+namespace VSTGUI {
+
+namespace {
+
+//------------------------------------------------------------------------
+SharedPointer<CShadowViewContainer> createContainer (const CRect& size)
+{
+	auto container = makeOwned<CShadowViewContainer> (size);
+	container->addView (new CView (CRect (10, 10, 30, 30)));
+	return container;
+}
+
+//------------------------------------------------------------------------
+void draw (CShadowViewContainer* container)
+{
+	auto context = COffscreenContext::create (CPoint (200, 200));
+	context->beginDraw ();
+	container->drawRect (context, container->getViewSize ());
+	context->endDraw ();
+}
+
+} // anonymous
+
+//------------------------------------------------------------------------
+TEST_CASE (CShadowViewContainerTest, ShareShadows)
+{
+	CShadowViewContainer::resetShadowStatistics ();
+	auto c1 = createContainer (CRect (0, 0, 50, 40));
+	auto c2 = createContainer (CRect (60, 0, 110, 40));
+	auto c3 = createContainer (CRect (0, 50, 50, 90));
+	c3->setShadowBlurSize (8.);
+	draw (c1);
+	draw (c2);
+	draw (c3);
+	const auto& stats = CShadowViewContainer::getShadowStatistics ();
+	EXPECT_EQ (stats.numRenderedShadows, 3u);
+	EXPECT_EQ (stats.numBlurredShadows, 2u);
+	EXPECT_EQ (stats.numSharedShadows, 1u);
+	EXPECT_TRUE (c1->getBackground ());
+	EXPECT_EQ (c1->getBackground (), c2->getBackground ());
+	EXPECT_NE (c1->getBackground (), c3->getBackground ());
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CShadowViewContainerTest, UnchangedSilhouette)
+{
+	CShadowViewContainer::resetShadowStatistics ();
+	auto container = createContainer (CRect (0, 0, 50, 41));
+	draw (container);
+	auto background = container->getBackground ();
+	container->invalidateShadow ();
+	draw (container);
+	const auto& stats = CShadowViewContainer::getShadowStatistics ();
+	EXPECT_EQ (stats.numRenderedShadows, 2u);
+	EXPECT_EQ (stats.numBlurredShadows, 1u);
+	EXPECT_FALSE (container->isShadowPending ());
+	EXPECT_EQ (container->getBackground (), background);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CShadowViewContainerTest, BlurInBackground)
+{
+	CShadowViewContainer::resetShadowStatistics ();
+	auto container = createContainer (CRect (0, 0, 50, 42));
+	draw (container);
+	auto background = container->getBackground ();
+	EXPECT_FALSE (container->isShadowPending ());
+
+	container->setViewSize (CRect (0, 0, 60, 42));
+	draw (container);
+	EXPECT_EQ (CShadowViewContainer::getShadowStatistics ().numAsyncBlurs, 1u);
+	if (container->isShadowPending ())
+		EXPECT_EQ (container->getBackground (), background);
+	for (auto i = 0; i < 1000 && container->isShadowPending (); ++i)
+	{
+		std::this_thread::sleep_for (std::chrono::milliseconds (1));
+		draw (container);
+	}
+	EXPECT_FALSE (container->isShadowPending ());
+	EXPECT_NE (container->getBackground (), background);
+	EXPECT_EQ (container->getBackground ()->getWidth (), 60.);
+	EXPECT_EQ (CShadowViewContainer::getShadowStatistics ().numBlurredShadows, 2u);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CShadowViewContainerTest, OneBlurPerContainer)
+{
+	CShadowViewContainer::resetShadowStatistics ();
+	auto container = createContainer (CRect (0, 0, 50, 43));
+	draw (container);
+	auto background = container->getBackground ();
+
+	// the silhouette changes three times while the first change is blurred
+	for (auto height : {1000., 1001., 1002., 1003.})
+	{
+		container->setViewSize (CRect (0, 0, 1000, height));
+		draw (container);
+	}
+	const auto& stats = CShadowViewContainer::getShadowStatistics ();
+	if (container->isShadowPending () && container->getBackground () == background)
+		EXPECT_EQ (stats.numAsyncBlurs, 1u);
+	for (auto i = 0; i < 5000 && container->isShadowPending (); ++i)
+	{
+		std::this_thread::sleep_for (std::chrono::milliseconds (1));
+		draw (container);
+	}
+	EXPECT_FALSE (container->isShadowPending ());
+	// only the latest silhouette was blurred after the first one
+	EXPECT_EQ (container->getBackground ()->getHeight (), 1003.);
+	EXPECT_EQ (stats.numRenderedShadows, 5u);
+	EXPECT (stats.numAsyncBlurs <= 2u);
+}
+
+} // VSTGUI
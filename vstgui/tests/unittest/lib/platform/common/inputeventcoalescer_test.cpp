@@ -0,0 +1,154 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "../../../../../lib/platform/common/inputeventcoalescer.h"
+#include "../../../unittests.h"
+#include <vector>
+
+namespace VSTGUI {
+
+namespace {
+
+//------------------------------------------------------------------------
+struct Recorder
+{
+	struct Entry
+	{
+		EventType type;
+		CPoint position;
+		MouseEventButtonState buttons;
+		CCoord deltaY {0.};
+		std::vector<CPoint> history;
+	};
+	std::vector<Entry> entries;
+
+	InputEventCoalescer::DispatchFunc func ()
+	{
+		return [this] (Event& event) {
+			Entry entry {event.type};
+			if (event.type == EventType::MouseMove)
+			{
+				auto& e = castMouseMoveEvent (event);
+				entry.position = e.mousePosition;
+				entry.buttons = e.buttonState;
+				entry.history.assign (e.coalescedPositions,
+				                      e.coalescedPositions + e.numCoalescedPositions);
+			}
+			else if (event.type == EventType::MouseWheel)
+			{
+				auto& e = castMouseWheelEvent (event);
+				entry.position = e.mousePosition;
+				entry.deltaY = e.deltaY;
+			}
+			entries.emplace_back (std::move (entry));
+		};
+	}
+};
+
+//------------------------------------------------------------------------
+MouseWheelEvent makeWheelEvent (CPoint pos, CCoord deltaY)
+{
+	MouseWheelEvent event;
+	event.mousePosition = pos;
+	event.deltaY = deltaY;
+	return event;
+}
+
+} // anonymous
+
+//------------------------------------------------------------------------
+TEST_CASE (InputEventCoalescerTest, MergeMoves)
+{
+	Recorder recorder;
+	InputEventCoalescer coalescer (recorder.func ());
+	for (auto i = 0; i < 10; ++i)
+		coalescer.onMouseMove (MouseMoveEvent ({static_cast<CCoord> (i), 0.}));
+	EXPECT_TRUE (recorder.entries.empty ());
+	EXPECT_TRUE (coalescer.hasPendingEvents ());
+	coalescer.flush ();
+	EXPECT_EQ (recorder.entries.size (), 1u);
+	EXPECT_EQ (recorder.entries[0].position, CPoint (9., 0.));
+	EXPECT_TRUE (recorder.entries[0].history.empty ());
+	EXPECT_EQ (coalescer.getNumReceivedEvents (), 10u);
+	EXPECT_EQ (coalescer.getNumDispatchedEvents (), 1u);
+	coalescer.flush ();
+	EXPECT_EQ (recorder.entries.size (), 1u);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (InputEventCoalescerTest, KeepButtonTransitions)
+{
+	Recorder recorder;
+	InputEventCoalescer coalescer (recorder.func ());
+	coalescer.onMouseMove (MouseMoveEvent ({1., 0.}));
+	coalescer.onMouseMove (MouseMoveEvent ({2., 0.}));
+	coalescer.onMouseMove (MouseMoveEvent ({3., 0.}, MouseButton::Left));
+	coalescer.onMouseMove (MouseMoveEvent ({4., 0.}, MouseButton::Left));
+	coalescer.onMouseMove (MouseMoveEvent ({5., 0.}));
+	coalescer.flush ();
+	EXPECT_EQ (recorder.entries.size (), 3u);
+	EXPECT_EQ (recorder.entries[0].position, CPoint (2., 0.));
+	EXPECT_TRUE (recorder.entries[0].buttons.empty ());
+	EXPECT_EQ (recorder.entries[1].position, CPoint (4., 0.));
+	EXPECT_TRUE (recorder.entries[1].buttons.isLeft ());
+	EXPECT_EQ (recorder.entries[2].position, CPoint (5., 0.));
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (InputEventCoalescerTest, AccumulateWheel)
+{
+	Recorder recorder;
+	InputEventCoalescer coalescer (recorder.func ());
+	coalescer.onMouseWheel (makeWheelEvent ({1., 1.}, 1.));
+	coalescer.onMouseWheel (makeWheelEvent ({1., 2.}, 1.));
+	coalescer.onMouseWheel (makeWheelEvent ({1., 3.}, -0.5));
+	coalescer.onMouseMove (MouseMoveEvent ({5., 5.}));
+	coalescer.onMouseWheel (makeWheelEvent ({5., 5.}, 1.));
+	coalescer.flush ();
+	EXPECT_EQ (recorder.entries.size (), 3u);
+	EXPECT_EQ (recorder.entries[0].type, EventType::MouseWheel);
+	EXPECT_EQ (recorder.entries[0].deltaY, 1.5);
+	EXPECT_EQ (recorder.entries[0].position, CPoint (1., 3.));
+	EXPECT_EQ (recorder.entries[1].type, EventType::MouseMove);
+	EXPECT_EQ (recorder.entries[2].type, EventType::MouseWheel);
+	EXPECT_EQ (recorder.entries[2].deltaY, 1.);
+	EXPECT_EQ (coalescer.getNumReceivedEvents (), 5u);
+	EXPECT_EQ (coalescer.getNumDispatchedEvents (), 3u);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (InputEventCoalescerTest, History)
+{
+	Recorder recorder;
+	InputEventCoalescer coalescer (recorder.func ());
+	coalescer.setKeepHistory (true);
+	for (auto i = 0; i < 4; ++i)
+		coalescer.onMouseMove (MouseMoveEvent ({static_cast<CCoord> (i), 0.}));
+	coalescer.flush ();
+	coalescer.onMouseMove (MouseMoveEvent ({10., 0.}));
+	coalescer.flush ();
+	EXPECT_EQ (recorder.entries.size (), 2u);
+	std::vector<CPoint> expected {{0., 0.}, {1., 0.}, {2., 0.}};
+	EXPECT_TRUE (recorder.entries[0].history == expected);
+	EXPECT_EQ (recorder.entries[0].position, CPoint (3., 0.));
+	EXPECT_TRUE (recorder.entries[1].history.empty ());
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (InputEventCoalescerTest, Disabled)
+{
+	Recorder recorder;
+	InputEventCoalescer coalescer (recorder.func ());
+	coalescer.onMouseMove (MouseMoveEvent ({1., 0.}));
+	coalescer.setEnabled (false);
+	EXPECT_EQ (recorder.entries.size (), 1u);
+	coalescer.onMouseMove (MouseMoveEvent ({2., 0.}));
+	coalescer.onMouseWheel (makeWheelEvent ({2., 0.}, 1.));
+	coalescer.onMouseWheel (makeWheelEvent ({2., 0.}, 1.));
+	EXPECT_EQ (recorder.entries.size (), 4u);
+	EXPECT_FALSE (coalescer.hasPendingEvents ());
+	EXPECT_EQ (coalescer.getNumReceivedEvents (), coalescer.getNumDispatchedEvents ());
+}
+
+} // VSTGUI
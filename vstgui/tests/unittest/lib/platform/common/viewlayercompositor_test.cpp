@@ -0,0 +1,267 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "../../../../../lib/platform/common/viewlayercompositor.h"
+#include "../../../../../lib/coffscreencontext.h"
+#include "../../../unittests.h"
+#include <vector>
+
+namespace VSTGUI {
+
+namespace {
+
+//------------------------------------------------------------------------
+struct CompositeEntry
+{
+	CPoint pos;
+	float alpha;
+	CRect clip;
+};
+using CompositeLog = std::vector<CompositeEntry>;
+
+//------------------------------------------------------------------------
+class TestSurface : public IViewLayerSurface
+{
+public:
+	TestSurface (const CPoint& size, CompositeLog& log)
+	: context (COffscreenContext::create (size)), log (log)
+	{
+	}
+
+	CDrawContext& getDrawContext () override { return *context; }
+	void drawInto (CDrawContext& c, const CPoint& pos, float alpha) override
+	{
+		CRect clip;
+		c.getClipRect (clip);
+		log.emplace_back (CompositeEntry {pos, alpha, clip});
+	}
+
+private:
+	SharedPointer<COffscreenContext> context;
+	CompositeLog& log;
+};
+
+//------------------------------------------------------------------------
+struct TestDelegate : IPlatformViewLayerDelegate
+{
+	std::vector<CRect> drawnRects;
+
+	void drawViewLayer (CDrawContext* context, const CRect& dirtyRect) override
+	{
+		drawnRects.emplace_back (dirtyRect);
+	}
+};
+
+//------------------------------------------------------------------------
+struct TestCompositor
+{
+	CompositeLog log;
+	std::vector<CRect> invalidRects;
+	std::vector<CPoint> surfaceSizes;
+	ViewLayerCompositor compositor {
+		[this] (const CPoint& size, double) {
+			surfaceSizes.emplace_back (size);
+			return std::unique_ptr<IViewLayerSurface> (new TestSurface (size, log));
+		},
+		[this] (const CRect& rect) { invalidRects.emplace_back (rect); }};
+
+	void composite (const CRect& rect)
+	{
+		auto context = COffscreenContext::create (CPoint (200, 200));
+		log.clear ();
+		compositor.composite (*context, rect);
+	}
+};
+
+} // anonymous
+
+//------------------------------------------------------------------------
+TEST_CASE (ViewLayerCompositorTest, RenderOnlyDirtyLayers)
+{
+	TestCompositor tc;
+	TestDelegate delegate1, delegate2;
+	auto layer1 = tc.compositor.createLayer (&delegate1);
+	auto layer2 = tc.compositor.createLayer (&delegate2);
+	EXPECT_TRUE (tc.compositor.hasLayers ());
+	layer1->setSize (CRect (0, 0, 50, 50));
+	layer2->setSize (CRect (100, 0, 150, 50));
+	tc.compositor.render ();
+	EXPECT_EQ (delegate1.drawnRects.size (), 1u);
+	EXPECT_EQ (delegate1.drawnRects[0], CRect (0, 0, 50, 50));
+	EXPECT_EQ (delegate2.drawnRects.size (), 1u);
+	EXPECT_EQ (tc.compositor.getStatistics ().numRenderedRects, 2u);
+
+	tc.compositor.resetStatistics ();
+	tc.invalidRects.clear ();
+	layer2->invalidRect (CRect (10, 10, 20, 20));
+	// outside of the layer
+	layer1->invalidRect (CRect (60, 60, 80, 80));
+	tc.compositor.render ();
+	EXPECT_EQ (delegate1.drawnRects.size (), 1u);
+	EXPECT_EQ (delegate2.drawnRects.size (), 2u);
+	EXPECT_EQ (delegate2.drawnRects[1], CRect (10, 10, 20, 20));
+	EXPECT_EQ (tc.compositor.getStatistics ().numRenderedRects, 1u);
+	EXPECT_EQ (tc.invalidRects.size (), 1u);
+	EXPECT_EQ (tc.invalidRects[0], CRect (110, 10, 120, 20));
+
+	tc.compositor.render ();
+	EXPECT_EQ (tc.compositor.getStatistics ().numRenderedRects, 1u);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (ViewLayerCompositorTest, MoveOnlyComposites)
+{
+	TestCompositor tc;
+	TestDelegate delegate;
+	auto layer = tc.compositor.createLayer (&delegate);
+	layer->setSize (CRect (0, 0, 50, 50));
+	tc.compositor.render ();
+	tc.invalidRects.clear ();
+
+	layer->setSize (CRect (20, 0, 70, 50));
+	tc.compositor.render ();
+	EXPECT_EQ (delegate.drawnRects.size (), 1u);
+	EXPECT_EQ (tc.invalidRects.size (), 2u);
+	EXPECT_EQ (tc.invalidRects[0], CRect (0, 0, 50, 50));
+	EXPECT_EQ (tc.invalidRects[1], CRect (20, 0, 70, 50));
+	tc.composite (CRect (0, 0, 200, 200));
+	EXPECT_EQ (tc.log.size (), 1u);
+	EXPECT_EQ (tc.log[0].pos, CPoint (20, 0));
+
+	layer->setSize (CRect (20, 0, 90, 50));
+	tc.compositor.render ();
+	EXPECT_EQ (delegate.drawnRects.size (), 2u);
+	EXPECT_EQ (delegate.drawnRects[1], CRect (0, 0, 70, 50));
+	EXPECT_EQ (tc.surfaceSizes.size (), 2u);
+	EXPECT_EQ (tc.surfaceSizes[1], CPoint (70, 50));
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (ViewLayerCompositorTest, CompositeOrder)
+{
+	TestCompositor tc;
+	TestDelegate delegate;
+	auto layer1 = tc.compositor.createLayer (&delegate);
+	auto layer2 = tc.compositor.createLayer (&delegate);
+	auto layer3 = tc.compositor.createLayer (&delegate);
+	layer1->setSize (CRect (1, 0, 51, 50));
+	layer2->setSize (CRect (2, 0, 52, 50));
+	layer3->setSize (CRect (3, 0, 53, 50));
+	tc.compositor.render ();
+
+	tc.composite (CRect (0, 0, 200, 200));
+	EXPECT_EQ (tc.log.size (), 3u);
+	EXPECT_EQ (tc.log[0].pos.x, 1.);
+	EXPECT_EQ (tc.log[1].pos.x, 2.);
+	EXPECT_EQ (tc.log[2].pos.x, 3.);
+	EXPECT_EQ (tc.compositor.getStatistics ().numCompositedLayers, 3u);
+
+	layer1->setZIndex (1);
+	tc.composite (CRect (0, 0, 200, 200));
+	EXPECT_EQ (tc.log[0].pos.x, 2.);
+	EXPECT_EQ (tc.log[1].pos.x, 3.);
+	EXPECT_EQ (tc.log[2].pos.x, 1.);
+
+	// only the layers in the rect are composited
+	layer3->setSize (CRect (100, 100, 150, 150));
+	tc.composite (CRect (0, 0, 60, 60));
+	EXPECT_EQ (tc.log.size (), 2u);
+	EXPECT_EQ (tc.log[0].clip, CRect (2, 0, 52, 50));
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (ViewLayerCompositorTest, ChildLayers)
+{
+	TestCompositor tc;
+	TestDelegate parentDelegate, childDelegate;
+	auto parent = tc.compositor.createLayer (&parentDelegate);
+	auto child = tc.compositor.createLayer (&childDelegate, parent);
+	EXPECT_TRUE (child);
+	parent->setSize (CRect (10, 10, 60, 60));
+	parent->setAlpha (0.5f);
+	child->setSize (CRect (40, 40, 100, 100));
+	child->setAlpha (0.5f);
+	tc.compositor.render ();
+	EXPECT_EQ (childDelegate.drawnRects.size (), 1u);
+
+	tc.invalidRects.clear ();
+	child->invalidRect (CRect (0, 0, 20, 20));
+	EXPECT_EQ (tc.invalidRects.size (), 1u);
+	EXPECT_EQ (tc.invalidRects[0], CRect (50, 50, 60, 60));
+
+	tc.composite (CRect (0, 0, 200, 200));
+	EXPECT_EQ (tc.log.size (), 2u);
+	EXPECT_EQ (tc.log[0].pos, CPoint (10, 10));
+	EXPECT_EQ (tc.log[0].alpha, 0.5f);
+	EXPECT_EQ (tc.log[1].pos, CPoint (50, 50));
+	EXPECT_EQ (tc.log[1].alpha, 0.25f);
+	EXPECT_EQ (tc.log[1].clip, CRect (50, 50, 60, 60));
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (ViewLayerCompositorTest, HiddenLayer)
+{
+	TestCompositor tc;
+	TestDelegate delegate;
+	auto layer = tc.compositor.createLayer (&delegate);
+	layer->setSize (CRect (0, 0, 50, 50));
+	layer->setAlpha (0.f);
+	tc.compositor.render ();
+	EXPECT_TRUE (delegate.drawnRects.empty ());
+	tc.composite (CRect (0, 0, 200, 200));
+	EXPECT_TRUE (tc.log.empty ());
+
+	layer->setAlpha (1.f);
+	tc.compositor.render ();
+	EXPECT_EQ (delegate.drawnRects.size (), 1u);
+	tc.composite (CRect (0, 0, 200, 200));
+	EXPECT_EQ (tc.log.size (), 1u);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (ViewLayerCompositorTest, ScaleFactor)
+{
+	TestCompositor tc;
+	TestDelegate delegate;
+	tc.compositor.setScaleFactor (2.);
+	auto layer = tc.compositor.createLayer (&delegate);
+	layer->setSize (CRect (0, 0, 50, 25));
+	tc.compositor.render ();
+	EXPECT_EQ (tc.surfaceSizes.size (), 1u);
+	EXPECT_EQ (tc.surfaceSizes[0], CPoint (100, 50));
+
+	layer->onScaleFactorChanged (1.5);
+	tc.compositor.render ();
+	EXPECT_EQ (tc.surfaceSizes.size (), 2u);
+	EXPECT_EQ (tc.surfaceSizes[1], CPoint (75, 38));
+	EXPECT_EQ (delegate.drawnRects.size (), 2u);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (ViewLayerCompositorTest, DestroyLayer)
+{
+	TestCompositor tc;
+	TestDelegate delegate;
+	auto layer = tc.compositor.createLayer (&delegate);
+	layer->setSize (CRect (10, 10, 50, 50));
+	tc.invalidRects.clear ();
+	layer = nullptr;
+	EXPECT_FALSE (tc.compositor.hasLayers ());
+	EXPECT_EQ (tc.invalidRects.size (), 1u);
+	EXPECT_EQ (tc.invalidRects[0], CRect (10, 10, 50, 50));
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (ViewLayerCompositorTest, InvalidParameters)
+{
+	TestCompositor tc1;
+	TestCompositor tc2;
+	TestDelegate delegate;
+	EXPECT_FALSE (tc1.compositor.createLayer (nullptr));
+	auto layer = tc1.compositor.createLayer (&delegate);
+	EXPECT_FALSE (tc2.compositor.createLayer (&delegate, layer));
+	EXPECT_FALSE (tc2.compositor.hasLayers ());
+}
+
+} // VSTGUI
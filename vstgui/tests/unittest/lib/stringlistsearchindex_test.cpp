@@ -0,0 +1,134 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "../../../lib/genericstringlistdatabrowsersource.h"
+#include "../../../lib/stringlistsearchindex.h"
+#include "../unittests.h"
+
+namespace VSTGUI {
+
+namespace {
+
+//------------------------------------------------------------------------
+const StringListSearchIndex::StringVector& testStrings ()
+{
+	static const StringListSearchIndex::StringVector strings = {
+	    "Zebra", "apple", "Banana", "application", "pineapple", "APPLY", "", "grape",
+	};
+	return strings;
+}
+
+//------------------------------------------------------------------------
+struct TestSource : GenericStringListDataBrowserSource
+{
+	using GenericStringListDataBrowserSource::GenericStringListDataBrowserSource;
+	using GenericStringListDataBrowserSource::dbGetNumRows;
+};
+
+} // anonymous
+
+//------------------------------------------------------------------------
+TEST_CASE (StringListSearchIndexTest, Prefix)
+{
+	StringListSearchIndex index (&testStrings ());
+	EXPECT_EQ (index.findFirstWithPrefix ("APP"), 1);
+	EXPECT_EQ (index.findFirstWithPrefix ("appli"), 3);
+	EXPECT_EQ (index.findFirstWithPrefix ("z"), 0);
+	EXPECT_EQ (index.findFirstWithPrefix ("apples"), -1);
+	EXPECT_EQ (index.findFirstWithPrefix ("x"), -1);
+
+	StringListSearchIndex::IndexList result;
+	index.findAllWithPrefix ("ApP", result);
+	EXPECT_TRUE ((result == StringListSearchIndex::IndexList {1, 3, 5}));
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (StringListSearchIndexTest, Substring)
+{
+	StringListSearchIndex index (&testStrings ());
+	StringListSearchIndex::IndexList result;
+	index.findAllContaining ("APPL", result);
+	EXPECT_TRUE ((result == StringListSearchIndex::IndexList {1, 3, 4, 5}));
+	index.findAllContaining ("an", result);
+	EXPECT_TRUE ((result == StringListSearchIndex::IndexList {2}));
+	index.findAllContaining ("e", result);
+	EXPECT_TRUE ((result == StringListSearchIndex::IndexList {0, 1, 4, 7}));
+	index.findAllContaining ("ez", result);
+	EXPECT_TRUE (result.empty ());
+	index.findAllContaining ("", result);
+	EXPECT_EQ (result.size (), testStrings ().size ());
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (StringListSearchIndexTest, MatchesLinearSearch)
+{
+	StringListSearchIndex::StringVector strings;
+	for (auto i = 0; i < 10000; ++i)
+		strings.emplace_back (UTF8String ("File_" + std::to_string ((i * 7919) % 10007) + ".wav"));
+	StringListSearchIndex index (&strings);
+
+	StringListSearchIndex::IndexList result;
+	for (auto query : {"1", "23", "_99", "7.W", "file_1", "WAV", "x"})
+	{
+		StringListSearchIndex::IndexList expected;
+		auto folded = StringListSearchIndex::fold (query);
+		for (uint32_t i = 0; i < strings.size (); ++i)
+		{
+			if (StringListSearchIndex::fold (strings[i].getString ()).find (folded) !=
+			    std::string::npos)
+				expected.emplace_back (i);
+		}
+		index.findAllContaining (query, result);
+		EXPECT_TRUE (result == expected);
+	}
+	for (auto query : {"f", "FILE_1", "file_99", "file_1000", "file_7.", "x"})
+	{
+		int32_t expected = -1;
+		auto folded = StringListSearchIndex::fold (query);
+		for (uint32_t i = 0; i < strings.size () && expected == -1; ++i)
+		{
+			if (StringListSearchIndex::fold (strings[i].getString ()).compare (0, folded.size (),
+			                                                                   folded) == 0)
+				expected = static_cast<int32_t> (i);
+		}
+		EXPECT_EQ (index.findFirstWithPrefix (query), expected);
+	}
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (StringListSearchIndexTest, Invalidate)
+{
+	StringListSearchIndex::StringVector strings = {"one", "two"};
+	StringListSearchIndex index (&strings);
+	EXPECT_EQ (index.findFirstWithPrefix ("three"), -1);
+	strings.emplace_back ("three");
+	EXPECT_EQ (index.findFirstWithPrefix ("three"), 2);
+	strings[0] = "four";
+	index.invalidate ();
+	EXPECT_EQ (index.findFirstWithPrefix ("fo"), 0);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (StringListSearchIndexTest, SourceFilter)
+{
+	auto source = makeOwned<TestSource> (&testStrings ());
+	EXPECT_EQ (source->dbGetNumRows (nullptr), 8);
+	source->setFilter ("apple");
+	EXPECT_EQ (source->dbGetNumRows (nullptr), 2);
+	EXPECT_EQ (source->getStringIndex (0), 1);
+	EXPECT_EQ (source->getStringIndex (1), 4);
+	EXPECT_EQ (source->getStringIndex (2), -1);
+	EXPECT_EQ (source->getRow (4), 1);
+	EXPECT_EQ (source->getRow (0), -1);
+
+	source->setFilter ("app", GenericStringListDataBrowserSource::FilterMode::Prefix);
+	EXPECT_EQ (source->dbGetNumRows (nullptr), 3);
+	EXPECT_EQ (source->getStringIndex (2), 5);
+
+	source->setFilter ("");
+	EXPECT_EQ (source->dbGetNumRows (nullptr), 8);
+	EXPECT_EQ (source->getRow (7), 7);
+}
+
+} // VSTGUI
@@ -0,0 +1,96 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "../../../lib/vstguitrace.h"
+#include "../../../lib/cview.h"
+#include "../../../lib/cviewcontainer.h"
+#include "../unittests.h"
+#include <typeinfo>
+
+namespace VSTGUI {
+
+TEST_CASE (TraceTest, ScopeRecordsOnlyWhenEnabled)
+{
+	Trace::clear ();
+	{
+		Trace::Scope scope ("disabled");
+	}
+	EXPECT_TRUE (Trace::collectEvents ().empty ());
+	Trace::setEnabled (true);
+	{
+		Trace::Scope scope ("enabled", &scope);
+	}
+	Trace::setEnabled (false);
+	auto events = Trace::collectEvents ();
+	EXPECT_EQ (events.size (), 1u);
+	EXPECT_EQ (std::string (events[0].name), "enabled");
+	EXPECT_TRUE (events[0].begin > 0);
+	Trace::clear ();
+	EXPECT_TRUE (Trace::collectEvents ().empty ());
+}
+
+TEST_CASE (TraceTest, RingBufferKeepsNewestEvents)
+{
+	Trace::clear ();
+	auto numEvents = static_cast<uint64_t> (Trace::kThreadBufferSize) + 10;
+	for (uint64_t i = 1; i <= numEvents; ++i)
+		Trace::record ("event", nullptr, nullptr, i * 10, i * 10 + 5);
+	auto events = Trace::collectEvents ();
+	EXPECT_EQ (events.size (), Trace::kThreadBufferSize);
+	EXPECT_EQ (events.front ().begin, 110u);
+	EXPECT_EQ (events.back ().begin, numEvents * 10);
+	Trace::clear ();
+}
+
+TEST_CASE (TraceTest, ViewDrawTimes)
+{
+	Trace::clear ();
+	auto container = makeOwned<CViewContainer> (CRect (0, 0, 100, 100));
+	auto view = makeOwned<CView> (CRect (0, 0, 10, 10));
+	auto containerClass = typeid (*container).name ();
+	auto viewClass = typeid (*view).name ();
+	// children are recorded before their parent
+	Trace::record (Trace::kViewDrawEventName, viewClass, view, 110, 130);
+	Trace::record (Trace::kViewDrawEventName, viewClass, view, 140, 150);
+	Trace::record (Trace::kViewDrawEventName, containerClass, container, 100, 200);
+	Trace::record (Trace::kViewDrawEventName, viewClass, view, 300, 310);
+
+	auto drawTimes = Trace::collectViewDrawTimes ();
+	EXPECT_EQ (drawTimes.size (), 2u);
+	EXPECT_EQ (drawTimes[0].view, container.get ());
+	EXPECT_EQ (drawTimes[0].className, "VSTGUI::CViewContainer");
+	EXPECT_EQ (drawTimes[0].numDraws, 1u);
+	EXPECT_EQ (drawTimes[0].totalTime, 100u);
+	EXPECT_EQ (drawTimes[0].selfTime, 70u);
+	EXPECT_EQ (drawTimes[1].view, view.get ());
+	EXPECT_EQ (drawTimes[1].className, "VSTGUI::CView");
+	EXPECT_EQ (drawTimes[1].numDraws, 3u);
+	EXPECT_EQ (drawTimes[1].totalTime, 40u);
+	EXPECT_EQ (drawTimes[1].selfTime, 40u);
+	Trace::clear ();
+}
+
+TEST_CASE (TraceTest, ChromeTraceJSON)
+{
+	Trace::EventList events;
+	Trace::Event event;
+	event.name = "CFrame::drawRect";
+	event.begin = 2000;
+	event.duration = 1500;
+	event.threadID = 1;
+	events.emplace_back (event);
+	event.name = "quote\"name";
+	event.detail = typeid (CView).name ();
+	event.object = &event;
+	events.emplace_back (event);
+
+	auto json = Trace::toChromeTraceJSON (events);
+	EXPECT_TRUE (json.find ("\"traceEvents\":[") != std::string::npos);
+	EXPECT_TRUE (json.find ("{\"name\":\"CFrame::drawRect\",\"cat\":\"vstgui\",\"ph\":\"X\",\"pid\":1,"
+							"\"tid\":1,\"ts\":2.000,\"dur\":1.500}") != std::string::npos);
+	EXPECT_TRUE (json.find ("\"name\":\"quote\\\"name\"") != std::string::npos);
+	EXPECT_TRUE (json.find ("\"class\":\"VSTGUI::CView\"") != std::string::npos);
+}
+
+} // VSTGUI
@@ -5,6 +5,7 @@
 #include "../../../uidescription/base64codec.h"
 #include "../unittests.h"
 #include <string>
+#include <vector>
 
 namespace VSTGUI {
 
@@ -72,4 +73,141 @@ TEST_CASE (Base64CodecTest, DecodeBinary)
 	EXPECT (ptr[5] == 0x0A);
 }
 
+TEST_CASE (Base64CodecTest, DecodeSkipsWhitespaceAndStopsAtPadding)
+{
+	std::string test ("iVBO\nRw0K\r\nQUJDRA==QUJD");
+	auto result = Base64Codec::decode (test);
+	EXPECT (result.dataSize == 10);
+	uint8_t* ptr = result.data.get ();
+	EXPECT (ptr[5] == 0x0A);
+	EXPECT (ptr[6] == 'A');
+	EXPECT (ptr[9] == 'D');
+}
+
+TEST_CASE (Base64CodecTest, EncodeShortInput)
+{
+	auto result = Base64Codec::encode ("A", 1);
+	EXPECT (result.dataSize == 4);
+	EXPECT (std::string (reinterpret_cast<const char*> (result.data.get ()), 4) == "QQ==");
+	result = Base64Codec::encode ("", 0);
+	EXPECT (result.dataSize == 0);
+}
+
+TEST_CASE (Base64CodecTest, AllKernelsRoundtrip)
+{
+	using Kernel = Base64Codec::Kernel;
+	for (auto kernel : {Kernel::Scalar, Kernel::SSSE3, Kernel::AVX2, Kernel::NEON})
+	{
+		if (!Base64Codec::isKernelSupported (kernel))
+			continue;
+		for (size_t size = 0; size < 300; ++size)
+		{
+			std::vector<uint8_t> binary (size);
+			for (size_t i = 0; i < size; ++i)
+				binary[i] = static_cast<uint8_t> (i * 7 + size);
+			std::vector<uint8_t> reference (Base64Codec::getEncodedSize (size));
+			std::vector<uint8_t> encoded (reference.size ());
+			Base64Codec::encode (binary.data (), size, reference.data (), reference.size (),
+			                     Kernel::Scalar);
+			auto encodedSize =
+			    Base64Codec::encode (binary.data (), size, encoded.data (), encoded.size (), kernel);
+			EXPECT (encodedSize == encoded.size ());
+			EXPECT (encoded == reference);
+
+			std::vector<uint8_t> decoded (Base64Codec::getMaxDecodedSize (encodedSize));
+			auto decodedSize = Base64Codec::decode (encoded.data (), encodedSize, decoded.data (),
+			                                        decoded.size (), kernel);
+			EXPECT (decodedSize == size);
+			decoded.resize (decodedSize);
+			EXPECT (decoded == binary);
+		}
+	}
+}
+
+TEST_CASE (Base64CodecTest, StreamingDecoder)
+{
+	std::vector<uint8_t> binary (1000);
+	for (size_t i = 0; i < binary.size (); ++i)
+		binary[i] = static_cast<uint8_t> (i * 13);
+	auto encoded = Base64Codec::encode (binary.data (), binary.size ());
+
+	for (size_t chunkSize = 1; chunkSize < 70; chunkSize += 3)
+	{
+		Base64Codec::Decoder decoder;
+		std::vector<uint8_t> decoded;
+		for (size_t pos = 0; pos < encoded.dataSize; pos += chunkSize)
+		{
+			auto size = std::min<size_t> (chunkSize, encoded.dataSize - pos);
+			std::vector<uint8_t> buffer (decoder.getMaxOutputSize (size));
+			auto written =
+			    decoder.process (encoded.data.get () + pos, size, buffer.data (), buffer.size ());
+			decoded.insert (decoded.end (), buffer.begin (), buffer.begin () + written);
+		}
+		uint8_t buffer[2];
+		auto written = decoder.finish (buffer, 2);
+		decoded.insert (decoded.end (), buffer, buffer + written);
+		EXPECT (decoded == binary);
+	}
+}
+
+TEST_CASE (Base64CodecTest, StreamingEncoder)
+{
+	std::vector<uint8_t> binary (1000);
+	for (size_t i = 0; i < binary.size (); ++i)
+		binary[i] = static_cast<uint8_t> (i * 13);
+	auto reference = Base64Codec::encode (binary.data (), binary.size ());
+
+	for (size_t chunkSize = 1; chunkSize < 70; chunkSize += 4)
+	{
+		Base64Codec::Encoder encoder;
+		std::vector<uint8_t> encoded;
+		for (size_t pos = 0; pos < binary.size (); pos += chunkSize)
+		{
+			auto size = std::min<size_t> (chunkSize, binary.size () - pos);
+			std::vector<uint8_t> buffer (encoder.getMaxOutputSize (size));
+			auto written = encoder.process (binary.data () + pos, size, buffer.data (), buffer.size ());
+			encoded.insert (encoded.end (), buffer.begin (), buffer.begin () + written);
+		}
+		uint8_t buffer[4];
+		auto written = encoder.finish (buffer, 4);
+		encoded.insert (encoded.end (), buffer, buffer + written);
+		EXPECT (encoded.size () == reference.dataSize);
+		EXPECT (memcmp (encoded.data (), reference.data.get (), encoded.size ()) == 0);
+	}
+}
+
+TEST_CASE (Base64CodecTest, OutputStream)
+{
+	std::vector<uint8_t> binary (20000);
+	for (size_t i = 0; i < binary.size (); ++i)
+		binary[i] = static_cast<uint8_t> (i * 3);
+	CMemoryStream encodeStream (1024, 1024, false);
+	EXPECT (Base64Codec::encode (binary.data (), binary.size (), encodeStream));
+	auto encodedSize = static_cast<size_t> (encodeStream.tell ());
+	EXPECT (encodedSize == Base64Codec::getEncodedSize (binary.size ()));
+
+	CMemoryStream decodeStream;
+	EXPECT (Base64Codec::decode (encodeStream.getBuffer (), encodedSize, decodeStream));
+	EXPECT (static_cast<size_t> (decodeStream.tell ()) == binary.size ());
+	EXPECT (memcmp (decodeStream.getBuffer (), binary.data (), binary.size ()) == 0);
+}
+
+TEST_CASE (Base64CodecTest, DecodeReader)
+{
+	std::vector<uint8_t> binary (20000);
+	for (size_t i = 0; i < binary.size (); ++i)
+		binary[i] = static_cast<uint8_t> (i * 7);
+	auto encoded = Base64Codec::encode (binary.data (), binary.size ());
+
+	for (size_t readSize : {1u, 7u, 8u, 9u, 33u, 4096u, 10000u, 30000u})
+	{
+		Base64Codec::DecodeReader reader (encoded.data.get (), encoded.dataSize);
+		std::vector<uint8_t> decoded;
+		std::vector<uint8_t> buffer (readSize);
+		while (auto numBytes = reader.read (buffer.data (), buffer.size ()))
+			decoded.insert (decoded.end (), buffer.begin (), buffer.begin () + numBytes);
+		EXPECT (decoded == binary);
+	}
+}
+
 }
@@ -0,0 +1,213 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "../../../lib/cbitmap.h"
+#include "../../../lib/ccolor.h"
+#include "../../../lib/cviewcontainer.h"
+#include "../../../lib/finally.h"
+#include "../../../lib/platform/platformfactory.h"
+#include "../../../uidescription/base64codec.h"
+#include "../../../uidescription/compresseduidescription.h"
+#include "../../../uidescription/cstream.h"
+#include "../unittests.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#if VSTGUI_ENABLE_XML_PARSER
+
+namespace VSTGUI {
+
+namespace {
+
+constexpr auto plainPath = "compresseduidescription_test.uidesc";
+constexpr auto chunkedPath = "compresseduidescription_test_chunked.uidesc";
+
+constexpr auto kChunkTypeTemplate = 1u;
+constexpr auto kChunkHeaderSize = 16u;
+
+//------------------------------------------------------------------------
+std::string createDescription ()
+{
+	auto bitmap = makeOwned<CBitmap> (CPoint (8, 8));
+	auto png =
+	    getPlatformFactory ().createBitmapMemoryPNGRepresentation (bitmap->getPlatformBitmap ());
+	auto base64 = Base64Codec::encode (png.data (), png.size ());
+	std::string str (R"(<vstgui-ui-description version="1">)"
+	                 R"(<colors><color name="c1" rgba="#ff0000ff"/></colors>)"
+	                 R"(<bitmaps><bitmap name="b1" path="b1.png"><data encoding="base64">)");
+	str.append (reinterpret_cast<const char*> (base64.data.get ()), base64.dataSize);
+	str += R"(</data></bitmap></bitmaps>)"
+	       R"(<template name="t1" class="CViewContainer" size="100, 100" bitmap="b1">)"
+	       R"(<view class="CView" size="10, 10"/><view class="CView" size="10, 10"/>)"
+	       R"(</template>)"
+	       R"(<template name="t2" class="CViewContainer" size="20, 20"/>)"
+	       R"(</vstgui-ui-description>)";
+	return str;
+}
+
+//------------------------------------------------------------------------
+bool writeFile (const char* path, const void* data, size_t size)
+{
+	CFileStream stream;
+	if (!stream.open (path, CFileStream::kWriteMode | CFileStream::kTruncateMode |
+	                            CFileStream::kBinaryMode))
+		return false;
+	return stream.writeRaw (data, static_cast<uint32_t> (size)) == size;
+}
+
+//------------------------------------------------------------------------
+std::vector<uint8_t> readFile (const char* path)
+{
+	CFileStream stream;
+	if (!stream.open (path, CFileStream::kReadMode | CFileStream::kBinaryMode))
+		return {};
+	std::vector<uint8_t> data (
+	    static_cast<size_t> (stream.seek (0, SeekableStream::SeekMode::kSeekEnd)));
+	stream.seek (0, SeekableStream::SeekMode::kSeekSet);
+	if (stream.readRaw (data.data (), static_cast<uint32_t> (data.size ())) != data.size ())
+		return {};
+	return data;
+}
+
+//------------------------------------------------------------------------
+bool writeChunkedContainer ()
+{
+	auto plain = createDescription ();
+	if (!writeFile (plainPath, plain.data (), plain.size ()))
+		return false;
+	auto desc = makeOwned<CompressedUIDescription> (CResourceDescription (plainPath));
+	if (!desc->parse ())
+		return false;
+	return desc->save (chunkedPath, UIDescription::kWriteImagesIntoUIDescFile |
+	                                    CompressedUIDescription::kNoPlainUIDescFileBackup |
+	                                    CompressedUIDescription::kWriteChunkedContainer);
+}
+
+//------------------------------------------------------------------------
+template<typename T>
+T readValue (const std::vector<uint8_t>& data, size_t pos)
+{
+	T value {};
+	for (auto i = 0u; i < sizeof (T); ++i)
+		value |= static_cast<T> (data[pos + i]) << (i * 8);
+	return value;
+}
+
+//------------------------------------------------------------------------
+/** invert the stored data of the first template chunk */
+bool corruptTemplateChunk (std::vector<uint8_t>& data)
+{
+	auto numChunks = readValue<uint32_t> (data, 12);
+	size_t pos = kChunkHeaderSize;
+	struct Entry
+	{
+		uint32_t type;
+		uint64_t offset;
+		uint32_t storedSize;
+	};
+	std::vector<Entry> entries;
+	for (auto i = 0u; i < numChunks; ++i)
+	{
+		Entry entry;
+		entry.type = readValue<uint32_t> (data, pos);
+		entry.offset = readValue<uint64_t> (data, pos + 8);
+		entry.storedSize = readValue<uint32_t> (data, pos + 16);
+		pos += 28 + readValue<uint32_t> (data, pos + 24);
+		entries.emplace_back (entry);
+	}
+	for (const auto& entry : entries)
+	{
+		if (entry.type != kChunkTypeTemplate)
+			continue;
+		auto start = data.begin () + static_cast<std::ptrdiff_t> (pos + entry.offset);
+		std::for_each (start, start + entry.storedSize, [] (auto& byte) { byte = ~byte; });
+		return true;
+	}
+	return false;
+}
+
+} // anonymous
+
+//------------------------------------------------------------------------
+TEST_CASE (CompressedUIDescriptionTests, ChunkedContainerRoundTrip)
+{
+	auto removeFiles = finally ([] () {
+		std::remove (plainPath);
+		std::remove (chunkedPath);
+	});
+	EXPECT (writeChunkedContainer ());
+
+	auto desc = makeOwned<CompressedUIDescription> (CResourceDescription (chunkedPath));
+	EXPECT (desc->parse ());
+	EXPECT (desc->getOriginalIsCompressed ());
+	EXPECT (desc->getOriginalIsChunked ());
+
+	CColor color;
+	EXPECT (desc->getColor ("c1", color));
+	EXPECT (color == kRedCColor);
+
+	auto view = owned (desc->createView ("t1", nullptr));
+	auto container = view ? view->asViewContainer () : nullptr;
+	EXPECT (container);
+	EXPECT (container->getNbViews () == 2);
+	auto bitmap = view->getBackground ();
+	EXPECT (bitmap && bitmap->getPlatformBitmap ());
+	EXPECT (bitmap->getWidth () == 8.);
+	EXPECT (owned (desc->createView ("t2", nullptr)));
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CompressedUIDescriptionTests, TruncatedChunkedContainer)
+{
+	auto removeFiles = finally ([] () {
+		std::remove (plainPath);
+		std::remove (chunkedPath);
+	});
+	EXPECT (writeChunkedContainer ());
+	auto data = readFile (chunkedPath);
+	EXPECT (data.size () > kChunkHeaderSize + 64);
+
+	// in the index, and in the chunk data
+	for (auto size : {kChunkHeaderSize + 10, static_cast<uint32_t> (data.size () - 10)})
+	{
+		EXPECT (writeFile (chunkedPath, data.data (), size));
+		auto desc = makeOwned<CompressedUIDescription> (CResourceDescription (chunkedPath));
+		EXPECT_FALSE (desc->parse ());
+		EXPECT_FALSE (desc->createView ("t1", nullptr));
+	}
+
+	// a chunk count beyond the limit
+	auto invalidCount = data;
+	std::memset (invalidCount.data () + 12, 0xff, 4);
+	EXPECT (writeFile (chunkedPath, invalidCount.data (), invalidCount.size ()));
+	auto desc = makeOwned<CompressedUIDescription> (CResourceDescription (chunkedPath));
+	EXPECT_FALSE (desc->parse ());
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CompressedUIDescriptionTests, CorruptTemplateChunk)
+{
+	auto removeFiles = finally ([] () {
+		std::remove (plainPath);
+		std::remove (chunkedPath);
+	});
+	EXPECT (writeChunkedContainer ());
+	auto data = readFile (chunkedPath);
+	EXPECT (corruptTemplateChunk (data));
+	EXPECT (writeFile (chunkedPath, data.data (), data.size ()));
+
+	// the resources are valid, but the description must not load without its templates
+	auto desc = makeOwned<CompressedUIDescription> (CResourceDescription (chunkedPath));
+	EXPECT_FALSE (desc->parse ());
+	CColor color;
+	EXPECT_FALSE (desc->getColor ("c1", color));
+	EXPECT_FALSE (desc->createView ("t1", nullptr));
+	EXPECT_FALSE (desc->createView ("t2", nullptr));
+}
+
+} // VSTGUI
+
+#endif
@@ -10,6 +10,10 @@
 #include "../../../uidescription/uiattributes.h"
 #include "../../../uidescription/uicontentprovider.h"
 #include "uidescription_test_helper.h"
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace VSTGUI {
 using namespace UIDescriptionTesting;
@@ -122,6 +126,26 @@ constexpr auto calculateTagNodesUIDesc = R"(
 }
 )";
 
+constexpr auto expressionNodesUIDesc = R"(
+{
+	"vstgui-ui-description": {
+		"version": "1",
+		"variables": {
+			"base": "10",
+			"double": "var.base * 2",
+			"other": "5"
+		},
+		"control-tags": {
+			"t1": "var.double + 1",
+			"t2": "tag.t1 + var.other",
+			"t3": "var.other",
+			"cycle1": "tag.cycle2 + 1",
+			"cycle2": "tag.cycle1 + 1"
+		}
+	}
+}
+)";
+
 constexpr auto gradientNodesUIDesc = R"(
 {
 	"vstgui-ui-description": {
@@ -1420,6 +1444,163 @@ TEST_CASE (UIDescriptionJSONTests, Calculations)
 	EXPECT (desc.calculateStringValue ("unknown", value) == false);
 }
 
+TEST_CASE (UIDescriptionJSONTests, ExpressionDependencies)
+{
+	MemoryContentProvider provider (expressionNodesUIDesc,
+	                                static_cast<uint32_t> (strlen (expressionNodesUIDesc)));
+	UIDescription desc (&provider);
+	EXPECT (desc.parse () == true);
+	EXPECT (desc.getTagForName ("t1") == 21);
+	EXPECT (desc.getTagForName ("t2") == 26);
+	EXPECT (desc.getTagForName ("t3") == 5);
+	EXPECT (desc.getTagForName ("cycle1") == -1);
+	EXPECT (desc.lookupControlTagName (26));
+	EXPECT (std::string (desc.lookupControlTagName (26)) == "t2");
+
+	auto evaluations = desc.getExpressionStatistics ().evaluations;
+	EXPECT (desc.getTagForName ("t2") == 26);
+	EXPECT (desc.getExpressionStatistics ().evaluations == evaluations);
+
+	// only t2, t1, var.double and var.base depend on var.base
+	EXPECT (desc.changeVariable ("base", "20"));
+	EXPECT (desc.getTagForName ("t2") == 46);
+	EXPECT (desc.getTagForName ("t3") == 5);
+	EXPECT (desc.getExpressionStatistics ().evaluations == evaluations + 4);
+	double value;
+	EXPECT (desc.getVariable ("double", value));
+	EXPECT (value == 40.);
+
+	EXPECT (desc.changeControlTagString ("t1", "7"));
+	EXPECT (desc.getTagForName ("t2") == 12);
+	desc.removeTag ("t1");
+	EXPECT (desc.getTagForName ("t2") == -1);
+	EXPECT (desc.changeControlTagString ("t1", "8", true));
+	EXPECT (desc.getTagForName ("t2") == 13);
+	EXPECT (desc.changeVariable ("new", "tag.t2 * 2", true));
+	EXPECT (desc.getVariable ("new", value));
+	EXPECT (value == 26.);
+}
+
+TEST_CASE (UIDescriptionJSONTests, ExpressionTagsWithController)
+{
+	struct OffsetController : Controller
+	{
+		int32_t offset {0};
+		int32_t getTagForName (UTF8StringPtr name, int32_t registeredTag) const override
+		{
+			if (std::string (name) == "unknown")
+				return 100 + offset;
+			return registeredTag == -1 ? -1 : registeredTag + offset;
+		}
+	};
+
+	MemoryContentProvider provider (expressionNodesUIDesc,
+	                                static_cast<uint32_t> (strlen (expressionNodesUIDesc)));
+	UIDescription desc (&provider);
+	EXPECT (desc.parse () == true);
+	EXPECT (desc.getTagForName ("t2") == 26);
+	EXPECT (desc.getTagForName ("unknown") == -1);
+
+	// every defined tag and every tag it references is passed to the controller
+	OffsetController controller1;
+	controller1.offset = 1000;
+	desc.setController (&controller1);
+	EXPECT (desc.getTagForName ("t1") == 1021);
+	EXPECT (desc.getTagForName ("t2") == 2026);
+	EXPECT (desc.getTagForName ("unknown") == 1100);
+	double value;
+	EXPECT (desc.calculateStringValue ("tag.t1 + 1", value));
+	EXPECT (value == 1022.);
+
+	OffsetController controller2;
+	controller2.offset = 2000;
+	desc.setController (&controller2);
+	EXPECT (desc.getTagForName ("t2") == 4026);
+	controller2.offset = 3000;
+	EXPECT (desc.getTagForName ("t2") == 6026);
+
+	desc.setController (nullptr);
+	EXPECT (desc.getTagForName ("t2") == 26);
+	EXPECT (desc.getTagForName ("unknown") == -1);
+}
+
+TEST_CASE (UIDescriptionJSONTests, ControllerTagRequests)
+{
+	struct RecordingController : Controller
+	{
+		mutable std::vector<std::pair<std::string, int32_t>> requests;
+		int32_t getTagForName (UTF8StringPtr name, int32_t registeredTag) const override
+		{
+			requests.emplace_back (name, registeredTag);
+			return registeredTag;
+		}
+	};
+
+	MemoryContentProvider provider (expressionNodesUIDesc,
+	                                static_cast<uint32_t> (strlen (expressionNodesUIDesc)));
+	UIDescription desc (&provider);
+	EXPECT (desc.parse () == true);
+	RecordingController controller;
+	desc.setController (&controller);
+
+	// the looked-up tag is requested once, after the tags its expression references
+	using Requests = decltype (controller.requests);
+	const Requests expected {{"t1", 21}, {"t2", 26}};
+	EXPECT (desc.getTagForName ("t2") == 26);
+	EXPECT (controller.requests == expected);
+	// the referenced tags are requested on every lookup, as the results are not cached while a
+	// controller is set
+	controller.requests.clear ();
+	EXPECT (desc.getTagForName ("t2") == 26);
+	EXPECT (controller.requests == expected);
+
+	controller.requests.clear ();
+	EXPECT (desc.getTagForName ("unknown") == -1);
+	const Requests unknown {{"unknown", -1}};
+	EXPECT (controller.requests == unknown);
+}
+
+TEST_CASE (UIDescriptionJSONTests, ExpressionTiming)
+{
+	constexpr auto numTags = 10000u;
+	std::string json = R"({"vstgui-ui-description": {"version": "1", "variables": {"step": "3"}, "control-tags": {"t0": "1")";
+	for (auto i = 1u; i < numTags; ++i)
+		json += ",\"t" + std::to_string (i) + "\": \"tag.t" + std::to_string (i / 2) + " + var.step\"";
+	json += "}}}";
+	MemoryContentProvider provider (json.data (), static_cast<uint32_t> (json.size ()));
+	UIDescription desc (&provider);
+	EXPECT (desc.parse () == true);
+
+	std::vector<std::string> names;
+	for (auto i = 0u; i < numTags; ++i)
+		names.emplace_back ("t" + std::to_string (i));
+	auto expectedTag = [] (uint32_t index, int32_t step) {
+		int32_t result = 1;
+		for (; index > 0; index /= 2)
+			result += step;
+		return result;
+	};
+	auto resolveAll = [&] (int32_t step) {
+		auto start = std::chrono::high_resolution_clock::now ();
+		bool success = true;
+		for (auto i = 0u; i < numTags; ++i)
+			success &= desc.getTagForName (names[i].data ()) == expectedTag (i, step);
+		std::chrono::duration<double, std::milli> duration =
+		    std::chrono::high_resolution_clock::now () - start;
+		EXPECT (success);
+		return duration.count ();
+	};
+	auto first = resolveAll (3);
+	auto cached = resolveAll (3);
+	EXPECT (desc.getExpressionStatistics ().compilations == numTags - 1);
+	EXPECT (desc.changeVariable ("step", "4"));
+	auto changed = resolveAll (4);
+	EXPECT (desc.getExpressionStatistics ().compilations == numTags - 1);
+	context->print ("resolving %u tag expressions: %.2f ms first, %.2f ms cached, %.2f ms after a "
+	                "variable change",
+	                numTags, first, cached, changed);
+}
+
 TEST_CASE (UIDescriptionJSONTests, WriteToStream)
 {
 	std::string str (withAllNodesUIDesc);
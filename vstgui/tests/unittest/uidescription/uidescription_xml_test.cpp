@@ -6,11 +6,16 @@
 #include "../../../lib/ccolor.h"
 #include "../../../lib/cgradient.h"
 #include "../../../lib/cviewcontainer.h"
+#include "../../../lib/platform/iplatformbitmap.h"
+#include "../../../lib/platform/platformfactory.h"
+#include "../../../uidescription/base64codec.h"
+#include "../../../uidescription/detail/uinode.h"
 #include "../../../uidescription/detail/uiviewcreatorattributes.h"
 #include "../../../uidescription/uiattributes.h"
 #include "../../../uidescription/uicontentprovider.h"
 #include "../../../uidescription/xmlparser.h"
 #include "uidescription_test_helper.h"
+#include <algorithm>
 
 #if VSTGUI_ENABLE_XML_PARSER
 
@@ -897,6 +902,203 @@ TEST_CASE (UIDescriptionXMLTests, SharedResources)
 	desc.setSharedResources (nullptr);
 }
 
+TEST_CASE (UIDescriptionXMLTests, EmbeddedBitmapStreamDecoding)
+{
+	constexpr auto bitmapSize = 512;
+	auto bitmap = makeOwned<CBitmap> (CPoint (bitmapSize, bitmapSize));
+	if (auto pixelAccess = owned (CBitmapPixelAccess::create (bitmap)))
+	{
+		uint32_t value = 0x12345678;
+		do
+		{
+			value = value * 1664525u + 1013904223u;
+			pixelAccess->setValue (value | 0xFF000000);
+		} while (++(*pixelAccess));
+	}
+	auto png =
+	    getPlatformFactory ().createBitmapMemoryPNGRepresentation (bitmap->getPlatformBitmap ());
+	EXPECT (!png.empty ());
+	auto base64 = Base64Codec::encode (png.data (), png.size ());
+
+	std::string str (R"(<vstgui-ui-description version="1"><bitmaps>)"
+	                 R"(<bitmap name="b1" path="b1.png"><data encoding="base64">)");
+	str.append (reinterpret_cast<const char*> (base64.data.get ()), base64.dataSize);
+	str += "</data></bitmap></bitmaps></vstgui-ui-description>";
+
+	MemoryContentProvider provider (str.data (), static_cast<uint32_t> (str.size ()));
+	SaveUIDescription desc (&provider);
+	EXPECT (desc.parse () == true);
+	auto decodedBitmap = desc.getBitmap ("b1");
+	EXPECT (decodedBitmap && decodedBitmap->getPlatformBitmap ());
+	EXPECT (decodedBitmap->getPlatformBitmap ()->getSize () == CPoint (bitmapSize, bitmapSize));
+
+	// the original image data is saved, not the platform bitmap encoded again
+	CMemoryStream outputStream (1024, 1024, false);
+	EXPECT (desc.saveToStream (outputStream, defaultSafeFlags, nullptr));
+	outputStream.end ();
+	std::string result (reinterpret_cast<const char*> (outputStream.getBuffer ()),
+	                    static_cast<size_t> (outputStream.tell ()));
+	EXPECT (result.find (R"(<data encoding="base64">)") != std::string::npos);
+	result.erase (std::remove_if (result.begin (), result.end (),
+	                              [] (char c) { return c == '\n' || c == '\t'; }),
+	              result.end ());
+	EXPECT (result.find (std::string (reinterpret_cast<const char*> (base64.data.get ()),
+	                                  base64.dataSize)) != std::string::npos);
+}
+
+TEST_CASE (UIDescriptionXMLTests, EmbeddedBitmapDataReleaseAndRestore)
+{
+	auto bitmap = makeOwned<CBitmap> (CPoint (16, 16));
+	auto png =
+	    getPlatformFactory ().createBitmapMemoryPNGRepresentation (bitmap->getPlatformBitmap ());
+	auto base64 = Base64Codec::encode (png.data (), png.size ());
+	std::string text (reinterpret_cast<const char*> (base64.data.get ()), base64.dataSize);
+
+	auto attributes = makeOwned<UIAttributes> ();
+	attributes->setAttribute ("path", "b1.png");
+	auto node = makeOwned<Detail::UIBitmapNode> ("bitmap", attributes);
+	auto dataNode = new Detail::UINode ("data");
+	dataNode->getAttributes ()->setAttribute ("encoding", "base64");
+	dataNode->getData () = text;
+	node->getChildren ().add (dataNode);
+	EXPECT (node->hasXMLData ());
+
+	// the base64 text is dropped after the platform bitmap was created from it
+	auto decodedBitmap = node->getBitmap ({});
+	EXPECT (decodedBitmap && decodedBitmap->getPlatformBitmap ());
+	node->releaseXMLData ();
+	EXPECT_FALSE (node->hasXMLData ());
+	EXPECT_FALSE (node->canDecodeAgain ());
+
+	// and restored unchanged when the platform bitmap is released
+	node->freePlatformResources ();
+	EXPECT (node->hasXMLData ());
+	EXPECT (node->canDecodeAgain ());
+	EXPECT (node->dataNode ()->getData () == text);
+
+	decodedBitmap = node->getBitmap ({});
+	EXPECT (decodedBitmap && decodedBitmap->getPlatformBitmap ());
+	EXPECT (decodedBitmap->getPlatformBitmap ()->getSize () == CPoint (16, 16));
+	node->releaseXMLData ();
+	EXPECT_FALSE (node->hasXMLData ());
+	node->createXMLData ({});
+	EXPECT (node->hasXMLData ());
+	EXPECT (node->dataNode ()->getData () == text);
+
+	// removing the data also drops the released bytes
+	node->freePlatformResources ();
+	EXPECT (node->getBitmap ({}));
+	node->releaseXMLData ();
+	EXPECT_FALSE (node->hasXMLData ());
+	node->removeXMLData ();
+	node->freePlatformResources ();
+	EXPECT_FALSE (node->hasXMLData ());
+}
+
+static std::string embeddedBitmapNode (const std::string& name, CCoord size)
+{
+	auto bitmap = makeOwned<CBitmap> (CPoint (size, size));
+	auto png =
+	    getPlatformFactory ().createBitmapMemoryPNGRepresentation (bitmap->getPlatformBitmap ());
+	auto base64 = Base64Codec::encode (png.data (), png.size ());
+	std::string str =
+	    "<bitmap name=\"" + name + "\" path=\"" + name + ".png\"><data encoding=\"base64\">";
+	str.append (reinterpret_cast<const char*> (base64.data.get ()), base64.dataSize);
+	return str + "</data></bitmap>";
+}
+
+TEST_CASE (UIDescriptionXMLTests, BitmapDecodePrePass)
+{
+	auto bitmapNode = embeddedBitmapNode;
+	std::string str (R"(<vstgui-ui-description version="1"><bitmaps>)");
+	str += bitmapNode ("b1", 8) + bitmapNode ("b1#2x", 16) + bitmapNode ("b2", 8) +
+	       bitmapNode ("b3", 8) + bitmapNode ("b4", 8);
+	str += R"(</bitmaps>)"
+	       R"(<template name="t1" class="CViewContainer" size="100, 100" bitmap="b1">)"
+	       R"(<view class="CView" size="10, 10" bitmap="b2"/>)"
+	       R"(<view class="CView" size="10, 10" tooltip="b4"/>)"
+	       R"(<view template="t2"/></template>)"
+	       R"(<template name="t2" class="CViewContainer" size="10, 10" bitmap="b3"/>)"
+	       R"(</vstgui-ui-description>)";
+
+	MemoryContentProvider provider (str.data (), static_cast<uint32_t> (str.size ()));
+	UIDescription desc (&provider);
+	EXPECT (desc.parse () == true);
+	EXPECT (desc.getBitmapDecodeThreadCount () == 1);
+	desc.setBitmapDecodeThreadCount (4);
+	EXPECT (desc.getBitmapDecodeThreadCount () == 4);
+
+	auto view = owned (desc.createView ("t1", nullptr));
+	EXPECT (view);
+	std::vector<std::string> names;
+	for (const auto& entry : desc.getBitmapDecodeTrace ())
+	{
+		EXPECT (entry.threadIndex < 4);
+		names.emplace_back (entry.name);
+	}
+	std::sort (names.begin (), names.end ());
+	EXPECT (names == std::vector<std::string> ({"b1", "b1#2x", "b2", "b3"}));
+	EXPECT (view->getBackground () == desc.getBitmap ("b1"));
+	EXPECT (view->getBackground ()->getPlatformBitmap ());
+
+	// all referenced bitmaps are decoded now, so the pre-pass has nothing to do
+	view = owned (desc.createView ("t1", nullptr));
+	EXPECT (desc.getBitmapDecodeTrace ().empty ());
+}
+
+TEST_CASE (UIDescriptionXMLTests, LazyBitmapLoading)
+{
+	std::string str (R"(<vstgui-ui-description version="1"><bitmaps>)");
+	str += embeddedBitmapNode ("b1", 8) + embeddedBitmapNode ("b1#2x", 16) +
+	       embeddedBitmapNode ("b1#3x", 24);
+	str += R"(</bitmaps>)"
+	       R"(<template name="t1" class="CViewContainer" size="100, 100" bitmap="b1"/>)"
+	       R"(</vstgui-ui-description>)";
+
+	MemoryContentProvider provider (str.data (), static_cast<uint32_t> (str.size ()));
+	SaveUIDescription desc (&provider);
+	EXPECT (desc.parse () == true);
+	desc.setBitmapDecodeThreadCount (4);
+	desc.setLazyBitmapLoading (true);
+	EXPECT (desc.getLazyBitmapLoading ());
+
+	auto view = owned (desc.createView ("t1", nullptr));
+	EXPECT (view);
+	// only the referenced bitmap is decoded by the pre-pass
+	EXPECT (desc.getBitmapDecodeTrace ().size () == 1);
+	auto bitmap = view->getBackground ();
+	EXPECT (bitmap && bitmap->hasLazyBitmaps ());
+	EXPECT (std::distance (bitmap->begin (), bitmap->end ()) == 1);
+	EXPECT (bitmap->getPlatformBitmap ()->getScaleFactor () == 1.);
+	EXPECT (desc.getUnloadedBitmapMemorySize () == (16 * 16 + 24 * 24) * 4);
+
+	desc.onScaleFactorChanged (nullptr, 2.);
+	EXPECT (desc.getBitmapScaleFactor () == 2.);
+	EXPECT (std::distance (bitmap->begin (), bitmap->end ()) == 1);
+	EXPECT (bitmap->getPlatformBitmap ()->getScaleFactor () == 2.);
+	EXPECT (bitmap->getWidth () == 8.);
+	EXPECT (desc.getUnloadedBitmapMemorySize () == (8 * 8 + 24 * 24) * 4);
+
+	desc.setBitmapScaleFactor (3.);
+	EXPECT (std::distance (bitmap->begin (), bitmap->end ()) == 1);
+	EXPECT (bitmap->getPlatformBitmap ()->getScaleFactor () == 3.);
+
+	desc.setBitmapScaleFactor (1.);
+	EXPECT (std::distance (bitmap->begin (), bitmap->end ()) == 1);
+	EXPECT (bitmap->getPlatformBitmap ()->getScaleFactor () == 1.);
+	EXPECT (desc.getUnloadedBitmapMemorySize () == (16 * 16 + 24 * 24) * 4);
+
+	// the embedded data of all variants is saved
+	CMemoryStream outputStream (1024, 1024, false);
+	EXPECT (desc.saveToStream (outputStream, defaultSafeFlags, nullptr));
+	outputStream.end ();
+	std::string result (reinterpret_cast<const char*> (outputStream.getBuffer ()));
+	size_t numDataNodes = 0;
+	for (auto pos = result.find ("<data"); pos != std::string::npos; pos = result.find ("<data", pos + 1))
+		++numDataNodes;
+	EXPECT (numDataNodes == 3);
+}
+
 } // VSTGUI
 
 #endif
@@ -55,6 +55,7 @@ public:
 		app.registerCommand (Commands::SaveDocument, 's');
 		app.registerCommand (Commands::SaveDocumentAs, 'S');
 		app.registerCommand (ExportCommand, 'e');
+		app.registerCommand (ExportAtlasCommand, 'E');
 
 		if (app.getWindows ().empty ())
 		{
@@ -139,7 +140,8 @@ public:
 			return [] (const UTF8String& lhs, const UTF8String& rhs) {
 				static auto order = {Commands::NewDocument.name,  Commands::OpenDocument.name,
 				                     Commands::SaveDocument.name, Commands::SaveDocumentAs.name,
-				                     ExportCommand.name,          Commands::CloseWindow.name};
+				                     ExportCommand.name,          ExportAtlasCommand.name,
+				                     Commands::CloseWindow.name};
 				auto leftIndex = std::find (order.begin (), order.end (), lhs);
 				auto rightIndex = std::find (order.begin (), order.end (), rhs);
 				return std::distance (leftIndex, rightIndex) > 0;
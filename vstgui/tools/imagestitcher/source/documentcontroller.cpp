@@ -5,6 +5,7 @@
 #include "documentcontroller.h"
 #include "imageframesview.h"
 #include "vstgui/lib/cbitmap.h"
+#include "vstgui/lib/cbitmapatlas.h"
 #include "vstgui/lib/cdatabrowser.h"
 #include "vstgui/lib/cgradientview.h"
 #include "vstgui/lib/coffscreencontext.h"
@@ -366,6 +367,62 @@ void DocumentWindowController::doExport ()
 	});
 }
 
+//------------------------------------------------------------------------
+static bool exportAtlas (const CBitmapAtlas& atlas, const Path& path)
+{
+	auto basePath = path;
+	auto extensionPos = basePath.find_last_of ('.');
+	if (extensionPos != Path::npos && basePath.find (PathSeparator, extensionPos) == Path::npos)
+		basePath.erase (extensionPos);
+	const auto& pages = atlas.getPages ();
+	for (auto index = 0u; index < pages.size (); ++index)
+	{
+		auto pagePath = basePath;
+		if (index > 0)
+			pagePath += "_" + std::to_string (index);
+		pagePath += ".png";
+		if (!exportImage (pages[index], pagePath.data ()))
+			return false;
+	}
+	auto description = atlas.toDescription ();
+	CFileStream stream;
+	if (!stream.open ((basePath + ".atlas").data (),
+	                  CFileStream::kWriteMode | CFileStream::kTruncateMode))
+		return false;
+	return stream.writeRaw (description.data (), static_cast<uint32_t> (description.size ())) ==
+	       description.size ();
+}
+
+//------------------------------------------------------------------------
+void DocumentWindowController::doExportAtlas ()
+{
+	auto fs =
+	    owned (CNewFileSelector::create (contentView, CNewFileSelector::Style::kSelectSaveFile));
+	if (!fs)
+		return;
+	fs->setTitle ("Save Image Atlas");
+	fs->setDefaultExtension (pngFileExtension);
+	fs->run ([this] (CNewFileSelector* fs) {
+		if (fs->getNumSelectedFiles () == 0)
+			return;
+		CBitmapAtlas::NamedBitmapList bitmaps;
+		for (const auto& image : imageList)
+			bitmaps.emplace_back (getDisplayFilename (image.path), image.bitmap);
+		CBitmapAtlas::Config config;
+		config.maxPageSize = 4096.;
+		config.maxBitmapSize = config.maxPageSize;
+		auto atlas = CBitmapAtlas::pack (bitmaps, config);
+		if (atlas->getNumPackedBitmaps () != bitmaps.size () ||
+		    !exportAtlas (*atlas, fs->getSelectedFile (0)))
+		{
+			AlertBoxForWindowConfig alert;
+			alert.window = window;
+			alert.headline = "Export failed";
+			IApplication::instance ().showAlertBoxForWindow (alert);
+		}
+	});
+}
+
 //------------------------------------------------------------------------
 void DocumentWindowController::doSave ()
 {
@@ -615,6 +672,8 @@ bool DocumentWindowController::canHandleCommand (const Command& command)
 		return !imageList.empty ();
 	if (command == ExportCommand)
 		return !imageList.empty ();
+	if (command == ExportAtlasCommand)
+		return !imageList.empty ();
 	if (command == Commands::SaveDocumentAs)
 		return !imageList.empty ();
 	if (command == Commands::SaveDocument)
@@ -640,6 +699,11 @@ bool DocumentWindowController::handleCommand (const Command& command)
 		doExport ();
 		return true;
 	}
+	if (command == ExportAtlasCommand)
+	{
+		doExportAtlas ();
+		return true;
+	}
 	if (command == Commands::SaveDocument)
 	{
 		doSave ();
@@ -23,6 +23,9 @@ class ImageFramesView;
 //------------------------------------------------------------------------
 static constexpr IdStringPtr ExportStr = "Export...";
 static const Standalone::Command ExportCommand {Standalone::CommandGroup::File, ExportStr};
+static constexpr IdStringPtr ExportAtlasStr = "Export Atlas...";
+static const Standalone::Command ExportAtlasCommand {Standalone::CommandGroup::File,
+                                                     ExportAtlasStr};
 static CFileExtension imageStitchExtension ("Image Stitch File", "imagestitch", "", 0, "");
 
 //------------------------------------------------------------------------
@@ -85,6 +88,7 @@ private:
 	void doStartAnimation ();
 	void doStopAnimation ();
 	void doExport ();
+	void doExportAtlas ();
 	void doSave ();
 
 	bool somethingSelected () const;
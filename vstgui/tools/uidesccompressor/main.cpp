@@ -45,6 +45,7 @@ int main (int argv, char* argc[])
 	std::string inputPath;
 	std::string outputPath;
 	bool noCompression = false;
+	bool chunked = false;
 	uint32_t compressionLevel = 1;
 	for (auto i = 0; i < argv; ++i)
 	{
@@ -71,13 +72,17 @@ int main (int argv, char* argc[])
 		{
 			noCompression = true;
 		}
+		else if (arg == "--chunked")
+		{
+			chunked = true;
+		}
 	}
 	if (inputPath.empty () || outputPath.empty ())
 	{
 		printAndTerminate ("No input or output path specified!");
 	}
 	printf ("Copy %s to %s%s\n", inputPath.data (), outputPath.data (),
-			noCompression ? " [uncompressed]" : "[compressed]");
+			noCompression ? " [uncompressed]" : (chunked ? " [chunked]" : " [compressed]"));
 
 	CompressedUIDescription uiDesc (CResourceDescription (inputPath.data ()));
 	if (!uiDesc.parse ())
@@ -97,12 +102,15 @@ int main (int argv, char* argc[])
 	}
 	else
 	{
-		if (inputPath == outputPath && uiDesc.getOriginalIsCompressed () == true)
+		if (inputPath == outputPath && uiDesc.getOriginalIsCompressed () == true &&
+			uiDesc.getOriginalIsChunked () == chunked)
 			return 0;
 
 		flags |= CompressedUIDescription::kNoPlainUIDescFileBackup |
 				 CompressedUIDescription::kForceWriteCompressedDesc |
 				 CompressedUIDescription::kDoNotVerifyImageData;
+		if (chunked)
+			flags |= CompressedUIDescription::kWriteChunkedContainer;
 		uiDesc.setCompressionLevel (compressionLevel);
 		if (!uiDesc.save (outputPath.data (), flags))
 		{
@@ -5,10 +5,22 @@
 #pragma once
 
 #include "../lib/malloc.h"
+#include "cstream.h"
+#include "detail/base64simd.h"
 
 namespace VSTGUI {
 
 //-----------------------------------------------------------------------------
+/** Base64 encoder and decoder
+ *
+ *	Uses SSSE3/AVX2 (x86) or NEON (ARM64) kernels when available and falls back to a scalar
+ *	implementation otherwise. Besides the one-shot functions returning a Result, the codec can
+ *	write into a caller provided buffer or an OutputStream, and the Decoder and Encoder classes
+ *	process the input in chunks.
+ *
+ *	The decoder skips characters outside of the base64 alphabet (e.g. line breaks) and stops at
+ *	the first padding character. Unpadded input is accepted.
+ */
 class Base64Codec
 {
 public:
@@ -18,6 +30,30 @@ public:
 		uint32_t dataSize {0};
 	};
 
+	enum class Kernel
+	{
+		Auto,
+		Scalar,
+		SSSE3,
+		AVX2,
+		NEON
+	};
+
+	/** returns the fastest kernel supported by the current CPU */
+	static inline Kernel getBestKernel ();
+	/** returns true if the kernel can be used on the current CPU */
+	static inline bool isKernelSupported (Kernel kernel);
+	static inline const char* getKernelName (Kernel kernel);
+
+	static constexpr size_t getEncodedSize (size_t binaryDataSize)
+	{
+		return ((binaryDataSize + 2) / 3) * 4;
+	}
+	static constexpr size_t getMaxDecodedSize (size_t base64DataSize)
+	{
+		return (base64DataSize / 4) * 3 + 2;
+	}
+
 	template<typename T>
 	static inline Result decode (const T& base64String)
 	{
@@ -29,108 +65,544 @@ public:
 	{
 		static_assert (sizeof (T) == 1, "T must be one byte type");
 		Result r;
-		r.data.allocate ((inBufferSize * 3 / 4) + 3);
-		uint8_t input1[4];
-		uint8_t input2[4];
-		auto input1Ptr = reinterpret_cast<uint32_t*>(&input1[0]);
-		auto input2Ptr = reinterpret_cast<uint32_t*>(&input2[0]);
-		auto buffer32Ptr = reinterpret_cast<const uint32_t*> (inBuffer);
-		while (inBufferSize > 8)
+		r.data.allocate (getMaxDecodedSize (inBufferSize));
+		r.dataSize = static_cast<uint32_t> (
+		    decode (inBuffer, inBufferSize, r.data.get (), r.data.size ()));
+		return r;
+	}
+
+	static inline Result encode (const void* binaryData, size_t binaryDataSize)
+	{
+		Result r;
+		r.data.allocate (getEncodedSize (binaryDataSize));
+		r.dataSize = static_cast<uint32_t> (
+		    encode (binaryData, binaryDataSize, r.data.get (), r.data.size ()));
+		return r;
+	}
+
+	/** decode into a caller provided buffer
+	 *
+	 *	@param output must be at least getMaxDecodedSize (base64DataSize) bytes
+	 *	@return number of bytes written to output
+	 */
+	static inline size_t decode (const void* base64Data, size_t base64DataSize, void* output,
+	                             size_t outputSize, Kernel kernel = Kernel::Auto)
+	{
+		Decoder decoder (kernel);
+		auto result = decoder.process (base64Data, base64DataSize, output, outputSize);
+		return result + decoder.finish (static_cast<uint8_t*> (output) + result,
+		                                outputSize - result);
+	}
+
+	/** encode into a caller provided buffer
+	 *
+	 *	@param output must be at least getEncodedSize (binaryDataSize) bytes
+	 *	@return number of bytes written to output
+	 */
+	static inline size_t encode (const void* binaryData, size_t binaryDataSize, void* output,
+	                             size_t outputSize, Kernel kernel = Kernel::Auto)
+	{
+		Encoder encoder (kernel);
+		auto result = encoder.process (binaryData, binaryDataSize, output, outputSize);
+		return result + encoder.finish (static_cast<uint8_t*> (output) + result,
+		                                outputSize - result);
+	}
+
+	/** decode and write the result to a stream */
+	static inline bool decode (const void* base64Data, size_t base64DataSize,
+	                           OutputStream& stream, Kernel kernel = Kernel::Auto)
+	{
+		Decoder decoder (kernel);
+		return decoder.process (base64Data, base64DataSize, stream) && decoder.finish (stream);
+	}
+
+	/** encode and write the result to a stream */
+	static inline bool encode (const void* binaryData, size_t binaryDataSize,
+	                           OutputStream& stream, Kernel kernel = Kernel::Auto)
+	{
+		Encoder encoder (kernel);
+		return encoder.process (binaryData, binaryDataSize, stream) && encoder.finish (stream);
+	}
+
+	//-----------------------------------------------------------------------------
+	/** Streaming base64 decoder
+	 *
+	 *	The input can be split at any position, incomplete quads are kept until the next call.
+	 */
+	class Decoder
+	{
+	public:
+		explicit Decoder (Kernel kernel = Kernel::Auto)
+		: kernel (kernel == Kernel::Auto ? getBestKernel () : kernel)
 		{
-			*input1Ptr = *buffer32Ptr++;
-			*input2Ptr = *buffer32Ptr++;
-			r.dataSize += decodeblock<false> (input1, r.data.get () + r.dataSize);
-			r.dataSize += decodeblock<false> (input2, r.data.get () + r.dataSize);
-			inBufferSize -= 8;
 		}
-		while (inBufferSize > 4)
+
+		/** the maximum number of bytes the next call to process will write */
+		size_t getMaxOutputSize (size_t inputSize) const
 		{
-			*input1Ptr = *buffer32Ptr++;
-			r.dataSize += decodeblock<false> (input1, r.data.get () + r.dataSize);
-			inBufferSize -= 4;
+			return getMaxDecodedSize (inputSize + pendingCount);
 		}
-		if (inBufferSize > 0)
+
+		/** returns the number of bytes written to output */
+		inline size_t process (const void* input, size_t inputSize, void* output,
+		                       size_t outputSize);
+		/** flush the pending bytes of unpadded input, returns the number of bytes written */
+		inline size_t finish (void* output, size_t outputSize);
+
+		inline bool process (const void* input, size_t inputSize, OutputStream& stream);
+		inline bool finish (OutputStream& stream);
+
+		/** true after the padding was reached */
+		bool isFinished () const { return finished; }
+		void reset ()
 		{
-			input1[0] = input1[1] = input1[2] = input1[3] = '=';
-			auto ptr = reinterpret_cast<const uint8_t*>(buffer32Ptr);
-			for (uint32_t j = 0; j < inBufferSize; j++)
-			{
-				input1[j] = *ptr++;
-			}
-			r.dataSize += decodeblock<true> (input1, r.data.get () + r.dataSize);
+			pendingCount = 0;
+			finished = false;
 		}
-		return r;
-	}
 
-	static inline Result encode (const void* binaryData, size_t binaryDataSize)
+	private:
+		Kernel kernel;
+		uint8_t pending[4];
+		uint32_t pendingCount {0};
+		bool finished {false};
+	};
+
+	//-----------------------------------------------------------------------------
+	/** Streaming base64 encoder
+	 *
+	 *	The input can be split at any position, incomplete triples are kept until the next call.
+	 */
+	class Encoder
 	{
-		Result r;
-		r.data.allocate ((binaryDataSize * 4) / 3 + 4);
-		auto ptr = reinterpret_cast<const uint8_t*> (binaryData);
-		uint8_t input[3];
-		uint32_t i;
-		for (i = 0; i < (binaryDataSize - 3); i += 3)
+	public:
+		explicit Encoder (Kernel kernel = Kernel::Auto)
+		: kernel (kernel == Kernel::Auto ? getBestKernel () : kernel)
 		{
-			input[0] = *ptr++;
-			input[1] = *ptr++;
-			input[2] = *ptr++;
-			encodeblock (input, r.data.get () + r.dataSize, 3);
-			r.dataSize += 4;
 		}
-		if (i < binaryDataSize)
+
+		/** the maximum number of bytes the next call to process will write */
+		size_t getMaxOutputSize (size_t inputSize) const
+		{
+			return ((inputSize + pendingCount) / 3) * 4;
+		}
+
+		/** returns the number of bytes written to output */
+		inline size_t process (const void* input, size_t inputSize, void* output,
+		                       size_t outputSize);
+		/** write the pending bytes including padding, returns the number of bytes written */
+		inline size_t finish (void* output, size_t outputSize);
+
+		inline bool process (const void* input, size_t inputSize, OutputStream& stream);
+		inline bool finish (OutputStream& stream);
+
+		void reset () { pendingCount = 0; }
+
+	private:
+		Kernel kernel;
+		uint8_t pending[3];
+		uint32_t pendingCount {0};
+	};
+
+	//-----------------------------------------------------------------------------
+	/** Pull style base64 decoder
+	 *
+	 *	Decodes the base64 data while it is read. If the caller's buffer is large enough the data
+	 *	is decoded directly into it, otherwise through a small fixed size staging buffer. Used to
+	 *	feed platform decoders without holding the complete binary data in memory.
+	 */
+	class DecodeReader
+	{
+	public:
+		static constexpr size_t kStagingBufferSize = 4096;
+
+		DecodeReader (const void* base64Data, size_t base64DataSize, Kernel kernel = Kernel::Auto)
+		: input (static_cast<const uint8_t*> (base64Data))
+		, inputEnd (input + base64DataSize)
+		, decoder (kernel)
+		{
+		}
+
+		/** returns the number of bytes written to buffer or zero at the end of the data */
+		inline size_t read (void* buffer, size_t size);
+
+	private:
+		static constexpr size_t kStagingInputSize = ((kStagingBufferSize - 2) / 3) * 4 - 4;
+
+		const uint8_t* input;
+		const uint8_t* inputEnd;
+		Decoder decoder;
+		uint8_t staging[kStagingBufferSize];
+		size_t stagingPos {0};
+		size_t stagingSize {0};
+		bool finished {false};
+	};
+
+private:
+	static constexpr size_t kStreamChunkSize = 8192;
+	static constexpr uint8_t kInvalid = 0xFF;
+
+	struct DecodeTable
+	{
+		uint8_t values[256];
+
+		constexpr DecodeTable () : values ()
+		{
+			for (auto& v : values)
+				v = kInvalid;
+			for (uint8_t i = 0; i < 64; ++i)
+				values[static_cast<uint8_t> (encodeTable ()[i])] = i;
+		}
+	};
+
+	static constexpr const char* encodeTable ()
+	{
+		return "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+	}
+
+	static inline const uint8_t* decodeTable ()
+	{
+		static constexpr DecodeTable table;
+		return table.values;
+	}
+
+	static inline void decodeBlocks (Kernel kernel, const uint8_t*& in, const uint8_t* inEnd,
+	                                 uint8_t*& out, const uint8_t* outEnd);
+	static inline void encodeBlocks (Kernel kernel, const uint8_t*& in, const uint8_t* inEnd,
+	                                 uint8_t*& out, const uint8_t* outEnd);
+
+	static inline void encodeblock (const uint8_t input[3], uint8_t output[4], uint32_t len)
+	{
+		auto cb64 = encodeTable ();
+		output[0] = static_cast<uint8_t> (cb64[input[0] >> 2]);
+		output[1] = static_cast<uint8_t> (
+		    cb64[((input[0] & 0x03) << 4) | (len > 1 ? ((input[1] & 0xf0) >> 4) : 0)]);
+		output[2] = static_cast<uint8_t> (
+		    len > 1 ? cb64[((input[1] & 0x0f) << 2) | (len > 2 ? ((input[2] & 0xc0) >> 6) : 0)]
+		            : '=');
+		output[3] = static_cast<uint8_t> (len > 2 ? cb64[input[2] & 0x3f] : '=');
+	}
+
+	static inline void decodeblock (const uint8_t input[4], uint8_t output[3])
+	{
+		output[0] = static_cast<uint8_t> ((input[0] << 2) | (input[1] >> 4));
+		output[1] = static_cast<uint8_t> ((input[1] << 4) | (input[2] >> 2));
+		output[2] = static_cast<uint8_t> ((input[2] << 6) | input[3]);
+	}
+};
+
+//-----------------------------------------------------------------------------
+inline Base64Codec::Kernel Base64Codec::getBestKernel ()
+{
+	static const Kernel bestKernel = [] () {
+		if (isKernelSupported (Kernel::AVX2))
+			return Kernel::AVX2;
+		if (isKernelSupported (Kernel::SSSE3))
+			return Kernel::SSSE3;
+		if (isKernelSupported (Kernel::NEON))
+			return Kernel::NEON;
+		return Kernel::Scalar;
+	}();
+	return bestKernel;
+}
+
+//-----------------------------------------------------------------------------
+inline bool Base64Codec::isKernelSupported (Kernel kernel)
+{
+	switch (kernel)
+	{
+		case Kernel::Auto:
+		case Kernel::Scalar:
+			return true;
+#if VSTGUI_BASE64_X86
+		case Kernel::SSSE3:
+			return Detail::Base64::cpuSupportsSSSE3 ();
+		case Kernel::AVX2:
+			return Detail::Base64::cpuSupportsAVX2 ();
+#endif
+#if VSTGUI_BASE64_NEON
+		case Kernel::NEON:
+			return true;
+#endif
+		default:
+			return false;
+	}
+}
+
+//-----------------------------------------------------------------------------
+inline const char* Base64Codec::getKernelName (Kernel kernel)
+{
+	switch (kernel)
+	{
+		case Kernel::Auto:
+			return getKernelName (getBestKernel ());
+		case Kernel::Scalar:
+			return "scalar";
+		case Kernel::SSSE3:
+			return "ssse3";
+		case Kernel::AVX2:
+			return "avx2";
+		case Kernel::NEON:
+			return "neon";
+	}
+	return "";
+}
+
+//-----------------------------------------------------------------------------
+inline void Base64Codec::decodeBlocks (Kernel kernel, const uint8_t*& in, const uint8_t* inEnd,
+                                       uint8_t*& out, const uint8_t* outEnd)
+{
+	switch (kernel)
+	{
+#if VSTGUI_BASE64_X86
+		case Kernel::AVX2:
+			Detail::Base64::decodeAVX2 (in, inEnd, out, outEnd);
+			break;
+		case Kernel::SSSE3:
+			Detail::Base64::decodeSSSE3 (in, inEnd, out, outEnd);
+			break;
+#endif
+#if VSTGUI_BASE64_NEON
+		case Kernel::NEON:
+			Detail::Base64::decodeNEON (in, inEnd, out, outEnd, decodeTable ());
+			break;
+#endif
+		default:
+			break;
+	}
+	auto table = decodeTable ();
+	while (inEnd - in >= 4 && outEnd - out >= 3)
+	{
+		uint8_t quad[4] = {table[in[0]], table[in[1]], table[in[2]], table[in[3]]};
+		if ((quad[0] | quad[1] | quad[2] | quad[3]) & 0xC0)
+			break;
+		decodeblock (quad, out);
+		in += 4;
+		out += 3;
+	}
+}
+
+//-----------------------------------------------------------------------------
+inline void Base64Codec::encodeBlocks (Kernel kernel, const uint8_t*& in, const uint8_t* inEnd,
+                                       uint8_t*& out, const uint8_t* outEnd)
+{
+	switch (kernel)
+	{
+#if VSTGUI_BASE64_X86
+		case Kernel::AVX2:
+			Detail::Base64::encodeAVX2 (in, inEnd, out, outEnd);
+			break;
+		case Kernel::SSSE3:
+			Detail::Base64::encodeSSSE3 (in, inEnd, out, outEnd);
+			break;
+#endif
+#if VSTGUI_BASE64_NEON
+		case Kernel::NEON:
+			Detail::Base64::encodeNEON (in, inEnd, out, outEnd,
+			                            reinterpret_cast<const uint8_t*> (encodeTable ()));
+			break;
+#endif
+		default:
+			break;
+	}
+	while (inEnd - in >= 3 && outEnd - out >= 4)
+	{
+		encodeblock (in, out, 3);
+		in += 3;
+		out += 4;
+	}
+}
+
+//-----------------------------------------------------------------------------
+inline size_t Base64Codec::Decoder::process (const void* input, size_t inputSize, void* output,
+                                             size_t outputSize)
+{
+	vstgui_assert (outputSize >= getMaxOutputSize (inputSize));
+	auto in = static_cast<const uint8_t*> (input);
+	auto inEnd = in + inputSize;
+	auto out = static_cast<uint8_t*> (output);
+	auto outStart = out;
+	auto outEnd = out + outputSize;
+	auto table = decodeTable ();
+	while (in < inEnd && !finished)
+	{
+		if (pendingCount == 0)
+			decodeBlocks (kernel, in, inEnd, out, outEnd);
+		// consume single characters until the next quad is complete
+		while (in < inEnd)
 		{
-			input[0] = input[1] = input[2] = 0;
-			uint32_t j;
-			for (j = 0; i < binaryDataSize; i++, j++)
+			auto c = *in++;
+			auto value = table[c];
+			if (value == kInvalid)
 			{
-				input[j] = *ptr++;
+				if (c == '=')
+				{
+					out += finish (out, static_cast<size_t> (outEnd - out));
+					finished = true;
+					break;
+				}
+				continue;
+			}
+			pending[pendingCount++] = value;
+			if (pendingCount == 4)
+			{
+				decodeblock (pending, out);
+				out += 3;
+				pendingCount = 0;
+				break;
 			}
-			encodeblock (input, r.data.get () + r.dataSize, j);
-			r.dataSize += 4;
 		}
-		return r;
 	}
+	return static_cast<size_t> (out - outStart);
+}
 
-private:
-	template<bool finalBlock = true>
-	static inline uint32_t decodeblock (uint8_t input[4], uint8_t output[3])
-	{
-		static constexpr uint8_t cd64[] = {
-			62,   0xFF, 0xFF, 0xFF, 63,   52,   53, 54, 55, 56, 57, 58, 59, 60, 61, 0xFF,
-			0xFF, 0xFF, 0,	0xFF, 0xFF, 0xFF, 0,  1,  2,  3,  4,  5,  6,  7,  8,  9,
-			10,   11,   12,   13,   14,   15,   16, 17, 18, 19, 20, 21, 22, 23, 24, 25,
-			0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35,
-			36,   37,   38,   39,   40,   41,   42, 43, 44, 45, 46, 47, 48, 49, 50, 51};
-
-		uint32_t result = 3;
-		if (finalBlock)
+//-----------------------------------------------------------------------------
+inline size_t Base64Codec::Decoder::finish (void* output, size_t outputSize)
+{
+	if (pendingCount < 2)
+	{
+		pendingCount = 0;
+		return 0;
+	}
+	vstgui_assert (outputSize >= pendingCount - 1);
+	auto out = static_cast<uint8_t*> (output);
+	out[0] = static_cast<uint8_t> ((pending[0] << 2) | (pending[1] >> 4));
+	if (pendingCount == 3)
+		out[1] = static_cast<uint8_t> ((pending[1] << 4) | (pending[2] >> 2));
+	auto result = pendingCount - 1;
+	pendingCount = 0;
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+inline bool Base64Codec::Decoder::process (const void* input, size_t inputSize,
+                                           OutputStream& stream)
+{
+	uint8_t buffer[getMaxDecodedSize (kStreamChunkSize + 3)];
+	auto in = static_cast<const uint8_t*> (input);
+	while (inputSize > 0 && !finished)
+	{
+		auto chunkSize = std::min (inputSize, kStreamChunkSize);
+		auto outSize = static_cast<uint32_t> (process (in, chunkSize, buffer, sizeof (buffer)));
+		if (outSize && stream.writeRaw (buffer, outSize) != outSize)
+			return false;
+		in += chunkSize;
+		inputSize -= chunkSize;
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+inline bool Base64Codec::Decoder::finish (OutputStream& stream)
+{
+	uint8_t buffer[2];
+	auto outSize = static_cast<uint32_t> (finish (buffer, sizeof (buffer)));
+	return outSize == 0 || stream.writeRaw (buffer, outSize) == outSize;
+}
+
+//-----------------------------------------------------------------------------
+inline size_t Base64Codec::DecodeReader::read (void* buffer, size_t size)
+{
+	auto out = static_cast<uint8_t*> (buffer);
+	auto outStart = out;
+	while (size > 0)
+	{
+		if (stagingPos < stagingSize)
+		{
+			auto numBytes = std::min (size, stagingSize - stagingPos);
+			memcpy (out, staging + stagingPos, numBytes);
+			stagingPos += numBytes;
+			out += numBytes;
+			size -= numBytes;
+			continue;
+		}
+		if (finished)
+			break;
+		stagingPos = 0;
+		if (input == inputEnd || decoder.isFinished ())
+		{
+			stagingSize = decoder.finish (staging, sizeof (staging));
+			finished = true;
+			continue;
+		}
+		auto remaining = static_cast<size_t> (inputEnd - input);
+		auto directInputSize = size > 8 ? std::min (((size - 2) / 3) * 4, remaining) : 0;
+		if (directInputSize)
 		{
-			if (input[2] == '=')
-				result = 1;
-			else if (input[3] == '=')
-				result = 2;
+			auto numBytes = decoder.process (input, directInputSize, out, size);
+			input += directInputSize;
+			out += numBytes;
+			size -= numBytes;
+			stagingSize = 0;
+			continue;
 		}
-		input[0] = cd64[input[0] - 43];
-		input[1] = cd64[input[1] - 43];
-		input[2] = cd64[input[2] - 43];
-		input[3] = cd64[input[3] - 43];
-		output[0] = static_cast<uint8_t> ((input[0] << 2) | ((input[1] & 0x30) >> 4));
-		output[1] = static_cast<uint8_t> (((input[1] & 0xF) << 4) | ((input[2] & 0x3C) >> 2));
-		output[2] = static_cast<uint8_t> (((input[2] & 0x03) << 6) | input[3]);
-		return result;
+		auto inputSize = std::min (kStagingInputSize, remaining);
+		stagingSize = decoder.process (input, inputSize, staging, sizeof (staging));
+		input += inputSize;
 	}
+	return static_cast<size_t> (out - outStart);
+}
 
-	static inline void encodeblock (uint8_t input[3], uint8_t output[4], uint32_t len)
+//-----------------------------------------------------------------------------
+inline size_t Base64Codec::Encoder::process (const void* input, size_t inputSize, void* output,
+                                             size_t outputSize)
+{
+	vstgui_assert (outputSize >= getMaxOutputSize (inputSize));
+	auto in = static_cast<const uint8_t*> (input);
+	auto inEnd = in + inputSize;
+	auto out = static_cast<uint8_t*> (output);
+	auto outStart = out;
+	auto outEnd = out + outputSize;
+	if (pendingCount)
 	{
-		static constexpr uint8_t cb64[] =
-			"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+		while (pendingCount < 3 && in < inEnd)
+			pending[pendingCount++] = *in++;
+		if (pendingCount < 3)
+			return 0;
+		encodeblock (pending, out, 3);
+		out += 4;
+		pendingCount = 0;
+	}
+	encodeBlocks (kernel, in, inEnd, out, outEnd);
+	while (in < inEnd)
+		pending[pendingCount++] = *in++;
+	return static_cast<size_t> (out - outStart);
+}
+
+//-----------------------------------------------------------------------------
+inline size_t Base64Codec::Encoder::finish (void* output, size_t outputSize)
+{
+	if (pendingCount == 0)
+		return 0;
+	vstgui_assert (outputSize >= 4);
+	encodeblock (pending, static_cast<uint8_t*> (output), pendingCount);
+	pendingCount = 0;
+	return 4;
+}
 
-		output[0] = cb64[input[0] >> 2];
-		output[1] = cb64[((input[0] & 0x03) << 4) | ((input[1] & 0xf0) >> 4)];
-		output[2] = static_cast<uint8_t>
-			(len > 1 ? cb64[((input[1] & 0x0f) << 2) | ((input[2] & 0xc0) >> 6)] : '=');
-		output[3] = static_cast<uint8_t>(len > 2 ? cb64[input[2] & 0x3f] : '=');
+//-----------------------------------------------------------------------------
+inline bool Base64Codec::Encoder::process (const void* input, size_t inputSize,
+                                           OutputStream& stream)
+{
+	uint8_t buffer[getEncodedSize (kStreamChunkSize + 2)];
+	auto in = static_cast<const uint8_t*> (input);
+	while (inputSize > 0)
+	{
+		auto chunkSize = std::min (inputSize, kStreamChunkSize);
+		auto outSize = static_cast<uint32_t> (process (in, chunkSize, buffer, sizeof (buffer)));
+		if (outSize && stream.writeRaw (buffer, outSize) != outSize)
+			return false;
+		in += chunkSize;
+		inputSize -= chunkSize;
 	}
-};
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+inline bool Base64Codec::Encoder::finish (OutputStream& stream)
+{
+	uint8_t buffer[4];
+	auto outSize = static_cast<uint32_t> (finish (buffer, sizeof (buffer)));
+	return outSize == 0 || stream.writeRaw (buffer, outSize) == outSize;
+}
 
 } // VSTGUI
@@ -3,10 +3,22 @@
 // distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
 
 #include "../lib/cresourcedescription.h"
+#include "../lib/malloc.h"
+#include "../lib/platform/iplatformbitmap.h"
+#include "../lib/platform/platformfactory.h"
+#include "base64codec.h"
 #include "compresseduidescription.h"
 #include "cstream.h"
+#include "detail/uijsonpersistence.h"
+#include "detail/uinode.h"
+#include "detail/uixmlpersistence.h"
+#include "uiattributes.h"
 #include "uicontentprovider.h"
 #include <array>
+#include <atomic>
+#include <future>
+#include <thread>
+#include <vector>
 
 //------------------------------------------------------------------------
 namespace VSTGUI {
@@ -106,6 +118,175 @@ public:
 
 //-----------------------------------------------------------------------------
 static constexpr int64_t kUIDescIdentifier = 0x7072637365646975LL; // 8 byte identifier
+static constexpr int64_t kUIDescChunkedIdentifier = 0x6b6e756863646975LL; // 8 byte identifier
+
+//-----------------------------------------------------------------------------
+/*	Chunked container layout (little endian):
+
+	int64	kUIDescChunkedIdentifier
+	uint32	version
+	uint32	number of chunks
+	for each chunk:
+		uint32	type (ChunkType)
+		uint32	flags (ChunkFlags)
+		uint64	offset of the chunk data relative to the end of the index
+		uint32	stored size
+		uint32	uncompressed size
+		uint32	name size
+		int8[]	name (the name attribute of the template or bitmap)
+	chunk data
+
+	The resources chunk is a complete description without templates and without embedded bitmap
+	data, every template chunk is a description with only this template and every bitmap chunk is
+	the PNG data of the bitmap with the same name. Templates are decompressed and parsed in
+	parallel, bitmaps are decoded on first use.
+*/
+namespace ChunkedContainer {
+
+static constexpr uint32_t kVersion = 1;
+
+// limits of the values read from a file, so that a corrupt file can't request huge allocations
+static constexpr uint32_t kMaxNumChunks = 1 << 16;
+static constexpr uint32_t kMaxNameSize = 1 << 12;
+static constexpr uint32_t kMaxChunkSize = 1 << 28;
+static constexpr uint32_t kDataReadBlockSize = 1 << 20;
+
+enum class ChunkType : uint32_t
+{
+	Resources = 0,
+	Template,
+	Bitmap,
+};
+
+enum ChunkFlags : uint32_t
+{
+	kCompressed = 1 << 0,
+};
+
+//-----------------------------------------------------------------------------
+struct Chunk
+{
+	ChunkType type {ChunkType::Resources};
+	uint32_t flags {0};
+	uint64_t offset {0};
+	uint32_t storedSize {0};
+	uint32_t size {0};
+	std::string name;
+};
+
+//-----------------------------------------------------------------------------
+struct Content
+{
+	std::vector<Chunk> chunks;
+	std::vector<uint8_t> data;
+
+	bool isValid (const Chunk& chunk) const
+	{
+		return chunk.size <= kMaxChunkSize && chunk.storedSize <= chunk.size &&
+		       chunk.offset <= data.size () && chunk.storedSize <= data.size () - chunk.offset;
+	}
+
+	const uint8_t* storedData (const Chunk& chunk) const { return data.data () + chunk.offset; }
+
+	bool decompress (const Chunk& chunk, Buffer<uint8_t>& output) const
+	{
+		if (!isValid (chunk))
+			return false;
+		output.allocate (chunk.size);
+		if (!(chunk.flags & kCompressed))
+		{
+			if (chunk.storedSize != chunk.size)
+				return false;
+			memcpy (output.get (), storedData (chunk), chunk.size);
+			return true;
+		}
+		uLong outputSize = chunk.size;
+		return uncompress (output.get (), &outputSize, storedData (chunk), chunk.storedSize) ==
+		           Z_OK &&
+		       outputSize == chunk.size;
+	}
+};
+
+//-----------------------------------------------------------------------------
+struct ByteOutputStream : public OutputStream
+{
+	bool operator<< (const std::string& str) override
+	{
+		return writeRaw (str.data (), static_cast<uint32_t> (str.size ())) == str.size ();
+	}
+	uint32_t writeRaw (const void* buffer, uint32_t size) override
+	{
+		auto bytes = static_cast<const uint8_t*> (buffer);
+		data.insert (data.end (), bytes, bytes + size);
+		return size;
+	}
+
+	std::vector<uint8_t> data;
+};
+
+//-----------------------------------------------------------------------------
+static SharedPointer<Detail::UINode> parseDescription (const Buffer<uint8_t>& data)
+{
+	MemoryContentProvider contentProvider (data.get (), static_cast<uint32_t> (data.size ()));
+	if (auto nodes = Detail::UIJsonDescReader::read (contentProvider))
+		return nodes;
+#if VSTGUI_ENABLE_XML_PARSER
+	contentProvider.rewind ();
+	Detail::UIXMLParser parser;
+	if (auto nodes = parser.parse (&contentProvider))
+		return nodes;
+#endif
+	return nullptr;
+}
+
+//-----------------------------------------------------------------------------
+static bool writeDescription (Detail::UINode* rootNode, int32_t flags, ByteOutputStream& stream)
+{
+	if (flags & UIDescription::kWriteAsXML)
+	{
+#if VSTGUI_ENABLE_XML_PARSER
+		Detail::UIXMLDescWriter writer;
+		return writer.write (stream, rootNode);
+#else
+		return false;
+#endif
+	}
+	return Detail::UIJsonDescWriter::write (stream, rootNode, false);
+}
+
+//-----------------------------------------------------------------------------
+static void addChunk (ChunkType type, std::string name, const uint8_t* data, size_t size,
+                      uint32_t compressionLevel, std::vector<Chunk>& chunks,
+                      std::vector<uint8_t>& chunkData)
+{
+	Chunk chunk;
+	chunk.type = type;
+	chunk.name = std::move (name);
+	chunk.offset = chunkData.size ();
+	chunk.size = static_cast<uint32_t> (size);
+
+	// already compressed data (PNG) is stored as is if deflate does not make it smaller
+	auto bound = compressBound (static_cast<uLong> (size));
+	chunkData.resize (chunk.offset + bound);
+	uLong compressedSize = bound;
+	if (compress2 (chunkData.data () + chunk.offset, &compressedSize, data,
+	               static_cast<uLong> (size), static_cast<int> (compressionLevel)) == Z_OK &&
+	    compressedSize < size)
+	{
+		chunk.flags |= kCompressed;
+		chunk.storedSize = static_cast<uint32_t> (compressedSize);
+	}
+	else
+	{
+		memcpy (chunkData.data () + chunk.offset, data, size);
+		chunk.storedSize = chunk.size;
+	}
+	chunkData.resize (chunk.offset + chunk.storedSize);
+	chunks.emplace_back (std::move (chunk));
+}
+
+//-----------------------------------------------------------------------------
+} // ChunkedContainer
 
 //-----------------------------------------------------------------------------
 CompressedUIDescription::CompressedUIDescription (const CResourceDescription& compressedUIDescFile)
@@ -119,7 +300,12 @@ bool CompressedUIDescription::parseWithStream (InputStream& stream)
 	bool result = false;
 	int64_t identifier;
 	stream >> identifier;
-	if (identifier == kUIDescIdentifier)
+	if (identifier == kUIDescChunkedIdentifier)
+	{
+		result = parseChunkedContainer (stream);
+		originalIsChunked = result;
+	}
+	else if (identifier == kUIDescIdentifier)
 	{
 		ZLibInputContentProvider zin (stream);
 		if (zin.open ())
@@ -132,6 +318,232 @@ bool CompressedUIDescription::parseWithStream (InputStream& stream)
 	return result;
 }
 
+//-----------------------------------------------------------------------------
+bool CompressedUIDescription::parseChunkedContainer (InputStream& stream)
+{
+	using namespace ChunkedContainer;
+
+	uint32_t version = 0;
+	uint32_t numChunks = 0;
+	if (!(stream >> version) || version != kVersion || !(stream >> numChunks) ||
+	    numChunks > kMaxNumChunks)
+		return false;
+
+	auto content = std::make_shared<Content> ();
+	uint64_t dataSize = 0;
+	for (uint32_t i = 0; i < numChunks; ++i)
+	{
+		Chunk chunk;
+		uint32_t type;
+		uint32_t nameSize;
+		if (!(stream >> type) || !(stream >> chunk.flags) || !(stream >> chunk.offset) ||
+		    !(stream >> chunk.storedSize) || !(stream >> chunk.size) || !(stream >> nameSize))
+			return false;
+		if (nameSize > kMaxNameSize || chunk.size > kMaxChunkSize ||
+		    chunk.storedSize > chunk.size ||
+		    chunk.offset > static_cast<uint64_t> (kMaxNumChunks) * kMaxChunkSize)
+			return false;
+		chunk.type = static_cast<ChunkType> (type);
+		chunk.name.resize (nameSize);
+		if (nameSize && stream.readRaw (&chunk.name[0], nameSize) != nameSize)
+			return false;
+		dataSize = std::max (dataSize, chunk.offset + chunk.storedSize);
+		content->chunks.emplace_back (std::move (chunk));
+	}
+	// the data grows with the bytes actually read, so a wrong size in the index fails at the end
+	// of the stream instead of allocating the size up front
+	for (uint64_t pos = 0; pos < dataSize;)
+	{
+		auto toRead = static_cast<uint32_t> (std::min<uint64_t> (dataSize - pos, kDataReadBlockSize));
+		content->data.resize (static_cast<size_t> (pos + toRead));
+		auto read = stream.readRaw (content->data.data () + pos, toRead);
+		if (read == 0 || read == kStreamIOError)
+			return false;
+		pos += read;
+	}
+	content->data.resize (static_cast<size_t> (dataSize));
+
+	const Chunk* resourcesChunk = nullptr;
+	std::vector<const Chunk*> templateChunks;
+	for (const auto& chunk : content->chunks)
+	{
+		if (chunk.type == ChunkType::Resources)
+			resourcesChunk = &chunk;
+		else if (chunk.type == ChunkType::Template)
+			templateChunks.emplace_back (&chunk);
+	}
+	if (!resourcesChunk)
+		return false;
+
+	// the templates are parsed by worker threads while this thread parses the resources
+	std::vector<SharedPointer<Detail::UINode>> templateNodes (templateChunks.size ());
+	std::atomic<size_t> nextTemplate {0};
+	auto parseTemplates = [&] () {
+		size_t index;
+		while ((index = nextTemplate++) < templateChunks.size ())
+		{
+			Buffer<uint8_t> data;
+			if (content->decompress (*templateChunks[index], data))
+				templateNodes[index] = parseDescription (data);
+		}
+	};
+	std::vector<std::future<void>> workers;
+	auto numWorkers =
+	    std::min<size_t> (templateChunks.size (), std::max (1u, std::thread::hardware_concurrency ()) - 1);
+	for (auto i = 0u; i < numWorkers; ++i)
+		workers.emplace_back (std::async (std::launch::async, parseTemplates));
+
+	bool result = false;
+	Buffer<uint8_t> resourcesData;
+	if (content->decompress (*resourcesChunk, resourcesData))
+	{
+		MemoryContentProvider contentProvider (resourcesData.get (),
+		                                       static_cast<uint32_t> (resourcesData.size ()));
+		setContentProvider (&contentProvider);
+		result = UIDescription::parse ();
+		setContentProvider (nullptr);
+	}
+	parseTemplates ();
+	for (auto& worker : workers)
+		worker.wait ();
+	if (!result)
+		return false;
+
+	auto rootNode = getRootNode ();
+	for (auto& templateRoot : templateNodes)
+	{
+		if (!templateRoot)
+		{
+			// leave an empty description as UIDescription::parse does when it fails
+			rootNode->getChildren ().removeAll ();
+			addDefaultNodes ();
+			return false;
+		}
+		for (auto& node : templateRoot->getChildren ())
+		{
+			if (node->getName () != Detail::MainNodeNames::kTemplate)
+				continue;
+			node->remember ();
+			rootNode->getChildren ().add (node);
+		}
+	}
+
+	auto bitmapsNode = rootNode->getChildren ().findChildNode (Detail::MainNodeNames::kBitmap);
+	for (const auto& chunk : content->chunks)
+	{
+		if (chunk.type != ChunkType::Bitmap || !bitmapsNode || !content->isValid (chunk))
+			continue;
+		auto bitmapNode = dynamic_cast<Detail::UIBitmapNode*> (
+		    bitmapsNode->getChildren ().findChildNodeWithAttributeValue ("name", chunk.name));
+		if (!bitmapNode)
+			continue;
+		bitmapNode->setPlatformBitmapLoader ([content, &chunk] () -> PlatformBitmapPtr {
+			if (!(chunk.flags & kCompressed))
+				return getPlatformFactory ().createBitmapFromMemory (content->storedData (chunk),
+				                                                     chunk.storedSize);
+			Buffer<uint8_t> data;
+			if (!content->decompress (chunk, data))
+				return nullptr;
+			return getPlatformFactory ().createBitmapFromMemory (
+			    data.get (), static_cast<uint32_t> (data.size ()));
+		});
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool CompressedUIDescription::saveChunkedContainer (OutputStream& stream, int32_t flags,
+                                                    AttributeSaveFilterFunc func)
+{
+	using namespace ChunkedContainer;
+	using Detail::UINode;
+	using Detail::UIDescList;
+
+	prepareNodesForSave (flags, func);
+
+	std::vector<Chunk> chunks;
+	std::vector<uint8_t> chunkData;
+
+	auto rootNode = getRootNode ();
+	auto resources = makeOwned<UIDescList> (false);
+	std::vector<SharedPointer<UINode>> templates;
+	for (auto& node : rootNode->getChildren ())
+	{
+		if (node->getName () == Detail::MainNodeNames::kTemplate)
+		{
+			templates.emplace_back (node);
+			continue;
+		}
+		if (node->getName () != Detail::MainNodeNames::kBitmap)
+		{
+			resources->add (node);
+			continue;
+		}
+		// replace the bitmap nodes with copies without the embedded data
+		auto bitmaps = makeOwned<UIDescList> (false);
+		for (auto& bitmapNode : node->getChildren ())
+		{
+			if (bitmapNode->noExport ())
+				continue;
+			auto bitmapChildren = makeOwned<UIDescList> (false);
+			for (auto& child : bitmapNode->getChildren ())
+			{
+				auto encoding = child->getAttributes ()->getAttributeValue ("encoding");
+				auto name = bitmapNode->getAttributes ()->getAttributeValue ("name");
+				if (child->getName () != "data" || !encoding || *encoding != "base64" || !name)
+				{
+					bitmapChildren->add (child);
+					continue;
+				}
+				auto png = Base64Codec::decode (child->getData ());
+				addChunk (ChunkType::Bitmap, *name, png.data.get (), png.dataSize,
+				          compressionLevel, chunks, chunkData);
+			}
+			bitmaps->add (makeOwned<UINode> (bitmapNode->getName (), bitmapChildren,
+			                                 bitmapNode->getAttributes ()));
+		}
+		resources->add (makeOwned<UINode> (node->getName (), bitmaps, node->getAttributes ()));
+	}
+
+	ByteOutputStream description;
+	auto resourcesRoot =
+	    makeOwned<UINode> (rootNode->getName (), resources, rootNode->getAttributes ());
+	if (!writeDescription (resourcesRoot, flags, description))
+		return false;
+	addChunk (ChunkType::Resources, {}, description.data.data (), description.data.size (),
+	          compressionLevel, chunks, chunkData);
+
+	for (auto& templateNode : templates)
+	{
+		auto list = makeOwned<UIDescList> (false);
+		list->add (templateNode);
+		auto templateRoot = makeOwned<UINode> (rootNode->getName (), list, rootNode->getAttributes ());
+		description.data.clear ();
+		if (!writeDescription (templateRoot, flags, description))
+			return false;
+		auto name = templateNode->getAttributes ()->getAttributeValue ("name");
+		addChunk (ChunkType::Template, name ? *name : "", description.data.data (),
+		          description.data.size (), compressionLevel, chunks, chunkData);
+	}
+
+	if (!(stream << kUIDescChunkedIdentifier) || !(stream << kVersion) ||
+	    !(stream << static_cast<uint32_t> (chunks.size ())))
+		return false;
+	for (const auto& chunk : chunks)
+	{
+		auto nameSize = static_cast<uint32_t> (chunk.name.size ());
+		if (!(stream << static_cast<uint32_t> (chunk.type)) || !(stream << chunk.flags) ||
+		    !(stream << chunk.offset) || !(stream << chunk.storedSize) || !(stream << chunk.size) ||
+		    !(stream << nameSize))
+			return false;
+		if (nameSize && stream.writeRaw (chunk.name.data (), nameSize) != nameSize)
+			return false;
+	}
+	return chunkData.empty () ||
+	       stream.writeRaw (chunkData.data (), static_cast<uint32_t> (chunkData.size ())) ==
+	           chunkData.size ();
+}
+
 //-----------------------------------------------------------------------------
 bool CompressedUIDescription::parse ()
 {
@@ -155,6 +567,9 @@ bool CompressedUIDescription::parse ()
 	}
 	if (!result)
 	{
+		// a compressed description which failed to parse has left an empty node tree
+		if (parsed ())
+			return false;
 		// fallback, check if it is an uncompressed UIDescription file
 		return UIDescription::parse ();
 	}
@@ -167,7 +582,23 @@ bool CompressedUIDescription::save (UTF8StringPtr filename, int32_t flags,
 									AttributeSaveFilterFunc func)
 {
 	bool result = false;
-	if (originalIsCompressed || (flags & kForceWriteCompressedDesc))
+	bool writeCompressed =
+	    originalIsCompressed || (flags & (kForceWriteCompressedDesc | kWriteChunkedContainer));
+	// kForceWriteCompressedDesc without kWriteChunkedContainer converts to the single stream format
+	bool writeChunked = (flags & kWriteChunkedContainer) ||
+	                    (originalIsChunked && !(flags & kForceWriteCompressedDesc));
+	if (writeChunked)
+	{
+		CFileStream fileStream;
+		if (fileStream.open (filename,
+		                     CFileStream::kWriteMode | CFileStream::kBinaryMode |
+		                         CFileStream::kTruncateMode,
+		                     kLittleEndianByteOrder))
+		{
+			result = saveChunkedContainer (fileStream, flags, func);
+		}
+	}
+	else if (writeCompressed)
 	{
 		CFileStream fileStream;
 		if (fileStream.open (filename,
@@ -190,7 +621,7 @@ bool CompressedUIDescription::save (UTF8StringPtr filename, int32_t flags,
 	{
 		// make a xml backup
 		std::string backupFileName (filename);
-		if (originalIsCompressed|| (flags & kForceWriteCompressedDesc))
+		if (writeCompressed)
 		{
 			if (flags & kWriteAsXML)
 				backupFileName.append (".xml");
@@ -17,6 +17,7 @@ protected:
 	{
 		NoPlainUIDescFileBackupBit = UIDescription::LastSaveFlagBit,
 		ForceWriteCompressedDesc,
+		WriteChunkedContainerBit,
 		LastCompressedSaveFlagBit,
 	};
 public:
@@ -26,6 +27,9 @@ public:
 	{
 		kNoPlainUIDescFileBackup = 1 << NoPlainUIDescFileBackupBit,
 		kForceWriteCompressedDesc = 1 << ForceWriteCompressedDesc,
+		/** write a container of independently compressed chunks (the resources, every template
+		 *	and every embedded bitmap) instead of a single compressed stream */
+		kWriteChunkedContainer = 1 << WriteChunkedContainerBit,
 		
 		kNoPlainXmlFileBackup [[deprecated("use kNoPlainUIDescFileBackup")]] = kNoPlainUIDescFileBackup,
 	};
@@ -35,12 +39,16 @@ public:
 			   AttributeSaveFilterFunc func = nullptr) override;
 
 	bool getOriginalIsCompressed () const { return originalIsCompressed; }
+	bool getOriginalIsChunked () const { return originalIsChunked; }
 	void setCompressionLevel (uint32_t level) { compressionLevel = level; }
 
 private:
 	bool parseWithStream (InputStream& stream);
+	bool parseChunkedContainer (InputStream& stream);
+	bool saveChunkedContainer (OutputStream& stream, int32_t flags, AttributeSaveFilterFunc func);
 
 	bool originalIsCompressed {false};
+	bool originalIsChunked {false};
 	uint32_t compressionLevel {1};
 };
 
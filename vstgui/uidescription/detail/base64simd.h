@@ -0,0 +1,325 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#if !defined(VSTGUI_BASE64_DISABLE_SIMD)
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define VSTGUI_BASE64_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define VSTGUI_BASE64_TARGET(name)
+#else
+#define VSTGUI_BASE64_TARGET(name) __attribute__ ((target (name)))
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define VSTGUI_BASE64_NEON 1
+#include <arm_neon.h>
+#endif
+#endif // VSTGUI_BASE64_DISABLE_SIMD
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace Detail {
+namespace Base64 {
+
+/*	All kernels follow the same contract:
+	- in/out are advanced past the consumed input and the produced output
+	- decoders only consume complete, valid quads and stop at the first block containing a
+	  character outside of the base64 alphabet (including padding), the scalar code handles the rest
+	- encoders only consume complete triples
+	- the output is never written beyond outEnd
+*/
+
+#if VSTGUI_BASE64_X86
+//------------------------------------------------------------------------
+inline bool cpuSupportsSSSE3 ()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+	int info[4];
+	__cpuid (info, 1);
+	return (info[2] & (1 << 9)) != 0;
+#else
+	return __builtin_cpu_supports ("ssse3");
+#endif
+}
+
+//------------------------------------------------------------------------
+inline bool cpuSupportsAVX2 ()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+	int info[4];
+	__cpuid (info, 0);
+	if (info[0] < 7)
+		return false;
+	__cpuid (info, 1);
+	constexpr int osxsaveAndAVX = (1 << 27) | (1 << 28);
+	if ((info[2] & osxsaveAndAVX) != osxsaveAndAVX)
+		return false;
+	if ((_xgetbv (0) & 0x6) != 0x6)
+		return false;
+	__cpuidex (info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	return __builtin_cpu_supports ("avx2");
+#endif
+}
+
+//------------------------------------------------------------------------
+VSTGUI_BASE64_TARGET ("ssse3")
+inline __m128i decodeReshuffleSSSE3 (__m128i in)
+{
+	// 00aaaaaa 00bbbbbb 00cccccc 00dddddd -> aaaaaabb bbbbcccc ccdddddd
+	const auto mergeAB = _mm_maddubs_epi16 (in, _mm_set1_epi32 (0x01400140));
+	const auto merged = _mm_madd_epi16 (mergeAB, _mm_set1_epi32 (0x00011000));
+	return _mm_shuffle_epi8 (
+	    merged, _mm_setr_epi8 (2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+//------------------------------------------------------------------------
+VSTGUI_BASE64_TARGET ("ssse3")
+inline bool decodeTranslateSSSE3 (__m128i& str)
+{
+	const auto lutLo = _mm_setr_epi8 (0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+	                                  0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+	const auto lutHi = _mm_setr_epi8 (0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10,
+	                                  0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+	const auto lutRoll = _mm_setr_epi8 (0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+	const auto mask0F = _mm_set1_epi8 (0x0F);
+	const auto mask2F = _mm_set1_epi8 (0x2F);
+
+	const auto hiNibbles = _mm_and_si128 (_mm_srli_epi32 (str, 4), mask0F);
+	const auto loNibbles = _mm_and_si128 (str, mask0F);
+	const auto hi = _mm_shuffle_epi8 (lutHi, hiNibbles);
+	const auto lo = _mm_shuffle_epi8 (lutLo, loNibbles);
+	if (_mm_movemask_epi8 (_mm_cmpgt_epi8 (_mm_and_si128 (lo, hi), _mm_setzero_si128 ())) != 0)
+		return false;
+	const auto eq2F = _mm_cmpeq_epi8 (str, mask2F);
+	const auto roll = _mm_shuffle_epi8 (lutRoll, _mm_add_epi8 (eq2F, hiNibbles));
+	str = _mm_add_epi8 (str, roll);
+	return true;
+}
+
+//------------------------------------------------------------------------
+VSTGUI_BASE64_TARGET ("ssse3")
+inline void decodeSSSE3 (const uint8_t*& in, const uint8_t* inEnd, uint8_t*& out,
+                         const uint8_t* outEnd)
+{
+	while (inEnd - in >= 16 && outEnd - out >= 16)
+	{
+		auto str = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (in));
+		if (!decodeTranslateSSSE3 (str))
+			break;
+		_mm_storeu_si128 (reinterpret_cast<__m128i*> (out), decodeReshuffleSSSE3 (str));
+		in += 16;
+		out += 12;
+	}
+}
+
+//------------------------------------------------------------------------
+VSTGUI_BASE64_TARGET ("ssse3")
+inline __m128i encodeReshuffleSSSE3 (__m128i in)
+{
+	in = _mm_shuffle_epi8 (in, _mm_set_epi8 (10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+	const auto t0 = _mm_and_si128 (in, _mm_set1_epi32 (0x0FC0FC00));
+	const auto t1 = _mm_mulhi_epu16 (t0, _mm_set1_epi32 (0x04000040));
+	const auto t2 = _mm_and_si128 (in, _mm_set1_epi32 (0x003F03F0));
+	const auto t3 = _mm_mullo_epi16 (t2, _mm_set1_epi32 (0x01000010));
+	return _mm_or_si128 (t1, t3);
+}
+
+//------------------------------------------------------------------------
+VSTGUI_BASE64_TARGET ("ssse3")
+inline __m128i encodeTranslateSSSE3 (__m128i in)
+{
+	// offsets for the ranges: A-Z, a-z, 0-9 (10 entries), '+', '/'
+	const auto lut = _mm_setr_epi8 (65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0);
+	auto indices = _mm_subs_epu8 (in, _mm_set1_epi8 (51));
+	const auto mask = _mm_cmpgt_epi8 (in, _mm_set1_epi8 (25));
+	indices = _mm_sub_epi8 (indices, mask);
+	return _mm_add_epi8 (in, _mm_shuffle_epi8 (lut, indices));
+}
+
+//------------------------------------------------------------------------
+VSTGUI_BASE64_TARGET ("ssse3")
+inline void encodeSSSE3 (const uint8_t*& in, const uint8_t* inEnd, uint8_t*& out,
+                         const uint8_t* outEnd)
+{
+	// 12 bytes are consumed per iteration, but 16 are loaded
+	while (inEnd - in >= 16 && outEnd - out >= 16)
+	{
+		auto str = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (in));
+		str = encodeTranslateSSSE3 (encodeReshuffleSSSE3 (str));
+		_mm_storeu_si128 (reinterpret_cast<__m128i*> (out), str);
+		in += 12;
+		out += 16;
+	}
+}
+
+//------------------------------------------------------------------------
+VSTGUI_BASE64_TARGET ("avx2")
+inline void decodeAVX2 (const uint8_t*& in, const uint8_t* inEnd, uint8_t*& out,
+                        const uint8_t* outEnd)
+{
+	const auto lutLo = _mm256_setr_epi8 (
+	    0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B,
+	    0x1A, 0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B,
+	    0x1B, 0x1A);
+	const auto lutHi = _mm256_setr_epi8 (
+	    0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+	    0x10, 0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+	    0x10, 0x10);
+	const auto lutRoll = _mm256_setr_epi8 (0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0,
+	                                       0, 0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0,
+	                                       0, 0);
+	const auto mask0F = _mm256_set1_epi8 (0x0F);
+	const auto mask2F = _mm256_set1_epi8 (0x2F);
+	const auto shuffle = _mm256_setr_epi8 (2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+	                                       2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+	const auto permute = _mm256_setr_epi32 (0, 1, 2, 4, 5, 6, -1, -1);
+
+	while (inEnd - in >= 32 && outEnd - out >= 32)
+	{
+		auto str = _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (in));
+		const auto hiNibbles = _mm256_and_si256 (_mm256_srli_epi32 (str, 4), mask0F);
+		const auto loNibbles = _mm256_and_si256 (str, mask0F);
+		const auto hi = _mm256_shuffle_epi8 (lutHi, hiNibbles);
+		const auto lo = _mm256_shuffle_epi8 (lutLo, loNibbles);
+		if (!_mm256_testz_si256 (lo, hi))
+			break;
+		const auto eq2F = _mm256_cmpeq_epi8 (str, mask2F);
+		const auto roll = _mm256_shuffle_epi8 (lutRoll, _mm256_add_epi8 (eq2F, hiNibbles));
+		str = _mm256_add_epi8 (str, roll);
+
+		const auto mergeAB = _mm256_maddubs_epi16 (str, _mm256_set1_epi32 (0x01400140));
+		const auto merged = _mm256_madd_epi16 (mergeAB, _mm256_set1_epi32 (0x00011000));
+		str = _mm256_shuffle_epi8 (merged, shuffle);
+		str = _mm256_permutevar8x32_epi32 (str, permute);
+		_mm256_storeu_si256 (reinterpret_cast<__m256i*> (out), str);
+		in += 32;
+		out += 24;
+	}
+	decodeSSSE3 (in, inEnd, out, outEnd);
+}
+
+//------------------------------------------------------------------------
+VSTGUI_BASE64_TARGET ("avx2")
+inline void encodeAVX2 (const uint8_t*& in, const uint8_t* inEnd, uint8_t*& out,
+                        const uint8_t* outEnd)
+{
+	const auto shuffle = _mm256_set_epi8 (10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1, 10,
+	                                      11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+	const auto lut = _mm256_setr_epi8 (65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0,
+	                                   0, 65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16,
+	                                   0, 0);
+	// 24 bytes are consumed per iteration, two lanes of 16 bytes each are loaded
+	while (inEnd - in >= 28 && outEnd - out >= 32)
+	{
+		auto str = _mm256_inserti128_si256 (
+		    _mm256_castsi128_si256 (_mm_loadu_si128 (reinterpret_cast<const __m128i*> (in))),
+		    _mm_loadu_si128 (reinterpret_cast<const __m128i*> (in + 12)), 1);
+		str = _mm256_shuffle_epi8 (str, shuffle);
+		const auto t0 = _mm256_and_si256 (str, _mm256_set1_epi32 (0x0FC0FC00));
+		const auto t1 = _mm256_mulhi_epu16 (t0, _mm256_set1_epi32 (0x04000040));
+		const auto t2 = _mm256_and_si256 (str, _mm256_set1_epi32 (0x003F03F0));
+		const auto t3 = _mm256_mullo_epi16 (t2, _mm256_set1_epi32 (0x01000010));
+		str = _mm256_or_si256 (t1, t3);
+
+		auto indices = _mm256_subs_epu8 (str, _mm256_set1_epi8 (51));
+		const auto mask = _mm256_cmpgt_epi8 (str, _mm256_set1_epi8 (25));
+		indices = _mm256_sub_epi8 (indices, mask);
+		str = _mm256_add_epi8 (str, _mm256_shuffle_epi8 (lut, indices));
+		_mm256_storeu_si256 (reinterpret_cast<__m256i*> (out), str);
+		in += 24;
+		out += 32;
+	}
+	encodeSSSE3 (in, inEnd, out, outEnd);
+}
+
+#endif // VSTGUI_BASE64_X86
+
+#if VSTGUI_BASE64_NEON
+//------------------------------------------------------------------------
+inline uint8x16x4_t loadTable64 (const uint8_t* table)
+{
+	uint8x16x4_t result;
+	result.val[0] = vld1q_u8 (table);
+	result.val[1] = vld1q_u8 (table + 16);
+	result.val[2] = vld1q_u8 (table + 32);
+	result.val[3] = vld1q_u8 (table + 48);
+	return result;
+}
+
+//------------------------------------------------------------------------
+inline void decodeNEON (const uint8_t*& in, const uint8_t* inEnd, uint8_t*& out,
+                        const uint8_t* outEnd, const uint8_t* decodeTable)
+{
+	const auto tableLo = loadTable64 (decodeTable);
+	const auto tableHi = loadTable64 (decodeTable + 64);
+	const auto offset = vdupq_n_u8 (64);
+
+	auto translate = [&] (uint8x16_t c) {
+		auto v = vqtbl4q_u8 (tableLo, c);
+		return vqtbx4q_u8 (v, tableHi, vsubq_u8 (c, offset));
+	};
+
+	while (inEnd - in >= 64 && outEnd - out >= 48)
+	{
+		auto str = vld4q_u8 (in);
+		const auto a = translate (str.val[0]);
+		const auto b = translate (str.val[1]);
+		const auto c = translate (str.val[2]);
+		const auto d = translate (str.val[3]);
+		// invalid table entries and non ascii characters have the top bit set
+		const auto check = vorrq_u8 (vorrq_u8 (vorrq_u8 (a, b), vorrq_u8 (c, d)),
+		                             vorrq_u8 (vorrq_u8 (str.val[0], str.val[1]),
+		                                       vorrq_u8 (str.val[2], str.val[3])));
+		if (vmaxvq_u8 (check) & 0x80)
+			break;
+		uint8x16x3_t result;
+		result.val[0] = vorrq_u8 (vshlq_n_u8 (a, 2), vshrq_n_u8 (b, 4));
+		result.val[1] = vorrq_u8 (vshlq_n_u8 (b, 4), vshrq_n_u8 (c, 2));
+		result.val[2] = vorrq_u8 (vshlq_n_u8 (c, 6), d);
+		vst3q_u8 (out, result);
+		in += 64;
+		out += 48;
+	}
+}
+
+//------------------------------------------------------------------------
+inline void encodeNEON (const uint8_t*& in, const uint8_t* inEnd, uint8_t*& out,
+                        const uint8_t* outEnd, const uint8_t* encodeTable)
+{
+	const auto table = loadTable64 (encodeTable);
+	const auto mask3F = vdupq_n_u8 (0x3F);
+	while (inEnd - in >= 48 && outEnd - out >= 64)
+	{
+		const auto str = vld3q_u8 (in);
+		uint8x16x4_t result;
+		result.val[0] = vshrq_n_u8 (str.val[0], 2);
+		result.val[1] =
+		    vandq_u8 (vorrq_u8 (vshlq_n_u8 (str.val[0], 4), vshrq_n_u8 (str.val[1], 4)), mask3F);
+		result.val[2] =
+		    vandq_u8 (vorrq_u8 (vshlq_n_u8 (str.val[1], 2), vshrq_n_u8 (str.val[2], 6)), mask3F);
+		result.val[3] = vandq_u8 (str.val[2], mask3F);
+		result.val[0] = vqtbl4q_u8 (table, result.val[0]);
+		result.val[1] = vqtbl4q_u8 (table, result.val[1]);
+		result.val[2] = vqtbl4q_u8 (table, result.val[2]);
+		result.val[3] = vqtbl4q_u8 (table, result.val[3]);
+		vst4q_u8 (out, result);
+		in += 48;
+		out += 64;
+	}
+}
+
+#endif // VSTGUI_BASE64_NEON
+
+//------------------------------------------------------------------------
+} // Base64
+} // Detail
+} // VSTGUI
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <locale>
+
 namespace VSTGUI {
 namespace Detail {
 
@@ -0,0 +1,389 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "uiexpressiongraph.h"
+#include "locale.h"
+#include "../../lib/cstring.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace VSTGUI {
+namespace Detail {
+
+//-----------------------------------------------------------------------------
+namespace {
+
+//-----------------------------------------------------------------------------
+inline bool startsWith (const std::string& str, const char* prefix)
+{
+	return str.compare (0, strlen (prefix), prefix) == 0;
+}
+
+//-----------------------------------------------------------------------------
+inline bool parseNumber (const char* str, size_t length, double& result)
+{
+	char* endPtr = nullptr;
+	result = strtod (str, &endPtr);
+	return endPtr == str + length;
+}
+
+//-----------------------------------------------------------------------------
+inline int32_t precedence (char op)
+{
+	return (op == '*' || op == '/') ? 2 : 1;
+}
+
+//-----------------------------------------------------------------------------
+} // anonymous
+
+//-----------------------------------------------------------------------------
+UIExpressionGraph::UIExpressionGraph (DefinitionFunc&& definitionFunc,
+                                      TagResolveFunc&& tagResolveFunc)
+: definitionFunc (std::move (definitionFunc)), tagResolveFunc (std::move (tagResolveFunc))
+{
+}
+
+//-----------------------------------------------------------------------------
+bool UIExpressionGraph::compile (const std::string& expression, Program& program)
+{
+	Locale localeResetter;
+
+	program.clear ();
+	double number;
+	if (parseNumber (expression.data (), expression.size (), number))
+	{
+		program.push_back ({Instruction::Type::Constant, number, {}});
+		return true;
+	}
+
+	// infix to postfix (shunting-yard). A leading sign of a (sub) expression is handled as 0 +/- x
+	std::vector<char> operators;
+	bool expectOperand = true;
+	bool atSubExpressionStart = true;
+
+	auto pushOperator = [&] (char op) {
+		switch (op)
+		{
+			case '+': program.push_back ({Instruction::Type::Add, 0., {}}); break;
+			case '-': program.push_back ({Instruction::Type::Subtract, 0., {}}); break;
+			case '*': program.push_back ({Instruction::Type::Multiply, 0., {}}); break;
+			case '/': program.push_back ({Instruction::Type::Divide, 0., {}}); break;
+		}
+	};
+	auto addOperand = [&] (std::string&& token) {
+		if (!expectOperand)
+			return false;
+		double value;
+		if (parseNumber (token.data (), token.size (), value))
+			program.push_back ({Instruction::Type::Constant, value, {}});
+		else if (startsWith (token, kTagPrefix) || startsWith (token, kVariablePrefix))
+			program.push_back ({Instruction::Type::Symbol, 0., std::move (token)});
+		else
+		{
+#if DEBUG
+			DebugPrint ("Substitution failed :%s\n", token.data ());
+#endif
+			return false;
+		}
+		expectOperand = false;
+		atSubExpressionStart = false;
+		return true;
+	};
+	auto addOperator = [&] (char op) {
+		switch (op)
+		{
+			case '(':
+			{
+				if (!expectOperand)
+					return false;
+				operators.push_back (op);
+				atSubExpressionStart = true;
+				return true;
+			}
+			case ')':
+			{
+				if (expectOperand)
+					return false;
+				while (!operators.empty () && operators.back () != '(')
+				{
+					pushOperator (operators.back ());
+					operators.pop_back ();
+				}
+				if (operators.empty ())
+					return false;
+				operators.pop_back ();
+				return true;
+			}
+			default:
+			{
+				if (expectOperand)
+				{
+					if (!atSubExpressionStart || op == '*' || op == '/')
+						return false;
+					program.push_back ({Instruction::Type::Constant, 0., {}});
+				}
+				while (!operators.empty () && operators.back () != '(' &&
+				       precedence (operators.back ()) >= precedence (op))
+				{
+					pushOperator (operators.back ());
+					operators.pop_back ();
+				}
+				operators.push_back (op);
+				expectOperand = true;
+				atSubExpressionStart = false;
+				return true;
+			}
+		}
+	};
+
+	UTF8CodePointIterator<std::string::const_iterator> start (expression.begin ());
+	UTF8CodePointIterator<std::string::const_iterator> end (expression.end ());
+	auto iterator = start;
+	for (; iterator != end; ++iterator)
+	{
+		auto codePoint = *iterator;
+		bool isSpace = isspace (codePoint);
+		bool isOperator = codePoint == '+' || codePoint == '-' || codePoint == '*' ||
+		                  codePoint == '/' || codePoint == '(' || codePoint == ')';
+		if (!isSpace && !isOperator)
+			continue;
+		if (start != iterator && !addOperand ({start.base (), iterator.base ()}))
+			return false;
+		if (isOperator && !addOperator (static_cast<char> (codePoint)))
+			return false;
+		start = iterator;
+		++start;
+	}
+	if (start != iterator && !addOperand ({start.base (), iterator.base ()}))
+		return false;
+	if (expectOperand)
+		return false;
+	while (!operators.empty ())
+	{
+		if (operators.back () == '(')
+			return false;
+		pushOperator (operators.back ());
+		operators.pop_back ();
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool UIExpressionGraph::compileEntry (const std::string& symbol, Entry& entry)
+{
+	Definition definition;
+	if (!definitionFunc (symbol, definition))
+	{
+		entry.isVolatile = definition.isVolatile;
+		entry.state = entry.isVolatile ? Entry::State::Uncompiled : Entry::State::Undefined;
+		return false;
+	}
+	entry.isVolatile = definition.isVolatile;
+	if (definition.type == Definition::Type::Value)
+	{
+		entry.program.clear ();
+		entry.program.push_back ({Instruction::Type::Constant, definition.value, {}});
+	}
+	else
+	{
+		++statistics.compilations;
+		if (!compile (definition.expression, entry.program))
+		{
+#if DEBUG
+			DebugPrint ("Wrong Expression: %s\n", definition.expression.data ());
+#endif
+			entry.program.clear ();
+			entry.state = Entry::State::Undefined;
+			return false;
+		}
+	}
+	for (const auto& instruction : entry.program)
+	{
+		if (instruction.type != Instruction::Type::Symbol ||
+		    std::find (entry.dependencies.begin (), entry.dependencies.end (),
+		               instruction.symbol) != entry.dependencies.end ())
+			continue;
+		entry.dependencies.push_back (instruction.symbol);
+		entries[instruction.symbol].dependents.emplace (symbol);
+	}
+	entry.state = Entry::State::Compiled;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool UIExpressionGraph::run (const Program& program, double& result, bool& isVolatile)
+{
+	std::vector<double> stack;
+	stack.reserve (program.size ());
+	for (const auto& instruction : program)
+	{
+		switch (instruction.type)
+		{
+			case Instruction::Type::Constant:
+			{
+				stack.push_back (instruction.value);
+				break;
+			}
+			case Instruction::Type::Symbol:
+			{
+				double value;
+				if (!evaluate (instruction.symbol, value, isVolatile))
+					return false;
+				stack.push_back (value);
+				break;
+			}
+			default:
+			{
+				if (stack.size () < 2)
+					return false;
+				auto rhs = stack.back ();
+				stack.pop_back ();
+				auto& lhs = stack.back ();
+				switch (instruction.type)
+				{
+					case Instruction::Type::Add: lhs += rhs; break;
+					case Instruction::Type::Subtract: lhs -= rhs; break;
+					case Instruction::Type::Multiply: lhs *= rhs; break;
+					case Instruction::Type::Divide: lhs /= rhs; break;
+					default: break;
+				}
+				break;
+			}
+		}
+	}
+	if (stack.size () != 1)
+		return false;
+	result = stack.back ();
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool UIExpressionGraph::evaluate (const std::string& symbol, double& result)
+{
+	bool isVolatile = false;
+	return evaluate (symbol, result, isVolatile);
+}
+
+//-----------------------------------------------------------------------------
+bool UIExpressionGraph::evaluate (const std::string& symbol, double& result, bool& isVolatile)
+{
+	auto& entry = entries[symbol];
+	switch (entry.state)
+	{
+		case Entry::State::Valid:
+		{
+			result = entry.value;
+			return true;
+		}
+		case Entry::State::Uncompiled:
+		{
+			if (!compileEntry (symbol, entry))
+			{
+				isVolatile |= entry.isVolatile;
+				return false;
+			}
+			break;
+		}
+		case Entry::State::Compiled:
+			break;
+		case Entry::State::Evaluating:
+		{
+#if DEBUG
+			DebugPrint ("Cyclic Expression: %s\n", symbol.data ());
+#endif
+			return false;
+		}
+		case Entry::State::Undefined:
+		case Entry::State::Failed:
+			return false;
+	}
+
+	++statistics.evaluations;
+	entry.state = Entry::State::Evaluating;
+	bool entryIsVolatile = entry.isVolatile;
+	double value = 0.;
+	bool success = run (entry.program, value, entryIsVolatile);
+	if (startsWith (symbol, kTagPrefix))
+	{
+		// control tags are integers and -1 is used for 'no tag'
+		auto tag = success ? static_cast<int32_t> (value) : -1;
+		if (tagResolveFunc)
+			tag = tagResolveFunc (symbol, tag);
+		value = tag;
+		success = tag != -1;
+	}
+	isVolatile |= entryIsVolatile;
+	if (entryIsVolatile)
+		entry.state = Entry::State::Compiled;
+	else
+	{
+		entry.state = success ? Entry::State::Valid : Entry::State::Failed;
+		entry.value = value;
+	}
+	if (success)
+		result = value;
+	return success;
+}
+
+//-----------------------------------------------------------------------------
+bool UIExpressionGraph::evaluateExpression (const std::string& expression, double& result)
+{
+	Program program;
+	++statistics.compilations;
+	if (!compile (expression, program))
+		return false;
+	bool isVolatile = false;
+	return run (program, result, isVolatile);
+}
+
+//-----------------------------------------------------------------------------
+void UIExpressionGraph::removeDependencies (const std::string& symbol, Entry& entry)
+{
+	for (const auto& dependency : entry.dependencies)
+	{
+		auto it = entries.find (dependency);
+		if (it != entries.end ())
+			it->second.dependents.erase (symbol);
+	}
+	entry.dependencies.clear ();
+}
+
+//-----------------------------------------------------------------------------
+void UIExpressionGraph::invalidate (const std::string& symbol)
+{
+	auto it = entries.find (symbol);
+	if (it == entries.end ())
+		return;
+	removeDependencies (symbol, it->second);
+	it->second.program.clear ();
+	it->second.state = Entry::State::Uncompiled;
+
+	std::vector<const std::string*> stack;
+	std::unordered_set<const Entry*> visited;
+	for (const auto& dependent : it->second.dependents)
+		stack.push_back (&dependent);
+	while (!stack.empty ())
+	{
+		auto entryIt = entries.find (*stack.back ());
+		stack.pop_back ();
+		if (entryIt == entries.end () || !visited.emplace (&entryIt->second).second)
+			continue;
+		auto& entry = entryIt->second;
+		if (entry.state == Entry::State::Valid || entry.state == Entry::State::Failed)
+			entry.state = Entry::State::Compiled;
+		for (const auto& dependent : entry.dependents)
+			stack.push_back (&dependent);
+	}
+}
+
+//-----------------------------------------------------------------------------
+void UIExpressionGraph::clear ()
+{
+	entries.clear ();
+}
+
+//------------------------------------------------------------------------
+} // Detail
+} // VSTGUI
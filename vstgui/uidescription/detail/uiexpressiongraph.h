@@ -0,0 +1,120 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#pragma once
+
+#include "../../lib/vstguibase.h"
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace VSTGUI {
+namespace Detail {
+
+//-----------------------------------------------------------------------------
+/** Compiled and cached evaluation of control tag and variable expressions.
+ *
+ *	Every symbol ("tag.name" or "var.name") is compiled once into a postfix program. Its value is
+ *	cached after the first evaluation and the symbols it references are recorded as dependencies,
+ *	so invalidating a symbol only invalidates the symbols which depend on it.
+ *	The definition of a symbol is requested lazily via the DefinitionFunc.
+ */
+class UIExpressionGraph
+{
+public:
+	struct Definition
+	{
+		enum class Type
+		{
+			Value,
+			Expression,
+		};
+		Type type {Type::Value};
+		double value {0.};
+		std::string expression;
+		/** the definition is not stored in the description and must be requested every time */
+		bool isVolatile {false};
+	};
+	/** return false if the symbol is not defined */
+	using DefinitionFunc = std::function<bool (const std::string& symbol, Definition& definition)>;
+	/** called with every evaluated control tag (-1 if the evaluation failed) before it is cached
+	 *	and used, returns the tag to use instead */
+	using TagResolveFunc = std::function<int32_t (const std::string& symbol, int32_t tag)>;
+
+	explicit UIExpressionGraph (DefinitionFunc&& definitionFunc,
+	                            TagResolveFunc&& tagResolveFunc = nullptr);
+
+	/** evaluate a symbol like "tag.name" or "var.name" */
+	bool evaluate (const std::string& symbol, double& result);
+	/** evaluate an expression which is not bound to a symbol */
+	bool evaluateExpression (const std::string& expression, double& result);
+
+	/** the definition of the symbol was changed, added or removed */
+	void invalidate (const std::string& symbol);
+	void clear ();
+
+	struct Statistics
+	{
+		uint64_t compilations {0};
+		uint64_t evaluations {0};
+	};
+	const Statistics& getStatistics () const { return statistics; }
+
+	static constexpr auto kTagPrefix = "tag.";
+	static constexpr auto kVariablePrefix = "var.";
+
+private:
+	struct Instruction
+	{
+		enum class Type : uint8_t
+		{
+			Constant,
+			Symbol,
+			Add,
+			Subtract,
+			Multiply,
+			Divide,
+		};
+		Type type;
+		double value {0.};
+		std::string symbol;
+	};
+	using Program = std::vector<Instruction>;
+
+	struct Entry
+	{
+		enum class State : uint8_t
+		{
+			Uncompiled,
+			Compiled,
+			Evaluating,
+			Valid,
+			Failed,
+			Undefined,
+		};
+		State state {State::Uncompiled};
+		bool isVolatile {false};
+		double value {0.};
+		Program program;
+		std::vector<std::string> dependencies;
+		std::unordered_set<std::string> dependents;
+	};
+
+	static bool compile (const std::string& expression, Program& program);
+	bool compileEntry (const std::string& symbol, Entry& entry);
+	bool evaluate (const std::string& symbol, double& result, bool& isVolatile);
+	bool run (const Program& program, double& result, bool& isVolatile);
+	void removeDependencies (const std::string& symbol, Entry& entry);
+
+	DefinitionFunc definitionFunc;
+	TagResolveFunc tagResolveFunc;
+	std::unordered_map<std::string, Entry> entries;
+	Statistics statistics;
+};
+
+//------------------------------------------------------------------------
+} // Detail
+} // VSTGUI
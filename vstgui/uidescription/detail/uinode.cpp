@@ -100,6 +100,21 @@ UICommentNode::UICommentNode (const std::string& comment) : UINode ("comment")
 UIVariableNode::UIVariableNode (const std::string& name,
                                 const SharedPointer<UIAttributes>& attributes)
 : UINode (name, attributes), type (kUnknown), number (0)
+{
+	parseValue ();
+}
+
+//-----------------------------------------------------------------------------
+void UIVariableNode::setValue (const std::string& value)
+{
+	attributes->setAttribute ("value", value);
+	type = kUnknown;
+	number = 0;
+	parseValue ();
+}
+
+//-----------------------------------------------------------------------------
+void UIVariableNode::parseValue ()
 {
 	const std::string* typeStr = attributes->getAttributeValue ("type");
 	const std::string* valueStr = attributes->getAttributeValue ("value");
@@ -217,7 +232,11 @@ void UIControlTagNode::setTagString (const std::string& str)
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
 UIBitmapNode::UIBitmapNode (const std::string& name, const SharedPointer<UIAttributes>& attributes)
-: UINode (name, attributes), bitmap (nullptr), filterProcessed (false), scaledBitmapsAdded (false)
+: UINode (name, attributes)
+, bitmap (nullptr)
+, filterProcessed (false)
+, scaledBitmapsAdded (false)
+, xmlDataReleased (false)
 {
 }
 
@@ -231,6 +250,7 @@ UIBitmapNode::~UIBitmapNode () noexcept
 //-----------------------------------------------------------------------------
 void UIBitmapNode::freePlatformResources ()
 {
+	restoreXMLData ();
 	if (bitmap)
 		bitmap->forget ();
 	bitmap = nullptr;
@@ -278,6 +298,12 @@ bool UIBitmapNode::hasXMLData () const
 //-----------------------------------------------------------------------------
 void UIBitmapNode::createXMLData (const std::string& pathHint)
 {
+	// the released bytes are the data the current bitmap was decoded from
+	if (xmlDataReleased)
+	{
+		restoreXMLData ();
+		return;
+	}
 	UINode* node = getChildren ().findChildNode ("data");
 	if (node)
 	{
@@ -310,26 +336,68 @@ void UIBitmapNode::createXMLData (const std::string& pathHint)
 				auto buffer =
 				    getPlatformFactory ().createBitmapMemoryPNGRepresentation (platformBitmap);
 				if (!buffer.empty ())
-				{
-					auto result = Base64Codec::encode (buffer.data (),
-					                                   static_cast<uint32_t> (buffer.size ()));
-					UINode* dataNode = new UINode ("data");
-					dataNode->getAttributes ()->setAttribute ("encoding", "base64");
-					dataNode->getData ().append (reinterpret_cast<const char*> (result.data.get ()),
-					                             static_cast<std::streamsize> (result.dataSize));
-					getChildren ().add (dataNode);
-				}
+					addXMLData (buffer.data (), buffer.size ());
 			}
 		}
 	}
 }
 
+//-----------------------------------------------------------------------------
+void UIBitmapNode::addXMLData (const void* binaryData, size_t binaryDataSize)
+{
+	auto result = Base64Codec::encode (binaryData, binaryDataSize);
+	UINode* dataNode = new UINode ("data");
+	dataNode->getAttributes ()->setAttribute ("encoding", "base64");
+	dataNode->getData ().append (reinterpret_cast<const char*> (result.data.get ()),
+	                             static_cast<std::streamsize> (result.dataSize));
+	getChildren ().add (dataNode);
+}
+
 //-----------------------------------------------------------------------------
 void UIBitmapNode::removeXMLData ()
 {
 	UINode* node = getChildren ().findChildNode ("data");
 	if (node)
 		getChildren ().remove (node);
+	xmlDataReleased = false;
+	std::vector<uint8_t> ().swap (releasedXMLData);
+}
+
+//-----------------------------------------------------------------------------
+void UIBitmapNode::releaseXMLData ()
+{
+	// Filters replace the platform bitmap, so the data is the only copy of the unfiltered image
+	for (auto& child : getChildren ())
+	{
+		if (child->getName () == "filter")
+			return;
+	}
+	auto node = dataNode ();
+	auto codecStr = node ? node->getAttributes ()->getAttributeValue ("encoding") : nullptr;
+	if (!codecStr || *codecStr != "base64")
+		return;
+	// Keep the decoded bytes, which are a quarter smaller than the base64 text. Encoding the
+	// platform bitmap again would not restore the original file, as it is premultiplied.
+	const auto& text = node->getData ();
+	releasedXMLData.resize ((text.size () / 4 + 1) * 3);
+	Base64Codec::DecodeReader reader (text.data (), text.size ());
+	size_t size = 0;
+	while (auto numBytes =
+	           reader.read (releasedXMLData.data () + size, releasedXMLData.size () - size))
+		size += numBytes;
+	releasedXMLData.resize (size);
+	getChildren ().remove (node);
+	xmlDataReleased = true;
+}
+
+//-----------------------------------------------------------------------------
+void UIBitmapNode::restoreXMLData ()
+{
+	if (!xmlDataReleased)
+		return;
+	xmlDataReleased = false;
+	addXMLData (releasedXMLData.data (), releasedXMLData.size ());
+	std::vector<uint8_t> ().swap (releasedXMLData);
 }
 
 //-----------------------------------------------------------------------------
@@ -352,19 +420,28 @@ UINode* UIBitmapNode::dataNode () const
 PlatformBitmapPtr UIBitmapNode::createBitmapFromDataNode () const
 {
 	if (auto node = dataNode ())
+		return decodePlatformBitmapFromData (*node, *attributes);
+	return nullptr;
+}
+
+//------------------------------------------------------------------------
+PlatformBitmapPtr UIBitmapNode::decodePlatformBitmapFromData (const UINode& dataNode,
+                                                             const UIAttributes& attributes)
+{
+	auto codecStr = dataNode.getAttributes ()->getAttributeValue ("encoding");
+	if (codecStr && *codecStr == "base64")
 	{
-		auto codecStr = node->getAttributes ()->getAttributeValue ("encoding");
-		if (codecStr && *codecStr == "base64")
+		const auto& data = dataNode.getData ();
+		Base64Codec::DecodeReader reader (data.data (), data.size ());
+		if (auto platformBitmap = getPlatformFactory ().createBitmapFromStream (
+		        [&] (void* buffer, uint32_t size) {
+			        return static_cast<uint32_t> (reader.read (buffer, size));
+		        }))
 		{
-			auto result = Base64Codec::decode (node->getData ());
-			if (auto platformBitmap = getPlatformFactory ().createBitmapFromMemory (
-			        result.data.get (), result.dataSize))
-			{
-				double scaleFactor = 1.;
-				if (attributes->getDoubleAttribute ("scale-factor", scaleFactor))
-					platformBitmap->setScaleFactor (scaleFactor);
-				return platformBitmap;
-			}
+			double scaleFactor = 1.;
+			if (attributes.getDoubleAttribute ("scale-factor", scaleFactor))
+				platformBitmap->setScaleFactor (scaleFactor);
+			return platformBitmap;
 		}
 	}
 	return nullptr;
@@ -405,7 +482,19 @@ CBitmap* UIBitmapNode::getBitmap (const std::string& pathHint)
 		if (bitmap && bitmap->getPlatformBitmap () == nullptr)
 		{
 			if (auto platformBitmap = createBitmapFromDataNode ())
+			{
 				bitmap->setPlatformBitmap (platformBitmap);
+			}
+			else if (platformBitmapLoader)
+			{
+				if ((platformBitmap = platformBitmapLoader ()))
+				{
+					double scaleFactor = 1.;
+					if (attributes->getDoubleAttribute ("scale-factor", scaleFactor))
+						platformBitmap->setScaleFactor (scaleFactor);
+					bitmap->setPlatformBitmap (platformBitmap);
+				}
+			}
 		}
 		if (bitmap && path && bitmap->getPlatformBitmap () &&
 		    bitmap->getPlatformBitmap ()->getScaleFactor () == 1.)
@@ -433,6 +522,86 @@ void UIBitmapNode::setBitmap (UTF8StringPtr bitmapName)
 	if (Detail::decodeScaleFactorFromName (name, scaleFactor))
 		attributes->setDoubleAttribute ("scale-factor", scaleFactor);
 	removeXMLData ();
+	platformBitmapLoader = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+void UIBitmapNode::setPlatformBitmapLoader (PlatformBitmapLoader&& loader)
+{
+	platformBitmapLoader = std::move (loader);
+}
+
+//-----------------------------------------------------------------------------
+PlatformBitmapPtr UIBitmapNode::decodePlatformBitmapFromPath (const UIAttributes& attributes,
+                                                             const std::string& pathHint)
+{
+	const std::string* path = attributes.getAttributeValue ("path");
+	if (!path)
+		return nullptr;
+	auto platformBitmap =
+	    getPlatformFactory ().createBitmap (CResourceDescription (path->c_str ()));
+	if (!platformBitmap && pathIsAbsolute (pathHint))
+	{
+		std::string absPath = pathHint;
+		if (removeLastPathComponent (absPath))
+		{
+			absPath += "/" + *path;
+			platformBitmap = getPlatformFactory ().createBitmapFromPath (absPath.c_str ());
+		}
+	}
+	if (platformBitmap)
+	{
+		double scaleFactor = 1.;
+		if (attributes.getDoubleAttribute ("scale-factor", scaleFactor) ||
+		    Detail::decodeScaleFactorFromName (*path, scaleFactor))
+			platformBitmap->setScaleFactor (scaleFactor);
+	}
+	return platformBitmap;
+}
+
+//-----------------------------------------------------------------------------
+PlatformBitmapPtr UIBitmapNode::decodePlatformBitmap (const std::string& pathHint) const
+{
+	if (auto platformBitmap = decodePlatformBitmapFromPath (*attributes, pathHint))
+		return platformBitmap;
+	if (auto platformBitmap = createBitmapFromDataNode ())
+		return platformBitmap;
+	if (platformBitmapLoader)
+	{
+		if (auto platformBitmap = platformBitmapLoader ())
+		{
+			double scaleFactor = 1.;
+			if (attributes->getDoubleAttribute ("scale-factor", scaleFactor))
+				platformBitmap->setScaleFactor (scaleFactor);
+			return platformBitmap;
+		}
+	}
+	return nullptr;
+}
+
+//-----------------------------------------------------------------------------
+double UIBitmapNode::getDeclaredScaleFactor () const
+{
+	double scaleFactor = 0.;
+	if (attributes->getDoubleAttribute ("scale-factor", scaleFactor))
+		return scaleFactor;
+	const std::string* path = attributes->getAttributeValue ("path");
+	if (path && Detail::decodeScaleFactorFromName (*path, scaleFactor))
+		return scaleFactor;
+	return 0.;
+}
+
+//-----------------------------------------------------------------------------
+bool UIBitmapNode::canDecodeAgain () const
+{
+	if (xmlDataReleased)
+		return false;
+	for (auto& child : getChildren ())
+	{
+		if (child->getName () == "filter")
+			return false;
+	}
+	return true;
 }
 
 //-----------------------------------------------------------------------------
@@ -461,6 +630,7 @@ void UIBitmapNode::setNinePartTiledOffset (const CRect* offsets)
 //-----------------------------------------------------------------------------
 void UIBitmapNode::invalidBitmap ()
 {
+	restoreXMLData ();
 	if (bitmap)
 		bitmap->forget ();
 	bitmap = nullptr;
@@ -8,6 +8,7 @@
 #include "../uidescriptionfwd.h"
 #include "../../lib/ccolor.h"
 #include "uidesclist.h"
+#include <vector>
 
 //------------------------------------------------------------------------
 namespace VSTGUI {
@@ -97,7 +98,11 @@ public:
 	double getNumber () const;
 	const std::string& getString () const;
 
+	void setValue (const std::string& value);
+
 protected:
+	void parseValue ();
+
 	Type type;
 	double number;
 };
@@ -123,6 +128,7 @@ class UIBitmapNode : public UINode
 public:
 	UIBitmapNode (const std::string& name, const SharedPointer<UIAttributes>& attributes);
 	CBitmap* getBitmap (const std::string& pathHint);
+	bool hasBitmap () const { return bitmap != nullptr; }
 	void setBitmap (UTF8StringPtr bitmapName);
 	void setNinePartTiledOffset (const CRect* offsets);
 	void invalidBitmap ();
@@ -134,18 +140,47 @@ public:
 	void createXMLData (const std::string& pathHint);
 	void removeXMLData ();
 	bool hasXMLData () const;
+	/** replace the xml data by its decoded bytes once the platform bitmap was created (not for
+	 *	bitmaps with filters), the data is restored before it is needed again */
+	void releaseXMLData ();
+
+	using PlatformBitmapLoader = std::function<PlatformBitmapPtr ()>;
+	/** the loader is asked for the platform bitmap when the node has neither a loadable path nor
+	 *	embedded data, used to defer decoding of bitmaps stored outside of the node tree */
+	void setPlatformBitmapLoader (PlatformBitmapLoader&& loader);
+	/** decode the platform bitmap without keeping it in the node and without releasing the xml
+	 *	data, used to load scaled variants lazily */
+	PlatformBitmapPtr decodePlatformBitmap (const std::string& pathHint) const;
+	/** decode the platform bitmap of the path attribute */
+	static PlatformBitmapPtr decodePlatformBitmapFromPath (const UIAttributes& attributes,
+	                                                       const std::string& pathHint);
+	/** decode the platform bitmap of the xml data node */
+	static PlatformBitmapPtr decodePlatformBitmapFromData (const UINode& dataNode,
+	                                                       const UIAttributes& attributes);
+	/** the xml data node if it is not empty */
+	UINode* dataNode () const;
+	/** the scale factor of the scale-factor attribute or of the path, zero if it has none */
+	double getDeclaredScaleFactor () const;
+	/** if the bitmap of the node can be decoded again, which is not the case with filters or when
+	 *	the xml data was released */
+	bool canDecodeAgain () const;
 
 	void freePlatformResources () override;
 
 protected:
 	~UIBitmapNode () noexcept override;
 	CBitmap* createBitmap (const std::string& str, CNinePartTiledDescription* partDesc) const;
+	void restoreXMLData ();
+	void addXMLData (const void* binaryData, size_t binaryDataSize);
 	PlatformBitmapPtr createBitmapFromDataNode () const;
 	static bool imagesEqual (IPlatformBitmap* b1, IPlatformBitmap* b2);
-	UINode* dataNode () const;
+	PlatformBitmapLoader platformBitmapLoader;
 	CBitmap* bitmap;
 	bool filterProcessed;
 	bool scaledBitmapsAdded;
+	bool xmlDataReleased;
+	/** the decoded bytes of the released xml data */
+	std::vector<uint8_t> releasedXMLData;
 };
 
 //-----------------------------------------------------------------------------
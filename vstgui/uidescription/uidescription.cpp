@@ -22,6 +22,7 @@
 #include "../lib/cbitmap.h"
 #include "../lib/cbitmapfilter.h"
 #include "../lib/dispatchlist.h"
+#include "../lib/vstguitrace.h"
 #include "../lib/platform/std_unorderedmap.h"
 #include "../lib/platform/iplatformbitmap.h"
 #include "../lib/platform/iplatformfont.h"
@@ -29,6 +30,7 @@
 #include "detail/parsecolor.h"
 #include "detail/scalefactorutils.h"
 #include "detail/uidesclist.h"
+#include "detail/uiexpressiongraph.h"
 #include "detail/uijsonpersistence.h"
 #include "detail/uinode.h"
 #include "detail/uiviewcreatorattributes.h"
@@ -36,8 +38,16 @@
 #include <sstream>
 #include <fstream>
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <deque>
+#include <future>
+#include <thread>
+
+#if WINDOWS
+	#include <objbase.h>
+#endif
 
 namespace VSTGUI {
 
@@ -96,6 +106,16 @@ struct UIDescription::Impl : ListenerProvider<Impl, UIDescriptionListener>
 	SharedPointer<UIDescription> sharedResources;
 	
 	mutable std::deque<IController*> subControllerStack;
+
+	uint32_t bitmapDecodeThreadCount {1};
+	double bitmapScaleFactor {1.};
+	bool lazyBitmapLoading {false};
+	mutable uint32_t createViewDepth {0};
+	mutable BitmapDecodeTrace bitmapDecodeTrace;
+
+	std::unique_ptr<Detail::UIExpressionGraph> expressionGraph;
+	/** used while a controller is set, the control tags are resolved by it and not cached */
+	std::unique_ptr<Detail::UIExpressionGraph> controllerExpressionGraph;
 	
 	Optional<UINode*> variableBaseNode;
 
@@ -247,6 +267,10 @@ bool UIDescription::parse ()
 {
 	if (parsed ())
 		return true;
+	if (impl->expressionGraph)
+		impl->expressionGraph->clear ();
+	if (impl->controllerExpressionGraph)
+		impl->controllerExpressionGraph->clear ();
 		
 	static auto parseUIDesc = [] (IContentProvider* contentProvider) -> SharedPointer<UINode> {
 		if (auto nodes = Detail::UIJsonDescReader::read (*contentProvider))
@@ -343,6 +367,84 @@ void UIDescription::setBitmapCreator2 (IBitmapCreator2* creator)
 	impl->bitmapCreator2 = creator;
 }
 
+//-----------------------------------------------------------------------------
+void UIDescription::setBitmapDecodeThreadCount (uint32_t count)
+{
+	impl->bitmapDecodeThreadCount = count;
+}
+
+//-----------------------------------------------------------------------------
+uint32_t UIDescription::getBitmapDecodeThreadCount () const
+{
+	return impl->bitmapDecodeThreadCount;
+}
+
+//-----------------------------------------------------------------------------
+auto UIDescription::getBitmapDecodeTrace () const -> const BitmapDecodeTrace&
+{
+	return impl->bitmapDecodeTrace;
+}
+
+//-----------------------------------------------------------------------------
+void UIDescription::setLazyBitmapLoading (bool state)
+{
+	impl->lazyBitmapLoading = state;
+}
+
+//-----------------------------------------------------------------------------
+bool UIDescription::getLazyBitmapLoading () const
+{
+	return impl->lazyBitmapLoading;
+}
+
+//-----------------------------------------------------------------------------
+void UIDescription::setBitmapScaleFactor (double scaleFactor)
+{
+	if (impl->bitmapScaleFactor == scaleFactor)
+		return;
+	impl->bitmapScaleFactor = scaleFactor;
+	auto bitmapsNode = getBaseNode (Detail::MainNodeNames::kBitmap);
+	if (!bitmapsNode)
+		return;
+	for (auto& child : bitmapsNode->getChildren ())
+	{
+		auto bitmapNode = dynamic_cast<Detail::UIBitmapNode*> (child);
+		if (!bitmapNode || !bitmapNode->hasBitmap ())
+			continue;
+		auto bitmap = bitmapNode->getBitmap (impl->filePath);
+		if (bitmap->hasLazyBitmaps ())
+			bitmap->selectScaleFactor (scaleFactor);
+	}
+}
+
+//-----------------------------------------------------------------------------
+double UIDescription::getBitmapScaleFactor () const
+{
+	return impl->bitmapScaleFactor;
+}
+
+//-----------------------------------------------------------------------------
+size_t UIDescription::getUnloadedBitmapMemorySize () const
+{
+	size_t result = 0;
+	auto bitmapsNode = getBaseNode (Detail::MainNodeNames::kBitmap);
+	if (!bitmapsNode)
+		return result;
+	for (auto& child : bitmapsNode->getChildren ())
+	{
+		auto bitmapNode = dynamic_cast<Detail::UIBitmapNode*> (child);
+		if (bitmapNode && bitmapNode->hasBitmap ())
+			result += bitmapNode->getBitmap (impl->filePath)->getUnloadedMemorySize ();
+	}
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+void UIDescription::onScaleFactorChanged (CFrame* frame, double newScaleFactor)
+{
+	setBitmapScaleFactor (newScaleFactor);
+}
+
 //-----------------------------------------------------------------------------
 static void FreeNodePlatformResources (Detail::UINode* node)
 {
@@ -443,6 +545,27 @@ bool UIDescription::save (UTF8StringPtr filename, int32_t flags, AttributeSaveFi
 
 //-----------------------------------------------------------------------------
 bool UIDescription::saveToStream (OutputStream& stream, int32_t flags, AttributeSaveFilterFunc func)
+{
+	prepareNodesForSave (flags, func);
+
+	BufferedOutputStream bufferedStream (stream);
+	if (flags & kWriteAsXML)
+	{
+#if VSTGUI_ENABLE_XML_PARSER
+		Detail::UIXMLDescWriter writer;
+		return writer.write (bufferedStream, impl->nodes);
+#else
+#if DEBUG
+		DebugPrint ("XML not available.");
+#endif
+		return false;
+#endif
+	}
+	return Detail::UIJsonDescWriter::write (bufferedStream, impl->nodes);
+}
+
+//-----------------------------------------------------------------------------
+void UIDescription::prepareNodesForSave (int32_t flags, AttributeSaveFilterFunc func)
 {
 	impl->attributeSaveFilterFunc = func;
 	impl->forEachListener ([this] (UIDescriptionListener* l) {
@@ -470,21 +593,6 @@ bool UIDescription::saveToStream (OutputStream& stream, int32_t flags, Attribute
 		}
 	}
 	impl->nodes->getAttributes ()->setAttribute ("version", "1");
-	
-	BufferedOutputStream bufferedStream (stream);
-	if (flags & kWriteAsXML)
-	{
-#if VSTGUI_ENABLE_XML_PARSER
-		Detail::UIXMLDescWriter writer;
-		return writer.write (bufferedStream, impl->nodes);
-#else
-#if DEBUG
-		DebugPrint ("XML not available.");
-#endif
-		return false;
-#endif
-	}
-	return Detail::UIJsonDescWriter::write (bufferedStream, impl->nodes);
 }
 
 //-----------------------------------------------------------------------------
@@ -747,6 +855,7 @@ CViewAttributeID UIDescription::kTemplateNameAttributeID = 'uitl';
 //-----------------------------------------------------------------------------
 CView* UIDescription::createView (UTF8StringPtr name, IController* _controller) const
 {
+	VSTGUI_TRACE_OBJECT_SCOPE ("UIDescription::createView", this);
 	ScopePointer<IController> sp (&impl->controller, _controller);
 	if (impl->nodes)
 	{
@@ -757,7 +866,11 @@ CView* UIDescription::createView (UTF8StringPtr name, IController* _controller)
 				const std::string* nodeName = itNode->getAttributes ()->getAttributeValue ("name");
 				if (nodeName && *nodeName == name)
 				{
+					if (impl->createViewDepth == 0)
+						decodeBitmaps (itNode);
+					++impl->createViewDepth;
 					CView* view = createViewFromNode (itNode);
+					--impl->createViewDepth;
 					if (view)
 						view->setAttribute (kTemplateNameAttributeID, static_cast<uint32_t> (strlen (name) + 1), name);
 					return view;
@@ -840,27 +953,12 @@ Detail::UINode* UIDescription::findChildNodeByNameAttribute (UINode* node, UTF8S
 //-----------------------------------------------------------------------------
 int32_t UIDescription::getTagForName (UTF8StringPtr name) const
 {
-	int32_t tag = -1;
-	if (auto* controlTagNode = dynamic_cast<Detail::UIControlTagNode*> (findChildNodeByNameAttribute (getBaseNode (Detail::MainNodeNames::kControlTag), name)))
-	{
-		tag = controlTagNode->getTag ();
-		if (tag == -1)
-		{
-			const std::string* tagStr = controlTagNode->getTagString ();
-			if (tagStr)
-			{
-				double value;
-				if (calculateStringValue (tagStr->c_str (), value))
-				{
-					tag = (int32_t)value;
-					controlTagNode->setTag (tag);
-				}
-			}
-		}
-	}
-	if (impl->controller)
-		tag = impl->controller->getTagForName (name, tag);
-	return tag;
+	// the expression graph of the current controller passes the tag to it, and on every lookup
+	// also the tags referenced by its expression
+	double value;
+	if (getExpressionGraph ().evaluate (Detail::UIExpressionGraph::kTagPrefix + std::string (name), value))
+		return static_cast<int32_t> (value);
+	return -1;
 }
 
 //-----------------------------------------------------------------------------
@@ -906,6 +1004,292 @@ IControlListener* UIDescription::getControlListener (UTF8StringPtr name) const
 	return nullptr;
 }
 
+//-----------------------------------------------------------------------------
+using BitmapFilterList = std::list<SharedPointer<BitmapFilter::IFilter>>;
+
+//-----------------------------------------------------------------------------
+static BitmapFilterList createBitmapFilters (Detail::UINode* bitmapNode,
+                                             const IUIDescription* description)
+{
+	BitmapFilterList filters;
+	for (auto& childNode : bitmapNode->getChildren ())
+	{
+		const std::string* filterName = nullptr;
+		if (childNode->getName () == "filter" && (filterName = childNode->getAttributes ()->getAttributeValue ("name")))
+		{
+			auto filter = owned (BitmapFilter::Factory::getInstance().createFilter (filterName->c_str ()));
+			if (filter == nullptr)
+				continue;
+			filters.emplace_back (filter);
+			for (auto& propertyNode : childNode->getChildren ())
+			{
+				if (propertyNode->getName () != "property")
+					continue;
+				const std::string* propName = propertyNode->getAttributes ()->getAttributeValue ("name");
+				if (propName == nullptr)
+					continue;
+				switch (filter->getProperty (propName->c_str ()).getType ())
+				{
+					case BitmapFilter::Property::kInteger:
+					{
+						int32_t intValue;
+						if (propertyNode->getAttributes ()->getIntegerAttribute ("value", intValue))
+							filter->setProperty (propName->c_str (), intValue);
+						break;
+					}
+					case BitmapFilter::Property::kFloat:
+					{
+						double floatValue;
+						if (propertyNode->getAttributes ()->getDoubleAttribute ("value", floatValue))
+							filter->setProperty (propName->c_str (), floatValue);
+						break;
+					}
+					case BitmapFilter::Property::kPoint:
+					{
+						CPoint pointValue;
+						if (propertyNode->getAttributes ()->getPointAttribute ("value", pointValue))
+							filter->setProperty (propName->c_str (), pointValue);
+						break;
+					}
+					case BitmapFilter::Property::kRect:
+					{
+						CRect rectValue;
+						if (propertyNode->getAttributes ()->getRectAttribute ("value", rectValue))
+							filter->setProperty (propName->c_str (), rectValue);
+						break;
+					}
+					case BitmapFilter::Property::kColor:
+					{
+						const std::string* colorString = propertyNode->getAttributes()->getAttributeValue ("value");
+						if (colorString)
+						{
+							CColor color;
+							if (description->getColor (colorString->c_str (), color))
+								filter->setProperty(propName->c_str (), color);
+						}
+						break;
+					}
+					case BitmapFilter::Property::kTransformMatrix:
+					{
+						// TODO
+						break;
+					}
+					case BitmapFilter::Property::kObject: // objects can not be stored/restored
+					case BitmapFilter::Property::kUnknown:
+						break;
+				}
+			}
+		}
+	}
+	return filters;
+}
+
+//-----------------------------------------------------------------------------
+static void runBitmapFilters (CBitmap* bitmap, const BitmapFilterList& filters)
+{
+	for (auto& filter : filters)
+	{
+		filter->setProperty (BitmapFilter::Standard::Property::kInputBitmap, bitmap);
+		if (filter->run ())
+		{
+			auto obj = filter->getProperty (BitmapFilter::Standard::Property::kOutputBitmap).getObject ();
+			if (auto* outputBitmap = dynamic_cast<CBitmap*>(obj))
+			{
+				bitmap->setPlatformBitmap (outputBitmap->getPlatformBitmap ());
+			}
+		}
+	}
+}
+
+#if WINDOWS
+//-----------------------------------------------------------------------------
+/** the WIC decoders of the Windows bitmaps need COM on the threads of the decode pre-pass */
+struct ScopedCOMInitialization
+{
+	ScopedCOMInitialization ()
+	: initialized (SUCCEEDED (CoInitializeEx (nullptr, COINIT_MULTITHREADED)))
+	{
+	}
+	~ScopedCOMInitialization () noexcept
+	{
+		if (initialized)
+			CoUninitialize ();
+	}
+
+	// false if the thread already uses another apartment model, COM can be used anyway
+	bool initialized;
+};
+#endif
+
+//-----------------------------------------------------------------------------
+struct TemplateBitmapNodeCollector
+{
+	std::unordered_map<std::string, Detail::UINode*> bitmaps;
+	std::unordered_map<std::string, Detail::UINode*> templates;
+	std::vector<Detail::UINode*> bitmapNodes;
+	std::vector<const Detail::UINode*> visitedTemplates;
+
+	TemplateBitmapNodeCollector (Detail::UINode* bitmapsNode, Detail::UINode* mainNode)
+	{
+		for (const auto& child : bitmapsNode->getChildren ())
+		{
+			const auto* name = child->getAttributes ()->getAttributeValue ("name");
+			if (name && dynamic_cast<Detail::UIBitmapNode*> (child))
+				bitmaps.emplace (*name, child);
+		}
+		for (const auto& child : mainNode->getChildren ())
+		{
+			if (child->getName () != Detail::MainNodeNames::kTemplate)
+				continue;
+			if (const auto* name = child->getAttributes ()->getAttributeValue ("name"))
+				templates.emplace (*name, child);
+		}
+	}
+
+	void collect (Detail::UINode* node)
+	{
+		// only the values of the bitmap attributes of the view class are references to bitmaps
+		const auto* viewClass = node->getAttributes ()->getAttributeValue (UIViewCreator::kAttrClass);
+		for (const auto& attribute : *node->getAttributes ())
+		{
+			if (attribute.first == Detail::MainNodeNames::kTemplate)
+			{
+				auto it = templates.find (attribute.second);
+				if (it != templates.end () &&
+				    std::find (visitedTemplates.begin (), visitedTemplates.end (), it->second) ==
+				        visitedTemplates.end ())
+				{
+					visitedTemplates.emplace_back (it->second);
+					collect (it->second);
+				}
+				continue;
+			}
+			if (viewClass == nullptr ||
+			    UIViewFactory::getAttributeTypeForViewName (*viewClass, attribute.first) !=
+			        IViewCreator::kBitmapType)
+				continue;
+			auto it = bitmaps.find (attribute.second);
+			if (it != bitmaps.end () &&
+			    std::find (bitmapNodes.begin (), bitmapNodes.end (), it->second) == bitmapNodes.end ())
+				bitmapNodes.emplace_back (it->second);
+		}
+		for (const auto& child : node->getChildren ())
+		{
+			if (child->getName () == "view")
+				collect (child);
+		}
+	}
+};
+
+//-----------------------------------------------------------------------------
+void UIDescription::decodeBitmaps (UINode* templateNode) const
+{
+	using Clock = std::chrono::steady_clock;
+	using Milliseconds = std::chrono::duration<double, std::milli>;
+
+	impl->bitmapDecodeTrace.clear ();
+	auto numThreads = impl->bitmapDecodeThreadCount;
+	if (numThreads == 0)
+		numThreads = std::thread::hardware_concurrency ();
+	UINode* bitmapsNode = getBaseNode (Detail::MainNodeNames::kBitmap);
+	if (numThreads <= 1 || bitmapsNode == nullptr)
+		return;
+
+	TemplateBitmapNodeCollector collector (bitmapsNode, impl->nodes);
+	collector.visitedTemplates.emplace_back (templateNode);
+	collector.collect (templateNode);
+	auto& bitmapNodes = collector.bitmapNodes;
+	if (bitmapNodes.empty ())
+		return;
+
+	// the scaled variants of a bitmap are added to it in getBitmap, so decode them too, unless
+	// they are loaded lazily
+	std::vector<std::string> baseNames;
+	for (auto node : bitmapNodes)
+	{
+		if (const auto* name = node->getAttributes ()->getAttributeValue ("name"))
+		{
+			auto baseName = Detail::removeScaleFactorFromName (*name);
+			baseNames.emplace_back (baseName.empty () ? *name : baseName);
+		}
+	}
+	for (const auto& child : bitmapsNode->getChildren ())
+	{
+		if (impl->lazyBitmapLoading)
+			break;
+		const auto* childName = child->getAttributes ()->getAttributeValue ("name");
+		if (!childName)
+			continue;
+		auto baseName = Detail::removeScaleFactorFromName (*childName);
+		if (baseName.empty () ||
+		    std::find (baseNames.begin (), baseNames.end (), baseName) == baseNames.end ())
+			continue;
+		if (std::find (bitmapNodes.begin (), bitmapNodes.end (), child) == bitmapNodes.end () &&
+		    dynamic_cast<Detail::UIBitmapNode*> (child))
+			bitmapNodes.emplace_back (child);
+	}
+
+	// the filters are created here as they may look up other resources of this description
+	struct Job
+	{
+		Detail::UIBitmapNode* node;
+		BitmapFilterList filters;
+	};
+	std::vector<Job> jobs;
+	for (auto node : bitmapNodes)
+	{
+		auto bitmapNode = static_cast<Detail::UIBitmapNode*> (node);
+		if (bitmapNode->hasBitmap () || bitmapNode->getFilterProcessed ())
+			continue;
+		jobs.push_back ({bitmapNode, createBitmapFilters (bitmapNode, this)});
+		BitmapDecodeTraceEntry entry;
+		if (const auto* name = bitmapNode->getAttributes ()->getAttributeValue ("name"))
+			entry.name = *name;
+		impl->bitmapDecodeTrace.emplace_back (std::move (entry));
+	}
+	if (jobs.empty ())
+		return;
+
+	std::atomic<size_t> nextJob {0};
+	auto decode = [&] (uint32_t threadIndex) {
+		size_t index;
+		while ((index = nextJob++) < jobs.size ())
+		{
+			auto& job = jobs[index];
+			auto& trace = impl->bitmapDecodeTrace[index];
+			trace.threadIndex = threadIndex;
+			auto start = Clock::now ();
+			auto bitmap = job.node->getBitmap (impl->filePath);
+			auto decoded = Clock::now ();
+			trace.decodeMilliseconds = Milliseconds (decoded - start).count ();
+			if (bitmap && bitmap->getPlatformBitmap () == nullptr)
+			{
+				// leave it to getBitmap, which asks the bitmap creators
+				job.node->invalidBitmap ();
+				continue;
+			}
+			if (bitmap)
+			{
+				runBitmapFilters (bitmap, job.filters);
+				job.node->setFilterProcessed ();
+				trace.filterMilliseconds = Milliseconds (Clock::now () - decoded).count ();
+			}
+		}
+	};
+	std::vector<std::future<void>> workers;
+	numThreads = std::min (numThreads, static_cast<uint32_t> (jobs.size ()));
+	for (auto i = 1u; i < numThreads; ++i)
+		workers.emplace_back (std::async (std::launch::async, [&decode, i] () {
+#if WINDOWS
+			ScopedCOMInitialization comInitialization;
+#endif
+			decode (i);
+		}));
+	decode (0);
+	for (auto& worker : workers)
+		worker.wait ();
+}
+
 //-----------------------------------------------------------------------------
 CBitmap* UIDescription::getBitmap (UTF8StringPtr name) const
 {
@@ -940,88 +1324,7 @@ CBitmap* UIDescription::getBitmap (UTF8StringPtr name) const
 		}
 		if (bitmap && bitmapNode->getFilterProcessed () == false)
 		{
-			std::list<SharedPointer<BitmapFilter::IFilter> > filters;
-			for (auto& childNode : bitmapNode->getChildren ())
-			{
-				const std::string* filterName = nullptr;
-				if (childNode->getName () == "filter" && (filterName = childNode->getAttributes ()->getAttributeValue ("name")))
-				{
-					auto filter = owned (BitmapFilter::Factory::getInstance().createFilter (filterName->c_str ()));
-					if (filter == nullptr)
-						continue;
-					filters.emplace_back (filter);
-					for (auto& propertyNode : childNode->getChildren ())
-					{
-						if (propertyNode->getName () != "property")
-							continue;
-						const std::string* propName = propertyNode->getAttributes ()->getAttributeValue ("name");
-						if (propName == nullptr)
-							continue;
-						switch (filter->getProperty (propName->c_str ()).getType ())
-						{
-							case BitmapFilter::Property::kInteger:
-							{
-								int32_t intValue;
-								if (propertyNode->getAttributes ()->getIntegerAttribute ("value", intValue))
-									filter->setProperty (propName->c_str (), intValue);
-								break;
-							}
-							case BitmapFilter::Property::kFloat:
-							{
-								double floatValue;
-								if (propertyNode->getAttributes ()->getDoubleAttribute ("value", floatValue))
-									filter->setProperty (propName->c_str (), floatValue);
-								break;
-							}
-							case BitmapFilter::Property::kPoint:
-							{
-								CPoint pointValue;
-								if (propertyNode->getAttributes ()->getPointAttribute ("value", pointValue))
-									filter->setProperty (propName->c_str (), pointValue);
-								break;
-							}
-							case BitmapFilter::Property::kRect:
-							{
-								CRect rectValue;
-								if (propertyNode->getAttributes ()->getRectAttribute ("value", rectValue))
-									filter->setProperty (propName->c_str (), rectValue);
-								break;
-							}
-							case BitmapFilter::Property::kColor:
-							{
-								const std::string* colorString = propertyNode->getAttributes()->getAttributeValue ("value");
-								if (colorString)
-								{
-									CColor color;
-									if (getColor (colorString->c_str (), color))
-										filter->setProperty(propName->c_str (), color);
-								}
-								break;
-							}
-							case BitmapFilter::Property::kTransformMatrix:
-							{
-								// TODO
-								break;
-							}
-							case BitmapFilter::Property::kObject: // objects can not be stored/restored
-							case BitmapFilter::Property::kUnknown:
-								break;
-						}
-					}
-				}
-			}
-			for (auto& filter : filters)
-			{
-				filter->setProperty (BitmapFilter::Standard::Property::kInputBitmap, bitmap);
-				if (filter->run ())
-				{
-					auto obj = filter->getProperty (BitmapFilter::Standard::Property::kOutputBitmap).getObject ();
-					if (auto* outputBitmap = dynamic_cast<CBitmap*>(obj))
-					{
-						bitmap->setPlatformBitmap (outputBitmap->getPlatformBitmap ());
-					}
-				}
-			}
+			runBitmapFilters (bitmap, createBitmapFilters (bitmapNode, this));
 			bitmapNode->setFilterProcessed ();
 		}
 		if (bitmap && bitmapNode->getScaledBitmapsAdded () == false)
@@ -1047,14 +1350,54 @@ CBitmap* UIDescription::getBitmap (UTF8StringPtr name) const
 					if (nameWithoutScaleFactor == bitmapName)
 					{
 						childNode->setScaledBitmapsAdded ();
+						auto childScaleFactor = childNode->getDeclaredScaleFactor ();
+						if (impl->lazyBitmapLoading && childNode->canDecodeAgain () &&
+						    childScaleFactor > 0.)
+						{
+							bitmap->addLazyBitmap (
+							    childScaleFactor, [node = shared (childNode),
+							                       filePath = impl->filePath] () -> PlatformBitmapPtr {
+								    // the variant may have been loaded by its own name
+								    if (node->hasBitmap ())
+									    return node->getBitmap (filePath)->getPlatformBitmap ();
+								    return node->decodePlatformBitmap (filePath);
+							    });
+							continue;
+						}
 						CBitmap* childBitmap = getBitmap (childNodeBitmapName->c_str ());
 						if (childBitmap && childBitmap->getPlatformBitmap ())
 							bitmap->addBitmap (childBitmap->getPlatformBitmap ());
 					}
 				}
+				if (bitmap->hasLazyBitmaps () && bitmap->getPlatformBitmap ())
+				{
+					// the bitmap must not keep its own node alive, so it only gets the attributes
+					// and the data node
+					if (bitmapNode->canDecodeAgain () &&
+					    (bitmapNode->dataNode () || bitmapNode->getAttributes ()->hasAttribute ("path")))
+					{
+						bitmap->addLazyBitmap (
+						    bitmap->getPlatformBitmap ()->getScaleFactor (),
+						    [attributes = bitmapNode->getAttributes (),
+						     data = shared (bitmapNode->dataNode ()),
+						     filePath = impl->filePath] () -> PlatformBitmapPtr {
+							    using Detail::UIBitmapNode;
+							    if (auto platformBitmap =
+							            UIBitmapNode::decodePlatformBitmapFromPath (*attributes, filePath))
+								    return platformBitmap;
+							    if (data)
+								    return UIBitmapNode::decodePlatformBitmapFromData (*data, *attributes);
+							    return nullptr;
+						    });
+					}
+					bitmap->selectScaleFactor (impl->bitmapScaleFactor);
+				}
 			}
 			bitmapNode->setScaledBitmapsAdded ();
 		}
+		// lazily loaded bitmaps decode their data again when the scale factor changes
+		if (bitmap && bitmap->getPlatformBitmap () && !bitmap->hasLazyBitmaps ())
+			bitmapNode->releaseXMLData ();
 		return bitmap;
 	}
 	return nullptr;
@@ -1152,8 +1495,11 @@ UTF8StringPtr UIDescription::lookupControlTagName (const int32_t tag) const
 		if (nodeTag == -1 && node->getTagString ())
 		{
 			double v;
-			if (desc->calculateStringValue (node->getTagString ()->c_str (), v))
-				nodeTag = (int32_t)v;
+			if (auto name = node->getAttributes ()->getAttributeValue ("name"))
+			{
+				if (desc->getExpressionGraph ().evaluate (Detail::UIExpressionGraph::kTagPrefix + *name, v))
+					nodeTag = static_cast<int32_t> (v);
+			}
 		}
 		return nodeTag == tag;
 	});
@@ -1186,6 +1532,8 @@ void UIDescription::changeColorName (UTF8StringPtr oldName, UTF8StringPtr newNam
 void UIDescription::changeTagName (UTF8StringPtr oldName, UTF8StringPtr newName)
 {
 	changeNodeName<Detail::UIControlTagNode> (oldName, newName, Detail::MainNodeNames::kControlTag);
+	invalidateExpression (Detail::UIExpressionGraph::kTagPrefix, oldName);
+	invalidateExpression (Detail::UIExpressionGraph::kTagPrefix, newName);
 	impl->forEachListener ([this] (UIDescriptionListener* l) {
 		l->onUIDescTagChanged (this);
 	});
@@ -1455,6 +1803,7 @@ void UIDescription::removeColor (UTF8StringPtr name)
 void UIDescription::removeTag (UTF8StringPtr name)
 {
 	removeNode (name, Detail::MainNodeNames::kControlTag);
+	invalidateExpression (Detail::UIExpressionGraph::kTagPrefix, name);
 	impl->forEachListener ([this] (UIDescriptionListener* l) {
 		l->onUIDescTagChanged (this);
 	});
@@ -1856,6 +2205,7 @@ bool UIDescription::changeControlTagString  (UTF8StringPtr tagName, const std::s
 		if (create)
 			return false;
 		controlTagNode->setTagString (newTagString);
+		invalidateExpression (Detail::UIExpressionGraph::kTagPrefix, tagName);
 		impl->forEachListener ([this](UIDescriptionListener* l) { l->onUIDescTagChanged (this); });
 		return true;
 	}
@@ -1869,6 +2219,7 @@ bool UIDescription::changeControlTagString  (UTF8StringPtr tagName, const std::s
 			node->setTagString (newTagString);
 			tagsNode->getChildren ().add (node);
 			tagsNode->sortChildren ();
+			invalidateExpression (Detail::UIExpressionGraph::kTagPrefix, tagName);
 			impl->forEachListener ([this] (UIDescriptionListener* l) {
 				l->onUIDescTagChanged (this);
 			});
@@ -1893,7 +2244,7 @@ bool UIDescription::getVariable (UTF8StringPtr name, double& value) const
 		if (node->getType () == Detail::UIVariableNode::kString)
 		{
 			double v;
-			if (calculateStringValue (node->getString ().c_str (), v))
+			if (getExpressionGraph ().evaluate (Detail::UIExpressionGraph::kVariablePrefix + std::string (name), v))
 			{
 				value = v;
 				return true;
@@ -1915,320 +2266,133 @@ bool UIDescription::getVariable (UTF8StringPtr name, std::string& value) const
 	return false;
 }
 
-namespace UIDescriptionPrivate {
-
-using Locale = Detail::Locale;
-
 //-----------------------------------------------------------------------------
-class StringToken : public std::string
+bool UIDescription::changeVariable (UTF8StringPtr name, const std::string& value, bool create)
 {
-public:
-	enum Type {
-		kString,
-		kAdd,
-		kSubtract,
-		kMulitply,
-		kDivide,
-		kOpenParenthesis,
-		kCloseParenthesis,
-		kResult
-	};
-	
-	explicit StringToken (const std::string& str) : std::string (str), type (kString), result (0) {}
-	StringToken (const StringToken& token) = default;
-	StringToken (Type type, double value = 0) : type (type), result (value) {}
-	
-	Type type;
-	double result;
-};
-
-using StringTokenList = std::list<StringToken>;
-	
-//-----------------------------------------------------------------------------
-static bool tokenizeString (std::string& str, StringTokenList& tokens)
-{
-	UTF8CodePointIterator<std::string::const_iterator> start (str.begin ());
-	UTF8CodePointIterator<std::string::const_iterator> end (str.end ());
-	auto iterator = start;
-	while (iterator != end)
+	UINode* variablesNode = impl->getVariableBaseNode ();
+	if (auto* node = dynamic_cast<Detail::UIVariableNode*> (findChildNodeByNameAttribute (variablesNode, name)))
 	{
-		auto codePoint = *iterator;
-		if (isspace (codePoint))
+		if (create)
+			return false;
+		node->setValue (value);
+		invalidateExpression (Detail::UIExpressionGraph::kVariablePrefix, name);
+		return true;
+	}
+	if (create)
+	{
+		if (!variablesNode)
 		{
-			if (start != iterator)
-				tokens.emplace_back (std::string {start.base (), iterator.base ()});
-			start = iterator;
-			++start;
+			variablesNode = getBaseNode (Detail::MainNodeNames::kVariable);
+			impl->variableBaseNode.reset ();
 		}
-		else
+		if (variablesNode)
 		{
-			switch (codePoint)
-			{
-				case '+':
-				{
-					if (start != iterator)
-						tokens.emplace_back (std::string {start.base (), iterator.base ()});
-					tokens.emplace_back (StringToken::kAdd);
-					start = iterator;
-					++start;
-					break;
-				}
-				case '-':
-				{
-					if (start != iterator)
-						tokens.emplace_back (std::string {start.base (), iterator.base ()});
-					tokens.emplace_back (StringToken::kSubtract);
-					start = iterator;
-					++start;
-					break;
-				}
-				case '*':
-				{
-					if (start != iterator)
-						tokens.emplace_back (std::string {start.base (), iterator.base ()});
-					tokens.emplace_back (StringToken::kMulitply);
-					start = iterator;
-					++start;
-					break;
-				}
-				case '/':
-				{
-					if (start != iterator)
-						tokens.emplace_back (std::string {start.base (), iterator.base ()});
-					tokens.emplace_back (StringToken::kDivide);
-					start = iterator;
-					++start;
-					break;
-				}
-				case '(':
-				{
-					if (start != iterator)
-						tokens.emplace_back (std::string {start.base (), iterator.base ()});
-					tokens.emplace_back (StringToken::kOpenParenthesis);
-					start = iterator;
-					++start;
-					break;
-				}
-				case ')':
-				{
-					if (start != iterator)
-						tokens.emplace_back (std::string {start.base (), iterator.base ()});
-					tokens.emplace_back (StringToken::kCloseParenthesis);
-					start = iterator;
-					++start;
-					break;
-				}
-			}
+			auto attr = makeOwned<UIAttributes> ();
+			attr->setAttribute ("name", name);
+			attr->setAttribute ("value", value);
+			variablesNode->getChildren ().add (new Detail::UIVariableNode ("var", attr));
+			variablesNode->sortChildren ();
+			invalidateExpression (Detail::UIExpressionGraph::kVariablePrefix, name);
+			return true;
 		}
-		++iterator;
 	}
-	if (start != iterator)
-		tokens.emplace_back (std::string {start.base (), iterator.base ()});
-	return true;
+	return false;
 }
 
 //-----------------------------------------------------------------------------
-static bool computeTokens (StringTokenList& tokens, double& result)
+Detail::UIExpressionGraph& UIDescription::getExpressionGraph () const
 {
-	int32_t openCount = 0;
-	StringTokenList::iterator openPosition = tokens.end ();
-	// first check parentheses
-	for (StringTokenList::iterator it = tokens.begin (); it != tokens.end (); ++it)
+	bool withController = impl->controller != nullptr;
+	auto& graph = withController ? impl->controllerExpressionGraph : impl->expressionGraph;
+	if (!graph)
 	{
-		if ((*it).type == StringToken::kOpenParenthesis)
-		{
-			openCount++;
-			if (openCount == 1)
-				openPosition = it;
-		}
-		else if ((*it).type == StringToken::kCloseParenthesis)
-		{
-			openCount--;
-			if (openCount == 0)
+		using Definition = Detail::UIExpressionGraph::Definition;
+		auto definitionFunc = [this, withController] (const std::string& symbol, Definition& definition) {
+			auto name = symbol.data () + strlen (Detail::UIExpressionGraph::kTagPrefix);
+			if (symbol.compare (0, strlen (Detail::UIExpressionGraph::kTagPrefix),
+			                    Detail::UIExpressionGraph::kTagPrefix) == 0)
 			{
-				StringTokenList tmp (++openPosition, it);
-				double value = 0;
-				if (computeTokens (tmp, value))
+				// the controller may change every tag and provide tags unknown to the
+				// description, so the tags are requested every time
+				definition.isVolatile = withController;
+				definition.value = -1;
+				auto* node = dynamic_cast<Detail::UIControlTagNode*> (findChildNodeByNameAttribute (getBaseNode (Detail::MainNodeNames::kControlTag), name));
+				if (!node)
+					return withController;
+				auto tag = node->getTag ();
+				if (tag != -1)
 				{
-					--openPosition;
-					++it;
-					tokens.erase (openPosition, it);
-					tokens.insert (it, StringToken (StringToken::kResult, value));
-					if (it == tokens.end ())
-					{
-						break;
-					}
-
-				}
-				else
-					return false;
-			}
-		}
-	}
-	// now multiply and divide
-	StringTokenList::iterator prevToken = tokens.begin ();
-	for (StringTokenList::iterator it = tokens.begin (); it != tokens.end (); ++it)
-	{
-		if (prevToken != it)
-		{
-			if ((*it).type == StringToken::kMulitply)
-			{
-				if ((*prevToken).type == StringToken::kResult)
-				{
-					++it;
-					if ((*it).type == StringToken::kResult)
-					{
-						double value = (*prevToken).result * (*it).result;
-						++it;
-						tokens.erase (prevToken, it);
-						tokens.insert (it, StringToken (StringToken::kResult, value));
-						--it;
-						prevToken = it;
-					}
-					else
-					{
-						return false;
-					}
-				}
-				else
-				{
-					return false;
-				}
-			}
-			else if ((*it).type == StringToken::kDivide)
-			{
-				if ((*prevToken).type == StringToken::kResult)
-				{
-					++it;
-					if ((*it).type == StringToken::kResult)
-					{
-						double value = (*prevToken).result / (*it).result;
-						++it;
-						tokens.erase (prevToken, it);
-						tokens.insert (it, StringToken (StringToken::kResult, value));
-						--it;
-						prevToken = it;
-					}
-					else
-					{
-						return false;
-					}
+					definition.value = tag;
+					return true;
 				}
-				else
+				if (auto tagString = node->getTagString ())
 				{
-					return false;
+					definition.type = Definition::Type::Expression;
+					definition.expression = *tagString;
+					return true;
 				}
+				return withController;
 			}
-			else
+			auto* node = dynamic_cast<Detail::UIVariableNode*> (findChildNodeByNameAttribute (impl->getVariableBaseNode (), name));
+			if (!node)
+				return false;
+			if (node->getType () == Detail::UIVariableNode::kNumber)
 			{
-				prevToken = it;
+				definition.value = node->getNumber ();
+				return true;
 			}
-		}
-	}
-	// now add and subtract
-	int32_t lastType = -1;
-	for (StringTokenList::const_iterator it = tokens.begin (); it != tokens.end (); ++it)
-	{
-		if ((*it).type == UIDescriptionPrivate::StringToken::kResult)
-		{
-			double value = (*it).result;
-			if (lastType == -1)
-				result = value;
-			else if (lastType == StringToken::kAdd)
-				result += value;
-			else if (lastType == StringToken::kSubtract)
-				result -= value;
-			else
+			if (node->getType () == Detail::UIVariableNode::kString)
 			{
-			#if DEBUG
-				DebugPrint ("Wrong Expression: %d\n", (*it).type);
-			#endif
-				return false;
+				definition.type = Definition::Type::Expression;
+				definition.expression = node->getString ();
+				return true;
 			}
-		}
-		else if (!(lastType == -1 || lastType == UIDescriptionPrivate::StringToken::kResult))
-		{
-		#if DEBUG
-			DebugPrint ("Wrong Expression: %d\n", (*it).type);
-		#endif
 			return false;
+		};
+		Detail::UIExpressionGraph::TagResolveFunc tagResolveFunc;
+		if (withController)
+		{
+			tagResolveFunc = [this] (const std::string& symbol, int32_t tag) {
+				auto name = symbol.data () + strlen (Detail::UIExpressionGraph::kTagPrefix);
+				return impl->controller ? impl->controller->getTagForName (name, tag) : tag;
+			};
 		}
-		lastType = (*it).type;
-		
+		graph = std::unique_ptr<Detail::UIExpressionGraph> (
+		    new Detail::UIExpressionGraph (std::move (definitionFunc), std::move (tagResolveFunc)));
 	}
-	return true;
+	return *graph;
 }
 
-} // UIDescriptionPrivate
+//-----------------------------------------------------------------------------
+void UIDescription::invalidateExpression (UTF8StringPtr prefix, UTF8StringPtr name)
+{
+	if (!name)
+		return;
+	if (impl->expressionGraph)
+		impl->expressionGraph->invalidate (std::string (prefix) + name);
+	if (impl->controllerExpressionGraph)
+		impl->controllerExpressionGraph->invalidate (std::string (prefix) + name);
+}
 
 //-----------------------------------------------------------------------------
-bool UIDescription::calculateStringValue (UTF8StringPtr _str, double& result) const
+bool UIDescription::calculateStringValue (UTF8StringPtr str, double& result) const
 {
-	UIDescriptionPrivate::Locale localeResetter;
+	return getExpressionGraph ().evaluateExpression (str, result);
+}
 
-	char* endPtr = nullptr;
-	result = strtod (_str, &endPtr);
-	if (endPtr == _str + strlen (_str))
-		return true;
-	std::string str (_str);
-	UIDescriptionPrivate::StringTokenList tokens;
-	if (!UIDescriptionPrivate::tokenizeString (str, tokens))
-	{
-	#if DEBUG
-		DebugPrint("TokenizeString failed :%s\n", _str);
-	#endif
-		return false;
-	}
-	// first make substituation
-	for (auto& token : tokens)
+//-----------------------------------------------------------------------------
+UIDescription::ExpressionStatistics UIDescription::getExpressionStatistics () const
+{
+	ExpressionStatistics result;
+	for (const auto& graph : {impl->expressionGraph.get (), impl->controllerExpressionGraph.get ()})
 	{
-		if (token.type == UIDescriptionPrivate::StringToken::kString)
+		if (graph)
 		{
-			const char* tokenStr = token.c_str ();
-			double value = strtod (tokenStr, &endPtr);
-			if (endPtr != tokenStr + token.length ())
-			{
-				// if it is not pure numeric try to substitute the string with a control tag or variable
-				if (token.find ("tag.") == 0)
-				{
-					value = getTagForName (token.c_str () + 4);
-					if (value == -1)
-					{
-					#if DEBUG
-						DebugPrint("Tag not found :%s\n", tokenStr);
-					#endif
-						return false;
-					}
-				}
-				else if (token.find ("var.") == 0)
-				{
-					double v;
-					if (getVariable (token.c_str () + 4, v))
-					{
-						value = v;
-					}
-					else
-					{
-					#if DEBUG
-						DebugPrint("Variable not found :%s\n", tokenStr);
-					#endif
-						return false;
-					}
-				}
-				else
-				{
-				#if DEBUG
-					DebugPrint("Substitution failed :%s\n", tokenStr);
-				#endif
-					return false;
-				}
-			}
-			token.result = value;
-			token.type = UIDescriptionPrivate::StringToken::kResult;
+			result.compilations += graph->getStatistics ().compilations;
+			result.evaluations += graph->getStatistics ().evaluations;
 		}
 	}
-	result = 0;
-	return UIDescriptionPrivate::computeTokens (tokens, result);
+	return result;
 }
 
 } // VSTGUI
@@ -6,18 +6,22 @@
 
 #include "iuidescription.h"
 #include "uidescriptionfwd.h"
+#include "../lib/iscalefactorchangedlistener.h"
 #include <list>
 #include <string>
 #include <memory>
+#include <vector>
 
 namespace VSTGUI {
-namespace Detail { class UINode; }
+namespace Detail { class UINode; class UIExpressionGraph; }
 
 //-----------------------------------------------------------------------------
 /// @brief XML description parser and view creator
 /// @ingroup new_in_4_0
 //-----------------------------------------------------------------------------
-class UIDescription : public NonAtomicReferenceCounted, public IUIDescription
+class UIDescription : public NonAtomicReferenceCounted,
+                      public IUIDescription,
+                      public IScaleFactorChangedListener
 {
 	using UINode = Detail::UINode;
 
@@ -134,14 +138,68 @@ public:
 	bool getControlTagString (UTF8StringPtr tagName, std::string& tagString) const;
 	bool changeControlTagString  (UTF8StringPtr tagName, const std::string& newTagString, bool create = false);
 
+	/** change the value of a variable. Cached control tags and variables which depend on it are
+	 *	evaluated again on their next use */
+	bool changeVariable (UTF8StringPtr name, const std::string& value, bool create = false);
+
 	bool calculateStringValue (UTF8StringPtr str, double& result) const;
 
+	struct ExpressionStatistics
+	{
+		/** number of expressions compiled */
+		uint64_t compilations {0};
+		/** number of compiled control tag and variable expressions evaluated */
+		uint64_t evaluations {0};
+	};
+	ExpressionStatistics getExpressionStatistics () const;
+
 	void registerListener (UIDescriptionListener* listener);
 	void unregisterListener (UIDescriptionListener* listener);
 
 	void setBitmapCreator (IBitmapCreator* bitmapCreator);
 	void setBitmapCreator2 (IBitmapCreator2* bitmapCreator);
 
+	/** Before the views of a template are created, all bitmaps referenced by the bitmap attributes
+	 *	of the template and its sub-templates can be decoded and filtered concurrently by this
+	 *	number of threads. 1 (the default) disables the pre-pass, 0 uses the number of hardware
+	 *	threads.
+	 *
+	 *	The pre-pass creates the platform bitmaps from the image files and runs the bitmap filters
+	 *	on worker threads. Only enable it when the platform creates bitmaps from files and memory in
+	 *	a thread safe way, which the Core Graphics (macOS, iOS), WIC (Windows) and Cairo (Linux)
+	 *	bitmaps do, and when all bitmap filters used by the description are thread safe. On Windows
+	 *	the worker threads initialize COM for the WIC decoders. Bitmaps created by an
+	 *	IBitmapCreator are always created on the calling thread. */
+	void setBitmapDecodeThreadCount (uint32_t count);
+	uint32_t getBitmapDecodeThreadCount () const;
+
+	struct BitmapDecodeTraceEntry
+	{
+		std::string name;
+		double decodeMilliseconds {0.};
+		double filterMilliseconds {0.};
+		uint32_t threadIndex {0};
+	};
+	using BitmapDecodeTrace = std::vector<BitmapDecodeTraceEntry>;
+	/** the trace of the bitmap pre-pass of the last createView call */
+	const BitmapDecodeTrace& getBitmapDecodeTrace () const;
+
+	/** In the lazy bitmap loading mode only the scaled variant of a bitmap which matches the
+	 *	bitmap scale factor best is decoded, the other variants are decoded when the bitmap scale
+	 *	factor changes and the unused ones are released (see CBitmap::selectScaleFactor).
+	 *	Variants with filters or which are only provided by a bitmap creator are decoded up front.
+	 *	Register the description as scale factor listener of the frame to follow its scale factor.
+	 *	Must be set before the bitmaps are loaded.
+	 */
+	void setLazyBitmapLoading (bool state);
+	bool getLazyBitmapLoading () const;
+	void setBitmapScaleFactor (double scaleFactor);
+	double getBitmapScaleFactor () const;
+	/** the estimated memory size in bytes of the scaled variants which are not decoded */
+	size_t getUnloadedBitmapMemorySize () const;
+
+	void onScaleFactorChanged (CFrame* frame, double newScaleFactor) override;
+
 	using FocusDrawing = FocusDrawingSettings;
 	FocusDrawing getFocusDrawingSettings () const;
 	void setFocusDrawingSettings (const FocusDrawing& fd);
@@ -155,6 +213,8 @@ protected:
 	void addDefaultNodes ();
 
 	bool saveToStream (OutputStream& stream, int32_t flags, AttributeSaveFilterFunc func);
+	/** notify the listeners and create or remove the embedded bitmap data as saveToStream does */
+	void prepareNodesForSave (int32_t flags, AttributeSaveFilterFunc func);
 
 	bool parsed () const;
 	void setContentProvider (IContentProvider* provider);
@@ -162,7 +222,10 @@ protected:
 	const CResourceDescription& getUIDescFile () const;
 private:
 	CView* createViewFromNode (UINode* node) const;
+	void decodeBitmaps (UINode* templateNode) const;
 	UINode* getBaseNode (UTF8StringPtr name) const;
+	Detail::UIExpressionGraph& getExpressionGraph () const;
+	void invalidateExpression (UTF8StringPtr prefix, UTF8StringPtr name);
 	UINode* findChildNodeByNameAttribute (UINode* node, UTF8StringPtr nameAttribute) const;
 	UINode* findNodeForView (CView* view) const;
 	bool updateAttributesForView (UINode* node, CView* view, bool deep = true);
@@ -293,14 +293,9 @@ bool UIViewFactory::getAttributeValue (CView* view, const std::string& attribute
 //-----------------------------------------------------------------------------
 IViewCreator::AttrType UIViewFactory::getAttributeType (CView* view, const std::string& attributeName) const
 {
-	auto& registry = getCreatorRegistry ();
-	auto type = IViewCreator::kUnknownType;
-	auto iter = registry.find (getViewName (view));
-	while (iter != registry.end () && (type = (*iter).second->getAttributeType (attributeName)) == IViewCreator::kUnknownType && (*iter).second->getBaseViewName ())
-	{
-		iter = registry.find ((*iter).second->getBaseViewName ());
-	}
-	return type;
+	if (auto viewName = getViewName (view))
+		return getAttributeTypeForViewName (viewName, attributeName);
+	return IViewCreator::kUnknownType;
 }
 
 //-----------------------------------------------------------------------------
@@ -485,4 +480,18 @@ void UIViewFactory::unregisterViewCreator (const IViewCreator& viewCreator)
 	registry.remove (&viewCreator);
 }
 
+//-----------------------------------------------------------------------------
+IViewCreator::AttrType UIViewFactory::getAttributeTypeForViewName (
+    const std::string& viewName, const std::string& attributeName)
+{
+	auto& registry = getCreatorRegistry ();
+	auto type = IViewCreator::kUnknownType;
+	auto iter = registry.find (viewName.data ());
+	while (iter != registry.end () && (type = (*iter).second->getAttributeType (attributeName)) == IViewCreator::kUnknownType && (*iter).second->getBaseViewName ())
+	{
+		iter = registry.find ((*iter).second->getBaseViewName ());
+	}
+	return type;
+}
+
 } // VSTGUI
@@ -31,6 +31,10 @@ public:
 	static void registerViewCreator (const IViewCreator& viewCreator);
 	static void unregisterViewCreator (const IViewCreator& viewCreator);
 
+	/** the type of an attribute of the registered view creator viewName or its base view creators */
+	static IViewCreator::AttrType getAttributeTypeForViewName (const std::string& viewName,
+	                                                           const std::string& attributeName);
+
 #if VSTGUI_LIVE_EDITING
 	using StringPtrList = std::list<const std::string*>;
 	using StringList = std::list<std::string>;
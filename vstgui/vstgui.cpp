@@ -3,14 +3,17 @@
 // distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
 
 #include "lib/cbitmap.cpp"
+#include "lib/cbitmapatlas.cpp"
 #include "lib/cbitmapfilter.cpp"
 #include "lib/cclipboard.cpp"
 #include "lib/ccolor.cpp"
 #include "lib/cdatabrowser.cpp"
 #include "lib/cdrawcontext.cpp"
 #include "lib/cdrawmethods.cpp"
+#include "lib/cdrawprofiler.cpp"
 #include "lib/cdropsource.cpp"
 #include "lib/cfileselector.cpp"
+#include "lib/cfilmstripbitmap.cpp"
 #include "lib/cfont.cpp"
 #include "lib/cframe.cpp"
 #include "lib/cgradient.cpp"
@@ -35,8 +38,10 @@
 #include "lib/events.cpp"
 #include "lib/genericstringlistdatabrowsersource.cpp"
 #include "lib/pixelbuffer.cpp"
+#include "lib/stringlistsearchindex.cpp"
 #include "lib/vstguidebug.cpp"
 #include "lib/vstguiinit.cpp"
+#include "lib/vstguitrace.cpp"
 
 #include "lib/controls/cautoanimation.cpp"
 #include "lib/controls/cbuttons.cpp"
@@ -48,6 +53,7 @@
 #include "lib/controls/cmoviebitmap.cpp"
 #include "lib/controls/cmoviebutton.cpp"
 #include "lib/controls/coptionmenu.cpp"
+#include "lib/controls/coptionmenumodel.cpp"
 #include "lib/controls/cparamdisplay.cpp"
 #include "lib/controls/cscrollbar.cpp"
 #include "lib/controls/csearchtextedit.cpp"
@@ -64,9 +70,13 @@
 
 #include "lib/animation/animations.cpp"
 #include "lib/animation/animator.cpp"
+#include "lib/animation/batchedanimations.cpp"
+#include "lib/animation/frameclock.cpp"
 #include "lib/animation/timingfunctions.cpp"
 
 #include "lib/platform/platformfactory.cpp"
 #include "lib/platform/common/fileresourceinputstream.cpp"
 #include "lib/platform/common/genericoptionmenu.cpp"
 #include "lib/platform/common/generictextedit.cpp"
+#include "lib/platform/common/inputeventcoalescer.cpp"
+#include "lib/platform/common/viewlayercompositor.cpp"
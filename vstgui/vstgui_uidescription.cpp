@@ -72,6 +72,7 @@
 #include "uidescription/viewcreator/xypadcreator.cpp"
 
 #include "uidescription/detail/uidesclist.cpp"
+#include "uidescription/detail/uiexpressiongraph.cpp"
 #include "uidescription/detail/uijsonpersistence.cpp"
 #include "uidescription/detail/uinode.cpp"
 #include "uidescription/detail/uixmlpersistence.cpp"